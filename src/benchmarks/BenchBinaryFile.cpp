@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "../main/BinaryFile.h"
+
+using namespace graph_algo;
+
+/*
+ * A file of n random points, written once per size
+ */
+static std::string pointFile(std::size_t n) {
+    const std::string path = "/tmp/graph_algo_bench_points_" + std::to_string(n) + ".bin";
+    std::FILE *existing = std::fopen(path.c_str(), "rb");
+    if (existing != nullptr) {
+        std::fclose(existing);
+        return path;
+    }
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    PointBuffer<double> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+    writePoints(path, points, 1 << 16);
+    return path;
+}
+
+// Opening a file: map it and check the header, the points are not touched
+static void BM_BinaryFile_Map(benchmark::State &state) {
+    const std::string path = pointFile(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        const MappedPoints<double> points(path);
+        benchmark::DoNotOptimize(points[points.size() / 2]);
+    }
+}
+
+// Opening a file and reading every point once from the page cache
+static void BM_BinaryFile_MapAndScan(benchmark::State &state) {
+    const std::string path = pointFile(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        const MappedPoints<double> points(path);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < points.size(); ++i) sum += points.xs()[i] + points.ys()[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Opening a file and copying its points into a PointBuffer
+static void BM_BinaryFile_Copy(benchmark::State &state) {
+    const std::string path = pointFile(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MappedPoints<double>(path).buffer().xs());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_BinaryFile_Validate(benchmark::State &state) {
+    const std::string path = pointFile(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBinaryFile(path).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_BinaryFile_Map)->Arg(1 << 20)->Arg(1 << 27)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BinaryFile_MapAndScan)->Arg(1 << 20)->Arg(1 << 27)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryFile_Copy)->Arg(1 << 20)->Arg(1 << 27)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryFile_Validate)->Arg(1 << 20)->Arg(1 << 27)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Comparators.h"
+#include "../main/Point.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<Point<T> > makePoints(std::size_t n) {
+    std::vector<Point<T> > points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(Point<T>(T(i * 7919 % 10007) * 0.25, T(i * 104729 % 7777) * -0.5));
+    }
+    return points;
+}
+
+static void BM_Sort_PointOperatorLess(benchmark::State &state) {
+    const std::vector<Point<T> > original = makePoints(state.range(0));
+    for (auto _ : state) {
+        std::vector<Point<T> > points = original;
+        std::sort(points.begin(), points.end());
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Sort_LessLength(benchmark::State &state) {
+    const std::vector<Point<T> > original = makePoints(state.range(0));
+    for (auto _ : state) {
+        std::vector<Point<T> > points = original;
+        std::sort(points.begin(), points.end(), LessLength());
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Sort_ByLength(benchmark::State &state) {
+    const std::vector<Point<T> > original = makePoints(state.range(0));
+    for (auto _ : state) {
+        std::vector<Point<T> > points = original;
+        sortByLength(points);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Sort_PointOperatorLess)->Arg(1 << 20);
+BENCHMARK(BM_Sort_LessLength)->Arg(1 << 20);
+BENCHMARK(BM_Sort_ByLength)->Arg(1 << 20);
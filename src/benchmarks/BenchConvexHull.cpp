@@ -0,0 +1,48 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/ConvexHull.h"
+#include "../main/PackedPoint.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<PackedPoint<T> > makePoints(std::size_t n) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<T> dist(-1000.0, 1000.0);
+    std::vector<PackedPoint<T> > points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(PackedPoint<T>(dist(gen), dist(gen)));
+    }
+    return points;
+}
+
+static void BM_MonotoneChainHull(benchmark::State &state) {
+    const std::vector<PackedPoint<T> > points = makePoints(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(monotoneChainHull(points).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ChanHull(benchmark::State &state) {
+    const std::vector<PackedPoint<T> > points = makePoints(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(chanHull(points).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ParallelHull(benchmark::State &state) {
+    const std::vector<PackedPoint<T> > points = makePoints(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallelHull(points).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_MonotoneChainHull)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ChanHull)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelHull)->Arg(10000000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <random>
+#include <benchmark/benchmark.h>
+#include "../main/Voronoi.h"
+
+using namespace graph_algo;
+
+static PointBuffer<double> randomPoints(std::size_t n) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    PointBuffer<double> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+    return points;
+}
+
+static void BM_Delaunay(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)));
+    for (auto _ : state) {
+        DelaunayTriangulation triangulation(points, unsigned(state.range(1)));
+        benchmark::DoNotOptimize(triangulation.triangleCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Delaunay_Grid(benchmark::State &state) {
+    const std::uint32_t side = std::uint32_t(state.range(0));
+    PointBuffer<double> points;
+    for (std::uint32_t y = 0; y < side; ++y) {
+        for (std::uint32_t x = 0; x < side; ++x) points.push_back(double(x), double(y));
+    }
+    for (auto _ : state) {
+        DelaunayTriangulation triangulation(points, unsigned(state.range(1)));
+        benchmark::DoNotOptimize(triangulation.triangleCount());
+    }
+    state.SetItemsProcessed(state.iterations() * side * side);
+}
+
+static void BM_Voronoi(benchmark::State &state) {
+    const DelaunayTriangulation triangulation(randomPoints(std::size_t(state.range(0))));
+    for (auto _ : state) {
+        VoronoiDiagram voronoi(triangulation);
+        benchmark::DoNotOptimize(voronoi.vertexCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MinimumSpanningTree(benchmark::State &state) {
+    const DelaunayTriangulation triangulation(randomPoints(std::size_t(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(triangulation.minimumSpanningTree().edgeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Delaunay)->Args({100000, 1})->Args({1000000, 1})->Args({1000000, 4})->Args({10000000, 1})
+        ->Args({10000000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Delaunay_Grid)->Args({1000, 1})->Args({1000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Voronoi)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MinimumSpanningTree)->Arg(1000000)->Unit(benchmark::kMillisecond);
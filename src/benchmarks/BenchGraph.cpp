@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Graph.h"
+
+using namespace graph_algo;
+
+typedef GraphBuilder<std::uint32_t, float> Builder;
+
+/*
+ * A road network like graph: n vertices of average out-degree 4, edges mostly between nearby ids
+ */
+static Builder makeBuilder(std::uint32_t n) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, n - 1);
+    std::uniform_int_distribution<int> offset(-64, 64);
+    std::uniform_real_distribution<float> weight(1.0f, 100.0f);
+    Builder::index_array sources, targets;
+    Builder::weight_array weights;
+    for (std::size_t i = 0; i < std::size_t(n) * 4; ++i) {
+        const std::uint32_t u = vertex(gen);
+        const std::int64_t v = std::int64_t(u) + offset(gen);
+        sources.push_back(u);
+        targets.push_back(std::uint32_t(v < 0 ? 0 : v >= n ? n - 1 : v));
+        weights.push_back(weight(gen));
+    }
+    return Builder(n, sources, targets, weights);
+}
+
+static void BM_Build_Csr(benchmark::State &state) {
+    const Builder builder = makeBuilder(std::uint32_t(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(builder.build().edgeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * builder.edgeCount());
+}
+
+static void BM_Build_AdjacencyList(benchmark::State &state) {
+    const Builder builder = makeBuilder(std::uint32_t(state.range(0)));
+    const CsrGraph<std::uint32_t, float> graph = builder.build();
+    for (auto _ : state) {
+        std::vector<std::vector<std::pair<std::uint32_t, float> > > adjacency(graph.vertexCount());
+        for (std::uint32_t v = 0; v < graph.vertexCount(); ++v) {
+            for (std::uint32_t e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                adjacency[v].push_back(std::make_pair(graph.target(e), graph.weight(e)));
+            }
+        }
+        benchmark::DoNotOptimize(adjacency.data());
+    }
+    state.SetItemsProcessed(state.iterations() * builder.edgeCount());
+}
+
+/*
+ * Sums the weights of the out-edges of every vertex, the inner loop of most graph algorithms
+ */
+static void BM_Scan_Csr(benchmark::State &state) {
+    const CsrGraph<std::uint32_t, float> graph = makeBuilder(std::uint32_t(state.range(0))).build();
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::uint32_t v = 0; v < graph.vertexCount(); ++v) {
+            for (std::uint32_t e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                sum += graph.weight(e) * graph.target(e);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+    state.counters["bytes"] = double(graph.memoryUsage());
+}
+
+static void BM_Scan_AdjacencyList(benchmark::State &state) {
+    const CsrGraph<std::uint32_t, float> graph = makeBuilder(std::uint32_t(state.range(0))).build();
+    std::vector<std::vector<std::pair<std::uint32_t, float> > > adjacency(graph.vertexCount());
+    for (std::uint32_t v = 0; v < graph.vertexCount(); ++v) {
+        for (std::uint32_t e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            adjacency[v].push_back(std::make_pair(graph.target(e), graph.weight(e)));
+        }
+    }
+    std::size_t bytes = adjacency.size() * sizeof(adjacency[0]);
+    for (std::size_t v = 0; v < adjacency.size(); ++v) bytes += adjacency[v].capacity() * sizeof(adjacency[v][0]);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::size_t v = 0; v < adjacency.size(); ++v) {
+            for (std::size_t i = 0; i < adjacency[v].size(); ++i) {
+                sum += adjacency[v][i].second * adjacency[v][i].first;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+    state.counters["bytes"] = double(bytes);
+}
+
+BENCHMARK(BM_Build_Csr)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Build_AdjacencyList)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Scan_Csr)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Scan_AdjacencyList)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
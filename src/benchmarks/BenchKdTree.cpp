@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/KdTree.h"
+#include "../main/Point.h"
+
+using namespace graph_algo;
+
+static PointBuffer<double> randomPoints(std::size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    PointBuffer<double> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+    return points;
+}
+
+static const KdTree<double> &tree(std::size_t n) {
+    static KdTree<double> cached;
+    if (cached.size() != n) cached = KdTree<double>(randomPoints(n, 1));
+    return cached;
+}
+
+static void BM_KdTree_Build(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    for (auto _ : state) {
+        KdTree<double> built(points, unsigned(state.range(1)));
+        benchmark::DoNotOptimize(built.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The brute force search that Point::operator| offers
+static void BM_Nearest_BruteForce(benchmark::State &state) {
+    std::vector<Point<double> > points;
+    const PointBuffer<double> buffer = randomPoints(std::size_t(state.range(0)), 1);
+    for (std::size_t i = 0; i < buffer.size(); ++i) points.push_back(Point<double>(buffer.xs()[i], buffer.ys()[i]));
+    const PointBuffer<double> queries = randomPoints(1024, 2);
+    std::size_t q = 0;
+    for (auto _ : state) {
+        const Point<double> query(queries.xs()[q], queries.ys()[q]);
+        q = (q + 1) % queries.size();
+        std::size_t best = 0;
+        double bestDistance = points[0] | query;
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            const double d = points[i] | query;
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = i;
+            }
+        }
+        benchmark::DoNotOptimize(best);
+    }
+}
+
+static void BM_KdTree_Nearest(benchmark::State &state) {
+    const KdTree<double> &index = tree(std::size_t(state.range(0)));
+    const PointBuffer<double> queries = randomPoints(1 << 16, 2);
+    std::size_t q = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.nearest(queries[q]));
+        q = (q + 1) & (queries.size() - 1);
+    }
+}
+
+static void BM_KdTree_Nearest16(benchmark::State &state) {
+    const KdTree<double> &index = tree(std::size_t(state.range(0)));
+    const PointBuffer<double> queries = randomPoints(1 << 16, 2);
+    std::uint32_t indices[16];
+    double distances[16];
+    std::size_t q = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.nearest(queries[q], 16, indices, distances));
+        q = (q + 1) & (queries.size() - 1);
+    }
+}
+
+static void BM_KdTree_NearestLoop(benchmark::State &state) {
+    const KdTree<double> &index = tree(std::size_t(state.range(0)));
+    const PointBuffer<double> queries = randomPoints(1 << 20, 2);
+    std::vector<std::uint32_t> out(queries.size());
+    for (auto _ : state) {
+        for (std::size_t q = 0; q < queries.size(); ++q) out[q] = index.nearest(queries[q]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_KdTree_NearestBatch(benchmark::State &state) {
+    const KdTree<double> &index = tree(std::size_t(state.range(0)));
+    const PointBuffer<double> queries = randomPoints(1 << 20, 2);
+    std::vector<std::uint32_t> out(queries.size());
+    for (auto _ : state) {
+        index.nearestBatch(queries, 1, out.data(), 0, unsigned(state.range(1)));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_KdTree_Box(benchmark::State &state) {
+    const KdTree<double> &index = tree(std::size_t(state.range(0)));
+    std::vector<std::uint32_t> out;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coordinate(0.0, 990.0);
+    for (auto _ : state) {
+        const double x = coordinate(gen), y = coordinate(gen);
+        out.clear();
+        benchmark::DoNotOptimize(index.box(x, y, x + 10.0, y + 10.0, out));
+    }
+}
+
+BENCHMARK(BM_KdTree_Build)->Args({1000000, 1})->Args({1000000, 4})->Args({10000000, 4})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Nearest_BruteForce)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_KdTree_Nearest)->Arg(100000)->Arg(10000000);
+BENCHMARK(BM_KdTree_Nearest16)->Arg(10000000);
+BENCHMARK(BM_KdTree_NearestLoop)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KdTree_NearestBatch)->Args({10000000, 1})->Args({10000000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_KdTree_Box)->Arg(10000000);
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/MemoryArena.h"
+#include "../main/PointBuffer.h"
+
+using namespace graph_algo;
+
+/*
+ * One small geometry query: a PointBuffer and an index list of range(0) entries, built and dropped
+ */
+template<class Buffer, class Indices>
+static std::size_t query(Buffer &points, Indices &indices, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(double(i), double(n - i));
+        indices.push_back(std::uint32_t(i));
+    }
+    return points.size() + indices.size();
+}
+
+static void BM_MemoryArena_HeapScratch(benchmark::State &state) {
+    const std::size_t n = std::size_t(state.range(0));
+    for (auto _ : state) {
+        PointBuffer<double> points;
+        std::vector<std::uint32_t> indices;
+        benchmark::DoNotOptimize(query(points, indices, n));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_MemoryArena_ArenaScratch(benchmark::State &state) {
+    const std::size_t n = std::size_t(state.range(0));
+    MonotonicArena arena;
+    for (auto _ : state) {
+        ArenaScope scope(arena);
+        PointBuffer<double> points(&arena);
+        std::pmr::vector<std::uint32_t> indices(&arena);
+        benchmark::DoNotOptimize(query(points, indices, n));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * A queue of 64 nodes that is pushed and popped, as in a breadth first walk
+ */
+static void BM_MemoryArena_HeapNodes(benchmark::State &state) {
+    std::list<std::uint64_t> queue(64);
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+        queue.push_back(i++);
+        queue.pop_front();
+    }
+    benchmark::DoNotOptimize(queue.front());
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_MemoryArena_PoolNodes(benchmark::State &state) {
+    FixedPool pool(32);
+    std::pmr::list<std::uint64_t> queue(64, &pool);
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+        queue.push_back(i++);
+        queue.pop_front();
+    }
+    benchmark::DoNotOptimize(queue.front());
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MemoryArena_HeapScratch)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_MemoryArena_ArenaScratch)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_MemoryArena_HeapNodes);
+BENCHMARK(BM_MemoryArena_PoolNodes);
@@ -0,0 +1,126 @@
+#include <cstring>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Point.h"
+#include "../main/PackedPoint.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static const int kPoints = 10000000;
+
+template<class P>
+static std::vector<P> makePoints(std::size_t n) {
+    std::vector<P> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(P(T(i % 1000) * 0.25, T(i % 777) * -0.5));
+    }
+    return points;
+}
+
+template<class P>
+static void BM_Copy(benchmark::State &state) {
+    const std::vector<P> src = makePoints<P>(state.range(0));
+    std::vector<P> dst(src.size());
+    for (auto _ : state) {
+        dst = src;
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(P));
+}
+
+static void BM_Memcpy_PackedPoint(benchmark::State &state) {
+    const std::vector<PackedPoint<T> > src = makePoints<PackedPoint<T> >(state.range(0));
+    std::vector<PackedPoint<T> > dst(src.size());
+    for (auto _ : state) {
+        std::memcpy(dst.data(), src.data(), src.size() * sizeof(PackedPoint<T>));
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(PackedPoint<T>));
+}
+
+template<class P>
+static void BM_Translate(benchmark::State &state) {
+    std::vector<P> points = makePoints<P>(state.range(0));
+    const P offset(0.5, -0.25);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            points[i] = points[i] + offset;
+        }
+        benchmark::DoNotOptimize(points.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class P>
+static void BM_CrossSum(benchmark::State &state) {
+    const std::vector<P> points = makePoints<P>(state.range(0));
+    for (auto _ : state) {
+        T sum = T();
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            sum += points[i - 1] & points[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class P>
+static void BM_LengthSum(benchmark::State &state) {
+    const std::vector<P> points = makePoints<P>(state.range(0));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            sum += points[i].length();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class P>
+static void BM_DistanceSum(benchmark::State &state) {
+    const std::vector<P> points = makePoints<P>(state.range(0));
+    for (auto _ : state) {
+        T sum = T();
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            sum += points[i - 1] | points[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class P>
+static void BM_AngleSum(benchmark::State &state) {
+    const std::vector<P> points = makePoints<P>(state.range(0));
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            sum += points[i].angle();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_Copy, Point<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Copy, PackedPoint<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Memcpy_PackedPoint)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Translate, Point<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Translate, PackedPoint<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CrossSum, Point<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CrossSum, PackedPoint<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LengthSum, Point<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LengthSum, PackedPoint<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DistanceSum, Point<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DistanceSum, PackedPoint<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_AngleSum, Point<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_AngleSum, PackedPoint<T>)->RangeMultiplier(100)->Range(1000, kPoints)->Unit(benchmark::kMicrosecond);
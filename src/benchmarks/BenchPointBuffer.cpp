@@ -0,0 +1,134 @@
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Point.h"
+#include "../main/PointBuffer.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<Point<T> > makePoints(std::size_t n) {
+    std::vector<Point<T> > points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(Point<T>(T(i % 1000) * 0.25, T(i % 777) * -0.5));
+    }
+    return points;
+}
+
+static void BM_PointLoop_Translate(benchmark::State &state) {
+    std::vector<Point<T> > points = makePoints(state.range(0));
+    const Point<T> offset(0.5, -0.25);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            points[i] = points[i] + offset;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_PointBuffer_Translate(benchmark::State &state) {
+    PointBuffer<T> buffer(makePoints(state.range(0)));
+    const PackedPoint<T> offset(0.5, -0.25);
+    for (auto _ : state) {
+        buffer += offset;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_PointLoop_Distance(benchmark::State &state) {
+    const std::vector<Point<T> > points = makePoints(state.range(0));
+    std::vector<T> out(points.size());
+    const Point<T> p(12.0, -3.0);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            out[i] = points[i] | p;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_PointBuffer_Distance(benchmark::State &state) {
+    const PointBuffer<T> buffer(makePoints(state.range(0)));
+    std::vector<T> out(buffer.size());
+    const PackedPoint<T> p(12.0, -3.0);
+    for (auto _ : state) {
+        buffer.distances(p, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::kernels().name);
+}
+
+static void BM_PointLoop_Cross(benchmark::State &state) {
+    const std::vector<Point<T> > points = makePoints(state.range(0));
+    std::vector<T> out(points.size());
+    const Point<T> p(12.0, -3.0);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            out[i] = points[i] & p;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_PointBuffer_Cross(benchmark::State &state) {
+    const PointBuffer<T> buffer(makePoints(state.range(0)));
+    std::vector<T> out(buffer.size());
+    const PackedPoint<T> p(12.0, -3.0);
+    for (auto _ : state) {
+        buffer.cross(p, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::kernels().name);
+}
+
+static void BM_PointLoop_Angle(benchmark::State &state) {
+    const std::vector<Point<T> > points = makePoints(state.range(0));
+    std::vector<T> out(points.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            out[i] = points[i].angle();
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class Precision>
+static void BM_PointBuffer_Angle(benchmark::State &state) {
+    const PointBuffer<T> buffer(makePoints(state.range(0)));
+    std::vector<T> out(buffer.size());
+    for (auto _ : state) {
+        buffer.angles<Precision>(out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::kernels().name);
+}
+
+static void BM_PointBuffer_PseudoAngle(benchmark::State &state) {
+    const PointBuffer<T> buffer(makePoints(state.range(0)));
+    std::vector<T> out(buffer.size());
+    for (auto _ : state) {
+        buffer.pseudoAngles(out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PointLoop_Translate)->Arg(1 << 20);
+BENCHMARK(BM_PointBuffer_Translate)->Arg(1 << 20);
+BENCHMARK(BM_PointLoop_Distance)->Arg(1 << 20);
+BENCHMARK(BM_PointBuffer_Distance)->Arg(1 << 20);
+BENCHMARK(BM_PointLoop_Cross)->Arg(1 << 20);
+BENCHMARK(BM_PointBuffer_Cross)->Arg(1 << 20);
+BENCHMARK(BM_PointLoop_Angle)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PointBuffer_Angle, ExactPrecision)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PointBuffer_Angle, ApproxPrecision)->Arg(1 << 20);
+BENCHMARK(BM_PointBuffer_PseudoAngle)->Arg(1 << 20);
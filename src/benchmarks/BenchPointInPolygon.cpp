@@ -0,0 +1,99 @@
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Point.h"
+#include "../main/PointInPolygon.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+/*
+ * A smooth concave outline of n vertices
+ */
+static Polygon<T> makeFlower(std::size_t n) {
+    Polygon<T> polygon;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = 2.0 * M_PI * double(i) / double(n), r = 100.0 * (0.7 + 0.3 * std::sin(5.0 * t));
+        polygon.push_back(r * std::cos(t), r * std::sin(t));
+    }
+    return polygon;
+}
+
+static Polygon<T> makeStar(std::mt19937 &gen, std::size_t n, T cx, T cy, T radius) {
+    std::uniform_real_distribution<T> unit(0.5, 1.0);
+    Polygon<T> polygon;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = 2.0 * M_PI * double(i) / double(n), r = radius * unit(gen);
+        polygon.push_back(cx + r * std::cos(t), cy + r * std::sin(t));
+    }
+    return polygon;
+}
+
+static PointBuffer<T> makePoints(std::size_t n, T low, T high) {
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<T> coordinate(low, high);
+    PointBuffer<T> points;
+    for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+    return points;
+}
+
+/*
+ * Ray casting over all edges, with the side of each edge from Point::operator&
+ */
+static void BM_PointInPolygon_RayCast(benchmark::State &state) {
+    const Polygon<T> polygon = makeFlower(std::size_t(state.range(0)));
+    std::vector<Point<T> > ring;
+    for (int i = 0; i < polygon.size(); ++i) ring.push_back(Point<T>(polygon.xs()[i], polygon.ys()[i]));
+    const PointBuffer<T> points = makePoints(1 << 12, -100.0, 100.0);
+    for (auto _ : state) {
+        std::size_t inside = 0;
+        for (std::size_t p = 0; p < points.size(); ++p) {
+            const Point<T> q(points.xs()[p], points.ys()[p]);
+            bool in = false;
+            for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                const bool up = ring[j].getY() <= q.getY(), down = ring[i].getY() <= q.getY();
+                // Crossing upwards with q on the left or downwards with q on the right
+                if (up != down && (((ring[i] - ring[j]) & (q - ring[j])) > 0.0) != down) in = !in;
+            }
+            inside += in;
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(points.size()));
+}
+
+static void BM_PointInPolygon_Locator(benchmark::State &state) {
+    const PolygonLocator<T> locator(makeFlower(std::size_t(state.range(0))));
+    const PointBuffer<T> points = makePoints(1 << 12, -100.0, 100.0);
+    std::vector<std::uint8_t> inside(points.size());
+    for (auto _ : state) {
+        locator.contains(0, points, inside.data());
+        benchmark::DoNotOptimize(inside.data());
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(points.size()));
+}
+
+/*
+ * 100k zones of 16 vertices over a 1000 x 1000 square against 1M points
+ */
+static void BM_PointInPolygon_Zones(benchmark::State &state) {
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<T> coordinate(0.0, 1000.0);
+    std::vector<Polygon<T> > zones;
+    for (int z = 0; z < 100000; ++z) zones.push_back(makeStar(gen, 16, coordinate(gen), coordinate(gen), 3.0));
+    const PolygonLocator<T> locator(zones);
+    const PointBuffer<T> points = makePoints(1 << 20, 0.0, 1000.0);
+    std::vector<std::uint32_t> located(points.size());
+    for (auto _ : state) {
+        locator.locate(points, located.data(), unsigned(state.range(0)));
+        benchmark::DoNotOptimize(located.data());
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(points.size()));
+}
+
+BENCHMARK(BM_PointInPolygon_RayCast)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_PointInPolygon_Locator)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_PointInPolygon_Zones)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,55 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Point.h"
+#include "../main/Polygon.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<Point<T> > makeRing(std::size_t n) {
+    std::vector<Point<T> > points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = 2.0 * M_PI * double(i) / double(n);
+        points.push_back(Point<T>(100.0 * std::cos(t), 50.0 * std::sin(t)));
+    }
+    return points;
+}
+
+/*
+ * Area, centroid and perimeter as three separate walks over Point objects
+ */
+static void BM_PointLoops_Metrics(benchmark::State &state) {
+    const std::vector<Point<T> > ring = makeRing(state.range(0));
+    const std::size_t n = ring.size();
+    for (auto _ : state) {
+        double area = 0.0, cx = 0.0, cy = 0.0, perimeter = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            area += ring[i] & ring[(i + 1) % n];
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const double c = ring[i] & ring[(i + 1) % n];
+            cx += (ring[i].getX() + ring[(i + 1) % n].getX()) * c;
+            cy += (ring[i].getY() + ring[(i + 1) % n].getY()) * c;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            perimeter += ring[i] | ring[(i + 1) % n];
+        }
+        benchmark::DoNotOptimize(area + cx + cy + perimeter);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Polygon_Metrics(benchmark::State &state) {
+    const Polygon<T> polygon(makeRing(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.metrics());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::kernels().name);
+}
+
+BENCHMARK(BM_PointLoops_Metrics)->Arg(1 << 20);
+BENCHMARK(BM_Polygon_Metrics)->Arg(1 << 20);
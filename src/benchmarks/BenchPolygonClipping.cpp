@@ -0,0 +1,88 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/PolygonClipping.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+/*
+ * n vertices around the origin, on a circle or alternating between two radii
+ */
+static Polygon<T> makeRing(std::size_t n, bool concave, double rotation = 0.0) {
+    Polygon<T> polygon;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = rotation + 2.0 * M_PI * double(i) / double(n);
+        const double r = concave && i % 2 == 1 ? 70.0 : 100.0;
+        polygon.push_back(r * std::cos(t), r * std::sin(t));
+    }
+    return polygon;
+}
+
+/*
+ * An 8 x 8 grid of squares over the ring
+ */
+static std::vector<Polygon<T> > makeTiles() {
+    std::vector<Polygon<T> > tiles;
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            const double x = -100.0 + 25.0 * i, y = -100.0 + 25.0 * j;
+            Polygon<T> tile;
+            tile.push_back(x, y);
+            tile.push_back(x + 25.0, y);
+            tile.push_back(x + 25.0, y + 25.0);
+            tile.push_back(x, y + 25.0);
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+/*
+ * Cuts a ring into tiles with one clipper and result, the convex ring takes the Sutherland-Hodgman path
+ */
+static void BM_PolygonClipping_Tiles(benchmark::State &state) {
+    const Polygon<T> ring = makeRing(std::size_t(state.range(0)), state.range(1) != 0);
+    const std::vector<Polygon<T> > tiles = makeTiles();
+    PolygonClipper<T> clipper;
+    PolygonSet<T> result;
+    for (auto _ : state) {
+        double area = 0.0;
+        for (std::size_t t = 0; t < tiles.size(); ++t) {
+            clipper.clip(ring, tiles[t], CLIP_INTERSECTION, result);
+            area += result.signedArea();
+        }
+        benchmark::DoNotOptimize(area);
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(tiles.size()));
+}
+
+// The same cuts through the free functions, with new buffers for every clip
+static void BM_PolygonClipping_TilesFresh(benchmark::State &state) {
+    const Polygon<T> ring = makeRing(std::size_t(state.range(0)), state.range(1) != 0);
+    const std::vector<Polygon<T> > tiles = makeTiles();
+    for (auto _ : state) {
+        double area = 0.0;
+        for (std::size_t t = 0; t < tiles.size(); ++t) area += polygonIntersection(ring, tiles[t]).signedArea();
+        benchmark::DoNotOptimize(area);
+    }
+    state.SetItemsProcessed(state.iterations() * std::int64_t(tiles.size()));
+}
+
+static void BM_PolygonClipping_Union(benchmark::State &state) {
+    const std::size_t n = std::size_t(state.range(0));
+    const Polygon<T> a = makeRing(n, true), b = makeRing(n, true, M_PI / double(n));
+    PolygonClipper<T> clipper;
+    PolygonSet<T> result;
+    for (auto _ : state) {
+        clipper.clip(a, b, CLIP_UNION, result);
+        benchmark::DoNotOptimize(result.vertexCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PolygonClipping_Tiles)->Args({64, 0})->Args({64, 1})->Args({4096, 0})->Args({4096, 1});
+BENCHMARK(BM_PolygonClipping_TilesFresh)->Args({64, 0})->Args({64, 1});
+BENCHMARK(BM_PolygonClipping_Union)->Arg(1 << 10)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
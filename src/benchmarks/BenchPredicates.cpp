@@ -0,0 +1,91 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/Point.h"
+#include "../main/Predicates.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+/*
+ * Triangles whose third point lies on the line through the first two, up to a few ulps
+ * when degenerate, or anywhere in the unit square otherwise.
+ */
+static std::vector<Point<T> > makeTriangles(std::size_t n, bool degenerate) {
+    std::vector<Point<T> > points;
+    points.reserve(3 * n);
+    const double ulp = std::ldexp(1.0, -53);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = double(i % 1000) / 1000.0;
+        points.push_back(Point<T>(12.0, 12.0));
+        points.push_back(Point<T>(24.0, 24.0));
+        if (degenerate) {
+            points.push_back(Point<T>(0.5 + double(i % 17) * ulp, 0.5 + double(i % 13) * ulp));
+        } else {
+            points.push_back(Point<T>(t, double(i * 7919 % 1000) / 1000.0));
+        }
+    }
+    return points;
+}
+
+/*
+ * Quadruples whose fourth point lies on the circle through the first three, up to one unit
+ * when degenerate, or anywhere in the bounding square otherwise.
+ */
+static std::vector<Point<T> > makeQuadruples(std::size_t n, bool degenerate) {
+    std::vector<Point<T> > points;
+    points.reserve(4 * n);
+    const double k = std::ldexp(1.0, 22);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(Point<T>(5 * k, 0.0));
+        points.push_back(Point<T>(3 * k, 4 * k));
+        points.push_back(Point<T>(-4 * k, 3 * k));
+        if (degenerate) {
+            points.push_back(Point<T>(4 * k + double(i % 3) - 1.0, -3 * k + double(i % 5) - 2.0));
+        } else {
+            points.push_back(Point<T>(double(i % 1000) * k / 100.0 - 5 * k, double(i * 7919 % 1000) * k / 100.0 - 5 * k));
+        }
+    }
+    return points;
+}
+
+static void BM_Orient2d(benchmark::State &state) {
+    const std::size_t n = 1 << 16;
+    const std::vector<Point<T> > p = makeTriangles(n, state.range(0) != 0);
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        hits += orient2dFilter(p[3 * i], p[3 * i + 1], p[3 * i + 2]);
+    }
+    for (auto _ : state) {
+        double s = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            s += orient2d(p[3 * i], p[3 * i + 1], p[3 * i + 2]);
+        }
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["filter_hit_rate"] = double(hits) / double(n);
+}
+
+static void BM_Incircle(benchmark::State &state) {
+    const std::size_t n = 1 << 16;
+    const std::vector<Point<T> > p = makeQuadruples(n, state.range(0) != 0);
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        hits += incircleFilter(p[4 * i], p[4 * i + 1], p[4 * i + 2], p[4 * i + 3]);
+    }
+    for (auto _ : state) {
+        double s = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            s += incircle(p[4 * i], p[4 * i + 1], p[4 * i + 2], p[4 * i + 3]);
+        }
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["filter_hit_rate"] = double(hits) / double(n);
+}
+
+// Argument 0 is random input, 1 is degenerate input
+BENCHMARK(BM_Orient2d)->Arg(0)->Arg(1);
+BENCHMARK(BM_Incircle)->Arg(0)->Arg(1);
@@ -0,0 +1,86 @@
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include "../main/PackedPoint.h"
+#include "../main/RingBuffer.h"
+
+using namespace graph_algo;
+
+typedef PackedPoint<double> P;
+
+static const int kItems = 1 << 20;
+static const std::size_t kBatch = 64;
+
+/*
+ * The mutex protected deque that the ring buffers replace
+ */
+class LockedDeque {
+public:
+    std::size_t tryPushBatch(const P *items, std::size_t n) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mItems.insert(mItems.end(), items, items + n);
+        return n;
+    }
+
+    std::size_t tryPopBatch(P *out, std::size_t n) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (n > mItems.size()) n = mItems.size();
+        std::copy(mItems.begin(), mItems.begin() + n, out);
+        mItems.erase(mItems.begin(), mItems.begin() + n);
+        return n;
+    }
+
+private:
+    std::mutex mMutex;
+    std::deque<P> mItems;
+};
+
+/*
+ * One producer streams kItems points in batches of `batch` to one consumer
+ */
+template<class Queue>
+static void stream(benchmark::State &state) {
+    const std::size_t batch = std::size_t(state.range(0));
+    for (auto _ : state) {
+        Queue *queue = new Queue();
+        std::thread producer([queue, batch]() {
+            P items[kBatch];
+            for (std::size_t i = 0; i < kBatch; ++i) items[i] = P(double(i), -double(i));
+            for (int sent = 0; sent < kItems;) {
+                const std::size_t n = queue->tryPushBatch(items, std::min<std::size_t>(batch, kItems - sent));
+                if (n == 0) std::this_thread::yield();
+                sent += int(n);
+            }
+        });
+        P out[kBatch];
+        double sum = 0.0;
+        for (int received = 0; received < kItems;) {
+            const std::size_t n = queue->tryPopBatch(out, batch);
+            if (n == 0) std::this_thread::yield();
+            for (std::size_t i = 0; i < n; ++i) sum += out[i].getX();
+            received += int(n);
+        }
+        producer.join();
+        benchmark::DoNotOptimize(sum);
+        delete queue;
+    }
+    state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+static void BM_Stream_LockedDeque(benchmark::State &state) {
+    stream<LockedDeque>(state);
+}
+
+static void BM_Stream_Spsc(benchmark::State &state) {
+    stream<SpscRingBuffer<P, 4096> >(state);
+}
+
+static void BM_Stream_Mpmc(benchmark::State &state) {
+    stream<MpmcRingBuffer<P, 4096> >(state);
+}
+
+// Argument is the batch size
+BENCHMARK(BM_Stream_LockedDeque)->Arg(1)->Arg(kBatch)->UseRealTime();
+BENCHMARK(BM_Stream_Spsc)->Arg(1)->Arg(kBatch)->UseRealTime();
+BENCHMARK(BM_Stream_Mpmc)->Arg(1)->Arg(kBatch)->UseRealTime();
@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/RingIndex.h"
+
+using namespace graph_algo;
+
+/*
+ * The RingIndex arithmetic as it was before the conditional subtract and mask paths
+ */
+class LegacyRingIndex {
+public:
+    LegacyRingIndex(int v, int ringSize) : mIndex(v), mSize(ringSize) {}
+
+    int operator+(int v) const {
+        int t = mIndex + v;
+        if (t >= mSize)
+            t = t % mSize;
+        return t;
+    }
+
+    int operator-(const int v) const {
+        if (mIndex - v < 0) {
+            return mSize - (std::abs(mIndex - v) % mSize);
+        }
+        return mIndex - v;
+    }
+
+    int operator++() {
+        if (mIndex >= mSize - 1) { mIndex = 0; }
+        else { ++mIndex; }
+        return mIndex;
+    }
+
+    operator int() const { return mIndex; }
+
+private:
+    int mIndex;
+    int mSize;
+};
+
+static const int kRing = 1024;
+static const int kSteps = 1 << 20;
+
+/*
+ * Walks a ring, reading the neighbours on both sides of every vertex
+ */
+template<class Index>
+static void walk(benchmark::State &state, Index index) {
+    std::vector<int> values(kRing);
+    for (int i = 0; i < kRing; ++i) values[i] = i;
+    for (auto _ : state) {
+        long sum = 0;
+        for (int i = 0; i < kSteps; ++i) {
+            sum += values[index + 1] - values[index - 1];
+            ++index;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kSteps);
+}
+
+static void BM_RingWalk_Legacy(benchmark::State &state) {
+    walk(state, LegacyRingIndex(0, kRing));
+}
+
+static void BM_RingWalk_Dynamic(benchmark::State &state) {
+    walk(state, RingIndex<>(0, kRing));
+}
+
+static void BM_RingWalk_Fixed(benchmark::State &state) {
+    walk(state, RingIndex<int, kRing - 1>());
+}
+
+static void BM_RingWalk_FixedPowerOfTwo(benchmark::State &state) {
+    walk(state, RingIndex<int, kRing>());
+}
+
+/*
+ * Jumps by offsets of up to the ring size in both directions, the wrap arithmetic of operator+ and operator-
+ */
+template<class Index>
+static void jump(benchmark::State &state, Index index, int ringSize) {
+    std::vector<int> offsets(kRing);
+    for (int i = 0; i < kRing; ++i) offsets[i] = (i * 7919) % ringSize;
+    for (auto _ : state) {
+        long sum = 0;
+        for (int i = 0; i < kSteps; ++i) {
+            const int offset = offsets[i & (kRing - 1)];
+            sum += (index + offset) - (index - offset);
+            ++index;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kSteps);
+}
+
+static void BM_RingJump_Legacy(benchmark::State &state) {
+    jump(state, LegacyRingIndex(0, int(state.range(0))), int(state.range(0)));
+}
+
+static void BM_RingJump_Dynamic(benchmark::State &state) {
+    jump(state, RingIndex<>(0, int(state.range(0))), int(state.range(0)));
+}
+
+static void BM_RingJump_Fixed(benchmark::State &state) {
+    jump(state, RingIndex<int, kRing - 1>(), kRing - 1);
+}
+
+static void BM_RingJump_FixedPowerOfTwo(benchmark::State &state) {
+    jump(state, RingIndex<int, kRing>(), kRing);
+}
+
+BENCHMARK(BM_RingWalk_Legacy);
+BENCHMARK(BM_RingWalk_Dynamic);
+BENCHMARK(BM_RingWalk_Fixed);
+BENCHMARK(BM_RingWalk_FixedPowerOfTwo);
+BENCHMARK(BM_RingJump_Legacy)->Arg(3)->Arg(kRing - 1)->Arg(1 << 20);
+BENCHMARK(BM_RingJump_Dynamic)->Arg(3)->Arg(kRing - 1)->Arg(1 << 20);
+BENCHMARK(BM_RingJump_Fixed);
+BENCHMARK(BM_RingJump_FixedPowerOfTwo);
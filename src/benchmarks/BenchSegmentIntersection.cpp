@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <benchmark/benchmark.h>
+#include "../main/SegmentIntersection.h"
+
+using namespace graph_algo;
+
+/*
+ * n short segments of a network over a square that grows with n
+ */
+static PointBuffer<double> makeSegments(std::size_t n) {
+    std::mt19937 gen(1);
+    const double side = std::sqrt(double(n));
+    std::uniform_real_distribution<double> coordinate(0.0, side), offset(-1.0, 1.0);
+    PointBuffer<double> endpoints;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double x = coordinate(gen), y = coordinate(gen);
+        endpoints.push_back(x, y);
+        endpoints.push_back(x + offset(gen), y + offset(gen));
+    }
+    return endpoints;
+}
+
+/*
+ * Every pair, with a bounding box test before the orientations
+ */
+static void BM_SegmentIntersection_Pairwise(benchmark::State &state) {
+    const PointBuffer<double> endpoints = makeSegments(std::size_t(state.range(0)));
+    const std::size_t n = endpoints.size() / 2;
+    for (auto _ : state) {
+        std::size_t found = 0;
+        for (std::size_t a = 0; a < n; ++a) {
+            const PackedPoint<double> a0 = endpoints[2 * a], a1 = endpoints[2 * a + 1];
+            for (std::size_t b = a + 1; b < n; ++b) {
+                const PackedPoint<double> b0 = endpoints[2 * b], b1 = endpoints[2 * b + 1];
+                if (std::max(a0.getX(), a1.getX()) < std::min(b0.getX(), b1.getX()) ||
+                    std::max(b0.getX(), b1.getX()) < std::min(a0.getX(), a1.getX()) ||
+                    std::max(a0.getY(), a1.getY()) < std::min(b0.getY(), b1.getY()) ||
+                    std::max(b0.getY(), b1.getY()) < std::min(a0.getY(), a1.getY())) {
+                    continue;
+                }
+                const double o1 = orient2d(a0, a1, b0), o2 = orient2d(a0, a1, b1);
+                const double o3 = orient2d(b0, b1, a0), o4 = orient2d(b0, b1, a1);
+                found += (o1 > 0.0) != (o2 > 0.0) && (o3 > 0.0) != (o4 > 0.0);
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SegmentIntersection_Sweep(benchmark::State &state) {
+    const PointBuffer<double> endpoints = makeSegments(std::size_t(state.range(0)));
+    SegmentIntersector<double> intersector;
+    std::atomic<std::size_t> found(0);
+    for (auto _ : state) {
+        intersector.forEachIntersection(endpoints, [&found](std::uint32_t, std::uint32_t) {
+            found.fetch_add(1, std::memory_order_relaxed);
+        }, unsigned(state.range(1)));
+    }
+    benchmark::DoNotOptimize(found.load());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SegmentIntersection_Pairwise)->Arg(1 << 12)->Arg(1 << 14)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SegmentIntersection_Sweep)->Args({1 << 12, 1})->Args({1 << 14, 1})->Args({1 << 20, 1})
+        ->Args({1 << 20, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/ShortestPath.h"
+
+using namespace graph_algo;
+
+typedef CsrGraph<std::uint32_t, float> Graph;
+
+/*
+ * A road network like grid of side x side vertices, edge weights are their length times 1 to 2
+ */
+static const Graph &roadGrid() {
+    static Graph graph;
+    if (graph.vertexCount() == 0) {
+        const std::uint32_t side = 1000;
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> stretch(1.0f, 2.0f);
+        GraphBuilder<std::uint32_t, float> builder(side * side);
+        PointBuffer<double> points;
+        for (std::uint32_t y = 0; y < side; ++y) {
+            for (std::uint32_t x = 0; x < side; ++x) {
+                points.push_back(double(x), double(y));
+                const std::uint32_t v = y * side + x;
+                if (x + 1 < side) builder.addUndirectedEdge(v, v + 1, stretch(gen));
+                if (y + 1 < side) builder.addUndirectedEdge(v, v + side, stretch(gen));
+            }
+        }
+        builder.setCoordinates(points);
+        graph = builder.build();
+    }
+    return graph;
+}
+
+static void BM_Sssp_PriorityQueue(benchmark::State &state) {
+    const Graph &graph = roadGrid();
+    typedef std::pair<float, std::uint32_t> Item;
+    for (auto _ : state) {
+        std::vector<float> distances(graph.vertexCount(), INFINITY);
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item> > queue;
+        distances[0] = 0.0f;
+        queue.push(Item(0.0f, 0));
+        while (!queue.empty()) {
+            const Item item = queue.top();
+            queue.pop();
+            if (item.first > distances[item.second]) continue;
+            for (std::uint32_t e = graph.edgeBegin(item.second); e < graph.edgeEnd(item.second); ++e) {
+                const float d = item.first + graph.weight(e);
+                if (d < distances[graph.target(e)]) {
+                    distances[graph.target(e)] = d;
+                    queue.push(Item(d, graph.target(e)));
+                }
+            }
+        }
+        benchmark::DoNotOptimize(distances.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+static void BM_Sssp_Dijkstra(benchmark::State &state) {
+    const Graph &graph = roadGrid();
+    ShortestPathSearch<std::uint32_t, float, double> search(graph);
+    for (auto _ : state) {
+        search.dijkstra(0);
+        benchmark::DoNotOptimize(search.distance(graph.vertexCount() - 1));
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+static void BM_Sssp_DeltaStepping(benchmark::State &state) {
+    const Graph &graph = roadGrid();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deltaStepping(graph, 0u, 0.0f, unsigned(state.range(0))).distance(1));
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edgeCount());
+}
+
+/*
+ * Random point to point queries, stopping at the target
+ */
+static void BM_Query_Dijkstra(benchmark::State &state) {
+    const Graph &graph = roadGrid();
+    ShortestPathSearch<std::uint32_t, float, double> search(graph);
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, graph.vertexCount() - 1);
+    for (auto _ : state) {
+        // A* with scale 0 is Dijkstra stopped at the target
+        benchmark::DoNotOptimize(search.astar(vertex(gen), vertex(gen), 0.0));
+    }
+}
+
+static void BM_Query_AStar(benchmark::State &state) {
+    const Graph &graph = roadGrid();
+    ShortestPathSearch<std::uint32_t, float, double> search(graph);
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, graph.vertexCount() - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search.astar(vertex(gen), vertex(gen)));
+    }
+}
+
+BENCHMARK(BM_Sssp_PriorityQueue)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Sssp_Dijkstra)->Unit(benchmark::kMillisecond);
+// Argument is the number of threads
+BENCHMARK(BM_Sssp_DeltaStepping)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Query_Dijkstra)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Query_AStar)->Unit(benchmark::kMillisecond);
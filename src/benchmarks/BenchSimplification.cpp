@@ -0,0 +1,70 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/PackedPoint.h"
+#include "../main/Simplification.h"
+
+using namespace graph_algo;
+
+typedef PackedPoint<double> P;
+
+/*
+ * A GPS-like track: a random walk of about one metre per fix with a little jitter
+ */
+static std::vector<P> makeTrack(std::size_t n) {
+    std::mt19937 gen(1);
+    std::normal_distribution<double> turn(0.0, 0.05), jitter(0.0, 0.2);
+    std::vector<P> track;
+    double x = 0.0, y = 0.0, heading = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        track.push_back(P(x + jitter(gen), y + jitter(gen)));
+        heading += turn(gen);
+        x += std::cos(heading);
+        y += std::sin(heading);
+    }
+    return track;
+}
+
+static void BM_Simplification_DouglasPeucker(benchmark::State &state) {
+    const std::vector<P> track = makeTrack(std::size_t(state.range(0)));
+    PolylineSimplifier simplifier;
+    std::size_t kept = 0;
+    for (auto _ : state) {
+        kept = simplifier.douglasPeucker(track, 1.0).size();
+        benchmark::DoNotOptimize(kept);
+    }
+    state.counters["ratio"] = double(track.size()) / double(kept);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Simplification_Visvalingam(benchmark::State &state) {
+    const std::vector<P> track = makeTrack(std::size_t(state.range(0)));
+    PolylineSimplifier simplifier;
+    std::size_t kept = 0;
+    for (auto _ : state) {
+        kept = simplifier.visvalingam(track, 1.0).size();
+        benchmark::DoNotOptimize(kept);
+    }
+    state.counters["ratio"] = double(track.size()) / double(kept);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Simplification_RadialStream(benchmark::State &state) {
+    const std::vector<P> track = makeTrack(std::size_t(state.range(0)));
+    RadialDistanceStream<P> stream(5.0);
+    std::size_t kept = 0;
+    const auto emit = [&kept](const P &) { ++kept; };
+    for (auto _ : state) {
+        kept = 0;
+        for (const P &p : track) stream.push(p, emit);
+        stream.finish(emit);
+        benchmark::DoNotOptimize(kept);
+    }
+    state.counters["ratio"] = double(track.size()) / double(kept);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Simplification_DouglasPeucker)->Arg(1 << 12)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Simplification_Visvalingam)->Arg(1 << 12)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Simplification_RadialStream)->Arg(1 << 12)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
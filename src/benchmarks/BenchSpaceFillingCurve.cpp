@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/SpaceFillingCurve.h"
+#include "../main/Delaunay.h"
+#include "../main/ShortestPath.h"
+
+using namespace graph_algo;
+
+static PointBuffer<double> randomPoints(std::size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    PointBuffer<double> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+    return points;
+}
+
+static void BM_Curve_MortonPortable(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    const CurveGrid<double> grid(points);
+    std::vector<std::uint64_t> keys(points.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const std::uint32_t x = grid.column(points.xs()[i]), y = grid.row(points.ys()[i]);
+            keys[i] = detail::spreadBits(x) | detail::spreadBits(y) << 1;
+        }
+        benchmark::DoNotOptimize(keys.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Runs the BMI2 kernel where the CPU has it
+static void BM_Curve_MortonKeys(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    const CurveGrid<double> grid(points);
+    std::vector<std::uint64_t> keys(points.size());
+    for (auto _ : state) {
+        curveKeys<MortonCurve>(points, grid, keys.data());
+        benchmark::DoNotOptimize(keys.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Curve_HilbertKeys(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    const CurveGrid<double> grid(points);
+    std::vector<std::uint64_t> keys(points.size());
+    for (auto _ : state) {
+        curveKeys<HilbertCurve>(points, grid, keys.data());
+        benchmark::DoNotOptimize(keys.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Curve_HilbertOrder(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(curveOrder<HilbertCurve>(points, unsigned(state.range(1))).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same keys through std::sort, for comparison with the radix sort in curveOrder
+static void BM_Curve_HilbertOrderStdSort(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    const CurveGrid<double> grid(points);
+    std::vector<std::uint64_t> keys(points.size());
+    std::vector<std::pair<std::uint64_t, std::uint32_t> > sorted(points.size());
+    for (auto _ : state) {
+        curveKeys<HilbertCurve>(points, grid, keys.data());
+        for (std::size_t i = 0; i < points.size(); ++i) sorted[i] = std::make_pair(keys[i], std::uint32_t(i));
+        std::sort(sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/*
+ * Dijkstra over the Delaunay graph of random points, with vertex ids in random order (range(1) == 0)
+ * or renumbered along the Hilbert curve (range(1) == 1)
+ */
+static void BM_Curve_DijkstraLocality(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    const CsrGraph<std::uint32_t, double, double> shuffled = DelaunayTriangulation(points).delaunayGraph();
+    const CsrGraph<std::uint32_t, double, double> graph =
+            state.range(1) ? permuteVertices(shuffled, curveOrder<HilbertCurve>(shuffled.coordinates())) : shuffled;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dijkstra(graph, std::uint32_t(0)).source());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Curve_MortonPortable)->Arg(1 << 20);
+BENCHMARK(BM_Curve_MortonKeys)->Arg(1 << 20);
+BENCHMARK(BM_Curve_HilbertKeys)->Arg(1 << 20);
+BENCHMARK(BM_Curve_HilbertOrder)->Args({1 << 20, 1})->Args({1 << 20, 4})->Args({10000000, 1})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Curve_HilbertOrderStdSort)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Curve_DijkstraLocality)->Args({1000000, 0})->Args({1000000, 1})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../main/SpatialHash.h"
+
+using namespace graph_algo;
+
+// A million points at the density of about one per unit square
+static const double WORLD = 1000.0;
+
+static PointBuffer<double> randomPoints(std::size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coordinate(0.0, WORLD);
+    PointBuffer<double> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+    return points;
+}
+
+/*
+ * Every point takes a small step, as in one tick of a simulation
+ */
+static void step(PointBuffer<double> &points, std::mt19937 &gen) {
+    std::uniform_real_distribution<double> delta(-0.05, 0.05);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points.xs()[i] += delta(gen);
+        points.ys()[i] += delta(gen);
+    }
+}
+
+static void BM_SpatialHash_Rebuild(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    SpatialHash<double> grid(1.0);
+    for (auto _ : state) {
+        grid.rebuild(points, unsigned(state.range(1)));
+        benchmark::DoNotOptimize(grid.cellCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SpatialHash_Move(benchmark::State &state) {
+    PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    SpatialHash<double> grid(1.0);
+    grid.rebuild(points);
+    std::mt19937 gen(2);
+    std::uint32_t i = 0;
+    std::uniform_real_distribution<double> delta(-0.05, 0.05);
+    for (auto _ : state) {
+        points.xs()[i] += delta(gen);
+        points.ys()[i] += delta(gen);
+        grid.move(i, points.xs()[i], points.ys()[i]);
+        i = (i + 1) % std::uint32_t(points.size());
+    }
+}
+
+static void BM_SpatialHash_InsertRemove(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    SpatialHash<double> grid(1.0);
+    grid.rebuild(points);
+    std::uint32_t i = 0;
+    for (auto _ : state) {
+        grid.remove(i);
+        grid.insert(i, points.xs()[i], points.ys()[i]);
+        i = (i + 1) % std::uint32_t(points.size());
+    }
+}
+
+static void BM_SpatialHash_MoveAll(benchmark::State &state) {
+    PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    SpatialHash<double> grid(1.0);
+    grid.rebuild(points);
+    std::mt19937 gen(2);
+    for (auto _ : state) {
+        state.PauseTiming();
+        step(points, gen);
+        state.ResumeTiming();
+        grid.moveAll(points, unsigned(state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SpatialHash_Radius(benchmark::State &state) {
+    const PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    SpatialHash<double> grid(1.0);
+    grid.rebuild(points);
+    const PointBuffer<double> queries = randomPoints(1 << 16, 2);
+    std::vector<std::uint32_t> out;
+    std::size_t q = 0;
+    for (auto _ : state) {
+        out.clear();
+        benchmark::DoNotOptimize(grid.radius(queries[q], 1.0, out));
+        q = (q + 1) & (queries.size() - 1);
+    }
+}
+
+// One 60 Hz tick of a proximity join: move every point, then find all pairs within distance 1
+static void BM_SpatialHash_Tick(benchmark::State &state) {
+    PointBuffer<double> points = randomPoints(std::size_t(state.range(0)), 1);
+    SpatialHash<double> grid(1.0);
+    grid.rebuild(points);
+    std::mt19937 gen(2);
+    for (auto _ : state) {
+        state.PauseTiming();
+        step(points, gen);
+        state.ResumeTiming();
+        grid.moveAll(points, unsigned(state.range(1)));
+        benchmark::DoNotOptimize(grid.pairsWithin(1.0, unsigned(state.range(1))).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SpatialHash_Rebuild)->Args({1000000, 1})->Args({1000000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_SpatialHash_Move)->Arg(1000000);
+BENCHMARK(BM_SpatialHash_InsertRemove)->Arg(1000000);
+BENCHMARK(BM_SpatialHash_MoveAll)->Args({1000000, 1})->Args({1000000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_SpatialHash_Radius)->Arg(1000000);
+BENCHMARK(BM_SpatialHash_Tick)->Args({1000000, 1})->Args({1000000, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
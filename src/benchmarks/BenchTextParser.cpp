@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "../main/TextParser.h"
+
+using namespace graph_algo;
+
+/*
+ * About 64 MB of "x,y" lines, printed with the given format
+ */
+static std::string pointText(const char *format) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> coordinate(-1000.0, 1000.0);
+    std::string text = "x,y\n";
+    char line[96];
+    while (text.size() < (std::size_t(64) << 20)) {
+        const double x = coordinate(gen), y = coordinate(gen);
+        text.append(line, std::size_t(std::snprintf(line, sizeof(line), format, x, y)));
+    }
+    return text;
+}
+
+static std::string edgeText() {
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, 9999999);
+    std::uniform_real_distribution<double> weight(0.0, 100.0);
+    std::string text;
+    char line[96];
+    while (text.size() < (std::size_t(64) << 20)) {
+        text.append(line, std::size_t(std::snprintf(line, sizeof(line), "%u %u %.3f\n", vertex(gen), vertex(gen),
+                                                     weight(gen))));
+    }
+    return text;
+}
+
+static void BM_TextParser_Points(benchmark::State &state) {
+    const std::string text = pointText(state.range(0) ? "%.17g,%.17g\n" : "%.6f,%.6f\n");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parsePoints<double>(text.data(), text.data() + text.size(),
+                                                     unsigned(state.range(1))).xs());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(text.size()));
+}
+
+// The same text through std::strtod, one number after the other
+static void BM_TextParser_PointsStrtod(benchmark::State &state) {
+    const std::string text = pointText(state.range(0) ? "%.17g,%.17g\n" : "%.6f,%.6f\n");
+    for (auto _ : state) {
+        PointBuffer<double> points;
+        const char *p = text.c_str() + 4;
+        char *end;
+        while (*p) {
+            const double x = std::strtod(p, &end);
+            const double y = std::strtod(end + 1, &end);
+            points.push_back(x, y);
+            p = end + 1;
+        }
+        benchmark::DoNotOptimize(points.xs());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(text.size()));
+}
+
+static void BM_TextParser_PointsStream(benchmark::State &state) {
+    const std::string text = pointText("%.6f,%.6f\n");
+    for (auto _ : state) {
+        std::istringstream in(text.substr(4));
+        PointBuffer<double> points;
+        double x, y;
+        char comma;
+        while (in >> x >> comma >> y) points.push_back(x, y);
+        benchmark::DoNotOptimize(points.xs());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(text.size()));
+}
+
+static void BM_TextParser_Edges(benchmark::State &state) {
+    const std::string text = edgeText();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseEdges(text.data(), text.data() + text.size(),
+                                            unsigned(state.range(0))).edgeCount());
+    }
+    state.SetBytesProcessed(state.iterations() * std::int64_t(text.size()));
+}
+
+BENCHMARK(BM_TextParser_Points)->Args({0, 1})->Args({0, 4})->Args({1, 1})->Args({1, 4})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_TextParser_PointsStrtod)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TextParser_PointsStream)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TextParser_Edges)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,102 @@
+#ifndef ALIGNEDALLOCATOR_H_
+#define ALIGNEDALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+/**
+ * A std::allocator replacement that hands out memory aligned to Alignment
+ * bytes (a cache line by default), so that SIMD kernels can run on whole
+ * vectors from the first element.
+ *
+ * By default the memory comes from the heap. An allocator constructed with a
+ * std::pmr::memory_resource, such as a MonotonicArena or FixedPool from MemoryArena.h,
+ * takes it from that resource instead. Like std::pmr::polymorphic_allocator it is not
+ * passed on when a container is copied: the copy goes back to the heap, so that it
+ * can outlive the resource.
+ */
+
+namespace graph_algo {
+
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    template<class T, std::size_t Alignment = CACHE_LINE_SIZE>
+    class AlignedAllocator {
+    public:
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template<class U>
+        struct rebind {
+            typedef AlignedAllocator<U, Alignment> other;
+        };
+
+        AlignedAllocator() : mResource(nullptr) {}
+
+        /**
+         * Constructor, takes memory from resource, or from the heap if resource is null
+         */
+        AlignedAllocator(std::pmr::memory_resource *resource) : mResource(resource) {}
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &other) : mResource(other.resource()) {}
+
+        AlignedAllocator select_on_container_copy_construction() const {
+            return AlignedAllocator();
+        }
+
+        std::pmr::memory_resource *resource() const { return mResource; }
+
+        T *allocate(std::size_t n) {
+            if (n == 0) return nullptr;
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc();
+            if (mResource != nullptr) return static_cast<T *>(mResource->allocate(n * sizeof(T), ALIGNMENT));
+            void *p = nullptr;
+#if defined(_WIN32)
+            p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+            if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0) p = nullptr;
+#endif
+            if (p == nullptr) throw std::bad_alloc();
+            return static_cast<T *>(p);
+        }
+
+        void deallocate(T *p, std::size_t n) {
+            if (mResource != nullptr) {
+                mResource->deallocate(p, n * sizeof(T), ALIGNMENT);
+                return;
+            }
+#if defined(_WIN32)
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+
+        template<class U>
+        bool operator==(const AlignedAllocator<U, Alignment> &other) const {
+            return mResource == other.resource() ||
+                   (mResource != nullptr && other.resource() != nullptr && mResource->is_equal(*other.resource()));
+        }
+
+        template<class U>
+        bool operator!=(const AlignedAllocator<U, Alignment> &other) const { return !operator==(other); }
+
+    private:
+        static constexpr std::size_t ALIGNMENT = Alignment > alignof(T) ? Alignment : alignof(T);
+
+        std::pmr::memory_resource *mResource;
+    };
+
+};// namespace graph_algo
+
+
+#endif /* ALIGNEDALLOCATOR_H_ */
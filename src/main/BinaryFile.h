@@ -0,0 +1,934 @@
+#ifndef BINARYFILE_H_
+#define BINARYFILE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+#include "Polygon.h"
+
+/**
+ * A versioned binary file format for point clouds, polygons and graphs that is read by memory
+ * mapping the file read only. Opening a file checks its header and section table and nothing
+ * else; the coordinates are then read straight from the page cache, without parsing and without
+ * copying them into points.
+ *
+ * The layout, all integers and floats little endian:
+ * - a 64 byte BinaryFileHeader: the magic "GALGOBIN", the format version, a byte order mark,
+ *   the kind of data, the number of sections, the file size and the number of items (points,
+ *   polygons or vertices),
+ * - the section table, one 48 byte BinarySectionHeader per section: its tag, element type,
+ *   offset, element count, a parameter and a checksum of its bytes,
+ * - the sections, plain arrays that start at multiples of BINARY_FILE_ALIGNMENT bytes, so that
+ *   they can go through the SIMD kernels like the arrays of PointBuffer.
+ *
+ * Coordinates are stored as two arrays, SECTION_XS and SECTION_YS. A point cloud may carry a
+ * chunk index, the bounding box of every run of `param` points, which lets a reader skip whole
+ * chunks; points written in curveSort order (SpaceFillingCurve.h) give tight boxes. Polygons
+ * share one vertex array, SECTION_RINGS holds the first vertex of every polygon followed by the
+ * number of vertices. Graphs store the arrays of CsrGraph.
+ *
+ * writePoints, writePolygons and writeGraph write a file, MappedPoints, MappedPolygons and
+ * MappedGraph map one. validateBinaryFile checks what opening a file does not: the checksums
+ * and the contents of the sections, e.g. that every edge ends at a vertex.
+ */
+
+namespace graph_algo {
+
+    struct BinaryFileIOException : public std::exception {
+        const char *what() const throw() {
+            return "The file could not be opened, mapped or written.";
+        }
+
+    };
+
+    struct BinaryFileFormatException : public std::exception {
+        const char *what() const throw() {
+            return "The file is not a little endian binary file of a supported version, or it is damaged.";
+        }
+
+    };
+
+    struct BinaryFileTypeException : public std::exception {
+        const char *what() const throw() {
+            return "The file holds another kind of data or other element types than requested.";
+        }
+
+    };
+
+    static const std::uint32_t BINARY_FILE_VERSION = 1;
+
+    static const std::size_t BINARY_FILE_ALIGNMENT = CACHE_LINE_SIZE;
+
+    enum BinaryFileKind {
+        BINARY_POINTS = 1, BINARY_POLYGONS = 2, BINARY_GRAPH = 3
+    };
+
+    enum BinarySection {
+        SECTION_XS = 1, SECTION_YS = 2, SECTION_CHUNKS = 3, SECTION_RINGS = 4, SECTION_OFFSETS = 5,
+        SECTION_TARGETS = 6, SECTION_WEIGHTS = 7, SECTION_IN_OFFSETS = 8, SECTION_IN_SOURCES = 9,
+        SECTION_IN_EDGES = 10
+    };
+
+    enum BinaryType {
+        BINARY_UINT32 = 1, BINARY_UINT64 = 2, BINARY_INT32 = 3, BINARY_INT64 = 4, BINARY_FLOAT = 5,
+        BINARY_DOUBLE = 6
+    };
+
+    struct BinaryFileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t kind;
+        std::uint32_t sectionCount;
+        std::uint64_t fileSize;
+        std::uint64_t itemCount;
+        std::uint64_t reserved[3];
+    };
+
+    struct BinarySectionHeader {
+        std::uint32_t tag;
+        std::uint32_t type;
+        std::uint64_t offset;
+        std::uint64_t count;
+        std::uint64_t param;
+        std::uint64_t checksum;
+        std::uint64_t reserved;
+    };
+
+    static_assert(sizeof(BinaryFileHeader) == 64 && sizeof(BinarySectionHeader) == 48,
+                  "the file and section headers must not be padded");
+
+    /**
+     * The bounding box of the points [first, last) of a point cloud
+     */
+    struct BinaryChunk {
+        std::size_t first, last;
+        double minX, minY, maxX, maxY;
+    };
+
+    namespace detail {
+
+        static const char BINARY_MAGIC[8] = {'G', 'A', 'L', 'G', 'O', 'B', 'I', 'N'};
+
+        static const std::uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+        template<class T>
+        struct BinaryTypeOf;
+
+        template<>
+        struct BinaryTypeOf<std::uint32_t> {
+            static const std::uint32_t value = BINARY_UINT32;
+        };
+
+        template<>
+        struct BinaryTypeOf<std::uint64_t> {
+            static const std::uint32_t value = BINARY_UINT64;
+        };
+
+        template<>
+        struct BinaryTypeOf<std::int32_t> {
+            static const std::uint32_t value = BINARY_INT32;
+        };
+
+        template<>
+        struct BinaryTypeOf<std::int64_t> {
+            static const std::uint32_t value = BINARY_INT64;
+        };
+
+        template<>
+        struct BinaryTypeOf<float> {
+            static const std::uint32_t value = BINARY_FLOAT;
+        };
+
+        template<>
+        struct BinaryTypeOf<double> {
+            static const std::uint32_t value = BINARY_DOUBLE;
+        };
+
+        /*
+         * The size of an element of type, 0 for unknown types
+         */
+        inline std::size_t binaryTypeSize(std::uint32_t type) {
+            switch (type) {
+                case BINARY_UINT32:
+                case BINARY_INT32:
+                case BINARY_FLOAT:
+                    return 4;
+                case BINARY_UINT64:
+                case BINARY_INT64:
+                case BINARY_DOUBLE:
+                    return 8;
+                default:
+                    return 0;
+            }
+        }
+
+        inline bool littleEndian() {
+            const std::uint32_t one = 1;
+            unsigned char first;
+            std::memcpy(&first, &one, 1);
+            return first == 1;
+        }
+
+        inline std::uint64_t alignUp(std::uint64_t n) {
+            return (n + BINARY_FILE_ALIGNMENT - 1) / BINARY_FILE_ALIGNMENT * BINARY_FILE_ALIGNMENT;
+        }
+
+        /*
+         * FNV-1a over 8 byte words instead of bytes, the last word padded with zeros
+         */
+        inline std::uint64_t checksum(const void *data, std::size_t bytes) {
+            const unsigned char *p = static_cast<const unsigned char *>(data);
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            std::size_t i = 0;
+            for (; i + 8 <= bytes; i += 8) {
+                std::uint64_t word;
+                std::memcpy(&word, p + i, 8);
+                h = (h ^ word) * 0x100000001b3ull;
+            }
+            if (i < bytes) {
+                std::uint64_t word = 0;
+                std::memcpy(&word, p + i, bytes - i);
+                h = (h ^ word) * 0x100000001b3ull;
+            }
+            return h;
+        }
+
+        /*
+         * Collects the sections of a file and writes them behind the header and the section table
+         */
+        class BinaryWriter {
+        public:
+            BinaryWriter(std::uint32_t kind, std::uint64_t items) : mKind(kind), mItems(items) {}
+
+            template<class T>
+            void add(std::uint32_t tag, const T *data, std::size_t count, std::uint64_t param = 0) {
+                BinarySectionHeader section = {tag, BinaryTypeOf<T>::value, 0, count, param,
+                                               checksum(data, count * sizeof(T)), 0};
+                mSections.push_back(section);
+                mData.push_back(data);
+            }
+
+            /*
+             * Throws BinaryFileIOException if the file cannot be written and BinaryFileFormatException
+             * on big endian machines
+             */
+            void write(const std::string &path) {
+                if (!littleEndian()) throw BinaryFileFormatException();
+                std::uint64_t end = alignUp(sizeof(BinaryFileHeader) + mSections.size() * sizeof(BinarySectionHeader));
+                for (std::size_t s = 0; s < mSections.size(); ++s) {
+                    mSections[s].offset = end;
+                    end = alignUp(end + mSections[s].count * binaryTypeSize(mSections[s].type));
+                }
+                BinaryFileHeader header;
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+                header.version = BINARY_FILE_VERSION;
+                header.byteOrder = BINARY_BYTE_ORDER;
+                header.kind = mKind;
+                header.sectionCount = std::uint32_t(mSections.size());
+                header.fileSize = end;
+                header.itemCount = mItems;
+
+                std::FILE *file = std::fopen(path.c_str(), "wb");
+                if (file == nullptr) throw BinaryFileIOException();
+                std::uint64_t position = 0;
+                bool ok = put(file, &header, sizeof(header), position);
+                ok = ok && (mSections.empty() ||
+                            put(file, mSections.data(), mSections.size() * sizeof(BinarySectionHeader), position));
+                for (std::size_t s = 0; s < mSections.size() && ok; ++s) {
+                    ok = pad(file, mSections[s].offset, position) &&
+                         put(file, mData[s], mSections[s].count * binaryTypeSize(mSections[s].type), position);
+                }
+                ok = ok && pad(file, end, position);
+                if (std::fclose(file) != 0 || !ok) throw BinaryFileIOException();
+            }
+
+        private:
+            static bool put(std::FILE *file, const void *data, std::size_t bytes, std::uint64_t &position) {
+                position += bytes;
+                return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+            }
+
+            static bool pad(std::FILE *file, std::uint64_t to, std::uint64_t &position) {
+                static const char zeros[BINARY_FILE_ALIGNMENT] = {};
+                return put(file, zeros, std::size_t(to - position), position);
+            }
+
+            std::uint32_t mKind;
+            std::uint64_t mItems;
+            std::vector<BinarySectionHeader> mSections;
+            std::vector<const void *> mData;
+
+        }; // BinaryWriter class
+
+    }; // namespace detail
+
+    /**
+     * A file mapped read only into memory, unmapped on destruction
+     */
+    class MappedFile {
+    public:
+        MappedFile() : mData(nullptr), mSize(0) {}
+
+        /**
+         * Constructor, maps the whole file. Throws BinaryFileIOException if it cannot be opened or mapped.
+         */
+        explicit MappedFile(const std::string &path) : mData(nullptr), mSize(0) {
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) throw BinaryFileIOException();
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size)) {
+                CloseHandle(file);
+                throw BinaryFileIOException();
+            }
+            mSize = std::size_t(size.QuadPart);
+            if (mSize > 0) {
+                // The view keeps the mapping alive, so neither handle is needed afterwards
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping != nullptr) {
+                    mData = static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    CloseHandle(mapping);
+                }
+            }
+            CloseHandle(file);
+#else
+            const int file = ::open(path.c_str(), O_RDONLY);
+            if (file < 0) throw BinaryFileIOException();
+            struct stat status;
+            if (::fstat(file, &status) != 0) {
+                ::close(file);
+                throw BinaryFileIOException();
+            }
+            mSize = std::size_t(status.st_size);
+            if (mSize > 0) {
+                void *data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+                if (data != MAP_FAILED) mData = static_cast<const unsigned char *>(data);
+            }
+            ::close(file);
+#endif
+            if (mSize > 0 && mData == nullptr) throw BinaryFileIOException();
+        }
+
+        MappedFile(MappedFile &&other) : mData(other.mData), mSize(other.mSize) {
+            other.mData = nullptr;
+            other.mSize = 0;
+        }
+
+        MappedFile &operator=(MappedFile &&other) {
+            if (this != &other) {
+                unmap();
+                mData = other.mData;
+                mSize = other.mSize;
+                other.mData = nullptr;
+                other.mSize = 0;
+            }
+            return *this;
+        }
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile() { unmap(); }
+
+        const unsigned char *data() const { return mData; }
+
+        std::size_t size() const { return mSize; }
+
+    private:
+        void unmap() {
+            if (mData == nullptr) return;
+#if defined(_WIN32)
+            UnmapViewOfFile(mData);
+#else
+            ::munmap(const_cast<unsigned char *>(mData), mSize);
+#endif
+            mData = nullptr;
+        }
+
+        const unsigned char *mData;
+        std::size_t mSize;
+
+    }; // MappedFile class
+
+    /**
+     * A mapped binary file with a checked header and section table
+     */
+    class BinaryFile {
+    public:
+        /**
+         * Constructor, maps the file and checks its header and section table.
+         * Throws BinaryFileIOException if the file cannot be mapped and BinaryFileFormatException
+         * if it is not a binary file of this version or a section lies outside the file.
+         */
+        explicit BinaryFile(const std::string &path) : mFile(path) {
+            if (mFile.size() < sizeof(BinaryFileHeader)) throw BinaryFileFormatException();
+            std::memcpy(&mHeader, mFile.data(), sizeof(mHeader));
+            if (std::memcmp(mHeader.magic, detail::BINARY_MAGIC, sizeof(mHeader.magic)) != 0 ||
+                mHeader.byteOrder != detail::BINARY_BYTE_ORDER || mHeader.version != BINARY_FILE_VERSION ||
+                mHeader.kind < BINARY_POINTS || mHeader.kind > BINARY_GRAPH || mHeader.fileSize != mFile.size() ||
+                mHeader.sectionCount > (mFile.size() - sizeof(BinaryFileHeader)) / sizeof(BinarySectionHeader)) {
+                throw BinaryFileFormatException();
+            }
+            mSections.resize(mHeader.sectionCount);
+            if (!mSections.empty()) {
+                std::memcpy(mSections.data(), mFile.data() + sizeof(BinaryFileHeader),
+                            mSections.size() * sizeof(BinarySectionHeader));
+            }
+            const std::uint64_t tableEnd = sizeof(BinaryFileHeader) + mSections.size() * sizeof(BinarySectionHeader);
+            for (std::size_t s = 0; s < mSections.size(); ++s) {
+                const BinarySectionHeader &section = mSections[s];
+                const std::size_t size = detail::binaryTypeSize(section.type);
+                if (size == 0 || section.offset % BINARY_FILE_ALIGNMENT != 0 || section.offset < tableEnd ||
+                    section.offset > mFile.size() || section.count > (mFile.size() - section.offset) / size) {
+                    throw BinaryFileFormatException();
+                }
+                for (std::size_t t = 0; t < s; ++t) {
+                    if (mSections[t].tag == section.tag) throw BinaryFileFormatException();
+                }
+            }
+        }
+
+        const BinaryFileHeader &header() const { return mHeader; }
+
+        std::uint32_t kind() const { return mHeader.kind; }
+
+        std::uint64_t itemCount() const { return mHeader.itemCount; }
+
+        std::size_t size() const { return mFile.size(); }
+
+        const std::vector<BinarySectionHeader> &sections() const { return mSections; }
+
+        /**
+         * The section with tag, nullptr if the file has none
+         */
+        const BinarySectionHeader *section(std::uint32_t tag) const {
+            for (std::size_t s = 0; s < mSections.size(); ++s) {
+                if (mSections[s].tag == tag) return &mSections[s];
+            }
+            return nullptr;
+        }
+
+        bool hasSection(std::uint32_t tag) const { return section(tag) != nullptr; }
+
+        /**
+         * The bytes of a section
+         */
+        const void *data(const BinarySectionHeader &section) const {
+            return mFile.data() + section.offset;
+        }
+
+        /**
+         * The elements of the section with tag, an empty range if there is none.
+         * Throws BinaryFileTypeException if its elements are not of type T.
+         */
+        template<class T>
+        ArrayRange<T> array(std::uint32_t tag) const {
+            const BinarySectionHeader *s = section(tag);
+            if (s == nullptr) return ArrayRange<T>(nullptr, nullptr);
+            if (s->type != detail::BinaryTypeOf<T>::value) throw BinaryFileTypeException();
+            const T *first = static_cast<const T *>(data(*s));
+            return ArrayRange<T>(first, first + s->count);
+        }
+
+        /**
+         * The elements of the section with tag, which must be there with count elements of type T.
+         * Throws BinaryFileFormatException if it is not and BinaryFileTypeException on other types.
+         */
+        template<class T>
+        ArrayRange<T> array(std::uint32_t tag, std::uint64_t count) const {
+            if (!hasSection(tag) || section(tag)->count != count) throw BinaryFileFormatException();
+            return array<T>(tag);
+        }
+
+        /**
+         * Throws BinaryFileTypeException if the file holds another kind of data
+         */
+        void expectKind(std::uint32_t kind) const {
+            if (mHeader.kind != kind) throw BinaryFileTypeException();
+        }
+
+    private:
+        MappedFile mFile;
+        BinaryFileHeader mHeader;
+        std::vector<BinarySectionHeader> mSections;
+
+    }; // BinaryFile class
+
+    /**
+     * Writes a point cloud. With chunkSize > 0 the file gets a chunk index: the bounding box of
+     * every chunkSize points.
+     * Throws BinaryFileIOException if the file cannot be written.
+     */
+    template<class T>
+    void writePoints(const std::string &path, const PointBuffer<T> &points, std::size_t chunkSize = 0) {
+        detail::BinaryWriter writer(BINARY_POINTS, points.size());
+        writer.add(SECTION_XS, points.xs(), points.size());
+        writer.add(SECTION_YS, points.ys(), points.size());
+        std::vector<double> boxes;
+        if (chunkSize > 0) {
+            for (std::size_t first = 0; first < points.size(); first += chunkSize) {
+                const std::size_t last = std::min(points.size(), first + chunkSize);
+                double minX = points.xs()[first], minY = points.ys()[first], maxX = minX, maxY = minY;
+                for (std::size_t i = first + 1; i < last; ++i) {
+                    minX = std::min(minX, double(points.xs()[i]));
+                    minY = std::min(minY, double(points.ys()[i]));
+                    maxX = std::max(maxX, double(points.xs()[i]));
+                    maxY = std::max(maxY, double(points.ys()[i]));
+                }
+                boxes.push_back(minX);
+                boxes.push_back(minY);
+                boxes.push_back(maxX);
+                boxes.push_back(maxY);
+            }
+            writer.add(SECTION_CHUNKS, boxes.data(), boxes.size(), chunkSize);
+        }
+        writer.write(path);
+    }
+
+    /**
+     * Writes polygons, their vertices one after the other.
+     * Throws BinaryFileIOException if the file cannot be written.
+     */
+    template<class T>
+    void writePolygons(const std::string &path, const std::vector<Polygon<T> > &polygons) {
+        std::vector<std::uint64_t> rings(1, 0);
+        for (std::size_t p = 0; p < polygons.size(); ++p) rings.push_back(rings.back() + polygons[p].size());
+        PointBuffer<T> vertices;
+        vertices.resize(std::size_t(rings.back()));
+        for (std::size_t p = 0; p < polygons.size(); ++p) {
+            std::copy(polygons[p].xs(), polygons[p].xs() + polygons[p].size(), vertices.xs() + rings[p]);
+            std::copy(polygons[p].ys(), polygons[p].ys() + polygons[p].size(), vertices.ys() + rings[p]);
+        }
+        detail::BinaryWriter writer(BINARY_POLYGONS, polygons.size());
+        writer.add(SECTION_XS, vertices.xs(), vertices.size());
+        writer.add(SECTION_YS, vertices.ys(), vertices.size());
+        writer.add(SECTION_RINGS, rings.data(), rings.size());
+        writer.write(path);
+    }
+
+    /**
+     * Writes a graph with its weights, coordinates and in-edges, as far as it has them.
+     * Throws BinaryFileIOException if the file cannot be written.
+     */
+    template<class Index, class Weight, class Coord>
+    void writeGraph(const std::string &path, const CsrGraph<Index, Weight, Coord> &graph) {
+        detail::BinaryWriter writer(BINARY_GRAPH, graph.vertexCount());
+        writer.add(SECTION_OFFSETS, graph.offsets().data(), graph.offsets().size());
+        writer.add(SECTION_TARGETS, graph.targets().data(), graph.targets().size());
+        if (graph.hasWeights()) writer.add(SECTION_WEIGHTS, graph.weights().data(), graph.weights().size());
+        if (graph.hasCoordinates()) {
+            writer.add(SECTION_XS, graph.coordinates().xs(), graph.coordinates().size());
+            writer.add(SECTION_YS, graph.coordinates().ys(), graph.coordinates().size());
+        }
+        if (graph.hasInEdges()) {
+            writer.add(SECTION_IN_OFFSETS, graph.inOffsets().data(), graph.inOffsets().size());
+            writer.add(SECTION_IN_SOURCES, graph.inSources().data(), graph.inSources().size());
+            writer.add(SECTION_IN_EDGES, graph.inEdges().data(), graph.inEdges().size());
+        }
+        writer.write(path);
+    }
+
+    /**
+     * A point cloud read from a mapped file
+     */
+    template<class T = double>
+    class MappedPoints {
+    public:
+        typedef PackedPoint<T> point_type;
+
+        /**
+         * Constructor, maps a file written by writePoints with coordinates of type T.
+         * Throws the exceptions of BinaryFile, and BinaryFileTypeException for other data.
+         */
+        explicit MappedPoints(const std::string &path)
+                : mFile(path), mXs(nullptr, nullptr), mYs(nullptr, nullptr), mChunks(nullptr, nullptr), mChunkSize(0) {
+            mFile.expectKind(BINARY_POINTS);
+            mXs = mFile.array<T>(SECTION_XS, mFile.itemCount());
+            mYs = mFile.array<T>(SECTION_YS, mFile.itemCount());
+            const BinarySectionHeader *chunks = mFile.section(SECTION_CHUNKS);
+            if (chunks != nullptr) {
+                mChunkSize = std::size_t(chunks->param);
+                if (mChunkSize == 0) throw BinaryFileFormatException();
+                mChunks = mFile.array<double>(SECTION_CHUNKS, 4 * ((size() + mChunkSize - 1) / mChunkSize));
+            }
+        }
+
+        std::size_t size() const { return mXs.size(); }
+
+        bool empty() const { return mXs.empty(); }
+
+        const T *xs() const { return mXs.begin(); }
+
+        const T *ys() const { return mYs.begin(); }
+
+        point_type operator[](std::size_t i) const { return point_type(mXs[i], mYs[i]); }
+
+        /**
+         * The number of points per chunk, 0 if the file has no chunk index
+         */
+        std::size_t chunkSize() const { return mChunkSize; }
+
+        std::size_t chunkCount() const { return mChunks.size() / 4; }
+
+        BinaryChunk chunk(std::size_t c) const {
+            const BinaryChunk chunk = {c * mChunkSize, std::min(size(), (c + 1) * mChunkSize),
+                                       mChunks[4 * c], mChunks[4 * c + 1], mChunks[4 * c + 2], mChunks[4 * c + 3]};
+            return chunk;
+        }
+
+        /**
+         * A copy of the points
+         */
+        PointBuffer<T> buffer() const {
+            PointBuffer<T> points;
+            points.resize(size());
+            std::copy(mXs.begin(), mXs.end(), points.xs());
+            std::copy(mYs.begin(), mYs.end(), points.ys());
+            return points;
+        }
+
+        const BinaryFile &file() const { return mFile; }
+
+    private:
+        BinaryFile mFile;
+        ArrayRange<T> mXs, mYs;
+        ArrayRange<double> mChunks;
+        std::size_t mChunkSize;
+
+    }; // MappedPoints class
+
+    /**
+     * Polygons read from a mapped file
+     */
+    template<class T = double>
+    class MappedPolygons {
+    public:
+        typedef PackedPoint<T> point_type;
+
+        /**
+         * Constructor, maps a file written by writePolygons with coordinates of type T.
+         * Throws the exceptions of BinaryFile, and BinaryFileTypeException for other data.
+         */
+        explicit MappedPolygons(const std::string &path)
+                : mFile(path), mXs(nullptr, nullptr), mYs(nullptr, nullptr), mRings(nullptr, nullptr) {
+            mFile.expectKind(BINARY_POLYGONS);
+            mRings = mFile.array<std::uint64_t>(SECTION_RINGS, mFile.itemCount() + 1);
+            const BinarySectionHeader *xs = mFile.section(SECTION_XS);
+            if (xs == nullptr) throw BinaryFileFormatException();
+            mXs = mFile.array<T>(SECTION_XS, xs->count);
+            mYs = mFile.array<T>(SECTION_YS, xs->count);
+        }
+
+        std::size_t size() const { return mRings.size() - 1; }
+
+        bool empty() const { return size() == 0; }
+
+        /**
+         * The number of vertices of all polygons
+         */
+        std::size_t vertexCount() const { return mXs.size(); }
+
+        /**
+         * The vertices of polygon p are [first(p), first(p) + size(p)) of xs() and ys().
+         * Throws BinaryFileFormatException if they lie outside the vertex arrays.
+         */
+        std::size_t first(std::size_t p) const {
+            if (mRings[p] > mRings[p + 1] || mRings[p + 1] > vertexCount()) throw BinaryFileFormatException();
+            return std::size_t(mRings[p]);
+        }
+
+        std::size_t size(std::size_t p) const { return std::size_t(mRings[p + 1] - first(p)); }
+
+        const T *xs() const { return mXs.begin(); }
+
+        const T *ys() const { return mYs.begin(); }
+
+        point_type vertex(std::size_t i) const { return point_type(mXs[i], mYs[i]); }
+
+        /**
+         * A copy of polygon p
+         */
+        Polygon<T> polygon(std::size_t p) const {
+            Polygon<T> polygon;
+            const std::size_t begin = first(p), end = begin + size(p);
+            polygon.reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i) polygon.push_back(mXs[i], mYs[i]);
+            return polygon;
+        }
+
+        const BinaryFile &file() const { return mFile; }
+
+    private:
+        BinaryFile mFile;
+        ArrayRange<T> mXs, mYs;
+        ArrayRange<std::uint64_t> mRings;
+
+    }; // MappedPolygons class
+
+    /**
+     * A graph read from a mapped file. The mapped arrays are used in place; graph() copies them
+     * into a CsrGraph for the algorithms that take one.
+     */
+    template<class Index = std::uint32_t, class Weight = double, class Coord = double>
+    class MappedGraph {
+    public:
+        typedef CsrGraph<Index, Weight, Coord> graph_type;
+        typedef PackedPoint<Coord> point_type;
+
+        /**
+         * Constructor, maps a file written by writeGraph for this graph type.
+         * Throws the exceptions of BinaryFile, and BinaryFileTypeException for other data.
+         */
+        explicit MappedGraph(const std::string &path)
+                : mFile(path), mOffsets(nullptr, nullptr), mTargets(nullptr, nullptr), mWeights(nullptr, nullptr),
+                  mXs(nullptr, nullptr), mYs(nullptr, nullptr), mInOffsets(nullptr, nullptr),
+                  mInSources(nullptr, nullptr), mInEdges(nullptr, nullptr) {
+            mFile.expectKind(BINARY_GRAPH);
+            const std::uint64_t n = mFile.itemCount();
+            if (n >= std::uint64_t(std::numeric_limits<Index>::max())) throw BinaryFileTypeException();
+            mOffsets = mFile.array<Index>(SECTION_OFFSETS, n + 1);
+            const BinarySectionHeader *targets = mFile.section(SECTION_TARGETS);
+            if (targets == nullptr) throw BinaryFileFormatException();
+            const std::uint64_t m = targets->count;
+            mTargets = mFile.array<Index>(SECTION_TARGETS, m);
+            if (mFile.hasSection(SECTION_WEIGHTS)) mWeights = mFile.array<Weight>(SECTION_WEIGHTS, m);
+            if (mFile.hasSection(SECTION_XS)) {
+                mXs = mFile.array<Coord>(SECTION_XS, n);
+                mYs = mFile.array<Coord>(SECTION_YS, n);
+            }
+            if (mFile.hasSection(SECTION_IN_OFFSETS)) {
+                mInOffsets = mFile.array<Index>(SECTION_IN_OFFSETS, n + 1);
+                mInSources = mFile.array<Index>(SECTION_IN_SOURCES, m);
+                mInEdges = mFile.array<Index>(SECTION_IN_EDGES, m);
+            }
+            if (mOffsets[0] != 0 || mOffsets[std::size_t(n)] != m) throw BinaryFileFormatException();
+        }
+
+        Index vertexCount() const { return Index(mOffsets.size() - 1); }
+
+        Index edgeCount() const { return Index(mTargets.size()); }
+
+        bool hasWeights() const { return !mWeights.empty(); }
+
+        bool hasCoordinates() const { return !mXs.empty(); }
+
+        bool hasInEdges() const { return !mInOffsets.empty(); }
+
+        Index degree(Index v) const { return mOffsets[v + 1] - mOffsets[v]; }
+
+        /**
+         * The heads of the out-edges of v in ascending order, see CsrGraph::neighbors
+         */
+        ArrayRange<Index> neighbors(Index v) const {
+            return ArrayRange<Index>(mTargets.begin() + mOffsets[v], mTargets.begin() + mOffsets[v + 1]);
+        }
+
+        Weight weight(Index edge) const { return mWeights.empty() ? Weight(1) : mWeights[edge]; }
+
+        point_type coordinate(Index v) const { return point_type(mXs[v], mYs[v]); }
+
+        const ArrayRange<Index> &offsets() const { return mOffsets; }
+
+        const ArrayRange<Index> &targets() const { return mTargets; }
+
+        const ArrayRange<Weight> &weights() const { return mWeights; }
+
+        /**
+         * A copy of the graph. The arrays are copied as they are, call validateBinaryFile first
+         * for files from untrusted sources.
+         */
+        graph_type graph() const {
+            graph_type graph;
+            graph.mOffsets.assign(mOffsets.begin(), mOffsets.end());
+            graph.mTargets.assign(mTargets.begin(), mTargets.end());
+            graph.mWeights.assign(mWeights.begin(), mWeights.end());
+            graph.mInOffsets.assign(mInOffsets.begin(), mInOffsets.end());
+            graph.mSources.assign(mInSources.begin(), mInSources.end());
+            graph.mInEdges.assign(mInEdges.begin(), mInEdges.end());
+            graph.mCoordinates.resize(mXs.size());
+            std::copy(mXs.begin(), mXs.end(), graph.mCoordinates.xs());
+            std::copy(mYs.begin(), mYs.end(), graph.mCoordinates.ys());
+            return graph;
+        }
+
+        const BinaryFile &file() const { return mFile; }
+
+    private:
+        BinaryFile mFile;
+        ArrayRange<Index> mOffsets, mTargets;
+        ArrayRange<Weight> mWeights;
+        ArrayRange<Coord> mXs, mYs;
+        ArrayRange<Index> mInOffsets, mInSources, mInEdges;
+
+    }; // MappedGraph class
+
+    namespace detail {
+
+        /*
+         * Checks that offsets starts at 0, never decreases and ends at count
+         */
+        template<class I>
+        bool validOffsets(const BinaryFile &file, const BinarySectionHeader &section, std::uint64_t count) {
+            const I *offsets = static_cast<const I *>(file.data(section));
+            if (section.count == 0 || offsets[0] != 0 || offsets[section.count - 1] != count) return false;
+            for (std::uint64_t i = 1; i < section.count; ++i) {
+                if (offsets[i] < offsets[i - 1]) return false;
+            }
+            return true;
+        }
+
+        template<class I>
+        bool validIndices(const BinaryFile &file, const BinarySectionHeader &section, std::uint64_t bound) {
+            const I *indices = static_cast<const I *>(file.data(section));
+            for (std::uint64_t i = 0; i < section.count; ++i) {
+                if (std::uint64_t(indices[i]) >= bound) return false;
+            }
+            return true;
+        }
+
+        template<class T>
+        bool validChunks(const BinaryFile &file, const BinarySectionHeader &chunks) {
+            const T *xs = static_cast<const T *>(file.data(*file.section(SECTION_XS)));
+            const T *ys = static_cast<const T *>(file.data(*file.section(SECTION_YS)));
+            const double *boxes = static_cast<const double *>(file.data(chunks));
+            const std::uint64_t n = file.itemCount();
+            for (std::uint64_t first = 0, c = 0; first < n; first += chunks.param, ++c) {
+                const std::uint64_t last = std::min(n, first + chunks.param);
+                for (std::uint64_t i = first; i < last; ++i) {
+                    if (double(xs[i]) < boxes[4 * c] || double(ys[i]) < boxes[4 * c + 1] ||
+                        double(xs[i]) > boxes[4 * c + 2] || double(ys[i]) > boxes[4 * c + 3]) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    }; // namespace detail
+
+    /**
+     * Checks a binary file completely: its header and section table, the checksum of every
+     * section and the contents the kind of data requires, e.g. that the vertex offsets of a
+     * graph never decrease and that every edge ends at a vertex. This reads the whole file.
+     * @return Returns the problems found, nothing if the file is valid.
+     */
+    inline std::vector<std::string> validateBinaryFile(const std::string &path) {
+        std::vector<std::string> problems;
+        try {
+            const BinaryFile file(path);
+            for (std::size_t s = 0; s < file.sections().size(); ++s) {
+                const BinarySectionHeader &section = file.sections()[s];
+                const std::size_t bytes = std::size_t(section.count * detail::binaryTypeSize(section.type));
+                if (detail::checksum(file.data(section), bytes) != section.checksum) {
+                    problems.push_back("section " + std::to_string(section.tag) + ": checksum mismatch");
+                }
+            }
+            const std::uint64_t n = file.itemCount();
+            const BinarySectionHeader *xs = file.section(SECTION_XS), *ys = file.section(SECTION_YS);
+            if ((xs == nullptr) != (ys == nullptr) ||
+                (xs != nullptr && (xs->count != ys->count || xs->type != ys->type ||
+                                   (xs->type != BINARY_FLOAT && xs->type != BINARY_DOUBLE)))) {
+                problems.push_back("coordinates: the x and y sections do not match");
+                xs = ys = nullptr;
+            }
+            if (file.kind() == BINARY_POINTS) {
+                if (xs == nullptr || xs->count != n) problems.push_back("points: missing or short coordinates");
+                const BinarySectionHeader *chunks = file.section(SECTION_CHUNKS);
+                if (chunks != nullptr && xs != nullptr && xs->count == n) {
+                    if (chunks->type != BINARY_DOUBLE || chunks->param == 0 ||
+                        chunks->count != 4 * ((n + chunks->param - 1) / chunks->param)) {
+                        problems.push_back("chunks: the index does not match the points");
+                    } else if (!(xs->type == BINARY_DOUBLE ? detail::validChunks<double>(file, *chunks)
+                                                           : detail::validChunks<float>(file, *chunks))) {
+                        problems.push_back("chunks: a point lies outside the box of its chunk");
+                    }
+                }
+            } else if (file.kind() == BINARY_POLYGONS) {
+                const BinarySectionHeader *rings = file.section(SECTION_RINGS);
+                if (xs == nullptr) problems.push_back("polygons: missing coordinates");
+                if (rings == nullptr || rings->type != BINARY_UINT64 || rings->count != n + 1) {
+                    problems.push_back("rings: missing or not one offset per polygon and one more");
+                } else if (xs != nullptr && !detail::validOffsets<std::uint64_t>(file, *rings, xs->count)) {
+                    problems.push_back("rings: the offsets are not ascending from 0 to the vertex count");
+                }
+            } else {
+                const BinarySectionHeader *offsets = file.section(SECTION_OFFSETS);
+                const BinarySectionHeader *targets = file.section(SECTION_TARGETS);
+                if (offsets == nullptr || targets == nullptr || offsets->count != n + 1 ||
+                    targets->type != offsets->type) {
+                    problems.push_back("graph: missing offsets or targets");
+                    return problems;
+                }
+                const std::uint64_t m = targets->count;
+                const bool u32 = offsets->type == BINARY_UINT32;
+                if (!u32 && offsets->type != BINARY_UINT64) {
+                    problems.push_back("graph: the vertex ids are not unsigned integers");
+                    return problems;
+                }
+                if (!(u32 ? detail::validOffsets<std::uint32_t>(file, *offsets, m)
+                          : detail::validOffsets<std::uint64_t>(file, *offsets, m))) {
+                    problems.push_back("offsets: not ascending from 0 to the edge count");
+                }
+                if (!(u32 ? detail::validIndices<std::uint32_t>(file, *targets, n)
+                          : detail::validIndices<std::uint64_t>(file, *targets, n))) {
+                    problems.push_back("targets: an edge ends outside the vertices");
+                }
+                const BinarySectionHeader *weights = file.section(SECTION_WEIGHTS);
+                if (weights != nullptr && weights->count != m) problems.push_back("weights: not one per edge");
+                if (xs != nullptr && xs->count != n) problems.push_back("coordinates: not one per vertex");
+                const BinarySectionHeader *inOffsets = file.section(SECTION_IN_OFFSETS);
+                const BinarySectionHeader *inSources = file.section(SECTION_IN_SOURCES);
+                const BinarySectionHeader *inEdges = file.section(SECTION_IN_EDGES);
+                if (inOffsets != nullptr || inSources != nullptr || inEdges != nullptr) {
+                    if (inOffsets == nullptr || inSources == nullptr || inEdges == nullptr ||
+                        inOffsets->type != offsets->type || inSources->type != offsets->type ||
+                        inEdges->type != offsets->type || inOffsets->count != n + 1 || inSources->count != m ||
+                        inEdges->count != m) {
+                        problems.push_back("in-edges: incomplete or not matching the edges");
+                    } else if (!(u32 ? detail::validOffsets<std::uint32_t>(file, *inOffsets, m) &&
+                                       detail::validIndices<std::uint32_t>(file, *inSources, n) &&
+                                       detail::validIndices<std::uint32_t>(file, *inEdges, m)
+                                     : detail::validOffsets<std::uint64_t>(file, *inOffsets, m) &&
+                                       detail::validIndices<std::uint64_t>(file, *inSources, n) &&
+                                       detail::validIndices<std::uint64_t>(file, *inEdges, m))) {
+                        problems.push_back("in-edges: an offset, source or edge id is out of range");
+                    }
+                }
+            }
+        } catch (const std::exception &e) {
+            problems.push_back(e.what());
+        }
+        return problems;
+    }
+
+};// namespace graph_algo
+
+
+#endif /* BINARYFILE_H_ */
@@ -0,0 +1,142 @@
+#ifndef COMPARATORS_H_
+#define COMPARATORS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Precision.h"
+
+/**
+ * Comparators and sort helpers that order points by magnitude without sqrt.
+ * - LessLength / GreaterLength order points by their distance from the origin.
+ * - LessDistanceTo / GreaterDistanceTo order points by their distance from a center point.
+ * They compare squared lengths, so each comparison computes one key per point
+ * and no hypot. The comparison is exact (no epsilon), which keeps it a strict
+ * weak ordering as std::sort requires.
+ *
+ * sortByKey precomputes one key per point, sorts the keys together with the
+ * point indices and then permutes the points once. sortByLength and
+ * sortByDistanceTo use it with the squared length as key.
+ *
+ * All of them work on Point, PackedPoint or any type with getX() and getY().
+ */
+
+namespace graph_algo {
+
+    struct LessLength {
+        template<class P>
+        bool operator()(const P &a, const P &b) const {
+            return squaredLength(a) < squaredLength(b);
+        }
+    };
+
+    struct GreaterLength {
+        template<class P>
+        bool operator()(const P &a, const P &b) const {
+            return squaredLength(b) < squaredLength(a);
+        }
+    };
+
+    template<class P>
+    class LessDistanceTo {
+    public:
+        explicit LessDistanceTo(const P &center) : mCenter(center) {}
+
+        bool operator()(const P &a, const P &b) const {
+            return squaredDistance(a, mCenter) < squaredDistance(b, mCenter);
+        }
+
+    private:
+        P mCenter;
+    };
+
+    template<class P>
+    class GreaterDistanceTo {
+    public:
+        explicit GreaterDistanceTo(const P &center) : mCenter(center) {}
+
+        bool operator()(const P &a, const P &b) const {
+            return squaredDistance(b, mCenter) < squaredDistance(a, mCenter);
+        }
+
+    private:
+        P mCenter;
+    };
+
+    template<class P>
+    inline LessDistanceTo<P> lessDistanceTo(const P &center) {
+        return LessDistanceTo<P>(center);
+    }
+
+    template<class P>
+    inline GreaterDistanceTo<P> greaterDistanceTo(const P &center) {
+        return GreaterDistanceTo<P>(center);
+    }
+
+    /**
+     * Sorts points in ascending order of key(point), evaluating key once per point.
+     * The sort is stable, points with equal keys keep their relative order.
+     * @param points The points to sort, in place.
+     * @param key Maps a point to something with operator<, e.g. its squared length.
+     */
+    template<class P, class Alloc, class Key>
+    void sortByKey(std::vector<P, Alloc> &points, Key key) {
+        typedef decltype(key(points.front())) key_type;
+        std::vector<std::pair<key_type, std::size_t> > keyed;
+        keyed.reserve(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            keyed.push_back(std::make_pair(key(points[i]), i));
+        }
+        // The index breaks ties, so this is stable without std::stable_sort
+        std::sort(keyed.begin(), keyed.end());
+
+        std::vector<P, Alloc> sorted;
+        sorted.reserve(points.size());
+        for (std::size_t i = 0; i < keyed.size(); ++i) {
+            sorted.push_back(points[keyed[i].second]);
+        }
+        points.swap(sorted);
+    }
+
+    namespace detail {
+
+        struct SquaredLengthKey {
+            template<class P>
+            auto operator()(const P &p) const -> decltype(squaredLength(p)) {
+                return squaredLength(p);
+            }
+        };
+
+        template<class P>
+        struct SquaredDistanceKey {
+            P center;
+
+            auto operator()(const P &p) const -> decltype(squaredDistance(p, center)) {
+                return squaredDistance(p, center);
+            }
+        };
+
+    }; // namespace detail
+
+    /**
+     * Sorts points by their distance from the origin, nearest first.
+     */
+    template<class P, class Alloc>
+    void sortByLength(std::vector<P, Alloc> &points) {
+        sortByKey(points, detail::SquaredLengthKey());
+    }
+
+    /**
+     * Sorts points by their distance from center, nearest first.
+     */
+    template<class P, class Alloc>
+    void sortByDistanceTo(std::vector<P, Alloc> &points, const P &center) {
+        detail::SquaredDistanceKey<P> key = {center};
+        sortByKey(points, key);
+    }
+
+};// namespace graph_algo
+
+
+#endif /* COMPARATORS_H_ */
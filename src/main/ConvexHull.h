@@ -0,0 +1,234 @@
+#ifndef CONVEXHULL_H_
+#define CONVEXHULL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "Predicates.h"
+#include "RingIndex.h"
+
+/**
+ * Convex hull algorithms.
+ * - monotoneChainHull is Andrew's monotone chain, O(n log n).
+ * - chanHull is Chan's output sensitive algorithm, O(n log h) for a hull of h vertices.
+ * - parallelHull splits the input into one chunk per thread, takes the monotone chain
+ *   hull of every chunk concurrently and merges the chunk hulls with a final monotone chain.
+ *
+ * All of them return the same Hull: the extreme points in counterclockwise order, starting
+ * at the point with the smallest x (and smallest y among those). Duplicate points and points
+ * in the interior of hull edges are dropped. Orientation tests use the exact orient2d from
+ * Predicates.h, so the result is correct for degenerate input as well.
+ *
+ * They work on Point, PackedPoint or any copyable type with getX() and getY().
+ */
+
+namespace graph_algo {
+
+    /**
+     * Inputs smaller than this per thread are not worth splitting in parallelHull
+     */
+    static const std::size_t PARALLEL_HULL_GRAIN = 1 << 16;
+
+    /**
+     * The vertices of a convex hull in counterclockwise order, indexed with RingIndex so that
+     * stepping past the last vertex wraps around to the first.
+     */
+    template<class P>
+    class Hull {
+    public:
+        typedef RingIndex<int> index_type;
+
+        Hull() {}
+
+        explicit Hull(const std::vector<P> &vertices) : mVertices(vertices) {}
+
+        int size() const { return int(mVertices.size()); }
+
+        bool empty() const { return mVertices.empty(); }
+
+        /**
+         * A RingIndex at vertex i, throws RingIndexOutOfBoundException if i is not a vertex
+         */
+        index_type index(int i) const {
+            return index_type(i, size());
+        }
+
+        const P &operator[](const index_type &i) const {
+            return mVertices[int(i)];
+        }
+
+        const std::vector<P> &vertices() const { return mVertices; }
+
+    private:
+        std::vector<P> mVertices;
+
+    }; // Hull class
+
+    namespace detail {
+
+        template<class P>
+        inline bool samePoint(const P &a, const P &b) {
+            return a.getX() == b.getX() && a.getY() == b.getY();
+        }
+
+        template<class P>
+        inline bool lexicographicLess(const P &a, const P &b) {
+            return a.getX() < b.getX() || (a.getX() == b.getX() && a.getY() < b.getY());
+        }
+
+        /*
+         * The hull of points that are sorted lexicographically and free of duplicates
+         */
+        template<class P>
+        std::vector<P> monotoneChain(const std::vector<P> &sorted) {
+            const std::size_t n = sorted.size();
+            if (n < 3) return sorted;
+
+            std::vector<P> hull;
+            hull.reserve(n + 1);
+            for (std::size_t i = 0; i < n; ++i) {
+                while (hull.size() >= 2 && orient2d(hull[hull.size() - 2], hull.back(), sorted[i]) <= 0.0) {
+                    hull.pop_back();
+                }
+                hull.push_back(sorted[i]);
+            }
+            const std::size_t lower = hull.size() + 1;
+            for (std::size_t i = n - 1; i-- > 0;) {
+                while (hull.size() >= lower && orient2d(hull[hull.size() - 2], hull.back(), sorted[i]) <= 0.0) {
+                    hull.pop_back();
+                }
+                hull.push_back(sorted[i]);
+            }
+            hull.pop_back();
+            return hull;
+        }
+
+        template<class Iterator>
+        std::vector<typename std::iterator_traits<Iterator>::value_type> monotoneChain(Iterator first, Iterator last) {
+            typedef typename std::iterator_traits<Iterator>::value_type P;
+            std::vector<P> sorted(first, last);
+            std::sort(sorted.begin(), sorted.end(), lexicographicLess<P>);
+            sorted.erase(std::unique(sorted.begin(), sorted.end(), samePoint<P>), sorted.end());
+            return monotoneChain(sorted);
+        }
+
+        /*
+         * Whether a comes after b when turning clockwise around p, which must be a hull vertex.
+         * Points collinear with p compare by distance from p and p itself comes first.
+         */
+        template<class P>
+        inline bool moreClockwise(const P &p, const P &a, const P &b) {
+            if (samePoint(a, p)) return false;
+            if (samePoint(b, p)) return true;
+            const double o = orient2d(p, b, a);
+            if (o != 0.0) return o < 0.0;
+            // Same ray from p, the farther point wins
+            return a.getX() != b.getX() ? (a.getX() > b.getX()) == (a.getX() > p.getX())
+                                        : a.getY() != b.getY() && (a.getY() > b.getY()) == (a.getY() > p.getY());
+        }
+
+        /*
+         * The vertex of the convex polygon h that is most clockwise seen from p.
+         * That order is unimodal around h, so a binary search finds its maximum.
+         */
+        template<class P>
+        std::size_t tangent(const std::vector<P> &h, const P &p) {
+            const std::size_t n = h.size();
+            if (n == 1) return 0;
+            const bool up0 = moreClockwise(p, h[1], h[0]);
+            if (!up0 && moreClockwise(p, h[0], h[n - 1])) return 0;
+
+            std::size_t lo = 0, hi = n - 1;
+            while (lo < hi) {
+                const std::size_t mid = (lo + hi) / 2;
+                const bool up = moreClockwise(p, h[mid + 1], h[mid]);
+                // Which of the runs (rising or falling from h[0]) mid is on tells the side of the maximum
+                const bool beforeMax = up0 ? up && !moreClockwise(p, h[0], h[mid])
+                                           : up || !moreClockwise(p, h[mid], h[0]);
+                if (beforeMax) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        }
+
+    }; // namespace detail
+
+    /**
+     * Andrew's monotone chain, O(n log n).
+     */
+    template<class P>
+    Hull<P> monotoneChainHull(const std::vector<P> &points) {
+        return Hull<P>(detail::monotoneChain(points.begin(), points.end()));
+    }
+
+    /**
+     * Chan's algorithm, O(n log h) for a hull of h vertices.
+     * Gift wrapping over the hulls of groups of m points, with m squared until the wrap closes.
+     */
+    template<class P>
+    Hull<P> chanHull(const std::vector<P> &points) {
+        const std::size_t n = points.size();
+        if (n < 3) return monotoneChainHull(points);
+
+        const P start = *std::min_element(points.begin(), points.end(), detail::lexicographicLess<P>);
+        std::size_t m = 4;
+        for (;;) {
+            m = std::min(m, n);
+            std::vector<std::vector<P> > groups;
+            for (std::size_t first = 0; first < n; first += m) {
+                groups.push_back(detail::monotoneChain(points.begin() + first, points.begin() + std::min(first + m, n)));
+            }
+
+            std::vector<P> hull(1, start);
+            for (std::size_t step = 0; step < m; ++step) {
+                const P &p = hull.back();
+                const P *best = &p;
+                for (std::size_t g = 0; g < groups.size(); ++g) {
+                    const P &q = groups[g][detail::tangent(groups[g], p)];
+                    if (detail::moreClockwise(p, q, *best)) best = &q;
+                }
+                if (detail::samePoint(*best, start)) return Hull<P>(hull);
+                hull.push_back(*best);
+            }
+            m = m > n / m ? n : m * m;
+        }
+    }
+
+    /**
+     * The monotone chain hull computed on several threads.
+     * @param points The points.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class P>
+    Hull<P> parallelHull(const std::vector<P> &points, unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = unsigned(std::min<std::size_t>(threads, points.size() / PARALLEL_HULL_GRAIN));
+        if (threads <= 1) return monotoneChainHull(points);
+
+        const std::size_t chunk = (points.size() + threads - 1) / threads;
+        std::vector<std::vector<P> > hulls(threads);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            const std::size_t first = std::min(t * chunk, points.size());
+            const std::size_t last = std::min(first + chunk, points.size());
+            workers.push_back(std::thread([&points, &hulls, t, first, last]() {
+                hulls[t] = detail::monotoneChain(points.begin() + first, points.begin() + last);
+            }));
+        }
+        for (std::size_t t = 0; t < workers.size(); ++t) {
+            workers[t].join();
+        }
+
+        std::vector<P> merged;
+        for (std::size_t t = 0; t < hulls.size(); ++t) {
+            merged.insert(merged.end(), hulls[t].begin(), hulls[t].end());
+        }
+        return Hull<P>(detail::monotoneChain(merged.begin(), merged.end()));
+    }
+
+};// namespace graph_algo
+
+
+#endif /* CONVEXHULL_H_ */
@@ -0,0 +1,937 @@
+#ifndef DELAUNAY_H_
+#define DELAUNAY_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+#include "Precision.h"
+#include "Predicates.h"
+
+/**
+ * Delaunay triangulation of a set of points, as a half-edge mesh in structure-of-arrays form
+ * with 32 bit indices:
+ * - triangles holds 3 point ids per triangle, counterclockwise. Half-edge e belongs to
+ *   triangle e / 3 and goes from point triangles[e] to point triangles[nextHalfedge(e)].
+ * - halfedges holds the opposite half-edge of every half-edge, DELAUNAY_NONE on the convex hull.
+ * - hull holds the convex hull counterclockwise.
+ *
+ * The triangulation is built by a sweep (after Delaunator): the points are added in order
+ * of their distance from the circumcenter of a seed triangle, each new point is connected to
+ * the hull edges it sees and every new triangle is made Delaunay by edge flips. Orientation
+ * and incircle tests use the exact predicates from Predicates.h, so the result is a valid
+ * Delaunay triangulation for any input whose coordinate products do not underflow into
+ * subnormals. Duplicate points are left out of the mesh and reported by duplicates().
+ *
+ * With several threads the points are split into vertical strips, the strips are
+ * triangulated concurrently and then merged from left to right: the gap between two strip
+ * hulls is triangulated between their common tangents, then edge flips spread from the seam
+ * until every edge is Delaunay again.
+ *
+ * delaunayGraph, nearestNeighborGraph and minimumSpanningTree give the Delaunay edges, the
+ * nearest neighbour of every point and the Euclidean minimum spanning tree as CsrGraph.
+ */
+
+namespace graph_algo {
+
+    /**
+     * Strips smaller than this are not worth triangulating on their own thread
+     */
+    static const std::size_t PARALLEL_DELAUNAY_GRAIN = 1 << 16;
+
+    /**
+     * No half-edge, no point: the opposite of a hull half-edge and the outgoing half-edge of a duplicate
+     */
+    static const std::uint32_t DELAUNAY_NONE = 0xffffffffu;
+
+    namespace detail {
+
+        /*
+         * Stable sort of the keys by their upper 32 bits: an LSD radix sort with three 11 bit digits
+         */
+        inline void radixSortUpper(std::vector<std::uint64_t> &keys) {
+            if (keys.size() < 1024) {
+                std::stable_sort(keys.begin(), keys.end(), [](std::uint64_t a, std::uint64_t b) {
+                    return (a >> 32) < (b >> 32);
+                });
+                return;
+            }
+            std::vector<std::uint64_t> buffer(keys.size());
+            std::vector<std::size_t> counts(1 << 11);
+            for (int shift = 32; shift < 64; shift += 11) {
+                std::fill(counts.begin(), counts.end(), 0);
+                for (std::size_t k = 0; k < keys.size(); ++k) ++counts[(keys[k] >> shift) & 0x7ff];
+                std::size_t sum = 0;
+                for (std::size_t d = 0; d < counts.size(); ++d) {
+                    const std::size_t count = counts[d];
+                    counts[d] = sum;
+                    sum += count;
+                }
+                for (std::size_t k = 0; k < keys.size(); ++k) buffer[counts[(keys[k] >> shift) & 0x7ff]++] = keys[k];
+                keys.swap(buffer);
+            }
+        }
+
+        /*
+         * The sweep over a subset of the points. The half-edge ids in triangles and halfedges are
+         * local to the sweep. hullNext, hullPrev and hullTri are shared between sweeps over
+         * disjoint subsets and indexed by point id: the hull is a circular list through hullNext
+         * and hullPrev, and hullTri[v] is the half-edge from v to hullNext[v].
+         */
+        class DelaunaySweep {
+        public:
+            typedef PackedPoint<double> point_type;
+
+            DelaunaySweep(const double *xs, const double *ys, std::uint32_t *hullNext, std::uint32_t *hullPrev,
+                          std::uint32_t *hullTri)
+                    : mXs(xs), mYs(ys), mHullNext(hullNext), mHullPrev(hullPrev), mHullTri(hullTri),
+                      mCenterX(0.0), mCenterY(0.0), mHashSize(0) {}
+
+            std::vector<std::uint32_t> triangles;
+            std::vector<std::uint32_t> halfedges;
+            // (duplicate, point it duplicates)
+            std::vector<std::pair<std::uint32_t, std::uint32_t> > duplicates;
+            // The distinct points in lexicographic order if they are all collinear
+            std::vector<std::uint32_t> collinear;
+
+            /*
+             * Triangulates the points ids[0, n). Returns a hull vertex, or DELAUNAY_NONE if there are
+             * no triangles because the points are collinear (see collinear) or fewer than 3.
+             */
+            std::uint32_t run(const std::uint32_t *ids, std::size_t n) {
+                triangles.clear();
+                halfedges.clear();
+                duplicates.clear();
+                collinear.clear();
+                if (n == 0) return DELAUNAY_NONE;
+
+                // Seed triangle: the point nearest the center of the bounding box, its nearest point and
+                // the point that makes the smallest circumcircle with the two
+                double minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+                for (std::size_t k = 0; k < n; ++k) {
+                    const std::uint32_t i = ids[k];
+                    minX = std::min(minX, mXs[i]);
+                    minY = std::min(minY, mYs[i]);
+                    maxX = std::max(maxX, mXs[i]);
+                    maxY = std::max(maxY, mYs[i]);
+                }
+                const double cx = (minX + maxX) / 2.0, cy = (minY + maxY) / 2.0;
+                std::uint32_t i0 = nearest(ids, n, cx, cy, DELAUNAY_NONE);
+                std::uint32_t i1 = nearest(ids, n, mXs[i0], mYs[i0], i0);
+                std::uint32_t i2 = DELAUNAY_NONE;
+                if (i1 != DELAUNAY_NONE) {
+                    double minRadius = INFINITY;
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const std::uint32_t i = ids[k];
+                        if (orient2d(point(i0), point(i1), point(i)) == 0.0) continue;
+                        const double r = circumradius2(i0, i1, i);
+                        if (r < minRadius) {
+                            minRadius = r;
+                            i2 = i;
+                        }
+                    }
+                }
+                if (i2 == DELAUNAY_NONE) {
+                    sortCollinear(ids, n);
+                    return DELAUNAY_NONE;
+                }
+                if (orient2d(point(i0), point(i1), point(i2)) < 0.0) std::swap(i1, i2);
+                circumcenter(i0, i1, i2, mCenterX, mCenterY);
+
+                // Sweep order: distance from the circumcenter, as float bits above the id. The order only
+                // has to be roughly right, points that end up inside the hull are located and inserted.
+                std::vector<std::uint64_t> order(n);
+                for (std::size_t k = 0; k < n; ++k) {
+                    const std::uint32_t i = ids[k];
+                    const double dx = mXs[i] - mCenterX, dy = mYs[i] - mCenterY;
+                    const float distance = float(dx * dx + dy * dy);
+                    std::uint32_t bits;
+                    std::memcpy(&bits, &distance, sizeof(bits));
+                    order[k] = std::uint64_t(bits) << 32 | i;
+                }
+                radixSortUpper(order);
+
+                // The sweep runs on a copy of the points in sweep order, with local ids. The neighbours of
+                // a new point were added shortly before it, so the points and hull it touches are in cache.
+                std::vector<double> xs(n), ys(n);
+                std::vector<std::uint32_t> next(n), prev(n), tri(n);
+                std::uint32_t s0 = 0, s1 = 0, s2 = 0;
+                for (std::uint32_t k = 0; k < n; ++k) {
+                    const std::uint32_t i = std::uint32_t(order[k]);
+                    xs[k] = mXs[i];
+                    ys[k] = mYs[i];
+                    if (i == i0) s0 = k;
+                    if (i == i1) s1 = k;
+                    if (i == i2) s2 = k;
+                }
+                const double *globalXs = mXs, *globalYs = mYs;
+                std::uint32_t *globalNext = mHullNext, *globalPrev = mHullPrev, *globalTri = mHullTri;
+                mXs = xs.data();
+                mYs = ys.data();
+                mHullNext = next.data();
+                mHullPrev = prev.data();
+                mHullTri = tri.data();
+
+                mHashSize = std::size_t(std::ceil(std::sqrt(double(n))));
+                mHullHash.assign(mHashSize, DELAUNAY_NONE);
+                triangles.reserve(6 * n);
+                halfedges.reserve(6 * n);
+
+                mHullNext[s0] = mHullPrev[s2] = s1;
+                mHullNext[s1] = mHullPrev[s0] = s2;
+                mHullNext[s2] = mHullPrev[s1] = s0;
+                mHullHash[hashKey(s0)] = s0;
+                mHullHash[hashKey(s1)] = s1;
+                mHullHash[hashKey(s2)] = s2;
+                addTriangle(s0, s1, s2, DELAUNAY_NONE, DELAUNAY_NONE, DELAUNAY_NONE);
+                std::uint32_t hullStart = s0;
+
+                for (std::uint32_t p = 0; p < n; ++p) {
+                    if (p == s0 || p == s1 || p == s2) continue;
+                    // Duplicates have the same distance, so they are often next to each other
+                    if (p > 0 && xs[p] == xs[p - 1] && ys[p] == ys[p - 1]) {
+                        duplicates.push_back(std::make_pair(p, p - 1));
+                        continue;
+                    }
+                    const std::uint32_t added = add(p);
+                    if (added != DELAUNAY_NONE) hullStart = added;
+                }
+
+                // Back to the ids of the points
+                for (std::size_t e = 0; e < triangles.size(); ++e) triangles[e] = std::uint32_t(order[triangles[e]]);
+                for (std::size_t k = 0; k < duplicates.size(); ++k) {
+                    duplicates[k].first = std::uint32_t(order[duplicates[k].first]);
+                    duplicates[k].second = std::uint32_t(order[duplicates[k].second]);
+                }
+                std::uint32_t v = hullStart;
+                do {
+                    const std::uint32_t i = std::uint32_t(order[v]);
+                    globalNext[i] = std::uint32_t(order[next[v]]);
+                    globalPrev[i] = std::uint32_t(order[prev[v]]);
+                    globalTri[i] = tri[v];
+                    v = next[v];
+                } while (v != hullStart);
+                mXs = globalXs;
+                mYs = globalYs;
+                mHullNext = globalNext;
+                mHullPrev = globalPrev;
+                mHullTri = globalTri;
+                return std::uint32_t(order[hullStart]);
+            }
+
+            /*
+             * Lawson's flip algorithm from the given half-edges: flips every edge that is not
+             * Delaunay and checks the four edges around each flip, until all edges are Delaunay.
+             */
+            void flipAll(std::vector<std::uint32_t> &stack) {
+                while (!stack.empty()) {
+                    const std::uint32_t a = stack.back();
+                    stack.pop_back();
+                    const std::uint32_t b = halfedges[a];
+                    if (flip(a)) {
+                        stack.push_back(a);
+                        stack.push_back(next(a));
+                        stack.push_back(b);
+                        stack.push_back(next(b));
+                    }
+                }
+            }
+
+            std::uint32_t addTriangle(std::uint32_t i0, std::uint32_t i1, std::uint32_t i2,
+                                      std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+                const std::uint32_t t = std::uint32_t(triangles.size());
+                triangles.push_back(i0);
+                triangles.push_back(i1);
+                triangles.push_back(i2);
+                halfedges.push_back(DELAUNAY_NONE);
+                halfedges.push_back(DELAUNAY_NONE);
+                halfedges.push_back(DELAUNAY_NONE);
+                link(t, a);
+                link(t + 1, b);
+                link(t + 2, c);
+                return t;
+            }
+
+            static std::uint32_t next(std::uint32_t e) { return e % 3 == 2 ? e - 2 : e + 1; }
+
+            static std::uint32_t prev(std::uint32_t e) { return e % 3 == 0 ? e + 2 : e - 1; }
+
+        private:
+            point_type point(std::uint32_t i) const { return point_type(mXs[i], mYs[i]); }
+
+            std::uint32_t nearest(const std::uint32_t *ids, std::size_t n, double x, double y,
+                                  std::uint32_t except) const {
+                std::uint32_t best = DELAUNAY_NONE;
+                double minDistance = INFINITY;
+                for (std::size_t k = 0; k < n; ++k) {
+                    const std::uint32_t i = ids[k];
+                    const double dx = mXs[i] - x, dy = mYs[i] - y, d = dx * dx + dy * dy;
+                    if (except != DELAUNAY_NONE && d == 0.0) continue;
+                    if (d < minDistance) {
+                        minDistance = d;
+                        best = i;
+                    }
+                }
+                return best;
+            }
+
+            void sortCollinear(const std::uint32_t *ids, std::size_t n) {
+                std::vector<std::uint32_t> sorted(ids, ids + n);
+                const double *xs = mXs, *ys = mYs;
+                std::sort(sorted.begin(), sorted.end(), [xs, ys](std::uint32_t a, std::uint32_t b) {
+                    return xs[a] < xs[b] || (xs[a] == xs[b] && (ys[a] < ys[b] || (ys[a] == ys[b] && a < b)));
+                });
+                for (std::size_t k = 0; k < sorted.size(); ++k) {
+                    const std::uint32_t i = sorted[k];
+                    if (!collinear.empty() && xs[i] == xs[collinear.back()] && ys[i] == ys[collinear.back()]) {
+                        duplicates.push_back(std::make_pair(i, collinear.back()));
+                    } else {
+                        collinear.push_back(i);
+                    }
+                }
+            }
+
+            double circumradius2(std::uint32_t a, std::uint32_t b, std::uint32_t c) const {
+                double x, y;
+                circumcenter(a, b, c, x, y);
+                x -= mXs[a];
+                y -= mYs[a];
+                return x * x + y * y;
+            }
+
+            void circumcenter(std::uint32_t a, std::uint32_t b, std::uint32_t c, double &x, double &y) const {
+                const double dx = mXs[b] - mXs[a], dy = mYs[b] - mYs[a];
+                const double ex = mXs[c] - mXs[a], ey = mYs[c] - mYs[a];
+                const double bl = dx * dx + dy * dy, cl = ex * ex + ey * ey;
+                const double d = 0.5 / (dx * ey - dy * ex);
+                x = mXs[a] + (ey * bl - dy * cl) * d;
+                y = mYs[a] + (dx * cl - ex * bl) * d;
+            }
+
+            std::size_t hashKey(std::uint32_t i) const {
+                const double angle = pseudoAtan2(mYs[i] - mCenterY, mXs[i] - mCenterX);
+                const std::size_t key = std::size_t((angle + 2.0) / 4.0 * double(mHashSize));
+                return key < mHashSize ? key : mHashSize - 1;
+            }
+
+            bool visible(std::uint32_t a, std::uint32_t b, std::uint32_t p) const {
+                return orient2d(point(a), point(b), point(p)) < 0.0;
+            }
+
+            void link(std::uint32_t a, std::uint32_t b) {
+                halfedges[a] = b;
+                if (b != DELAUNAY_NONE) halfedges[b] = a;
+                else mHullTri[triangles[a]] = a;
+            }
+
+            /*
+             * Adds p outside the current hull. Returns a hull vertex, DELAUNAY_NONE if p went inside.
+             */
+            std::uint32_t add(std::uint32_t p) {
+                // A hull vertex near p by angle, then the first hull edge p sees from there on
+                const std::size_t key = hashKey(p);
+                std::uint32_t start = DELAUNAY_NONE;
+                for (std::size_t j = 0; j < mHashSize; ++j) {
+                    start = mHullHash[(key + j) % mHashSize];
+                    if (start != DELAUNAY_NONE && start != mHullNext[start]) break;
+                }
+                start = mHullPrev[start];
+                std::uint32_t e = start, q;
+                while (!visible(e, mHullNext[e], p)) {
+                    e = mHullNext[e];
+                    if (e == start) {
+                        // Not outside the hull: p is a duplicate or inside after all
+                        insertInside(p, mHullTri[start]);
+                        return DELAUNAY_NONE;
+                    }
+                }
+
+                std::uint32_t t = addTriangle(e, p, mHullNext[e], DELAUNAY_NONE, DELAUNAY_NONE, mHullTri[e]);
+                legalize(t + 2);
+
+                std::uint32_t n = mHullNext[e];
+                while (q = mHullNext[n], visible(n, q, p)) {
+                    t = addTriangle(n, p, q, mHullTri[p], DELAUNAY_NONE, mHullTri[n]);
+                    legalize(t + 2);
+                    mHullNext[n] = n;
+                    n = q;
+                }
+                if (e == start) {
+                    while (q = mHullPrev[e], visible(q, e, p)) {
+                        t = addTriangle(q, p, e, DELAUNAY_NONE, mHullTri[e], mHullTri[q]);
+                        legalize(t + 2);
+                        mHullNext[e] = e;
+                        e = q;
+                    }
+                }
+
+                mHullPrev[p] = e;
+                mHullNext[e] = p;
+                mHullPrev[n] = p;
+                mHullNext[p] = n;
+                mHullHash[hashKey(p)] = p;
+                mHullHash[hashKey(e)] = e;
+                return p;
+            }
+
+            /*
+             * Adds p inside the hull or on it: finds its triangle by walking from the triangle of
+             * half-edge from, then splits the triangle, or the two triangles of the edge p is on.
+             */
+            void insertInside(std::uint32_t p, std::uint32_t from) {
+                std::uint32_t t = from - from % 3;
+                const std::size_t maxSteps = triangles.size();
+                for (std::size_t step = 0;; ++step) {
+                    std::uint32_t cross = DELAUNAY_NONE;
+                    bool inside = true;
+                    for (std::uint32_t k = 0; k < 3; ++k) {
+                        const std::uint32_t e = t + (k + std::uint32_t(step)) % 3;
+                        if (visible(triangles[e], triangles[next(e)], p)) {
+                            cross = halfedges[e];
+                            inside = false;
+                            break;
+                        }
+                    }
+                    if (inside) break;
+                    // Outside the hull cannot happen, p saw no hull edge
+                    if (cross == DELAUNAY_NONE || step > maxSteps) return;
+                    t = cross - cross % 3;
+                }
+
+                std::uint32_t on = DELAUNAY_NONE;
+                for (std::uint32_t e = t; e < t + 3; ++e) {
+                    if (mXs[triangles[e]] == mXs[p] && mYs[triangles[e]] == mYs[p]) {
+                        duplicates.push_back(std::make_pair(p, triangles[e]));
+                        return;
+                    }
+                    if (orient2d(point(triangles[e]), point(triangles[next(e)]), point(p)) == 0.0) on = e;
+                }
+                if (on == DELAUNAY_NONE) splitTriangle(t, p);
+                else splitEdge(on, p);
+            }
+
+            void splitTriangle(std::uint32_t t, std::uint32_t p) {
+                const std::uint32_t v0 = triangles[t], v1 = triangles[t + 1], v2 = triangles[t + 2];
+                const std::uint32_t h1 = halfedges[t + 1], h2 = halfedges[t + 2], hull2 = mHullTri[v2];
+                // t becomes (v0, v1, p), then (v1, v2, p) and (v2, v0, p)
+                triangles[t + 2] = p;
+                const std::uint32_t t1 = addTriangle(v1, v2, p, h1, DELAUNAY_NONE, t + 1);
+                const std::uint32_t t2 = addTriangle(v2, v0, p, h2, t + 2, t1 + 1);
+                // Linking the placeholder t1 + 1 overwrote hullTri of v2, which is only right if the
+                // edge from v2 to v0 is on the hull
+                if (h2 != DELAUNAY_NONE) mHullTri[v2] = hull2;
+                legalize(t);
+                legalize(t1);
+                legalize(t2);
+            }
+
+            void splitEdge(std::uint32_t a, std::uint32_t p) {
+                // a goes from x to y in (x, y, u), its twin b from y to x in (y, x, w)
+                const std::uint32_t b = halfedges[a];
+                const std::uint32_t x = triangles[a], y = triangles[next(a)], u = triangles[prev(a)];
+                const std::uint32_t an = next(a), hn = halfedges[an];
+                // (x, y, u) becomes (x, p, u) and (p, y, u)
+                triangles[an] = p;
+                const std::uint32_t ta = addTriangle(p, y, u, DELAUNAY_NONE, hn, an);
+                if (b == DELAUNAY_NONE) {
+                    // p is on the hull edge from x to y
+                    link(a, DELAUNAY_NONE);
+                    mHullNext[x] = p;
+                    mHullPrev[p] = x;
+                    mHullNext[p] = y;
+                    mHullPrev[y] = p;
+                    mHullHash[hashKey(p)] = p;
+                } else {
+                    // (y, x, w) becomes (y, p, w) and (p, x, w)
+                    const std::uint32_t w = triangles[prev(b)], bn = next(b), hbn = halfedges[bn];
+                    triangles[bn] = p;
+                    const std::uint32_t tb = addTriangle(p, x, w, a, hbn, bn);
+                    link(b, ta);
+                    legalize(prev(b));
+                    legalize(tb + 1);
+                }
+                legalize(prev(a));
+                legalize(ta + 1);
+            }
+
+            /*
+             * Flips a if it is not Delaunay. a goes from x to y with third point u, its twin b from
+             * y to x with third point w. After the flip a and b are the edges from w to y and from
+             * u to x, and the new diagonal runs between u and w.
+             */
+            bool flip(std::uint32_t a) {
+                const std::uint32_t b = halfedges[a];
+                if (b == DELAUNAY_NONE) return false;
+                const std::uint32_t ap = prev(a), bp = prev(b);
+                const std::uint32_t x = triangles[a], y = triangles[b], u = triangles[ap], w = triangles[bp];
+                if (incircle(point(x), point(y), point(u), point(w)) <= 0.0) return false;
+                const std::uint32_t hap = halfedges[ap], hbp = halfedges[bp];
+                triangles[a] = w;
+                triangles[b] = u;
+                link(a, hbp);
+                link(b, hap);
+                link(ap, bp);
+                return true;
+            }
+
+            /*
+             * Makes the edge a Delaunay, where the third point of the triangle of a was just added,
+             * and continues with the edges opposite that point after every flip
+             */
+            void legalize(std::uint32_t a) {
+                mStack.push_back(a);
+                while (!mStack.empty()) {
+                    const std::uint32_t e = mStack.back();
+                    mStack.pop_back();
+                    const std::uint32_t b = halfedges[e];
+                    if (flip(e)) {
+                        mStack.push_back(e);
+                        mStack.push_back(next(b));
+                    }
+                }
+            }
+
+            const double *mXs;
+            const double *mYs;
+            std::uint32_t *mHullNext;
+            std::uint32_t *mHullPrev;
+            std::uint32_t *mHullTri;
+            double mCenterX, mCenterY;
+            std::size_t mHashSize;
+            std::vector<std::uint32_t> mHullHash;
+            std::vector<std::uint32_t> mStack;
+
+        }; // DelaunaySweep class
+
+    }; // namespace detail
+
+    class DelaunayTriangulation {
+    public:
+        typedef PackedPoint<double> point_type;
+        typedef CsrGraph<std::uint32_t, double, double> graph_type;
+
+        DelaunayTriangulation() {}
+
+        /**
+         * Constructor, triangulates the points.
+         * @param points The points.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        explicit DelaunayTriangulation(const PointBuffer<double> &points, unsigned threads = 1) : mPoints(points) {
+            build(threads);
+        }
+
+        /**
+         * Constructor, triangulates points of any type with getX() and getY()
+         */
+        template<class P>
+        explicit DelaunayTriangulation(const std::vector<P> &points, unsigned threads = 1) : mPoints(points) {
+            build(threads);
+        }
+
+        static std::uint32_t nextHalfedge(std::uint32_t e) { return detail::DelaunaySweep::next(e); }
+
+        static std::uint32_t prevHalfedge(std::uint32_t e) { return detail::DelaunaySweep::prev(e); }
+
+        std::size_t pointCount() const { return mPoints.size(); }
+
+        std::size_t triangleCount() const { return mTriangles.size() / 3; }
+
+        const PointBuffer<double> &points() const { return mPoints; }
+
+        point_type point(std::uint32_t i) const { return mPoints[i]; }
+
+        const std::vector<std::uint32_t> &triangles() const { return mTriangles; }
+
+        const std::vector<std::uint32_t> &halfedges() const { return mHalfedges; }
+
+        /**
+         * The convex hull counterclockwise. Without triangles, i.e. for collinear points,
+         * the distinct points in lexicographic order.
+         */
+        const std::vector<std::uint32_t> &hull() const { return mHull; }
+
+        /**
+         * The points left out of the mesh because they duplicate another point, as pairs of
+         * (duplicate, point). The point may itself be a duplicate of another point.
+         */
+        const std::vector<std::pair<std::uint32_t, std::uint32_t> > &duplicates() const { return mDuplicates; }
+
+        /**
+         * A half-edge out of point i, DELAUNAY_NONE if i is not in the mesh. For hull points it is the
+         * hull edge, so that turning counterclockwise from it visits every triangle around i.
+         * Without triangles it is the position of i in hull().
+         */
+        std::uint32_t outgoing(std::uint32_t i) const { return mOutgoing[i]; }
+
+        /**
+         * The points connected to i by an edge, counterclockwise
+         */
+        std::vector<std::uint32_t> neighbors(std::uint32_t i) const {
+            std::vector<std::uint32_t> result;
+            if (mTriangles.empty()) {
+                // Collinear points: the neighbours along the line
+                const std::uint32_t k = mOutgoing[i];
+                if (k == DELAUNAY_NONE) return result;
+                if (k > 0) result.push_back(mHull[k - 1]);
+                if (k + 1 < mHull.size()) result.push_back(mHull[k + 1]);
+                return result;
+            }
+            const std::uint32_t start = mOutgoing[i];
+            if (start == DELAUNAY_NONE) return result;
+            std::uint32_t e = start;
+            do {
+                result.push_back(mTriangles[nextHalfedge(e)]);
+                const std::uint32_t in = prevHalfedge(e);
+                e = mHalfedges[in];
+                if (e == DELAUNAY_NONE) {
+                    // Hull point, the last neighbour is at the end of the incoming hull edge
+                    result.push_back(mTriangles[in]);
+                    break;
+                }
+            } while (e != start);
+            return result;
+        }
+
+        /**
+         * Whether every edge is Delaunay, i.e. no point lies inside the circumcircle of a neighbouring triangle
+         */
+        bool isDelaunay() const {
+            for (std::size_t a = 0; a < mHalfedges.size(); ++a) {
+                const std::uint32_t b = mHalfedges[a];
+                if (b == DELAUNAY_NONE || b < a) continue;
+                const std::uint32_t e = std::uint32_t(a);
+                if (incircle(point(mTriangles[e]), point(mTriangles[nextHalfedge(e)]), point(mTriangles[prevHalfedge(e)]),
+                             point(mTriangles[prevHalfedge(b)])) > 0.0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Every edge of the triangulation once, plus an edge between every duplicate and its point
+         */
+        std::vector<std::pair<std::uint32_t, std::uint32_t> > edges() const {
+            std::vector<std::pair<std::uint32_t, std::uint32_t> > result;
+            if (mTriangles.empty()) {
+                for (std::size_t k = 1; k < mHull.size(); ++k) result.push_back(std::make_pair(mHull[k - 1], mHull[k]));
+            }
+            for (std::size_t e = 0; e < mHalfedges.size(); ++e) {
+                if (mHalfedges[e] == DELAUNAY_NONE || mHalfedges[e] > e) {
+                    result.push_back(std::make_pair(mTriangles[e], mTriangles[nextHalfedge(std::uint32_t(e))]));
+                }
+            }
+            result.insert(result.end(), mDuplicates.begin(), mDuplicates.end());
+            return result;
+        }
+
+        /**
+         * The Delaunay edges in both directions, weighted by their length, with the points as coordinates
+         */
+        graph_type delaunayGraph() const {
+            const std::vector<std::pair<std::uint32_t, std::uint32_t> > all = edges();
+            GraphBuilder<std::uint32_t, double, double> builder(std::uint32_t(mPoints.size()));
+            builder.reserve(2 * all.size());
+            for (std::size_t k = 0; k < all.size(); ++k) {
+                builder.addUndirectedEdge(all[k].first, all[k].second, length(all[k].first, all[k].second));
+            }
+            builder.setCoordinates(mPoints);
+            return builder.build();
+        }
+
+        /**
+         * An edge from every point to its nearest other point, which is always a Delaunay neighbour.
+         * Ties go to the smaller point id.
+         */
+        graph_type nearestNeighborGraph() const {
+            const std::size_t n = mPoints.size();
+            std::vector<std::uint32_t> nearest(n, DELAUNAY_NONE);
+            std::vector<double> best(n, INFINITY);
+            const std::vector<std::pair<std::uint32_t, std::uint32_t> > all = edges();
+            for (std::size_t k = 0; k < all.size(); ++k) {
+                const std::uint32_t u = all[k].first, v = all[k].second;
+                const double d = squaredLength(u, v);
+                if (d < best[u] || (d == best[u] && v < nearest[u])) {
+                    best[u] = d;
+                    nearest[u] = v;
+                }
+                if (d < best[v] || (d == best[v] && u < nearest[v])) {
+                    best[v] = d;
+                    nearest[v] = u;
+                }
+            }
+            GraphBuilder<std::uint32_t, double, double> builder(static_cast<std::uint32_t>(n));
+            for (std::uint32_t u = 0; u < n; ++u) {
+                if (nearest[u] != DELAUNAY_NONE) builder.addEdge(u, nearest[u], std::sqrt(best[u]));
+            }
+            builder.setCoordinates(mPoints);
+            return builder.build();
+        }
+
+        /**
+         * The Euclidean minimum spanning tree, in both directions. It is a subgraph of the
+         * Delaunay graph, so Kruskal's algorithm runs on the Delaunay edges.
+         */
+        graph_type minimumSpanningTree() const {
+            const std::vector<std::pair<std::uint32_t, std::uint32_t> > all = edges();
+            std::vector<std::pair<double, std::uint32_t> > order(all.size());
+            for (std::size_t k = 0; k < all.size(); ++k) {
+                order[k] = std::make_pair(squaredLength(all[k].first, all[k].second), std::uint32_t(k));
+            }
+            std::sort(order.begin(), order.end());
+
+            std::vector<std::uint32_t> parent(mPoints.size());
+            std::iota(parent.begin(), parent.end(), 0u);
+            GraphBuilder<std::uint32_t, double, double> builder(std::uint32_t(mPoints.size()));
+            for (std::size_t k = 0; k < order.size(); ++k) {
+                const std::uint32_t u = all[order[k].second].first, v = all[order[k].second].second;
+                const std::uint32_t ru = find(parent, u), rv = find(parent, v);
+                if (ru == rv) continue;
+                parent[ru] = rv;
+                builder.addUndirectedEdge(u, v, std::sqrt(order[k].first));
+            }
+            builder.setCoordinates(mPoints);
+            return builder.build();
+        }
+
+    private:
+        double squaredLength(std::uint32_t u, std::uint32_t v) const {
+            const double dx = mPoints.xs()[u] - mPoints.xs()[v], dy = mPoints.ys()[u] - mPoints.ys()[v];
+            return dx * dx + dy * dy;
+        }
+
+        double length(std::uint32_t u, std::uint32_t v) const {
+            return std::sqrt(squaredLength(u, v));
+        }
+
+        static std::uint32_t find(std::vector<std::uint32_t> &parent, std::uint32_t v) {
+            while (parent[v] != v) {
+                parent[v] = parent[parent[v]];
+                v = parent[v];
+            }
+            return v;
+        }
+
+        void build(unsigned threads) {
+            const std::size_t n = mPoints.size();
+            if (n >= std::size_t(DELAUNAY_NONE) / 6) throw GraphTooLargeException();
+            mHullNext.assign(n, DELAUNAY_NONE);
+            mHullPrev.assign(n, DELAUNAY_NONE);
+            mHullTri.assign(n, DELAUNAY_NONE);
+
+            const unsigned strips = detail::chunkCount(n, threads, PARALLEL_DELAUNAY_GRAIN);
+            std::uint32_t start = DELAUNAY_NONE;
+            bool done = false;
+            if (strips > 1) done = buildStrips(strips, start);
+            if (!done) {
+                std::vector<std::uint32_t> ids(n);
+                std::iota(ids.begin(), ids.end(), 0u);
+                detail::DelaunaySweep sweep(mPoints.xs(), mPoints.ys(), mHullNext.data(), mHullPrev.data(), mHullTri.data());
+                start = sweep.run(ids.data(), n);
+                mTriangles.swap(sweep.triangles);
+                mHalfedges.swap(sweep.halfedges);
+                mDuplicates.swap(sweep.duplicates);
+                if (start == DELAUNAY_NONE) mHull.swap(sweep.collinear);
+            }
+
+            mOutgoing.assign(n, DELAUNAY_NONE);
+            if (start == DELAUNAY_NONE) {
+                // Collinear: outgoing holds the position along the line
+                for (std::size_t k = 0; k < mHull.size(); ++k) mOutgoing[mHull[k]] = std::uint32_t(k);
+            } else {
+                std::uint32_t v = start;
+                do {
+                    mHull.push_back(v);
+                    v = mHullNext[v];
+                } while (v != start);
+                for (std::size_t e = 0; e < mTriangles.size(); ++e) mOutgoing[mTriangles[e]] = std::uint32_t(e);
+                for (std::size_t k = 0; k < mHull.size(); ++k) mOutgoing[mHull[k]] = mHullTri[mHull[k]];
+            }
+            std::vector<std::uint32_t>().swap(mHullNext);
+            std::vector<std::uint32_t>().swap(mHullPrev);
+            std::vector<std::uint32_t>().swap(mHullTri);
+        }
+
+        /*
+         * Triangulates vertical strips concurrently and merges them. Returns false, leaving the
+         * mesh empty, if a strip is degenerate or a seam cannot be zipped.
+         */
+        bool buildStrips(unsigned strips, std::uint32_t &start) {
+            const std::size_t n = mPoints.size();
+            const double *xs = mPoints.xs(), *ys = mPoints.ys();
+
+            // Split at x quantiles of a sample, points on a split line go to the strip on its left
+            std::vector<double> sample;
+            const std::size_t stride = std::max<std::size_t>(1, n / (256 * strips));
+            for (std::size_t i = 0; i < n; i += stride) sample.push_back(xs[i]);
+            std::sort(sample.begin(), sample.end());
+            std::vector<double> splits;
+            for (unsigned s = 1; s < strips; ++s) {
+                const double x = sample[s * sample.size() / strips];
+                if (splits.empty() || x > splits.back()) splits.push_back(x);
+            }
+            strips = unsigned(splits.size() + 1);
+            if (strips <= 1) return false;
+
+            std::vector<std::vector<std::uint32_t> > ids(strips);
+            for (std::uint32_t i = 0; i < n; ++i) {
+                ids[std::lower_bound(splits.begin(), splits.end(), xs[i]) - splits.begin()].push_back(i);
+            }
+            std::vector<detail::DelaunaySweep> sweeps(strips, detail::DelaunaySweep(xs, ys, mHullNext.data(),
+                                                                                    mHullPrev.data(), mHullTri.data()));
+            std::vector<std::uint32_t> starts(strips);
+            detail::forEachChunk(strips, strips, [&](unsigned, std::size_t s, std::size_t) {
+                starts[s] = sweeps[s].run(ids[s].data(), ids[s].size());
+            });
+            for (unsigned s = 0; s < strips; ++s) {
+                if (starts[s] == DELAUNAY_NONE) return false;
+            }
+
+            // One mesh, with the half-edge ids of every strip shifted past the strips before it
+            std::vector<std::size_t> offsets(strips + 1, 0);
+            for (unsigned s = 0; s < strips; ++s) offsets[s + 1] = offsets[s] + sweeps[s].triangles.size();
+            detail::DelaunaySweep merged(xs, ys, mHullNext.data(), mHullPrev.data(), mHullTri.data());
+            merged.triangles.resize(offsets[strips]);
+            merged.halfedges.resize(offsets[strips]);
+            detail::forEachChunk(strips, strips, [&](unsigned, std::size_t s, std::size_t) {
+                const std::uint32_t shift = std::uint32_t(offsets[s]);
+                std::copy(sweeps[s].triangles.begin(), sweeps[s].triangles.end(), merged.triangles.begin() + shift);
+                for (std::size_t e = 0; e < sweeps[s].halfedges.size(); ++e) {
+                    const std::uint32_t h = sweeps[s].halfedges[e];
+                    merged.halfedges[shift + e] = h == DELAUNAY_NONE ? DELAUNAY_NONE : h + shift;
+                }
+                std::uint32_t v = starts[s];
+                do {
+                    mHullTri[v] += shift;
+                    v = mHullNext[v];
+                } while (v != starts[s]);
+                std::vector<std::uint32_t>().swap(sweeps[s].triangles);
+                std::vector<std::uint32_t>().swap(sweeps[s].halfedges);
+            });
+
+            start = starts[0];
+            for (unsigned s = 1; s < strips; ++s) {
+                start = zip(merged, start, starts[s]);
+                if (start == DELAUNAY_NONE) {
+                    for (std::size_t k = 0; k < n; ++k) mHullNext[k] = mHullPrev[k] = mHullTri[k] = DELAUNAY_NONE;
+                    return false;
+                }
+            }
+            mTriangles.swap(merged.triangles);
+            mHalfedges.swap(merged.halfedges);
+            for (unsigned s = 0; s < strips; ++s) {
+                mDuplicates.insert(mDuplicates.end(), sweeps[s].duplicates.begin(), sweeps[s].duplicates.end());
+            }
+            return true;
+        }
+
+        bool lexicographicLess(std::uint32_t a, std::uint32_t b) const {
+            const double *xs = mPoints.xs(), *ys = mPoints.ys();
+            return xs[a] < xs[b] || (xs[a] == xs[b] && ys[a] < ys[b]);
+        }
+
+        double orient(std::uint32_t a, std::uint32_t b, std::uint32_t c) const {
+            return orient2d(point(a), point(b), point(c));
+        }
+
+        /*
+         * Merges the triangulation with hull vertex left and the one with hull vertex right, which lies
+         * entirely to its right. Triangulates the gap between the two hulls from their lower to
+         * their upper common tangent, then flips edges from the seam until all are Delaunay.
+         * Returns a hull vertex of the merged triangulation, DELAUNAY_NONE if the gap has no valid zigzag.
+         */
+        std::uint32_t zip(detail::DelaunaySweep &mesh, std::uint32_t left, std::uint32_t right) {
+            std::vector<std::uint32_t> &next = mHullNext, &prev = mHullPrev;
+            std::uint32_t rightmost = left, leftmost = right;
+            for (std::uint32_t v = next[left]; v != left; v = next[v]) {
+                if (lexicographicLess(rightmost, v)) rightmost = v;
+            }
+            for (std::uint32_t v = next[right]; v != right; v = next[v]) {
+                if (lexicographicLess(v, leftmost)) leftmost = v;
+            }
+
+            // Lower tangent from l to r and upper tangent from r2 to l2, every point on their left
+            std::uint32_t l = rightmost, r = leftmost;
+            for (bool moved = true; moved;) {
+                moved = false;
+                while (orient(l, r, prev[l]) < 0.0) l = prev[l], moved = true;
+                while (orient(l, r, next[r]) < 0.0) r = next[r], moved = true;
+            }
+            while (orient(l, r, next[l]) == 0.0) l = next[l];
+            while (orient(l, r, prev[r]) == 0.0) r = prev[r];
+            std::uint32_t l2 = rightmost, r2 = leftmost;
+            for (bool moved = true; moved;) {
+                moved = false;
+                while (orient(r2, l2, next[l2]) < 0.0) l2 = next[l2], moved = true;
+                while (orient(r2, l2, prev[r2]) < 0.0) r2 = prev[r2], moved = true;
+            }
+            while (orient(r2, l2, prev[l2]) == 0.0) l2 = prev[l2];
+            while (orient(r2, l2, next[r2]) == 0.0) r2 = next[r2];
+
+            // Zigzag up the left hull counterclockwise and the right hull clockwise
+            std::vector<std::uint32_t> stack;
+            // Open cross edges are linked as hull edges until the next step closes them, which
+            // overwrites hullTri of their start. Of those starts only r stays on the hull.
+            const std::uint32_t rightEdge = mHullTri[r];
+            std::uint32_t li = l, rj = r, twin = DELAUNAY_NONE, leftEdge = mHullTri[l];
+            while (li != l2 || rj != r2) {
+                const std::uint32_t lc = next[li], rc = prev[rj];
+                const bool canL = li != l2, canR = rj != r2;
+                // Each step cuts an ear off the gap: the triangle must be counterclockwise and its new
+                // base must not enter the hull at its far end, i.e. must not lie in the corner of that hull
+                const bool validR = canR && orient(li, rj, rc) > 0.0 &&
+                                    !(orient(prev[li], li, rc) >= 0.0 && orient(li, lc, rc) >= 0.0);
+                const bool validL = canL && orient(li, rj, lc) > 0.0 &&
+                                    !(orient(rc, rj, lc) >= 0.0 && orient(rj, next[rj], lc) >= 0.0);
+                if (!validR && !validL) return DELAUNAY_NONE;
+                const bool useR = validR && (!validL || incircle(point(li), point(rj), point(rc), point(lc)) <= 0.0);
+                std::uint32_t t;
+                if (useR) {
+                    t = mesh.addTriangle(li, rj, rc, twin, mHullTri[rc], DELAUNAY_NONE);
+                    twin = t + 2;
+                    rj = rc;
+                } else {
+                    t = mesh.addTriangle(li, rj, lc, twin, DELAUNAY_NONE, leftEdge);
+                    twin = t + 1;
+                    li = lc;
+                    leftEdge = mHullTri[lc];
+                }
+                stack.push_back(t);
+                stack.push_back(t + 1);
+                stack.push_back(t + 2);
+            }
+            if (r != r2) mHullTri[r] = rightEdge;
+            next[l] = r;
+            prev[r] = l;
+            next[r2] = l2;
+            prev[l2] = r2;
+            mesh.flipAll(stack);
+            return l;
+        }
+
+        PointBuffer<double> mPoints;
+        std::vector<std::uint32_t> mTriangles;
+        std::vector<std::uint32_t> mHalfedges;
+        std::vector<std::uint32_t> mHull;
+        std::vector<std::uint32_t> mOutgoing;
+        std::vector<std::pair<std::uint32_t, std::uint32_t> > mDuplicates;
+        // Only used while building
+        std::vector<std::uint32_t> mHullNext;
+        std::vector<std::uint32_t> mHullPrev;
+        std::vector<std::uint32_t> mHullTri;
+
+    }; // DelaunayTriangulation class
+
+};// namespace graph_algo
+
+
+#endif /* DELAUNAY_H_ */
@@ -0,0 +1,546 @@
+#ifndef GRAPH_H_
+#define GRAPH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AlignedAllocator.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+
+/**
+ * An immutable directed graph in compressed sparse row (CSR) form.
+ * - offsets holds, for every vertex v, the first edge id of v; the edges of v are
+ *   [offsets[v], offsets[v + 1]).
+ * - targets holds the head of every edge, sorted by target within each vertex.
+ * - weights holds the weight of every edge, it is empty for unweighted graphs.
+ * - coordinates optionally holds one point per vertex as a PointBuffer.
+ * The in-edges of every vertex can be kept as well, in compressed sparse column (CSC)
+ * form: inOffsets, the source of every in-edge and the id of the matching CSR edge,
+ * so that both directions share one weight array.
+ *
+ * Index is the unsigned integer type of vertex and edge ids, std::uint32_t for graphs
+ * with fewer than 2^32 edges and std::uint64_t beyond that.
+ *
+ * Graphs are made by GraphBuilder from an unsorted edge list. The build is a counting
+ * sort: count the out-degrees, take their prefix sums as offsets and scatter every edge
+ * to its slot. On several threads the edges are first split by vertex range, so that every
+ * thread sorts its own range without atomics. Then every row is sorted by target.
+ * permuteVertices renumbers the vertices of a graph, e.g. along a space filling curve.
+ */
+
+namespace graph_algo {
+
+    struct GraphVertexOutOfBoundException : public std::exception {
+        const char *what() const throw() {
+            return "The vertex of an edge must be [0, n-1] where n is the number of vertices of the graph.";
+        }
+
+    };
+
+    struct GraphTooLargeException : public std::exception {
+        const char *what() const throw() {
+            return "The number of edges does not fit the index type of the graph.";
+        }
+
+    };
+
+    struct GraphEdgeListMismatchException : public std::exception {
+        const char *what() const throw() {
+            return "The source, target and weight arrays of an edge list must have the same size.";
+        }
+
+    };
+
+    /**
+     * Inputs smaller than this per thread are not worth splitting in GraphBuilder::build
+     */
+    static const std::size_t PARALLEL_GRAPH_GRAIN = 1 << 16;
+
+    namespace detail {
+
+        /*
+         * The number of threads to split n items into, at most one per grain items
+         */
+        inline unsigned chunkCount(std::size_t n, unsigned threads, std::size_t grain) {
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            return unsigned(std::max<std::size_t>(1, std::min<std::size_t>(threads, n / grain)));
+        }
+
+        /*
+         * Calls f(chunk, first, last) for `chunks` contiguous ranges of [0, n), each on its own thread
+         */
+        template<class F>
+        void forEachChunk(std::size_t n, unsigned chunks, F f) {
+            if (chunks <= 1) {
+                f(0u, std::size_t(0), n);
+                return;
+            }
+            const std::size_t size = (n + chunks - 1) / chunks;
+            std::vector<std::thread> workers;
+            for (unsigned c = 0; c < chunks; ++c) {
+                const std::size_t first = std::min(c * size, n);
+                const std::size_t last = std::min(first + size, n);
+                workers.push_back(std::thread([&f, c, first, last]() { f(c, first, last); }));
+            }
+            for (std::size_t c = 0; c < workers.size(); ++c) {
+                workers[c].join();
+            }
+        }
+
+        /*
+         * Sorts the edges of one row by target, then by weight. Rows are short in sparse graphs,
+         * so they are insertion sorted in place and only long rows go through std::sort.
+         */
+        template<class Index, class Weight>
+        void sortRow(Index *targets, Weight *weights, std::size_t n) {
+            if (n <= 32) {
+                for (std::size_t i = 1; i < n; ++i) {
+                    const Index t = targets[i];
+                    const Weight w = weights ? weights[i] : Weight();
+                    std::size_t j = i;
+                    for (; j > 0 && (targets[j - 1] > t || (weights && targets[j - 1] == t && w < weights[j - 1])); --j) {
+                        targets[j] = targets[j - 1];
+                        if (weights) weights[j] = weights[j - 1];
+                    }
+                    targets[j] = t;
+                    if (weights) weights[j] = w;
+                }
+            } else if (weights) {
+                std::vector<std::pair<Index, Weight> > row(n);
+                for (std::size_t i = 0; i < n; ++i) row[i] = std::make_pair(targets[i], weights[i]);
+                std::sort(row.begin(), row.end());
+                for (std::size_t i = 0; i < n; ++i) {
+                    targets[i] = row[i].first;
+                    weights[i] = row[i].second;
+                }
+            } else {
+                std::sort(targets, targets + n);
+            }
+        }
+
+    }; // namespace detail
+
+    /**
+     * A read only view of a contiguous run of values, e.g. the targets of the edges of a vertex
+     */
+    template<class T>
+    class ArrayRange {
+    public:
+        ArrayRange(const T *first, const T *last) : mFirst(first), mLast(last) {}
+
+        const T *begin() const { return mFirst; }
+
+        const T *end() const { return mLast; }
+
+        std::size_t size() const { return std::size_t(mLast - mFirst); }
+
+        bool empty() const { return mFirst == mLast; }
+
+        const T &operator[](std::size_t i) const { return mFirst[i]; }
+
+    private:
+        const T *mFirst;
+        const T *mLast;
+
+    }; // ArrayRange class
+
+    template<class Index, class Weight, class Coord>
+    class GraphBuilder;
+
+    template<class Index, class Weight, class Coord>
+    class MappedGraph;
+
+    template<class Index = std::uint32_t, class Weight = double, class Coord = double>
+    class CsrGraph {
+    public:
+        static_assert(std::is_integral<Index>::value && std::is_unsigned<Index>::value,
+                      "the index type must be an unsigned integer");
+
+        typedef Index index_type;
+        typedef Weight weight_type;
+        typedef PackedPoint<Coord> point_type;
+        typedef std::vector<Index, AlignedAllocator<Index> > index_array;
+        typedef std::vector<Weight, AlignedAllocator<Weight> > weight_array;
+
+        /**
+         * Constructor, the graph without vertices
+         */
+        CsrGraph() : mOffsets(1, Index(0)) {}
+
+        Index vertexCount() const { return Index(mOffsets.size() - 1); }
+
+        Index edgeCount() const { return Index(mTargets.size()); }
+
+        bool hasWeights() const { return !mWeights.empty(); }
+
+        bool hasCoordinates() const { return !mCoordinates.empty(); }
+
+        bool hasInEdges() const { return !mInOffsets.empty(); }
+
+        /**
+         * The out-edges of v are the edge ids [edgeBegin(v), edgeEnd(v)). v is not range checked.
+         */
+        Index edgeBegin(Index v) const { return mOffsets[v]; }
+
+        Index edgeEnd(Index v) const { return mOffsets[v + 1]; }
+
+        Index degree(Index v) const { return mOffsets[v + 1] - mOffsets[v]; }
+
+        /**
+         * The heads of the out-edges of v in ascending order
+         */
+        ArrayRange<Index> neighbors(Index v) const {
+            return ArrayRange<Index>(mTargets.data() + mOffsets[v], mTargets.data() + mOffsets[v + 1]);
+        }
+
+        Index target(Index edge) const { return mTargets[edge]; }
+
+        /**
+         * The weight of an edge, 1 for every edge of an unweighted graph
+         */
+        Weight weight(Index edge) const { return mWeights.empty() ? Weight(1) : mWeights[edge]; }
+
+        /**
+         * The id of the first edge from u to v, or edgeCount() if there is none. O(log degree(u)).
+         */
+        Index findEdge(Index u, Index v) const {
+            const Index *first = mTargets.data() + mOffsets[u], *last = mTargets.data() + mOffsets[u + 1];
+            const Index *it = std::lower_bound(first, last, v);
+            return it != last && *it == v ? Index(it - mTargets.data()) : edgeCount();
+        }
+
+        bool hasEdge(Index u, Index v) const { return findEdge(u, v) != edgeCount(); }
+
+        /**
+         * The in-edges of v are the positions [inEdgeBegin(v), inEdgeEnd(v)) of inSource and inEdge.
+         * Only available if hasInEdges().
+         */
+        Index inEdgeBegin(Index v) const { return mInOffsets[v]; }
+
+        Index inEdgeEnd(Index v) const { return mInOffsets[v + 1]; }
+
+        Index inDegree(Index v) const { return mInOffsets[v + 1] - mInOffsets[v]; }
+
+        /**
+         * The tails of the in-edges of v in ascending order
+         */
+        ArrayRange<Index> inNeighbors(Index v) const {
+            return ArrayRange<Index>(mSources.data() + mInOffsets[v], mSources.data() + mInOffsets[v + 1]);
+        }
+
+        Index inSource(Index i) const { return mSources[i]; }
+
+        /**
+         * The CSR edge id of in-edge i, e.g. for weight(inEdge(i))
+         */
+        Index inEdge(Index i) const { return mInEdges[i]; }
+
+        point_type coordinate(Index v) const { return mCoordinates[v]; }
+
+        const PointBuffer<Coord> &coordinates() const { return mCoordinates; }
+
+        const index_array &offsets() const { return mOffsets; }
+
+        const index_array &targets() const { return mTargets; }
+
+        const weight_array &weights() const { return mWeights; }
+
+        const index_array &inOffsets() const { return mInOffsets; }
+
+        const index_array &inSources() const { return mSources; }
+
+        const index_array &inEdges() const { return mInEdges; }
+
+        /**
+         * The bytes held by the arrays of the graph
+         */
+        std::size_t memoryUsage() const {
+            return (mOffsets.size() + mTargets.size() + mInOffsets.size() + mSources.size() + mInEdges.size()) *
+                   sizeof(Index) + mWeights.size() * sizeof(Weight) + 2 * mCoordinates.size() * sizeof(Coord);
+        }
+
+    private:
+        friend class GraphBuilder<Index, Weight, Coord>;
+        friend class MappedGraph<Index, Weight, Coord>;
+
+        index_array mOffsets;
+        index_array mTargets;
+        weight_array mWeights;
+        index_array mInOffsets;
+        index_array mSources;
+        index_array mInEdges;
+        PointBuffer<Coord> mCoordinates;
+
+    }; // CsrGraph class
+
+    /**
+     * Collects an unsorted edge list and builds a CsrGraph from it.
+     * Edges are kept as separate source, target and weight arrays until build().
+     */
+    template<class Index = std::uint32_t, class Weight = double, class Coord = double>
+    class GraphBuilder {
+    public:
+        typedef CsrGraph<Index, Weight, Coord> graph_type;
+        typedef typename graph_type::index_array index_array;
+        typedef typename graph_type::weight_array weight_array;
+
+        /**
+         * Constructor, a graph of n vertices without edges
+         */
+        explicit GraphBuilder(Index n) : mVertices(n) {
+            if (n == std::numeric_limits<Index>::max()) throw GraphTooLargeException();
+        }
+
+        /**
+         * Constructor, takes over an edge list. weights is either empty or holds one weight per edge.
+         * Throws GraphEdgeListMismatchException if the arrays differ in size and
+         * GraphVertexOutOfBoundException if an edge has a vertex outside [0, n-1].
+         */
+        GraphBuilder(Index n, index_array sources, index_array targets, weight_array weights = weight_array())
+                : mVertices(n), mSources(std::move(sources)), mTargets(std::move(targets)), mWeights(std::move(weights)) {
+            if (n == std::numeric_limits<Index>::max()) throw GraphTooLargeException();
+            if (mSources.size() != mTargets.size() || (!mWeights.empty() && mWeights.size() != mSources.size())) {
+                throw GraphEdgeListMismatchException();
+            }
+            for (std::size_t i = 0; i < mSources.size(); ++i) {
+                if (mSources[i] >= n || mTargets[i] >= n) throw GraphVertexOutOfBoundException();
+            }
+        }
+
+        Index vertexCount() const { return mVertices; }
+
+        std::size_t edgeCount() const { return mSources.size(); }
+
+        void reserve(std::size_t edges) {
+            mSources.reserve(edges);
+            mTargets.reserve(edges);
+            if (!mWeights.empty()) mWeights.reserve(edges);
+        }
+
+        /**
+         * Adds the edge u -> v, with weight 1 if the graph is weighted
+         */
+        void addEdge(Index u, Index v) {
+            if (u >= mVertices || v >= mVertices) throw GraphVertexOutOfBoundException();
+            mSources.push_back(u);
+            mTargets.push_back(v);
+            if (!mWeights.empty()) mWeights.push_back(Weight(1));
+        }
+
+        /**
+         * Adds the edge u -> v with weight w. The first weighted edge makes the graph weighted,
+         * the edges added before it get weight 1.
+         */
+        void addEdge(Index u, Index v, Weight w) {
+            if (u >= mVertices || v >= mVertices) throw GraphVertexOutOfBoundException();
+            if (mWeights.empty()) mWeights.assign(mSources.size(), Weight(1));
+            mSources.push_back(u);
+            mTargets.push_back(v);
+            mWeights.push_back(w);
+        }
+
+        /**
+         * Adds u -> v and v -> u
+         */
+        void addUndirectedEdge(Index u, Index v, Weight w) {
+            addEdge(u, v, w);
+            addEdge(v, u, w);
+        }
+
+        /**
+         * Sets the coordinates of the vertices, one point per vertex.
+         * Throws GraphVertexOutOfBoundException if the number of points is not the number of vertices.
+         */
+        void setCoordinates(const PointBuffer<Coord> &coordinates) {
+            if (coordinates.size() != std::size_t(mVertices)) throw GraphVertexOutOfBoundException();
+            mCoordinates = coordinates;
+        }
+
+        /**
+         * Builds the graph. The builder keeps its edges and can build again.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         * @param inEdges Whether to build the in-edges (CSC) as well.
+         */
+        graph_type build(unsigned threads = 0, bool inEdges = false) const {
+            const std::size_t m = mSources.size();
+            if (m >= std::size_t(std::numeric_limits<Index>::max())) throw GraphTooLargeException();
+
+            graph_type graph;
+            const Weight *weights = mWeights.empty() ? nullptr : mWeights.data();
+            graph.mOffsets = countingSort(mSources.data(), mTargets.data(), weights, threads,
+                                          graph.mTargets, weights ? &graph.mWeights : nullptr, nullptr);
+
+            // findEdge relies on rows sorted by target
+            const unsigned chunks = detail::chunkCount(m, threads, PARALLEL_GRAPH_GRAIN);
+            const std::size_t n = mVertices;
+            detail::forEachChunk(n, chunks, [&graph](unsigned, std::size_t first, std::size_t last) {
+                Weight *w = graph.mWeights.empty() ? nullptr : graph.mWeights.data();
+                for (std::size_t v = first; v < last; ++v) {
+                    const Index begin = graph.mOffsets[v];
+                    detail::sortRow(graph.mTargets.data() + begin, w ? w + begin : w, graph.mOffsets[v + 1] - begin);
+                }
+            });
+
+            if (inEdges) {
+                // The CSR edges are in source order and the counting sort is stable, so every in-edge
+                // row comes out sorted by source and then edge id
+                index_array sources(m);
+                detail::forEachChunk(n, chunks, [&graph, &sources](unsigned, std::size_t first, std::size_t last) {
+                    for (std::size_t v = first; v < last; ++v) {
+                        std::fill(sources.begin() + graph.mOffsets[v], sources.begin() + graph.mOffsets[v + 1], Index(v));
+                    }
+                });
+                graph.mInOffsets = countingSort(graph.mTargets.data(), sources.data(), static_cast<const Weight *>(nullptr),
+                                                threads, graph.mSources, nullptr, &graph.mInEdges);
+            }
+
+            graph.mCoordinates = mCoordinates;
+            return graph;
+        }
+
+    private:
+        /*
+         * Groups the edges (keys[i], values[i]) by key and returns the offsets of the groups.
+         * The values, the weights and the original edge ids go to the arrays given. Edges keep
+         * their input order within a group.
+         *
+         * With several threads this is a two pass radix sort without atomics: the first pass
+         * splits the edges into one bucket per thread by key range, the second pass runs a
+         * plain counting sort within every bucket. A shared counter per vertex would need a
+         * locked add per edge, which on x86 also drains the store buffer and so serializes the
+         * cache misses of the scatter.
+         */
+        index_array countingSort(const Index *keys, const Index *values, const Weight *weights, unsigned threads,
+                                 index_array &outValues, weight_array *outWeights, index_array *outIds) const {
+            const std::size_t n = mVertices, m = mSources.size();
+            const unsigned chunks = detail::chunkCount(m, threads, PARALLEL_GRAPH_GRAIN);
+            const std::size_t range = (n + chunks - 1) / chunks;
+
+            index_array offsets(n + 1);
+            offsets[n] = Index(m);
+            outValues.resize(m);
+            if (outWeights) outWeights->resize(m);
+            if (outIds) outIds->resize(m);
+
+            // Counting sort of the edges ids[first, last), all with keys in [lo, hi), to the slots from `base` on
+            auto sortBucket = [&](const Index *ids, std::size_t first, std::size_t last, std::size_t lo, std::size_t hi,
+                                  Index base) {
+                std::fill(offsets.begin() + lo, offsets.begin() + hi, Index(0));
+                for (std::size_t i = first; i < last; ++i) ++offsets[keys[ids ? ids[i] : i]];
+                std::vector<Index> cursor(hi - lo);
+                for (std::size_t v = lo; v < hi; ++v) {
+                    const Index degree = offsets[v];
+                    offsets[v] = cursor[v - lo] = base;
+                    base += degree;
+                }
+                Index *valueSlots = outValues.data();
+                Weight *weightSlots = outWeights ? outWeights->data() : nullptr;
+                Index *idSlots = outIds ? outIds->data() : nullptr;
+                for (std::size_t i = first; i < last; ++i) {
+                    const Index e = ids ? ids[i] : Index(i);
+                    const Index slot = cursor[keys[e] - lo]++;
+                    valueSlots[slot] = values[e];
+                    if (weightSlots) weightSlots[slot] = weights[e];
+                    if (idSlots) idSlots[slot] = e;
+                }
+            };
+
+            if (chunks <= 1) {
+                sortBucket(nullptr, 0, m, 0, n, Index(0));
+                return offsets;
+            }
+
+            // First pass: the edges of every chunk per bucket, then the edge ids grouped by bucket
+            std::vector<std::vector<Index> > counts(chunks, std::vector<Index>(chunks + 1, Index(0)));
+            detail::forEachChunk(m, chunks, [&counts, keys, range](unsigned c, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) ++counts[c][keys[i] / range];
+            });
+            std::vector<Index> bucketStart(chunks + 1, Index(0));
+            Index sum = 0;
+            for (unsigned b = 0; b < chunks; ++b) {
+                bucketStart[b] = sum;
+                for (unsigned c = 0; c < chunks; ++c) {
+                    const Index count = counts[c][b];
+                    counts[c][b] = sum;
+                    sum += count;
+                }
+            }
+            bucketStart[chunks] = sum;
+            index_array ids(m);
+            detail::forEachChunk(m, chunks, [&counts, &ids, keys, range](unsigned c, std::size_t first, std::size_t last) {
+                std::vector<Index> &cursor = counts[c];
+                for (std::size_t i = first; i < last; ++i) ids[cursor[keys[i] / range]++] = Index(i);
+            });
+
+            // Second pass: every bucket on its own
+            detail::forEachChunk(chunks, chunks, [&](unsigned, std::size_t b, std::size_t) {
+                sortBucket(ids.data(), bucketStart[b], bucketStart[b + 1], std::min(b * range, n),
+                           std::min((b + 1) * range, n), bucketStart[b]);
+            });
+            return offsets;
+        }
+
+        Index mVertices;
+        index_array mSources;
+        index_array mTargets;
+        weight_array mWeights;
+        PointBuffer<Coord> mCoordinates;
+
+    }; // GraphBuilder class
+
+    /**
+     * The graph with its vertices renumbered, vertex k of the result is vertex order[k] of graph.
+     * Edges, weights, coordinates and in-edges move along. Ordering the vertices along a space
+     * filling curve of their coordinates (curveOrder in SpaceFillingCurve.h) puts neighbours at
+     * nearby ids, so that traversals touch fewer cache lines.
+     * Throws GraphVertexOutOfBoundException if order is not a permutation of the vertices.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class Index, class Weight, class Coord, class OrderIndex>
+    CsrGraph<Index, Weight, Coord> permuteVertices(const CsrGraph<Index, Weight, Coord> &graph,
+                                                   const std::vector<OrderIndex> &order, unsigned threads = 0) {
+        typedef typename CsrGraph<Index, Weight, Coord>::index_array index_array;
+        typedef typename CsrGraph<Index, Weight, Coord>::weight_array weight_array;
+        const std::size_t n = graph.vertexCount(), m = graph.edgeCount();
+        if (order.size() != n) throw GraphVertexOutOfBoundException();
+        const Index none = std::numeric_limits<Index>::max();
+        index_array rank(n, none);
+        for (std::size_t k = 0; k < n; ++k) {
+            if (std::size_t(order[k]) >= n || rank[order[k]] != none) throw GraphVertexOutOfBoundException();
+            rank[order[k]] = Index(k);
+        }
+
+        index_array sources(m), targets(m);
+        weight_array weights(graph.hasWeights() ? m : 0);
+        PointBuffer<Coord> coordinates;
+        coordinates.resize(graph.hasCoordinates() ? n : 0);
+        const unsigned chunks = detail::chunkCount(m, threads, PARALLEL_GRAPH_GRAIN);
+        detail::forEachChunk(n, chunks, [&](unsigned, std::size_t first, std::size_t last) {
+            for (std::size_t v = first; v < last; ++v) {
+                for (Index e = graph.edgeBegin(Index(v)); e < graph.edgeEnd(Index(v)); ++e) {
+                    sources[e] = rank[v];
+                    targets[e] = rank[graph.target(e)];
+                    if (!weights.empty()) weights[e] = graph.weight(e);
+                }
+            }
+            for (std::size_t k = first; k < last && graph.hasCoordinates(); ++k) {
+                coordinates.xs()[k] = graph.coordinates().xs()[order[k]];
+                coordinates.ys()[k] = graph.coordinates().ys()[order[k]];
+            }
+        });
+        GraphBuilder<Index, Weight, Coord> builder(Index(n), std::move(sources), std::move(targets), std::move(weights));
+        if (graph.hasCoordinates()) builder.setCoordinates(coordinates);
+        return builder.build(threads, graph.hasInEdges());
+    }
+
+};// namespace graph_algo
+
+
+#endif /* GRAPH_H_ */
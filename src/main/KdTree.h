@@ -0,0 +1,438 @@
+#ifndef KDTREE_H_
+#define KDTREE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+#include "SpaceFillingCurve.h"
+
+/**
+ * A static 2d tree for nearest neighbour, radius and box queries.
+ *
+ * The tree has an implicit layout: the points are stored in one PointBuffer in tree order,
+ * a subtree is a contiguous range [first, last) and its splitting point is the median at
+ * first + (last - first) / 2, with the smaller coordinates before it and the larger after.
+ * The only per node data is the split axis, one byte at the position of the median, chosen as
+ * the wider side of the range's bounding box. Ranges of up to KDTREE_LEAF_SIZE points are
+ * leaves that are scanned linearly. indices() maps tree order back to the input order.
+ *
+ * The build partitions around medians with std::nth_element, O(n log n). With several threads
+ * the ranges of each of the top levels are split concurrently until there is a range per
+ * thread, then every thread builds its subtrees.
+ *
+ * The batch queries sort the queries along a Z-order curve first (curveOrder), so that
+ * consecutive queries walk the same part of the tree while it is still in cache, then answer
+ * them in parallel.
+ */
+
+namespace graph_algo {
+
+    /**
+     * Ranges of at most this many points are scanned instead of split
+     */
+    static const std::size_t KDTREE_LEAF_SIZE = 16;
+
+    /**
+     * Ranges smaller than this are not worth splitting or querying on their own thread
+     */
+    static const std::size_t PARALLEL_KDTREE_GRAIN = 1 << 14;
+
+    template<class T = double>
+    class KdTree {
+    public:
+        typedef PackedPoint<T> point_type;
+
+        static const std::uint32_t NO_POINT = std::numeric_limits<std::uint32_t>::max();
+
+        KdTree() {}
+
+        /**
+         * Constructor, builds the tree.
+         * @param points The points.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        explicit KdTree(const PointBuffer<T> &points, unsigned threads = 1) {
+            build(points.xs(), points.ys(), points.size(), threads);
+        }
+
+        /**
+         * Constructor, builds the tree over points of any type with getX() and getY()
+         */
+        template<class P>
+        explicit KdTree(const std::vector<P> &points, unsigned threads = 1) {
+            const PointBuffer<T> buffer(points);
+            build(buffer.xs(), buffer.ys(), buffer.size(), threads);
+        }
+
+        std::size_t size() const { return mIndices.size(); }
+
+        bool empty() const { return mIndices.empty(); }
+
+        /**
+         * The points in tree order
+         */
+        const PointBuffer<T> &points() const { return mPoints; }
+
+        /**
+         * The input index of every point in tree order
+         */
+        const std::vector<std::uint32_t> &indices() const { return mIndices; }
+
+        /**
+         * Approximate heap memory in bytes
+         */
+        std::size_t memoryUsage() const {
+            return mPoints.size() * 2 * sizeof(T) + mIndices.size() * sizeof(std::uint32_t) + mAxes.size();
+        }
+
+        /**
+         * The input index of the point nearest to q, NO_POINT if the tree is empty
+         */
+        template<class P>
+        std::uint32_t nearest(const P &q) const {
+            std::uint32_t index = NO_POINT;
+            T distance;
+            nearest(q, 1, &index, &distance);
+            return index;
+        }
+
+        /**
+         * The k nearest points to q, nearest first.
+         * @param indices Receives the input indices of the points.
+         * @param squaredDistances Receives their squared distances to q.
+         * @return Returns the number of points found, k unless the tree has fewer points.
+         */
+        template<class P>
+        std::size_t nearest(const P &q, std::size_t k, std::uint32_t *indices, T *squaredDistances) const {
+            if (k == 0 || empty()) return 0;
+            Neighbors neighbors(k, indices, squaredDistances);
+            searchNearest(T(q.getX()), T(q.getY()), 0, size(), neighbors);
+            for (std::size_t i = 0; i < neighbors.count; ++i) indices[i] = mIndices[indices[i]];
+            return neighbors.count;
+        }
+
+        /**
+         * The input indices of the k nearest points to q, nearest first
+         */
+        template<class P>
+        std::vector<std::uint32_t> nearest(const P &q, std::size_t k) const {
+            std::vector<std::uint32_t> indices(std::min(k, size()));
+            std::vector<T> distances(indices.size());
+            nearest(q, indices.size(), indices.data(), distances.data());
+            return indices;
+        }
+
+        /**
+         * Appends the input indices of all points within distance r of q to out, in no particular order.
+         * @return Returns the number of points appended.
+         */
+        template<class P>
+        std::size_t radius(const P &q, T r, std::vector<std::uint32_t> &out) const {
+            const std::size_t before = out.size();
+            if (!empty()) searchRadius(T(q.getX()), T(q.getY()), r * r, 0, size(), out);
+            return out.size() - before;
+        }
+
+        /**
+         * Appends the input indices of all points in the box [minX, maxX] x [minY, maxY] to out,
+         * in no particular order.
+         * @return Returns the number of points appended.
+         */
+        std::size_t box(T minX, T minY, T maxX, T maxY, std::vector<std::uint32_t> &out) const {
+            const std::size_t before = out.size();
+            if (!empty()) {
+                const Box query = {minX, minY, maxX, maxY};
+                const Box cell = {std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), farthest(),
+                                  farthest()};
+                searchBox(query, cell, 0, size(), out);
+            }
+            return out.size() - before;
+        }
+
+        /**
+         * The k nearest points of every query, k entries per query in query order, nearest first.
+         * Queries with fewer than k results are padded with NO_POINT and an infinite (or maximal) distance.
+         * @param squaredDistances Receives the squared distances, may be null.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        void nearestBatch(const PointBuffer<T> &queries, std::size_t k, std::uint32_t *indices,
+                          T *squaredDistances = 0, unsigned threads = 1) const {
+            const std::vector<std::uint32_t> order = curveOrder<MortonCurve>(queries, threads);
+            const unsigned chunks = detail::chunkCount(order.size(), threads, PARALLEL_KDTREE_GRAIN);
+            const T *xs = queries.xs(), *ys = queries.ys();
+            detail::forEachChunk(order.size(), chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                std::vector<T> distances(squaredDistances ? 0 : k);
+                for (std::size_t j = first; j < last; ++j) {
+                    const std::uint32_t i = order[j];
+                    std::uint32_t *outIndices = indices + i * k;
+                    T *outDistances = squaredDistances ? squaredDistances + i * k : distances.data();
+                    const std::size_t found = nearest(point_type(xs[i], ys[i]), k, outIndices, outDistances);
+                    for (std::size_t m = found; m < k; ++m) {
+                        outIndices[m] = NO_POINT;
+                        outDistances[m] = farthest();
+                    }
+                }
+            });
+        }
+
+        /**
+         * The points within distance r of every query, in CSR form: the results of query i are
+         * indices[offsets[i], offsets[i + 1]).
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        void radiusBatch(const PointBuffer<T> &queries, T r, std::vector<std::size_t> &offsets,
+                         std::vector<std::uint32_t> &indices, unsigned threads = 1) const {
+            const std::vector<std::uint32_t> order = curveOrder<MortonCurve>(queries, threads);
+            const unsigned chunks = detail::chunkCount(order.size(), threads, PARALLEL_KDTREE_GRAIN);
+            const T *xs = queries.xs(), *ys = queries.ys();
+            // Every chunk collects its results, then they are copied out in query order
+            std::vector<std::vector<std::uint32_t> > results(chunks);
+            std::vector<std::size_t> starts(queries.size()), counts(queries.size());
+            detail::forEachChunk(order.size(), chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                for (std::size_t j = first; j < last; ++j) {
+                    const std::uint32_t i = order[j];
+                    starts[i] = results[c].size();
+                    counts[i] = radius(point_type(xs[i], ys[i]), r, results[c]);
+                }
+            });
+            std::vector<unsigned> chunkOf(queries.size());
+            const std::size_t chunkSize = std::max<std::size_t>(1, (order.size() + chunks - 1) / chunks);
+            for (std::size_t j = 0; j < order.size(); ++j) chunkOf[order[j]] = unsigned(j / chunkSize);
+            offsets.assign(queries.size() + 1, 0);
+            for (std::size_t i = 0; i < queries.size(); ++i) offsets[i + 1] = offsets[i] + counts[i];
+            indices.resize(offsets.back());
+            detail::forEachChunk(queries.size(), chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) {
+                    const std::vector<std::uint32_t> &source = results[chunkOf[i]];
+                    std::copy(source.begin() + starts[i], source.begin() + starts[i] + counts[i],
+                              indices.begin() + offsets[i]);
+                }
+            });
+        }
+
+    private:
+        /*
+         * Larger than any squared distance
+         */
+        static T farthest() {
+            return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                        : std::numeric_limits<T>::max();
+        }
+
+        struct Entry {
+            T x, y;
+            std::uint32_t index;
+        };
+
+        struct Box {
+            T minX, minY, maxX, maxY;
+        };
+
+        /*
+         * The k best candidates so far, sorted by distance in the caller's arrays. The indices are
+         * tree positions until the search ends.
+         */
+        struct Neighbors {
+            Neighbors(std::size_t k, std::uint32_t *indices, T *distances)
+                    : k(k), count(0), indices(indices), distances(distances) {}
+
+            T worst() const {
+                return count < k ? farthest() : distances[k - 1];
+            }
+
+            void offer(std::uint32_t position, T distance) {
+                if (count == k && !(distance < distances[k - 1])) return;
+                std::size_t i = count < k ? count++ : k - 1;
+                while (i > 0 && distance < distances[i - 1]) {
+                    distances[i] = distances[i - 1];
+                    indices[i] = indices[i - 1];
+                    --i;
+                }
+                distances[i] = distance;
+                indices[i] = position;
+            }
+
+            std::size_t k;
+            std::size_t count;
+            std::uint32_t *indices;
+            T *distances;
+        };
+
+        void build(const T *xs, const T *ys, std::size_t n, unsigned threads) {
+            if (n >= std::size_t(NO_POINT)) throw GraphTooLargeException();
+            std::vector<Entry> entries(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                entries[i].x = xs[i];
+                entries[i].y = ys[i];
+                entries[i].index = std::uint32_t(i);
+            }
+            mAxes.assign(n, 0);
+
+            // Split the top levels breadth first, a level at a time, until there is a range per thread
+            const unsigned chunks = detail::chunkCount(n, threads, PARALLEL_KDTREE_GRAIN);
+            std::vector<std::pair<std::size_t, std::size_t> > ranges(1, std::make_pair(std::size_t(0), n));
+            while (ranges.size() < chunks) {
+                std::vector<std::pair<std::size_t, std::size_t> > children;
+                for (std::size_t r = 0; r < ranges.size(); ++r) {
+                    if (ranges[r].second - ranges[r].first <= KDTREE_LEAF_SIZE) continue;
+                    const std::size_t mid = ranges[r].first + (ranges[r].second - ranges[r].first) / 2;
+                    children.push_back(std::make_pair(ranges[r].first, mid));
+                    children.push_back(std::make_pair(mid + 1, ranges[r].second));
+                }
+                if (children.empty()) break;
+                detail::forEachChunk(ranges.size(), unsigned(std::min<std::size_t>(chunks, ranges.size())),
+                                     [&](unsigned, std::size_t first, std::size_t last) {
+                                         for (std::size_t r = first; r < last; ++r) {
+                                             split(entries, ranges[r].first, ranges[r].second);
+                                         }
+                                     });
+                ranges.swap(children);
+            }
+            detail::forEachChunk(ranges.size(), unsigned(std::min<std::size_t>(chunks, ranges.size())),
+                                 [&](unsigned, std::size_t first, std::size_t last) {
+                                     for (std::size_t r = first; r < last; ++r) {
+                                         buildRange(entries, ranges[r].first, ranges[r].second);
+                                     }
+                                 });
+
+            mPoints.resize(n);
+            mIndices.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                mPoints.xs()[i] = entries[i].x;
+                mPoints.ys()[i] = entries[i].y;
+                mIndices[i] = entries[i].index;
+            }
+        }
+
+        void buildRange(std::vector<Entry> &entries, std::size_t first, std::size_t last) {
+            while (last - first > KDTREE_LEAF_SIZE) {
+                const std::size_t mid = split(entries, first, last);
+                buildRange(entries, first, mid);
+                first = mid + 1;
+            }
+        }
+
+        /*
+         * Puts the median along the wider side of the range at its middle, returns the middle
+         */
+        std::size_t split(std::vector<Entry> &entries, std::size_t first, std::size_t last) {
+            const std::size_t mid = first + (last - first) / 2;
+            if (last - first <= KDTREE_LEAF_SIZE) return mid;
+            T minX = entries[first].x, maxX = minX, minY = entries[first].y, maxY = minY;
+            for (std::size_t i = first + 1; i < last; ++i) {
+                minX = std::min(minX, entries[i].x);
+                maxX = std::max(maxX, entries[i].x);
+                minY = std::min(minY, entries[i].y);
+                maxY = std::max(maxY, entries[i].y);
+            }
+            const bool axisY = maxY - minY > maxX - minX;
+            mAxes[mid] = axisY ? 1 : 0;
+            if (axisY) {
+                std::nth_element(entries.begin() + first, entries.begin() + mid, entries.begin() + last,
+                                 [](const Entry &a, const Entry &b) { return a.y < b.y; });
+            } else {
+                std::nth_element(entries.begin() + first, entries.begin() + mid, entries.begin() + last,
+                                 [](const Entry &a, const Entry &b) { return a.x < b.x; });
+            }
+            return mid;
+        }
+
+        T squaredDistance(T qx, T qy, std::size_t i) const {
+            const T dx = mPoints.xs()[i] - qx, dy = mPoints.ys()[i] - qy;
+            return dx * dx + dy * dy;
+        }
+
+        void searchNearest(T qx, T qy, std::size_t first, std::size_t last, Neighbors &neighbors) const {
+            while (last - first > KDTREE_LEAF_SIZE) {
+                const std::size_t mid = first + (last - first) / 2;
+                const T d = mAxes[mid] ? qy - mPoints.ys()[mid] : qx - mPoints.xs()[mid];
+                neighbors.offer(std::uint32_t(mid), squaredDistance(qx, qy, mid));
+                // The near side first, then the far side if the splitting line is closer than the worst candidate
+                if (d < 0) {
+                    searchNearest(qx, qy, first, mid, neighbors);
+                    if (!(d * d < neighbors.worst())) return;
+                    first = mid + 1;
+                } else {
+                    searchNearest(qx, qy, mid + 1, last, neighbors);
+                    if (!(d * d < neighbors.worst())) return;
+                    last = mid;
+                }
+            }
+            for (std::size_t i = first; i < last; ++i) neighbors.offer(std::uint32_t(i), squaredDistance(qx, qy, i));
+        }
+
+        void searchRadius(T qx, T qy, T r2, std::size_t first, std::size_t last, std::vector<std::uint32_t> &out) const {
+            while (last - first > KDTREE_LEAF_SIZE) {
+                const std::size_t mid = first + (last - first) / 2;
+                const T d = mAxes[mid] ? qy - mPoints.ys()[mid] : qx - mPoints.xs()[mid];
+                if (squaredDistance(qx, qy, mid) <= r2) out.push_back(mIndices[mid]);
+                if (d < 0) {
+                    searchRadius(qx, qy, r2, first, mid, out);
+                    if (d * d > r2) return;
+                    first = mid + 1;
+                } else {
+                    searchRadius(qx, qy, r2, mid + 1, last, out);
+                    if (d * d > r2) return;
+                    last = mid;
+                }
+            }
+            for (std::size_t i = first; i < last; ++i) {
+                if (squaredDistance(qx, qy, i) <= r2) out.push_back(mIndices[i]);
+            }
+        }
+
+        /*
+         * cell bounds the points of [first, last). A cell inside the query box is taken whole.
+         */
+        void searchBox(const Box &query, const Box &cell, std::size_t first, std::size_t last,
+                       std::vector<std::uint32_t> &out) const {
+            if (cell.minX >= query.minX && cell.maxX <= query.maxX && cell.minY >= query.minY && cell.maxY <= query.maxY) {
+                out.insert(out.end(), mIndices.begin() + first, mIndices.begin() + last);
+                return;
+            }
+            if (last - first <= KDTREE_LEAF_SIZE) {
+                for (std::size_t i = first; i < last; ++i) {
+                    if (inside(query, mPoints.xs()[i], mPoints.ys()[i])) out.push_back(mIndices[i]);
+                }
+                return;
+            }
+            const std::size_t mid = first + (last - first) / 2;
+            const T x = mPoints.xs()[mid], y = mPoints.ys()[mid];
+            if (inside(query, x, y)) out.push_back(mIndices[mid]);
+            Box lower = cell, upper = cell;
+            if (mAxes[mid]) {
+                lower.maxY = upper.minY = y;
+                if (query.minY <= y) searchBox(query, lower, first, mid, out);
+                if (query.maxY >= y) searchBox(query, upper, mid + 1, last, out);
+            } else {
+                lower.maxX = upper.minX = x;
+                if (query.minX <= x) searchBox(query, lower, first, mid, out);
+                if (query.maxX >= x) searchBox(query, upper, mid + 1, last, out);
+            }
+        }
+
+        static bool inside(const Box &box, T x, T y) {
+            return x >= box.minX && x <= box.maxX && y >= box.minY && y <= box.maxY;
+        }
+
+        PointBuffer<T> mPoints;
+        std::vector<std::uint32_t> mIndices;
+        // The split axis at the position of every median, 0 for x and 1 for y
+        std::vector<std::uint8_t> mAxes;
+
+    }; // KdTree class
+
+    template<class T>
+    const std::uint32_t KdTree<T>::NO_POINT;
+
+};// namespace graph_algo
+
+
+#endif /* KDTREE_H_ */
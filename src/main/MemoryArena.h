@@ -0,0 +1,348 @@
+#ifndef MEMORYARENA_H_
+#define MEMORYARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include "AlignedAllocator.h"
+
+/**
+ * Memory resources for scratch memory, to keep short lived geometry work away from malloc.
+ * - MonotonicArena hands out memory by bumping a pointer through blocks taken from an upstream
+ *   resource. Freeing a single allocation does nothing; rewinding to a mark or resetting frees
+ *   everything allocated since in O(1) and keeps the blocks for reuse, so a steady stream of
+ *   queries stops touching the upstream resource after the first few.
+ * - ArenaScope marks an arena on construction and rewinds it on destruction.
+ * - FixedPool hands out blocks of one size from a free list, for node based containers whose
+ *   nodes come and go in any order. Larger or more aligned requests go to the upstream resource.
+ *
+ * Both are std::pmr::memory_resource, so std::pmr containers take them directly and the library's
+ * containers take them through AlignedAllocator, e.g. PointBuffer<T>(&arena).
+ * Blocks and slabs are cache line aligned.
+ *
+ * Neither is thread safe, use one per thread. Memory from them must not outlive them.
+ */
+
+namespace graph_algo {
+
+    /**
+     * Size of the first block of a MonotonicArena unless given, later blocks double in size
+     */
+    static const std::size_t DEFAULT_ARENA_BLOCK = 1 << 16;
+
+    namespace detail {
+
+        /*
+         * Sits at the start of every block or slab taken from upstream, padded to a cache line so
+         * that the memory after it keeps the block's alignment
+         */
+        struct alignas(CACHE_LINE_SIZE) BlockHeader {
+            BlockHeader *next;
+            std::size_t size;
+        };
+
+        inline char *blockBegin(BlockHeader *block) {
+            return reinterpret_cast<char *>(block) + sizeof(BlockHeader);
+        }
+
+        inline char *blockEnd(BlockHeader *block) {
+            return reinterpret_cast<char *>(block) + block->size;
+        }
+
+        inline char *alignUp(char *p, std::size_t alignment) {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+            return p + ((alignment - address % alignment) % alignment);
+        }
+
+    }; // namespace detail
+
+    class MonotonicArena : public std::pmr::memory_resource {
+    public:
+        /**
+         * A position in the arena to rewind to
+         */
+        struct Mark {
+            detail::BlockHeader *block;
+            char *cursor;
+            std::size_t used;
+        };
+
+        /**
+         * Constructor, takes no memory until the first allocation
+         *
+         * @param blockSize the size of the first block, later blocks double up to 64 times this
+         * @param upstream where the blocks come from
+         */
+        explicit MonotonicArena(std::size_t blockSize = DEFAULT_ARENA_BLOCK,
+                                std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+                : mUpstream(upstream), mBlockSize(std::max(blockSize, 2 * sizeof(detail::BlockHeader))),
+                  mFirst(nullptr), mCurrent(nullptr), mCursor(nullptr), mEnd(nullptr), mUsed(0), mHeld(0) {}
+
+        MonotonicArena(const MonotonicArena &) = delete;
+
+        MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+        ~MonotonicArena() override { release(); }
+
+        /**
+         * The current position, everything allocated after it goes with rewind(mark)
+         */
+        Mark mark() const {
+            return Mark{mCurrent, mCursor, mUsed};
+        }
+
+        /**
+         * Frees everything allocated since mark in O(1). The blocks stay with the arena.
+         */
+        void rewind(const Mark &mark) {
+            if (mark.block == nullptr) {
+                reset();
+                return;
+            }
+            mCurrent = mark.block;
+            mCursor = mark.cursor;
+            mEnd = detail::blockEnd(mCurrent);
+            mUsed = mark.used;
+        }
+
+        /**
+         * Frees everything in O(1). The blocks stay with the arena.
+         */
+        void reset() {
+            if (mFirst != nullptr) enter(mFirst);
+            mUsed = 0;
+        }
+
+        /**
+         * Frees everything and returns the blocks upstream
+         */
+        void release() {
+            for (detail::BlockHeader *block = mFirst; block != nullptr;) {
+                detail::BlockHeader *next = block->next;
+                mUpstream->deallocate(block, block->size, CACHE_LINE_SIZE);
+                block = next;
+            }
+            mFirst = mCurrent = nullptr;
+            mCursor = mEnd = nullptr;
+            mUsed = mHeld = 0;
+        }
+
+        /**
+         * Bytes handed out since the last reset, including alignment padding and the ends of
+         * blocks that were skipped because a request did not fit
+         */
+        std::size_t used() const { return mUsed; }
+
+        /**
+         * Bytes taken from upstream
+         */
+        std::size_t memoryUsage() const { return mHeld; }
+
+        std::pmr::memory_resource *upstream() const { return mUpstream; }
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            char *p = mCursor == nullptr ? nullptr : detail::alignUp(mCursor, alignment);
+            if (p == nullptr || p > mEnd || std::size_t(mEnd - p) < bytes) {
+                p = detail::alignUp(nextBlock(bytes, alignment), alignment);
+            }
+            mUsed += std::size_t(p + bytes - mCursor);
+            mCursor = p + bytes;
+            return p;
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        void enter(detail::BlockHeader *block) {
+            mCurrent = block;
+            mCursor = detail::blockBegin(block);
+            mEnd = detail::blockEnd(block);
+        }
+
+        /*
+         * Moves on to the next block that fits bytes at alignment, reusing the blocks after the
+         * current one before taking a new one from upstream, and returns its start
+         */
+        char *nextBlock(std::size_t bytes, std::size_t alignment) {
+            const std::size_t need = sizeof(detail::BlockHeader) + bytes + alignment;
+            if (mCurrent != nullptr) mUsed += std::size_t(mEnd - mCursor);
+            detail::BlockHeader *next = mCurrent == nullptr ? mFirst : mCurrent->next;
+            while (next != nullptr && next->size < need) {
+                mUsed += next->size - sizeof(detail::BlockHeader);
+                mCurrent = next;
+                next = next->next;
+            }
+            if (next == nullptr) {
+                std::size_t size = mCurrent == nullptr ? mBlockSize : std::min(2 * mCurrent->size, 64 * mBlockSize);
+                size = std::max(size, need);
+                next = new(mUpstream->allocate(size, CACHE_LINE_SIZE)) detail::BlockHeader{nullptr, size};
+                mHeld += size;
+                if (mCurrent == nullptr) {
+                    mFirst = next;
+                } else {
+                    mCurrent->next = next;
+                }
+            }
+            enter(next);
+            return mCursor;
+        }
+
+        std::pmr::memory_resource *mUpstream;
+        std::size_t mBlockSize;
+        detail::BlockHeader *mFirst;
+        detail::BlockHeader *mCurrent;
+        char *mCursor;
+        char *mEnd;
+        std::size_t mUsed;
+        std::size_t mHeld;
+
+    }; // MonotonicArena class
+
+    /**
+     * Rewinds an arena to where it was when the scope began
+     */
+    class ArenaScope {
+    public:
+        explicit ArenaScope(MonotonicArena &arena) : mArena(arena), mMark(arena.mark()) {}
+
+        ArenaScope(const ArenaScope &) = delete;
+
+        ArenaScope &operator=(const ArenaScope &) = delete;
+
+        ~ArenaScope() { mArena.rewind(mMark); }
+
+    private:
+        MonotonicArena &mArena;
+        MonotonicArena::Mark mMark;
+
+    }; // ArenaScope class
+
+    class FixedPool : public std::pmr::memory_resource {
+    public:
+        /**
+         * Constructor, takes no memory until the first allocation
+         *
+         * @param blockSize the largest request the pool serves itself, rounded up to a multiple of
+         * alignof(std::max_align_t). Blocks are aligned to the largest power of two dividing that,
+         * up to a cache line.
+         * @param blocksPerSlab how many blocks to take from upstream at a time
+         * @param upstream where the slabs come from, and where requests the pool does not serve go
+         */
+        explicit FixedPool(std::size_t blockSize, std::size_t blocksPerSlab = 256,
+                           std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+                : mUpstream(upstream), mBlockSize(roundUp(std::max(blockSize, sizeof(void *)))),
+                  mAlignment(std::min(CACHE_LINE_SIZE, mBlockSize & (~mBlockSize + 1))),
+                  mBlocksPerSlab(std::max<std::size_t>(blocksPerSlab, 1)), mSlabs(nullptr), mFree(nullptr),
+                  mCursor(nullptr), mEnd(nullptr), mHeld(0), mInUse(0) {}
+
+        FixedPool(const FixedPool &) = delete;
+
+        FixedPool &operator=(const FixedPool &) = delete;
+
+        ~FixedPool() override { release(); }
+
+        /**
+         * Frees every block and returns the slabs upstream. Requests that went upstream are not
+         * tracked and must be deallocated by their owners.
+         */
+        void release() {
+            for (detail::BlockHeader *slab = mSlabs; slab != nullptr;) {
+                detail::BlockHeader *next = slab->next;
+                mUpstream->deallocate(slab, slab->size, CACHE_LINE_SIZE);
+                slab = next;
+            }
+            mSlabs = nullptr;
+            mFree = nullptr;
+            mCursor = mEnd = nullptr;
+            mHeld = mInUse = 0;
+        }
+
+        std::size_t blockSize() const { return mBlockSize; }
+
+        std::size_t blockAlignment() const { return mAlignment; }
+
+        /**
+         * Blocks handed out and not yet deallocated
+         */
+        std::size_t blocksInUse() const { return mInUse; }
+
+        /**
+         * Bytes taken from upstream for slabs
+         */
+        std::size_t memoryUsage() const { return mHeld; }
+
+        std::pmr::memory_resource *upstream() const { return mUpstream; }
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            if (bytes > mBlockSize || alignment > mAlignment) return mUpstream->allocate(bytes, alignment);
+            ++mInUse;
+            if (mFree != nullptr) {
+                FreeBlock *block = mFree;
+                mFree = block->next;
+                return block;
+            }
+            if (mCursor == mEnd) addSlab();
+            void *p = mCursor;
+            mCursor += mBlockSize;
+            return p;
+        }
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+            if (bytes > mBlockSize || alignment > mAlignment) {
+                mUpstream->deallocate(p, bytes, alignment);
+                return;
+            }
+            --mInUse;
+            FreeBlock *block = static_cast<FreeBlock *>(p);
+            block->next = mFree;
+            mFree = block;
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        static std::size_t roundUp(std::size_t size) {
+            const std::size_t unit = alignof(std::max_align_t);
+            return (size + unit - 1) / unit * unit;
+        }
+
+        void addSlab() {
+            const std::size_t size = sizeof(detail::BlockHeader) + mBlockSize * mBlocksPerSlab;
+            detail::BlockHeader *slab = new(mUpstream->allocate(size, CACHE_LINE_SIZE)) detail::BlockHeader{mSlabs, size};
+            mSlabs = slab;
+            mHeld += size;
+            mCursor = detail::blockBegin(slab);
+            mEnd = detail::blockEnd(slab);
+        }
+
+        std::pmr::memory_resource *mUpstream;
+        std::size_t mBlockSize;
+        std::size_t mAlignment;
+        std::size_t mBlocksPerSlab;
+        detail::BlockHeader *mSlabs;
+        FreeBlock *mFree;
+        char *mCursor;
+        char *mEnd;
+        std::size_t mHeld;
+        std::size_t mInUse;
+
+    }; // FixedPool class
+
+};// namespace graph_algo
+
+
+#endif /* MEMORYARENA_H_ */
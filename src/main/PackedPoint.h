@@ -0,0 +1,228 @@
+#ifndef PACKEDPOINT_H_
+#define PACKEDPOINT_H_
+
+#include <cmath>
+#include <type_traits>
+#include "Point.h"
+#include "Precision.h"
+#include "Tolerance.h"
+
+/**
+ * A non-polymorphic counterpart of Point, meant for bulk geometry.
+ * It offers the same operators as Point but has no virtual functions,
+ * so a PackedPoint is standard-layout, trivially copyable and holds
+ * nothing but its two coordinates. Arrays of them can be copied with
+ * memcpy and every operator can be inlined into the calling loop.
+ * It is a literal type: the arithmetic is constexpr, so fixed shapes
+ * and offset tables can be computed at compile time.
+ *
+ * The comparison operators use the Tolerance policy (see Tolerance.h)
+ * instead of a per point epsilon. Integral coordinates compare exactly
+ * by default.
+ */
+
+namespace graph_algo {
+
+    template<class T = double, class Tolerance = typename DefaultTolerance<T>::type>
+    class PackedPoint final {
+    public:
+
+        /**
+         * Default constructor
+         * Sets all values to 0.0.
+         */
+        constexpr PackedPoint() noexcept : mX(T()), mY(T()) {}
+
+        /**
+         * Constructor, sets x and y position
+         */
+        constexpr PackedPoint(const T x, const T y) noexcept : mX(x), mY(y) {}
+
+        /**
+         * Conversion from the polymorphic Point. The epsilon of p is dropped.
+         */
+        template<class PointTolerance>
+        explicit PackedPoint(const Point<T, PointTolerance> &p) noexcept : mX(p.getX()), mY(p.getY()) {}
+
+        /**
+         * Conversion to the polymorphic Point, using the default epsilon.
+         */
+        Point<T> toPoint() const noexcept {
+            return Point<T>(mX, mY);
+        }
+
+        /**
+         * Compare (less than) operator
+         * Checks if this points distance from origin is less than other points distance from origin
+         */
+        bool operator<(const PackedPoint &p) const noexcept {
+            return Tolerance::lessLength(*this, p);
+        }
+
+        bool operator>(const PackedPoint &p) const noexcept {
+            return p.operator<(*this);
+        }
+
+        bool operator==(const PackedPoint &p) const noexcept {
+            return Tolerance::equal(*this, p);
+        }
+
+        bool operator!=(const PackedPoint &p) const noexcept {
+            return !operator==(p);
+        }
+
+        bool operator<=(const PackedPoint &p) const noexcept {
+            return (operator==(p) || operator<(p));
+        }
+
+        bool operator>=(const PackedPoint &p) const noexcept {
+            return (operator==(p) || operator>(p));
+        }
+
+        /**
+         * Equality with a tolerance chosen at runtime, e.g. one stored once per container.
+         * @param p The other point.
+         * @param epsilon The coordinates are equal when they differ by less than this, as with the policies.
+         */
+        bool equals(const PackedPoint &p, T epsilon) const noexcept {
+            return std::fabs(double(mX - p.mX)) < epsilon && std::fabs(double(mY - p.mY)) < epsilon;
+        }
+
+        /**
+         * Point-wise addition
+         * @param p The other point which we want to add to
+         * @return Returns a new PackedPoint which is the sum of the two points
+         */
+        constexpr PackedPoint operator+(const PackedPoint &p) const noexcept {
+            return PackedPoint(mX + p.mX, mY + p.mY);
+        }
+
+        /**
+         * Point-wise subtraction
+         * @param p The other point which we want this point to be subtracted from.
+         * @return Returns a new PackedPoint which the result of this point minus the other point
+         */
+        constexpr PackedPoint operator-(const PackedPoint &p) const noexcept {
+            return PackedPoint(mX - p.mX, mY - p.mY);
+        }
+
+        /**
+         * Multiplication with a scalar
+         * @param scalar The scalar whom we want to multiply this point with.
+         * @return Returns a new PackedPoint which is this point multiplicated by the scalar.
+         */
+        constexpr PackedPoint operator*(T scalar) const noexcept {
+            return PackedPoint(mX * scalar, mY * scalar);
+        }
+
+        /**
+         * Division with a scalar
+         * @param scalar The scalar whom we want to divide this point with.
+         * @return Returns a new PackedPoint which is this point divided by the scalar.
+         */
+        constexpr PackedPoint operator/(T scalar) const noexcept {
+            return PackedPoint(mX / scalar, mY / scalar);
+        }
+
+        /**
+         * Distance of p and this point.
+         * @param p The other point.
+         * @return Returns the distance between this point and the other point.
+         */
+        T operator|(const PackedPoint &p) const noexcept {
+            return std::hypot(p.mX - mX, p.mY - mY);
+        }
+
+        /**
+         * Calculates the scalar product (= dot product) of two points.
+         * @param p The other point which we want to do scalar product with.
+         * @return Returns the scalar product of this point and the other point p.
+         */
+        constexpr T operator^(const PackedPoint &p) const noexcept {
+            return mX * p.mX + mY * p.mY;
+        }
+
+        /**
+         * Calculates the cross product of two points/vectors.
+         * @param p The other point which we want to do cross product with.
+         * @return Returns the cross product of this point and the other point p.
+         */
+        constexpr T operator&(const PackedPoint &p) const noexcept {
+            return (mX * p.mY) - (p.mX * mY);
+        }
+
+        /**
+         * Length of the vector
+         * @return Returns the length of the vector (or this point from origin).
+         */
+        double length() const noexcept {
+            return std::hypot(mX, mY);
+        }
+
+        /**
+         * Squared length of the vector, orders points like length() but without the square root.
+         * @return Returns the squared length of the vector (or this point from origin).
+         */
+        constexpr T squaredLength() const noexcept {
+            return mX * mX + mY * mY;
+        }
+
+        /**
+         * A monotone stand-in for angle() in (-2, 2], orders points like angle() but without trigonometry.
+         * @return Returns the pseudo-angle of this point in relation to the origin.
+         */
+        double pseudoAngle() const noexcept {
+            return pseudoAtan2(double(mY), double(mX));
+        }
+
+        /**
+         * The angle of this point in relation to the origin.
+         * @return Returns the angle of this point in relation to the origin.
+         */
+        double angle() const noexcept {
+            return angle(T(), T());
+        }
+
+        /**
+         * The angle of this point in relation to another points coordinates
+         * @param cX The x-coordinate for the center-point
+         * @param cY The y-coordinate for the center-point
+         * @return Returns the angle between this point in relation to the given coordinates.
+         */
+        double angle(T cX, T cY) const noexcept {
+            return std::atan2(mY - cY, mX - cX);
+        }
+
+        /**
+         * The angle of this point in relation to another point.
+         * @param p The point that we want to calculate the angle from. (This is usually the origin)
+         * @return Returns the angle between this point and the given point.
+         */
+        double angle(const PackedPoint &p) const noexcept {
+            return angle(p.mX, p.mY);
+        }
+
+        constexpr void setX(T x) noexcept { mX = x; }
+
+        constexpr void setY(T y) noexcept { mY = y; }
+
+        constexpr T getX() const noexcept { return mX; }
+
+        constexpr T getY() const noexcept { return mY; }
+
+    private:
+        T mX, mY;
+
+    }; // PackedPoint class
+
+    static_assert(std::is_standard_layout<PackedPoint<double> >::value,
+                  "PackedPoint must stay standard-layout");
+    static_assert(std::is_trivially_copyable<PackedPoint<double> >::value,
+                  "PackedPoint must stay trivially copyable");
+    static_assert(sizeof(PackedPoint<double>) == 2 * sizeof(double),
+                  "PackedPoint must hold nothing but its coordinates");
+
+};// namespace graph_algo
+
+
+#endif /* PACKEDPOINT_H_ */
@@ -2,6 +2,8 @@
 #define POINT_H_
 
 #include <cmath>
+#include "Precision.h"
+#include "Tolerance.h"
 
 /**
  * This Point class can be used to for geometrical calculation.
@@ -15,6 +17,14 @@
  * - get distance to another point
  * - the angle of this point/vector
  *
+ * The comparison operators use the Tolerance policy (see Tolerance.h).
+ * By default a point stores its own epsilon, except that integral
+ * coordinates compare exactly, e.g. Point<int64_t>. With any other policy
+ * a point stores only its coordinates.
+ *
+ * None of the operations throw. Point is polymorphic and so cannot be
+ * used in constant expressions, PackedPoint is its constexpr counterpart.
+ *
  * Created on: Dec 10, 2012
  *
  * @version 0.9
@@ -24,35 +34,66 @@
 
 namespace graph_algo {
 
-    static const double DEFAULT_EPSILON = 0.00000000001;
+    namespace detail {
+
+        /*
+         * The epsilon of a Point, nothing but the policy's unless the policy is StoredTolerance,
+         * which also gives the Point setEpsilon
+         */
+        template<class T, class Tolerance>
+        class PointEpsilon {
+        protected:
+            T epsilon() const noexcept { return T(Tolerance::epsilon()); }
+        };
+
+        template<class T>
+        class PointEpsilon<T, StoredTolerance> {
+        public:
+            virtual void setEpsilon(double epsilon) { mEPSILON = T(epsilon); }
+
+        protected:
+            PointEpsilon() noexcept : mEPSILON(DEFAULT_EPSILON) {}
+
+            explicit PointEpsilon(const T epsilon) noexcept : mEPSILON(epsilon) {}
+
+            virtual ~PointEpsilon() {}
+
+            T epsilon() const noexcept { return mEPSILON; }
+
+        private:
+            T mEPSILON;
+        };
+
+    }; // namespace detail
+
+    template<class T = double, class Tolerance = typename DefaultPointTolerance<T>::type>
+    class Point : public detail::PointEpsilon<T, Tolerance> {
+        typedef detail::PointEpsilon<T, Tolerance> Epsilon;
 
-    template<class T = double>
-    class Point {
     public:
 
         /**
          * Default constructor
          * Sets all values to 0.0.
          */
-        Point() : mX(T()), mY(T()), mEPSILON(DEFAULT_EPSILON) {}
+        Point() noexcept : mX(T()), mY(T()) {}
 
         /**
          * Constructor, sets x and y position
          */
-        Point(const T x, const T y) : mX(x), mY(y), mEPSILON(DEFAULT_EPSILON) {}
+        Point(const T x, const T y) noexcept : mX(x), mY(y) {}
 
         /**
-         * Constructor, sets x, y positions and epsilon
+         * Constructor, sets x, y positions and epsilon, only with StoredTolerance
          */
-        Point(const T x, const T y, const T epsilon) : mX(x), mY(y), mEPSILON(epsilon) {}
+        Point(const T x, const T y, const T epsilon) noexcept : Epsilon(epsilon), mX(x), mY(y) {}
 
         /**
          * Copy constructor
          */
-        Point(const Point &other) {
+        Point(const Point &other) : Epsilon(other) {
             mX = other.mX;
             mY = other.mY;
-            mEPSILON = other.mEPSILON;
         }
 
         /**
@@ -80,15 +121,15 @@ namespace graph_algo {
          * 		otherwise false
          */
         virtual bool operator<(const Point &p) const {
-            return length() < p.length() && (fabs(length() - p.length()) > std::max(mEPSILON, p.mEPSILON));
+            return Tolerance::lessLength(*this, p);
         }
 
         virtual bool operator>(const Point &p) const {
-            return length() > p.length() && (fabs(length() - p.length()) > std::max(mEPSILON, p.mEPSILON));
+            return Tolerance::lessLength(p, *this);
         }
 
         virtual bool operator==(const Point &p) const {
-            return (fabs(mX - p.mX) < mEPSILON && fabs(mY - p.mY) < mEPSILON);
+            return Tolerance::equal(*this, p);
         }
 
         virtual bool operator<=(const Point &p) const {
@@ -104,7 +145,7 @@ namespace graph_algo {
          * @param p The other point which we want to add to
          * @return Returns a new Point which is the sum of the two points
          */
-        virtual Point operator+(const Point &p) const {
+        virtual Point operator+(const Point &p) const noexcept {
             return Point(mX + p.mX, mY + p.mY);
         }
 
@@ -113,7 +154,7 @@ namespace graph_algo {
          * @param p The other point which we want this point to be subtracted from.
          * @return Returns a new Point which the result of this point minus the other point
          */
-        virtual Point operator-(const Point &p) const {
+        virtual Point operator-(const Point &p) const noexcept {
             return Point(mX - p.mX, mY - p.mY);
         }
 
@@ -122,7 +163,7 @@ namespace graph_algo {
          * @param scalar The scalar whom we want to multiply this point with.
          * @return Returns a new Point which is this point multiplicated by the scalar.
          */
-        virtual Point operator*(T scalar) const {
+        virtual Point operator*(T scalar) const noexcept {
             return Point(mX * scalar, mY * scalar);
         }
 
@@ -131,7 +172,7 @@ namespace graph_algo {
          * @param scalar The scalar whom we want to divide this point with.
          * @return Returns a new Point which is this point divided by the scalar.
          */
-        virtual Point operator/(T scalar) const {
+        virtual Point operator/(T scalar) const noexcept {
             return Point(mX / scalar, mY / scalar);
         }
 
@@ -140,7 +181,7 @@ namespace graph_algo {
          * @param p The other point.
          * @return Returns the distance between this point and the other point.
          */
-        virtual T operator|(const Point &p) const {
+        virtual T operator|(const Point &p) const noexcept {
             return hypot(p.mX - mX, p.mY - mY);
         }
 
@@ -149,7 +190,7 @@ namespace graph_algo {
          * @param p The other point which we want to do scalar product with.
          * @return Returns the scalar product of this point and the other point p.
          */
-        virtual T operator^(const Point &p) const {
+        virtual T operator^(const Point &p) const noexcept {
             return mX * p.mX + mY * p.mY;
         }
 
@@ -158,7 +199,7 @@ namespace graph_algo {
          * @param p The other point which we want to do cross product with.
          * @return Returns the cross product of this point and the other point p.
          */
-        virtual T operator&(const Point &p) const {
+        virtual T operator&(const Point &p) const noexcept {
             return (mX * p.mY) - (p.mX * mY);
         }
 
@@ -166,15 +207,31 @@ namespace graph_algo {
          * Length of the vector
          * @return Returns the length of the vector (or this point from origin).
          */
-        virtual double length() const {
+        virtual double length() const noexcept {
             return hypot(mX, mY);
         }
 
+        /**
+         * Squared length of the vector, orders points like length() but without the square root.
+         * @return Returns the squared length of the vector (or this point from origin).
+         */
+        virtual T squaredLength() const noexcept {
+            return mX * mX + mY * mY;
+        }
+
+        /**
+         * A monotone stand-in for angle() in (-2, 2], orders points like angle() but without trigonometry.
+         * @return Returns the pseudo-angle of this point in relation to the origin.
+         */
+        virtual double pseudoAngle() const noexcept {
+            return pseudoAtan2(double(mY), double(mX));
+        }
+
         /**
          * The angle of this point in relation to the origin.
          * @return Returns the angle of this point in relation to the origin.
          */
-        virtual double angle() const {
+        virtual double angle() const noexcept {
             return angle(T(), T());
         }
 
@@ -184,7 +241,7 @@ namespace graph_algo {
          * @param cY The y-coordinate for the center-point
          * @return Returns the angle between this point in relation to the given coordinates.
          */
-        virtual double angle(T cX, T cY) const {
+        virtual double angle(T cX, T cY) const noexcept {
             return atan2(mY - cY, mX - cX);
         }
 
@@ -193,7 +250,7 @@ namespace graph_algo {
          * @param p The point that we want to calculate the angle from. (This is usually the origin)
          * @return Returns the angle between this point and the given point.
          */
-        virtual double angle(const Point &p) const {
+        virtual double angle(const Point &p) const noexcept {
             return angle(p.mX, p.mY);
         }
 
@@ -201,16 +258,17 @@ namespace graph_algo {
 
         virtual void setY(double y) { mY = y; }
 
-        virtual void setEpsilon(double epsilon) { mEPSILON = epsilon; }
-
-        virtual T getX() const { return mX; }
+        virtual T getX() const noexcept { return mX; }
 
-        virtual T getY() const { return mY; }
+        virtual T getY() const noexcept { return mY; }
 
-        virtual T getEpsilon() const { return mEPSILON; }
+        /**
+         * The epsilon of this point, or of the Tolerance policy, 0 for exact comparison
+         */
+        virtual T getEpsilon() const noexcept { return Epsilon::epsilon(); }
 
     private:
-        T mX, mY, mEPSILON;
+        T mX, mY;
 
 
     }; // Point class
@@ -0,0 +1,363 @@
+#ifndef POINTBUFFER_H_
+#define POINTBUFFER_H_
+
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+#include "AlignedAllocator.h"
+#include "PackedPoint.h"
+#include "Precision.h"
+#include "SimdKernels.h"
+
+/**
+ * A structure-of-arrays container of points.
+ * The x and y coordinates are kept in two separate, cache line aligned arrays,
+ * which lets the bulk operations below run as SIMD loops over many points at once.
+ * The bulk operations are the batch counterparts of the Point operators:
+ * - translation (+=, -=)
+ * - scalar multiplication and division (*=, /=)
+ * - scalar product with a point (dot)
+ * - cross product with a point (cross)
+ * - length of every vector (lengths)
+ * - distance from every point to a point (distances)
+ * - angle of every point (angles)
+ *
+ * For double coordinates the work is done by the runtime dispatched kernels in SimdKernels.h.
+ *
+ * lengths, distances and angles take a precision mode from Precision.h as template argument.
+ * lengths and distances default to FastPrecision, which is not bit for bit the hypot of
+ * Point::length(), and angles to ExactPrecision.
+ * squaredLengths, squaredDistances and pseudoAngles give keys that order like them, for sorting.
+ *
+ * A PointBuffer constructed with a std::pmr::memory_resource keeps its coordinates there, e.g. in a
+ * MonotonicArena for per-query scratch. Copies go back to the heap.
+ */
+
+namespace graph_algo {
+
+    namespace detail {
+
+        template<class T>
+        inline void translate(T *xs, T *ys, std::size_t n, T dx, T dy) {
+            for (std::size_t i = 0; i < n; ++i) {
+                xs[i] += dx;
+                ys[i] += dy;
+            }
+        }
+
+        inline void translate(double *xs, double *ys, std::size_t n, double dx, double dy) {
+            simd::kernels().translate(xs, ys, n, dx, dy);
+        }
+
+        template<class T>
+        inline void scale(T *xs, T *ys, std::size_t n, T s) {
+            for (std::size_t i = 0; i < n; ++i) {
+                xs[i] *= s;
+                ys[i] *= s;
+            }
+        }
+
+        inline void scale(double *xs, double *ys, std::size_t n, double s) {
+            simd::kernels().scale(xs, ys, n, s);
+        }
+
+        template<class T>
+        inline void divide(T *xs, T *ys, std::size_t n, T s) {
+            for (std::size_t i = 0; i < n; ++i) {
+                xs[i] /= s;
+                ys[i] /= s;
+            }
+        }
+
+        inline void divide(double *xs, double *ys, std::size_t n, double s) {
+            simd::kernels().divide(xs, ys, n, s);
+        }
+
+        template<class T>
+        inline void dot(const T *xs, const T *ys, std::size_t n, T px, T py, T *out) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = xs[i] * px + ys[i] * py;
+            }
+        }
+
+        inline void dot(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+            simd::kernels().dot(xs, ys, n, px, py, out);
+        }
+
+        template<class T>
+        inline void cross(const T *xs, const T *ys, std::size_t n, T px, T py, T *out) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = xs[i] * py - px * ys[i];
+            }
+        }
+
+        inline void cross(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+            simd::kernels().cross(xs, ys, n, px, py, out);
+        }
+
+        template<class Precision, class T, class R>
+        inline void distance(Precision, const T *xs, const T *ys, std::size_t n, T px, T py, R *out) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = R(Precision::hypot(double(xs[i] - px), double(ys[i] - py)));
+            }
+        }
+
+        inline void distance(FastPrecision, const double *xs, const double *ys, std::size_t n, double px, double py,
+                             double *out) {
+            simd::kernels().distance(xs, ys, n, px, py, out);
+        }
+
+        inline void distance(ApproxPrecision, const double *xs, const double *ys, std::size_t n, double px, double py,
+                             double *out) {
+            simd::kernels().distance(xs, ys, n, px, py, out);
+        }
+
+        template<class T>
+        inline void squaredDistance(const T *xs, const T *ys, std::size_t n, T px, T py, T *out) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const T dx = xs[i] - px, dy = ys[i] - py;
+                out[i] = dx * dx + dy * dy;
+            }
+        }
+
+        template<class Precision, class T>
+        inline void angle(Precision, const T *xs, const T *ys, std::size_t n, T cx, T cy, double *out) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = Precision::atan2(double(ys[i] - cy), double(xs[i] - cx));
+            }
+        }
+
+        inline void angle(ApproxPrecision, const double *xs, const double *ys, std::size_t n, double cx, double cy,
+                          double *out) {
+            simd::kernels().angle(xs, ys, n, cx, cy, out);
+        }
+
+        template<class T>
+        inline void pseudoAngle(const T *xs, const T *ys, std::size_t n, T cx, T cy, double *out) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = pseudoAtan2(double(ys[i] - cy), double(xs[i] - cx));
+            }
+        }
+
+    }; // namespace detail
+
+    template<class T = double>
+    class PointBuffer {
+    public:
+        typedef PackedPoint<T> point_type;
+        typedef std::vector<T, AlignedAllocator<T> > array_type;
+
+        PointBuffer() {}
+
+        /**
+         * Constructor, holds n points at the origin
+         */
+        explicit PointBuffer(std::size_t n) : mXs(n), mYs(n) {}
+
+        /**
+         * Constructor, an empty buffer that takes its memory from resource
+         */
+        explicit PointBuffer(std::pmr::memory_resource *resource)
+                : mXs(AlignedAllocator<T>(resource)), mYs(AlignedAllocator<T>(resource)) {}
+
+        /**
+         * Constructor, n points at the origin in memory from resource
+         */
+        PointBuffer(std::size_t n, std::pmr::memory_resource *resource)
+                : mXs(n, T(), AlignedAllocator<T>(resource)), mYs(n, T(), AlignedAllocator<T>(resource)) {}
+
+        /**
+         * Constructor, copies the coordinates of any point type with getX() and getY()
+         */
+        template<class P>
+        explicit PointBuffer(const std::vector<P> &points) : mXs(points.size()), mYs(points.size()) {
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                mXs[i] = points[i].getX();
+                mYs[i] = points[i].getY();
+            }
+        }
+
+        std::size_t size() const { return mXs.size(); }
+
+        /**
+         * Where the coordinates live, null for the heap
+         */
+        std::pmr::memory_resource *resource() const { return mXs.get_allocator().resource(); }
+
+        bool empty() const { return mXs.empty(); }
+
+        void reserve(std::size_t n) {
+            mXs.reserve(n);
+            mYs.reserve(n);
+        }
+
+        void resize(std::size_t n) {
+            mXs.resize(n);
+            mYs.resize(n);
+        }
+
+        void clear() {
+            mXs.clear();
+            mYs.clear();
+        }
+
+        void push_back(T x, T y) {
+            mXs.push_back(x);
+            mYs.push_back(y);
+        }
+
+        void push_back(const point_type &p) {
+            push_back(p.getX(), p.getY());
+        }
+
+        point_type operator[](std::size_t i) const {
+            return point_type(mXs[i], mYs[i]);
+        }
+
+        void set(std::size_t i, const point_type &p) {
+            mXs[i] = p.getX();
+            mYs[i] = p.getY();
+        }
+
+        T *xs() { return mXs.data(); }
+
+        const T *xs() const { return mXs.data(); }
+
+        T *ys() { return mYs.data(); }
+
+        const T *ys() const { return mYs.data(); }
+
+        /**
+         * Translates every point by p
+         */
+        PointBuffer &operator+=(const point_type &p) {
+            detail::translate(xs(), ys(), size(), p.getX(), p.getY());
+            return *this;
+        }
+
+        /**
+         * Translates every point by -p
+         */
+        PointBuffer &operator-=(const point_type &p) {
+            detail::translate(xs(), ys(), size(), T(-p.getX()), T(-p.getY()));
+            return *this;
+        }
+
+        /**
+         * Multiplies every point with a scalar
+         */
+        PointBuffer &operator*=(T scalar) {
+            detail::scale(xs(), ys(), size(), scalar);
+            return *this;
+        }
+
+        /**
+         * Divides every point with a scalar
+         */
+        PointBuffer &operator/=(T scalar) {
+            detail::divide(xs(), ys(), size(), scalar);
+            return *this;
+        }
+
+        /**
+         * Scalar product of every point with p.
+         * @param p The other point.
+         * @param out Receives size() values, out[i] = (*this)[i] ^ p
+         */
+        void dot(const point_type &p, T *out) const {
+            detail::dot(xs(), ys(), size(), p.getX(), p.getY(), out);
+        }
+
+        /**
+         * Cross product of every point with p.
+         * @param p The other point.
+         * @param out Receives size() values, out[i] = (*this)[i] & p
+         */
+        void cross(const point_type &p, T *out) const {
+            detail::cross(xs(), ys(), size(), p.getX(), p.getY(), out);
+        }
+
+        /**
+         * Length of every vector.
+         * @param out Receives size() values, out[i] = (*this)[i].length() with ExactPrecision,
+         *      within a few ulps of it with the default FastPrecision
+         */
+        template<class Precision = FastPrecision>
+        void lengths(double *out) const {
+            detail::distance(Precision(), xs(), ys(), size(), T(), T(), out);
+        }
+
+        /**
+         * Distance from every point to p.
+         * @param p The other point.
+         * @param out Receives size() values, out[i] = (*this)[i] | p with ExactPrecision,
+         *      within a few ulps of it with the default FastPrecision
+         */
+        template<class Precision = FastPrecision>
+        void distances(const point_type &p, T *out) const {
+            detail::distance(Precision(), xs(), ys(), size(), p.getX(), p.getY(), out);
+        }
+
+        /**
+         * Squared length of every vector.
+         * @param out Receives size() values, out[i] = (*this)[i].squaredLength()
+         */
+        void squaredLengths(T *out) const {
+            detail::squaredDistance(xs(), ys(), size(), T(), T(), out);
+        }
+
+        /**
+         * Squared distance from every point to p.
+         * @param p The other point.
+         * @param out Receives size() values, out[i] = squaredDistance((*this)[i], p)
+         */
+        void squaredDistances(const point_type &p, T *out) const {
+            detail::squaredDistance(xs(), ys(), size(), p.getX(), p.getY(), out);
+        }
+
+        /**
+         * The angle of every point in relation to the origin.
+         * @param out Receives size() values, out[i] = (*this)[i].angle()
+         */
+        template<class Precision = ExactPrecision>
+        void angles(double *out) const {
+            angles<Precision>(point_type(), out);
+        }
+
+        /**
+         * The angle of every point in relation to a center point.
+         * @param center The point that we want to calculate the angles from.
+         * @param out Receives size() values, out[i] = (*this)[i].angle(center)
+         */
+        template<class Precision = ExactPrecision>
+        void angles(const point_type &center, double *out) const {
+            detail::angle(Precision(), xs(), ys(), size(), center.getX(), center.getY(), out);
+        }
+
+        /**
+         * The pseudo-angle of every point in relation to the origin.
+         * @param out Receives size() values, out[i] = (*this)[i].pseudoAngle()
+         */
+        void pseudoAngles(double *out) const {
+            pseudoAngles(point_type(), out);
+        }
+
+        /**
+         * The pseudo-angle of every point in relation to a center point.
+         * @param center The point that we want to calculate the pseudo-angles from.
+         * @param out Receives size() values, out[i] = pseudoAngle((*this)[i], center)
+         */
+        void pseudoAngles(const point_type &center, double *out) const {
+            detail::pseudoAngle(xs(), ys(), size(), center.getX(), center.getY(), out);
+        }
+
+    private:
+        array_type mXs, mYs;
+
+    }; // PointBuffer class
+
+};// namespace graph_algo
+
+
+#endif /* POINTBUFFER_H_ */
@@ -0,0 +1,413 @@
+#ifndef POINTINPOLYGON_H_
+#define POINTINPOLYGON_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Graph.h"
+#include "PointBuffer.h"
+#include "Polygon.h"
+
+/**
+ * Point in polygon tests for many points against one polygon or many, such as positions
+ * against geofencing zones.
+ *
+ * Every polygon is a Polygon or a PolygonSet read with the even-odd rule. It is cut into
+ * horizontal slabs of equal height, and each slab keeps copies of the edges that cross its
+ * range of y as separate arrays: lowest y, highest y, x at the lowest y and dx / dy. A test
+ * finds the slab of the point and counts the edges right of the point in one branch free
+ * loop over the slab, which the compiler vectorizes. There is a slab per four edges, or
+ * fewer where long edges would be copied into too many of them, so a slab holds a handful
+ * of edges and a test no longer walks all edges of the polygon like plain ray casting.
+ *
+ * With many polygons a uniform grid over their bounding boxes finds the candidates: each
+ * cell lists the polygons whose box overlaps it, in the order of their ids. Large batches
+ * are bucketed by cell first, so that consecutive points read the same polygons from cache.
+ *
+ * An edge counts for the y in [lowest y, highest y), so a point on the boundary is inside
+ * or outside depending on the side its rounding falls on, as with ray casting.
+ *
+ * A locator does not change after construction, so any number of threads may query it.
+ * The batch queries split the points over threads themselves.
+ */
+
+namespace graph_algo {
+
+    /**
+     * Batches smaller than this per thread are not worth splitting
+     */
+    static const std::size_t PARALLEL_LOCATE_GRAIN = 1 << 14;
+
+    template<class T = double>
+    class PolygonLocator {
+    public:
+        static const std::uint32_t NO_POLYGON = std::numeric_limits<std::uint32_t>::max();
+
+        PolygonLocator() {
+            buildGrid();
+        }
+
+        /**
+         * Constructor, a single polygon with id 0
+         */
+        explicit PolygonLocator(const Polygon<T> &polygon) {
+            addPolygon(detail::ringView(polygon));
+            buildGrid();
+        }
+
+        explicit PolygonLocator(const PolygonSet<T> &polygons) {
+            addPolygon(detail::ringView(polygons));
+            buildGrid();
+        }
+
+        /**
+         * Constructor, polygons[i] gets id i. P is Polygon<T> or PolygonSet<T>.
+         */
+        template<class P>
+        explicit PolygonLocator(const std::vector<P> &polygons) {
+            mZones.reserve(polygons.size());
+            for (std::size_t i = 0; i < polygons.size(); ++i) addPolygon(detail::ringView(polygons[i]));
+            buildGrid();
+        }
+
+        /**
+         * The number of polygons
+         */
+        std::size_t size() const { return mZones.size(); }
+
+        bool empty() const { return mZones.empty(); }
+
+        std::size_t memoryUsage() const {
+            return mZones.capacity() * sizeof(Zone) + mSlabStarts.capacity() * sizeof(std::size_t) +
+                   (mLows.capacity() + mHighs.capacity() + mXs.capacity() + mSlopes.capacity()) * sizeof(T) +
+                   mCellStarts.capacity() * sizeof(std::size_t) + mCellZones.capacity() * sizeof(std::uint32_t);
+        }
+
+        /**
+         * Whether (x, y) is inside the given polygon
+         */
+        bool contains(std::uint32_t polygon, T x, T y) const {
+            return inside(mZones[polygon], x, y);
+        }
+
+        template<class P>
+        bool contains(std::uint32_t polygon, const P &p) const {
+            return contains(polygon, T(p.getX()), T(p.getY()));
+        }
+
+        /**
+         * The lowest id of the polygons that contain (x, y), NO_POLYGON if there is none
+         */
+        std::uint32_t locate(T x, T y) const {
+            std::size_t first, last;
+            if (!candidates(x, y, first, last)) return NO_POLYGON;
+            for (std::size_t i = first; i < last; ++i) {
+                if (inside(mZones[mCellZones[i]], x, y)) return mCellZones[i];
+            }
+            return NO_POLYGON;
+        }
+
+        template<class P>
+        std::uint32_t locate(const P &p) const {
+            return locate(T(p.getX()), T(p.getY()));
+        }
+
+        /**
+         * Appends the ids of all polygons that contain (x, y) to out, in increasing order.
+         * @return Returns the number of ids appended.
+         */
+        std::size_t locateAll(T x, T y, std::vector<std::uint32_t> &out) const {
+            std::size_t first, last, found = 0;
+            if (!candidates(x, y, first, last)) return 0;
+            for (std::size_t i = first; i < last; ++i) {
+                if (inside(mZones[mCellZones[i]], x, y)) {
+                    out.push_back(mCellZones[i]);
+                    ++found;
+                }
+            }
+            return found;
+        }
+
+        /**
+         * out[i] = whether points[i] is inside the given polygon, for every point
+         * @param threads The number of threads, 0 for one per core.
+         */
+        void contains(std::uint32_t polygon, const PointBuffer<T> &points, std::uint8_t *out,
+                      unsigned threads = 1) const {
+            const Zone &zone = mZones[polygon];
+            const T *xs = points.xs(), *ys = points.ys();
+            const unsigned chunks = detail::chunkCount(points.size(), threads, PARALLEL_LOCATE_GRAIN);
+            detail::forEachChunk(points.size(), chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) out[i] = std::uint8_t(inside(zone, xs[i], ys[i]));
+            });
+        }
+
+        /**
+         * out[i] = locate(points[i]) for every point
+         * @param threads The number of threads, 0 for one per core.
+         */
+        void locate(const PointBuffer<T> &points, std::uint32_t *out, unsigned threads = 1) const {
+            const T *xs = points.xs(), *ys = points.ys();
+            const std::size_t n = points.size(), cells = mColumns * mRows;
+            const unsigned chunks = detail::chunkCount(n, threads, PARALLEL_LOCATE_GRAIN);
+            if (n < cells || mCellZones.empty()) {
+                detail::forEachChunk(n, chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i) out[i] = locate(xs[i], ys[i]);
+                });
+                return;
+            }
+
+            // Bucket the points by cell, so that the points after one another test the same polygons
+            std::vector<std::size_t> starts(cells + 2, 0), order(n);
+            std::vector<std::uint32_t> cellOf(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                cellOf[i] = std::uint32_t(cellAt(xs[i], ys[i]));
+                ++starts[cellOf[i] + 1];
+            }
+            for (std::size_t c = 0; c <= cells; ++c) starts[c + 1] += starts[c];
+            for (std::size_t i = 0; i < n; ++i) order[starts[cellOf[i]]++] = i;
+            // Every start has moved to the end of its cell. The points outside the grid come last and are in no polygon.
+            const std::size_t inGrid = starts[cells - 1];
+            for (std::size_t k = inGrid; k < n; ++k) out[order[k]] = NO_POLYGON;
+            detail::forEachChunk(inGrid, chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                for (std::size_t k = first; k < last; ++k) {
+                    const std::size_t i = order[k], cell = cellOf[i];
+                    std::uint32_t found = NO_POLYGON;
+                    for (std::size_t c = mCellStarts[cell]; c < mCellStarts[cell + 1]; ++c) {
+                        if (inside(mZones[mCellZones[c]], xs[i], ys[i])) {
+                            found = mCellZones[c];
+                            break;
+                        }
+                    }
+                    out[i] = found;
+                }
+            });
+        }
+
+    private:
+        /*
+         * A polygon: its bounding box and its slabs, mSlabStarts[firstSlab, firstSlab + slabs]
+         * are the first edges of each slab and the end of the last one
+         */
+        struct Zone {
+            T minX, minY, maxX, maxY;
+            double inverse; // slabs per unit of y
+            std::size_t slabs, firstSlab;
+        };
+
+        struct Edge {
+            T low, high, x, slope;
+        };
+
+        /*
+         * Slabs and grid cells stop shrinking where they would hold more than this many copies
+         * per edge or per polygon
+         */
+        static const std::size_t MAX_COPIES = 4;
+
+        /*
+         * The slabs to start from, a loop over a few edges costs about as much as finding the slab
+         */
+        static const std::size_t EDGES_PER_SLAB = 4;
+
+        static std::size_t slabOf(const Zone &zone, T y) {
+            return std::min(std::size_t((double(y) - double(zone.minY)) * zone.inverse), zone.slabs - 1);
+        }
+
+        bool inside(const Zone &zone, T x, T y) const {
+            if (!(y >= zone.minY && y < zone.maxY && x >= zone.minX && x <= zone.maxX)) return false;
+            const std::size_t slab = zone.firstSlab + slabOf(zone, y);
+            const std::size_t first = mSlabStarts[slab], last = mSlabStarts[slab + 1];
+            const T *lows = mLows.data(), *highs = mHighs.data(), *xs = mXs.data(), *slopes = mSlopes.data();
+            unsigned crossings = 0;
+            for (std::size_t i = first; i < last; ++i) {
+                crossings += unsigned(lows[i] <= y) & unsigned(y < highs[i]) &
+                             unsigned(x < xs[i] + (y - lows[i]) * slopes[i]);
+            }
+            return (crossings & 1) != 0;
+        }
+
+        void addPolygon(const detail::RingView<T> &rings) {
+            Zone zone = {T(), T(), T(), T(), 0.0, 0, mSlabStarts.size()};
+            std::vector<Edge> edges;
+            bool first = true;
+            for (std::size_t r = 0; r < rings.count(); ++r) {
+                const T *xs = rings.xs + rings.first(r), *ys = rings.ys + rings.first(r);
+                const std::size_t n = rings.size(r);
+                for (std::size_t i = 0, j = n - 1; i < n; j = i++) {
+                    if (first || xs[i] < zone.minX) zone.minX = xs[i];
+                    if (first || ys[i] < zone.minY) zone.minY = ys[i];
+                    if (first || xs[i] > zone.maxX) zone.maxX = xs[i];
+                    if (first || ys[i] > zone.maxY) zone.maxY = ys[i];
+                    first = false;
+                    // Horizontal edges are never crossed
+                    if (ys[i] == ys[j]) continue;
+                    const std::size_t low = ys[i] < ys[j] ? i : j, high = low == i ? j : i;
+                    const Edge edge = {ys[low], ys[high], xs[low], (xs[high] - xs[low]) / (ys[high] - ys[low])};
+                    edges.push_back(edge);
+                }
+            }
+            if (edges.empty()) {
+                // Nothing is inside, the empty box says so
+                zone.minX = zone.minY = zone.maxX = zone.maxY = T();
+                mZones.push_back(zone);
+                return;
+            }
+
+            // Halve the slabs until the edges spanning several of them are copied few enough times
+            const double height = double(zone.maxY) - double(zone.minY);
+            zone.slabs = (edges.size() + EDGES_PER_SLAB - 1) / EDGES_PER_SLAB;
+            while (true) {
+                zone.inverse = double(zone.slabs) / height;
+                std::size_t copies = 0;
+                for (std::size_t e = 0; e < edges.size(); ++e) {
+                    copies += slabOf(zone, edges[e].high) - slabOf(zone, edges[e].low) + 1;
+                }
+                if (copies <= MAX_COPIES * edges.size() || zone.slabs == 1) break;
+                zone.slabs = (zone.slabs + 1) / 2;
+            }
+
+            // Counting sort of the edges into their slabs
+            const std::size_t base = mLows.size();
+            mSlabStarts.resize(zone.firstSlab + zone.slabs + 1, 0);
+            std::size_t *starts = &mSlabStarts[zone.firstSlab];
+            for (std::size_t e = 0; e < edges.size(); ++e) {
+                for (std::size_t s = slabOf(zone, edges[e].low); s <= slabOf(zone, edges[e].high); ++s) ++starts[s + 1];
+            }
+            starts[0] = base;
+            for (std::size_t s = 0; s < zone.slabs; ++s) starts[s + 1] += starts[s];
+            mLows.resize(starts[zone.slabs]);
+            mHighs.resize(starts[zone.slabs]);
+            mXs.resize(starts[zone.slabs]);
+            mSlopes.resize(starts[zone.slabs]);
+            std::vector<std::size_t> next(starts, starts + zone.slabs);
+            for (std::size_t e = 0; e < edges.size(); ++e) {
+                for (std::size_t s = slabOf(zone, edges[e].low); s <= slabOf(zone, edges[e].high); ++s) {
+                    const std::size_t i = next[s]++;
+                    mLows[i] = edges[e].low;
+                    mHighs[i] = edges[e].high;
+                    mXs[i] = edges[e].x;
+                    mSlopes[i] = edges[e].slope;
+                }
+            }
+            mZones.push_back(zone);
+        }
+
+        /*
+         * The grid over the bounding boxes of the polygons, with about one cell per polygon
+         */
+        void buildGrid() {
+            mColumns = mRows = 1;
+            mGridMinX = mGridMinY = mGridMaxX = mGridMaxY = T();
+            mInverseX = mInverseY = 0.0;
+            bool first = true;
+            std::size_t zones = 0;
+            for (std::size_t z = 0; z < mZones.size(); ++z) {
+                const Zone &zone = mZones[z];
+                if (zone.slabs == 0) continue;
+                if (first || zone.minX < mGridMinX) mGridMinX = zone.minX;
+                if (first || zone.minY < mGridMinY) mGridMinY = zone.minY;
+                if (first || zone.maxX > mGridMaxX) mGridMaxX = zone.maxX;
+                if (first || zone.maxY > mGridMaxY) mGridMaxY = zone.maxY;
+                first = false;
+                ++zones;
+            }
+            mCellStarts.assign(2, 0);
+            mCellZones.clear();
+            if (zones == 0) return;
+
+            const double width = double(mGridMaxX) - double(mGridMinX), height = double(mGridMaxY) - double(mGridMinY);
+            double cell = width > 0.0 ? std::sqrt(width * height / double(zones)) : height / double(zones);
+            while (true) {
+                mColumns = std::size_t(std::min(width / cell, 65536.0)) + 1;
+                mRows = std::size_t(std::min(height / cell, 65536.0)) + 1;
+                mInverseX = width > 0.0 ? double(mColumns) / width : 0.0;
+                mInverseY = double(mRows) / height;
+                std::size_t copies = 0;
+                for (std::size_t z = 0; z < mZones.size(); ++z) {
+                    const Zone &zone = mZones[z];
+                    if (zone.slabs == 0) continue;
+                    copies += (column(zone.maxX) - column(zone.minX) + 1) * (row(zone.maxY) - row(zone.minY) + 1);
+                }
+                if (copies <= MAX_COPIES * zones || mColumns * mRows == 1) break;
+                cell *= 2.0;
+            }
+
+            // Counting sort of the polygons into the cells they overlap, in the order of their ids
+            mCellStarts.assign(mColumns * mRows + 1, 0);
+            for (int pass = 0; pass < 2; ++pass) {
+                for (std::size_t z = 0; z < mZones.size(); ++z) {
+                    const Zone &zone = mZones[z];
+                    if (zone.slabs == 0) continue;
+                    for (std::size_t y = row(zone.minY); y <= row(zone.maxY); ++y) {
+                        for (std::size_t x = column(zone.minX); x <= column(zone.maxX); ++x) {
+                            if (pass == 0) {
+                                ++mCellStarts[y * mColumns + x + 1];
+                            } else {
+                                mCellZones[mCellStarts[y * mColumns + x]++] = std::uint32_t(z);
+                            }
+                        }
+                    }
+                }
+                if (pass == 0) {
+                    for (std::size_t c = 0; c < mColumns * mRows; ++c) mCellStarts[c + 1] += mCellStarts[c];
+                    mCellZones.resize(mCellStarts.back());
+                }
+            }
+            // The second pass moved every start to the end of its cell
+            for (std::size_t c = mColumns * mRows; c > 0; --c) mCellStarts[c] = mCellStarts[c - 1];
+            mCellStarts[0] = 0;
+        }
+
+        std::size_t column(T x) const {
+            return std::min(std::size_t((double(x) - double(mGridMinX)) * mInverseX), mColumns - 1);
+        }
+
+        std::size_t row(T y) const {
+            return std::min(std::size_t((double(y) - double(mGridMinY)) * mInverseY), mRows - 1);
+        }
+
+        /*
+         * The cell of (x, y), the number of cells if it is outside the grid
+         */
+        std::size_t cellAt(T x, T y) const {
+            if (!(x >= mGridMinX && x <= mGridMaxX && y >= mGridMinY && y <= mGridMaxY) || mCellZones.empty()) {
+                return mColumns * mRows;
+            }
+            return row(y) * mColumns + column(x);
+        }
+
+        /*
+         * The range of mCellZones that may contain (x, y)
+         */
+        bool candidates(T x, T y, std::size_t &first, std::size_t &last) const {
+            const std::size_t cell = cellAt(x, y);
+            if (cell == mColumns * mRows) return false;
+            first = mCellStarts[cell];
+            last = mCellStarts[cell + 1];
+            return true;
+        }
+
+        std::vector<Zone> mZones;
+        std::vector<std::size_t> mSlabStarts;
+        // The edges of the slabs
+        std::vector<T> mLows;
+        std::vector<T> mHighs;
+        std::vector<T> mXs;
+        std::vector<T> mSlopes;
+
+        T mGridMinX, mGridMinY, mGridMaxX, mGridMaxY;
+        double mInverseX, mInverseY;
+        std::size_t mColumns, mRows;
+        std::vector<std::size_t> mCellStarts;
+        std::vector<std::uint32_t> mCellZones;
+
+    }; // PolygonLocator class
+
+};// namespace graph_algo
+
+
+#endif /* POINTINPOLYGON_H_ */
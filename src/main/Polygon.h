@@ -0,0 +1,378 @@
+#ifndef POLYGON_H_
+#define POLYGON_H_
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+#include "Predicates.h"
+#include "RingIndex.h"
+#include "SimdKernels.h"
+
+/**
+ * A simple polygon, stored as a closed ring of vertices.
+ * The vertices live in a PointBuffer, i.e. in separate aligned x and y arrays,
+ * and are addressed with RingIndex so that the neighbours of the last vertex
+ * wrap around to the first.
+ *
+ * metrics() computes the signed area (shoelace formula), the centroid and the
+ * perimeter in one pass over the vertices. For double coordinates that pass is
+ * the runtime dispatched edgeSums kernel from SimdKernels.h. The coordinates
+ * are taken relative to the first vertex, which keeps the centroid accurate
+ * for polygons far from the origin.
+ *
+ * PolygonSet holds several rings in one buffer, for polygons with holes and
+ * the results of the boolean operations in PolygonClipping.h.
+ */
+
+namespace graph_algo {
+
+    /**
+     * The result of Polygon::metrics()
+     */
+    struct PolygonMetrics {
+        double area; // signed, positive for counterclockwise polygons
+        double centroidX, centroidY;
+        double perimeter;
+    };
+
+    namespace detail {
+
+        template<class T>
+        inline void edgeSums(const T *xs, const T *ys, std::size_t n, double ox, double oy, double *out) {
+            double cross = 0.0, sx = 0.0, sy = 0.0, length = 0.0;
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                const double x0 = double(xs[i]) - ox, y0 = double(ys[i]) - oy;
+                const double x1 = double(xs[i + 1]) - ox, y1 = double(ys[i + 1]) - oy;
+                const double c = x0 * y1 - x1 * y0, dx = x1 - x0, dy = y1 - y0;
+                cross += c;
+                sx += (x0 + x1) * c;
+                sy += (y0 + y1) * c;
+                length += std::sqrt(dx * dx + dy * dy);
+            }
+            out[0] = cross;
+            out[1] = sx;
+            out[2] = sy;
+            out[3] = length;
+        }
+
+        inline void edgeSums(const double *xs, const double *ys, std::size_t n, double ox, double oy, double *out) {
+            simd::kernels().edgeSums(xs, ys, n, ox, oy, out);
+        }
+
+        template<class V>
+        inline int sign(V v) {
+            return (v > V()) - (v < V());
+        }
+
+        /*
+         * Whether the ring of n vertices is convex, see Polygon::isConvex()
+         */
+        template<class T>
+        inline bool isConvexRing(const T *x, const T *y, std::size_t n) {
+            if (n < 3) return false;
+
+            // The turns are between edges of nonzero length, a repeated vertex would hide the turn at it
+            std::size_t h = n - 1;
+            while (h > 0 && x[h] == x[0] && y[h] == y[0]) --h;
+            if (h == 0) return false;
+            int turn = 0, xFlips = 0, yFlips = 0;
+            int xSign = sign(x[0] - x[h]), ySign = sign(y[0] - y[h]);
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t j = i + 1 == n ? 0 : i + 1;
+                if (x[j] == x[i] && y[j] == y[i]) continue;
+                const int t = sign(orient2d(PackedPoint<T>(x[h], y[h]), PackedPoint<T>(x[i], y[i]),
+                                            PackedPoint<T>(x[j], y[j])));
+                h = i;
+                if (t != 0) {
+                    if (turn != 0 && t != turn) return false;
+                    turn = t;
+                }
+                // A convex boundary reverses its x and y direction exactly twice
+                const int sx = sign(x[j] - x[i]), sy = sign(y[j] - y[i]);
+                if (sx != 0) {
+                    xFlips += xSign != 0 && sx != xSign;
+                    xSign = sx;
+                }
+                if (sy != 0) {
+                    yFlips += ySign != 0 && sy != ySign;
+                    ySign = sy;
+                }
+            }
+            return turn != 0 && xFlips <= 2 && yFlips <= 2;
+        }
+
+        /*
+         * Twice the signed area of the ring of n vertices, relative to its first vertex
+         */
+        template<class T>
+        inline double ringCross(const T *xs, const T *ys, std::size_t n) {
+            if (n == 0) return 0.0;
+            double sums[4];
+            edgeSums(xs, ys, n, double(xs[0]), double(ys[0]), sums);
+            return sums[0];
+        }
+
+    }; // namespace detail
+
+    template<class T = double>
+    class Polygon {
+    public:
+        typedef PackedPoint<T> point_type;
+        typedef RingIndex<int> index_type;
+
+        Polygon() {}
+
+        /**
+         * Constructor, copies the vertices of any point type with getX() and getY()
+         */
+        template<class P>
+        explicit Polygon(const std::vector<P> &vertices) : mVertices(vertices) {}
+
+        int size() const { return int(mVertices.size()); }
+
+        bool empty() const { return mVertices.empty(); }
+
+        void reserve(std::size_t n) { mVertices.reserve(n); }
+
+        void clear() { mVertices.clear(); }
+
+        void push_back(T x, T y) { mVertices.push_back(x, y); }
+
+        void push_back(const point_type &p) { mVertices.push_back(p); }
+
+        /**
+         * A RingIndex at vertex i, throws RingIndexOutOfBoundException if i is not a vertex
+         */
+        index_type index(int i) const {
+            return index_type(i, size());
+        }
+
+        point_type operator[](const index_type &i) const {
+            return mVertices[int(i)];
+        }
+
+        /**
+         * The vertex after i, the first vertex follows the last
+         */
+        point_type next(const index_type &i) const {
+            return mVertices[i + 1];
+        }
+
+        /**
+         * The vertex before i, the last vertex precedes the first
+         */
+        point_type prev(const index_type &i) const {
+            return mVertices[i + (size() - 1)];
+        }
+
+        void set(const index_type &i, const point_type &p) { mVertices.set(int(i), p); }
+
+        const T *xs() const { return mVertices.xs(); }
+
+        const T *ys() const { return mVertices.ys(); }
+
+        const PointBuffer<T> &vertices() const { return mVertices; }
+
+        PointBuffer<T> &vertices() { return mVertices; }
+
+        /**
+         * Signed area, centroid and perimeter, computed in a single pass.
+         * A polygon with zero area has the mean of its vertices as centroid.
+         */
+        PolygonMetrics metrics() const {
+            PolygonMetrics m = {0.0, 0.0, 0.0, 0.0};
+            const std::size_t n = mVertices.size();
+            if (n == 0) return m;
+
+            const double ox = double(xs()[0]), oy = double(ys()[0]);
+            double sums[4];
+            detail::edgeSums(xs(), ys(), n, ox, oy, sums);
+
+            // The closing edge from the last vertex back to the first, which is the origin here
+            const double lx = double(xs()[n - 1]) - ox, ly = double(ys()[n - 1]) - oy;
+            sums[3] += std::sqrt(lx * lx + ly * ly);
+
+            m.area = sums[0] / 2.0;
+            m.perimeter = sums[3];
+            if (sums[0] != 0.0) {
+                m.centroidX = ox + sums[1] / (3.0 * sums[0]);
+                m.centroidY = oy + sums[2] / (3.0 * sums[0]);
+            } else {
+                double sx = 0.0, sy = 0.0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    sx += double(xs()[i]) - ox;
+                    sy += double(ys()[i]) - oy;
+                }
+                m.centroidX = ox + sx / double(n);
+                m.centroidY = oy + sy / double(n);
+            }
+            return m;
+        }
+
+        /**
+         * Signed area, positive if the vertices are counterclockwise
+         */
+        double signedArea() const { return metrics().area; }
+
+        double area() const { return std::fabs(signedArea()); }
+
+        double perimeter() const { return metrics().perimeter; }
+
+        PackedPoint<double> centroid() const {
+            const PolygonMetrics m = metrics();
+            return PackedPoint<double>(m.centroidX, m.centroidY);
+        }
+
+        /**
+         * @return Returns 1 if the vertices are counterclockwise, -1 if clockwise and 0 if the area is zero.
+         */
+        int orientation() const {
+            const double a = signedArea();
+            return (a > 0.0) - (a < 0.0);
+        }
+
+        /**
+         * Whether the polygon is convex: every turn goes the same way and the boundary winds once.
+         * Collinear vertices are allowed, polygons with zero area are not convex.
+         */
+        bool isConvex() const {
+            return detail::isConvexRing(xs(), ys(), mVertices.size());
+        }
+
+    private:
+        PointBuffer<T> mVertices;
+
+    }; // Polygon class
+
+    /**
+     * Several rings, e.g. polygons with holes. The vertices of all rings share one PointBuffer
+     * and ring r is the range [first(r), first(r) + size(r)) of it.
+     *
+     * As an input the rings are read with the even-odd rule: a point is inside when it is inside
+     * an odd number of rings, so holes need neither a parent nor an orientation. The results of
+     * PolygonClipper (see PolygonClipping.h) are stricter: outer rings are counterclockwise, holes
+     * are clockwise and parent(r) is the outer ring that hole r lies in, -1 for outer rings.
+     */
+    template<class T = double>
+    class PolygonSet {
+    public:
+        typedef PackedPoint<T> point_type;
+
+        PolygonSet() : mFirsts(1, 0) {}
+
+        /**
+         * Constructor, a single outer ring
+         */
+        explicit PolygonSet(const Polygon<T> &polygon) : mFirsts(1, 0) {
+            addRing(polygon);
+        }
+
+        std::size_t ringCount() const { return mParents.size(); }
+
+        std::size_t vertexCount() const { return mVertices.size(); }
+
+        bool empty() const { return mParents.empty(); }
+
+        std::size_t first(std::size_t r) const { return mFirsts[r]; }
+
+        std::size_t size(std::size_t r) const { return mFirsts[r + 1] - mFirsts[r]; }
+
+        int parent(std::size_t r) const { return mParents[r]; }
+
+        bool isHole(std::size_t r) const { return mParents[r] >= 0; }
+
+        point_type vertex(std::size_t i) const { return mVertices[i]; }
+
+        const T *xs() const { return mVertices.xs(); }
+
+        const T *ys() const { return mVertices.ys(); }
+
+        /**
+         * Removes every ring but keeps the memory for the next rings
+         */
+        void clear() {
+            mVertices.clear();
+            mFirsts.resize(1);
+            mParents.clear();
+        }
+
+        void addRing(const Polygon<T> &polygon, int parent = -1) {
+            for (int i = 0; i < polygon.size(); ++i) mVertices.push_back(polygon.xs()[i], polygon.ys()[i]);
+            closeRing(parent);
+        }
+
+        /**
+         * Appends a vertex to the ring that the next closeRing() call ends
+         */
+        void push_back(T x, T y) { mVertices.push_back(x, y); }
+
+        void closeRing(int parent = -1) {
+            mFirsts.push_back(mVertices.size());
+            mParents.push_back(parent);
+        }
+
+        /**
+         * A copy of ring r
+         */
+        Polygon<T> ring(std::size_t r) const {
+            Polygon<T> polygon;
+            polygon.reserve(size(r));
+            for (std::size_t i = first(r); i < mFirsts[r + 1]; ++i) polygon.push_back(mVertices[i]);
+            return polygon;
+        }
+
+        /**
+         * The sum of the signed areas of the rings, which is the covered area when outer rings
+         * are counterclockwise and holes clockwise.
+         */
+        double signedArea() const {
+            double area = 0.0;
+            for (std::size_t r = 0; r < ringCount(); ++r) area += detail::ringCross(xs() + first(r), ys() + first(r), size(r));
+            return area / 2.0;
+        }
+
+    private:
+        PointBuffer<T> mVertices;
+        std::vector<std::size_t> mFirsts;
+        std::vector<int> mParents;
+
+    }; // PolygonSet class
+
+    namespace detail {
+
+        /*
+         * The rings of a Polygon or of a PolygonSet
+         */
+        template<class T>
+        struct RingView {
+            const T *xs, *ys;
+            const PolygonSet<T> *set; // null for the single ring of a Polygon
+            std::size_t vertices;
+
+            std::size_t count() const { return set ? set->ringCount() : vertices > 0; }
+
+            std::size_t first(std::size_t r) const { return set ? set->first(r) : 0; }
+
+            std::size_t size(std::size_t r) const { return set ? set->size(r) : vertices; }
+        };
+
+        template<class T>
+        inline RingView<T> ringView(const Polygon<T> &polygon) {
+            const RingView<T> view = {polygon.xs(), polygon.ys(), nullptr, std::size_t(polygon.size())};
+            return view;
+        }
+
+        template<class T>
+        inline RingView<T> ringView(const PolygonSet<T> &polygons) {
+            const RingView<T> view = {polygons.xs(), polygons.ys(), &polygons, polygons.vertexCount()};
+            return view;
+        }
+
+    }; // namespace detail
+
+};// namespace graph_algo
+
+
+#endif /* POLYGON_H_ */
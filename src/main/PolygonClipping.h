@@ -0,0 +1,931 @@
+#ifndef POLYGONCLIPPING_H_
+#define POLYGONCLIPPING_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <vector>
+#include "PackedPoint.h"
+#include "Polygon.h"
+#include "Predicates.h"
+#include "RingIndex.h"
+
+/**
+ * Boolean operations on polygons with holes: intersection, union, difference and XOR.
+ * The inputs are a Polygon or a PolygonSet read with the even-odd rule, the result is a
+ * PolygonSet with counterclockwise outer rings, clockwise holes and the outer ring of
+ * every hole as its parent.
+ *
+ * The general case is the sweep line of Martinez, Rueda and Feito, "A simple algorithm
+ * for Boolean operations on polygons" (2013), in two passes. Every edge is an event at its
+ * left and at its right end. The first sweep keeps the edges that cross the sweep line
+ * sorted from bottom to top and splits neighbours where they meet, until edges meet only
+ * at their ends or are equal. Equal edges are then merged into one that toggles both
+ * inputs, or into none when they cancel, and the second sweep gives each edge the inputs
+ * above it from the edge below it. The edges that bound the result are linked into rings.
+ *
+ * The decisions use the exact orient2d of Predicates.h; only the positions of crossings
+ * are rounded. A crossing is computed from the input edges rather than from the parts
+ * already split off them, clamped into both edges, and taken to be an end of either edge
+ * when within rounding distance of it. An end within rounding distance of another edge,
+ * and within its length, splits it. So the edges through one point meet at one point,
+ * which integer coordinates get exactly. Where rounding still leaves edges that cross or
+ * overlap, the result would be wrong and the clip throws PolygonClippingRoundingException
+ * instead: the second sweep tests its neighbours exactly, and an input of n edges that
+ * needs more than 4 n^2 more events to split, more than any pair of edges needs, has
+ * splits going round in circles.
+ *
+ * When both inputs of an intersection are single convex rings the sweep is skipped for
+ * Sutherland-Hodgman: the subject is cut by one edge of the other ring after another.
+ *
+ * PolygonClipper keeps its events, sweep line and rings between calls, and clears the
+ * result instead of replacing it. Once the buffers have grown to the largest input a
+ * clip allocates nothing. Not thread safe, use one clipper per thread.
+ */
+
+namespace graph_algo {
+
+    enum ClipOperation {
+        CLIP_INTERSECTION, CLIP_UNION, CLIP_DIFFERENCE, CLIP_XOR
+    };
+
+    struct PolygonClippingRoundingException : public std::exception {
+        const char *what() const throw() {
+            return "Rounded crossings left edges of the polygons crossing, the clip would be wrong.";
+        }
+
+    };
+
+    namespace detail {
+
+        inline double clipOrient(double ax, double ay, double bx, double by, double cx, double cy) {
+            return orient2d(PackedPoint<double>(ax, ay), PackedPoint<double>(bx, by), PackedPoint<double>(cx, cy));
+        }
+
+        /*
+         * (ax, ay) before (bx, by) in the order of the sweep, by x and then by y
+         */
+        inline bool sweepLess(double ax, double ay, double bx, double by) {
+            return ax < bx || (ax == bx && ay < by);
+        }
+
+        struct ClipEvent {
+            double x, y;
+            int other; // the event at the other end of the edge
+            int edge; // the first of the two events of the input edge this is part of
+            int prevInResult; // the closest edge below that bounds the result, -1 if none
+            int position; // the position of the other end among the result events
+            int outputContour; // the loop of the result
+            unsigned char polygon; // 0 for the subject, 1 for the clipping polygon
+            unsigned char toggles; // bit p set if crossing the edge enters or leaves input p, 0 for repeats of an edge
+            unsigned char inside; // bit p set if just above the edge, left of it if vertical, is inside input p
+            bool left; // the left end of the edge
+            signed char resultTransition; // 1 if the result is above the edge, -1 if below, 0 if not a result edge
+        };
+
+        /*
+         * A ring of the result, the edges mLoopEdges[begin, end) of PolygonClipper
+         */
+        struct ClipLoop {
+            int begin, end;
+            int first; // the position of the lowest edge at the first point in the sweep order
+            int parent; // the loop this one is a hole of, -1 for outer loops
+            int ring; // the ring of the result, -1 if the loop was dropped
+        };
+
+    }; // namespace detail
+
+    template<class T = double>
+    class PolygonClipper {
+    public:
+        PolygonClipper() : mEventLimit(0), mConvex(false) {}
+
+        /**
+         * Writes subject op clipping to result, replacing its rings.
+         * subject and clipping are each a Polygon<T> or a PolygonSet<T>.
+         */
+        template<class A, class B>
+        void clip(const A &subject, const B &clipping, ClipOperation operation, PolygonSet<T> &result) {
+            run(detail::ringView(subject), detail::ringView(clipping), operation, result);
+        }
+
+        template<class A, class B>
+        PolygonSet<T> clip(const A &subject, const B &clipping, ClipOperation operation) {
+            PolygonSet<T> result;
+            clip(subject, clipping, operation, result);
+            return result;
+        }
+
+        /**
+         * Whether the last clip took the Sutherland-Hodgman path for convex rings
+         */
+        bool convexClipped() const { return mConvex; }
+
+    private:
+        typedef detail::ClipEvent Event;
+
+        struct Later {
+            const PolygonClipper *clipper;
+
+            bool operator()(int a, int b) const { return clipper->later(a, b); }
+        };
+
+        void run(const detail::RingView<T> &subject, const detail::RingView<T> &clipping, ClipOperation operation,
+                 PolygonSet<T> &result) {
+            result.clear();
+            mConvex = false;
+            double sb[4] = {0.0, 0.0, 0.0, 0.0}, cb[4] = {0.0, 0.0, 0.0, 0.0};
+            const bool hasSubject = bounds(subject, sb), hasClipping = bounds(clipping, cb);
+            if (!hasSubject && (operation == CLIP_INTERSECTION || operation == CLIP_DIFFERENCE)) return;
+            if (!hasClipping && operation == CLIP_INTERSECTION) return;
+            if (operation == CLIP_INTERSECTION && (sb[0] > cb[2] || cb[0] > sb[2] || sb[1] > cb[3] || cb[1] > sb[3])) {
+                return;
+            }
+            if (operation == CLIP_INTERSECTION && subject.count() == 1 && clipping.count() == 1 &&
+                detail::isConvexRing(subject.xs, subject.ys, subject.vertices) &&
+                detail::isConvexRing(clipping.xs, clipping.ys, clipping.vertices)) {
+                mConvex = true;
+                convexClip(subject, clipping, result);
+                return;
+            }
+
+            mEvents.clear();
+            mQueue.clear();
+            mStatus.clear();
+            mSorted.clear();
+            addEdges(subject, 0);
+            addEdges(clipping, 1);
+            std::make_heap(mQueue.begin(), mQueue.end(), Later{this});
+            const std::size_t edges = mEvents.size() / 2;
+            mEventLimit = mEvents.size() + 4 * edges * edges;
+            subdivide(operation, std::min(sb[2], cb[2]), sb[2]);
+            label(operation);
+            connectEdges(result);
+        }
+
+        static bool bounds(const detail::RingView<T> &rings, double *box) {
+            if (rings.vertices == 0) return false;
+            box[0] = box[2] = double(rings.xs[0]);
+            box[1] = box[3] = double(rings.ys[0]);
+            for (std::size_t i = 1; i < rings.vertices; ++i) {
+                const double x = double(rings.xs[i]), y = double(rings.ys[i]);
+                box[0] = std::min(box[0], x);
+                box[1] = std::min(box[1], y);
+                box[2] = std::max(box[2], x);
+                box[3] = std::max(box[3], y);
+            }
+            return true;
+        }
+
+        int newEvent(double x, double y, int polygon, int edge) {
+            Event e;
+            e.x = x;
+            e.y = y;
+            e.other = e.prevInResult = e.position = e.outputContour = -1;
+            e.edge = edge;
+            e.polygon = (unsigned char) polygon;
+            e.toggles = (unsigned char) (1 << polygon);
+            e.inside = 0;
+            e.left = false;
+            e.resultTransition = 0;
+            mEvents.push_back(e);
+            return int(mEvents.size()) - 1;
+        }
+
+        void addEdges(const detail::RingView<T> &rings, int polygon) {
+            for (std::size_t r = 0; r < rings.count(); ++r) {
+                const std::size_t first = rings.first(r);
+                const int n = int(rings.size(r));
+                for (int i = 0; i < n; ++i) {
+                    const RingIndex<int> at(i, n);
+                    const std::size_t j = first + std::size_t(at + 1);
+                    const double x0 = double(rings.xs[first + std::size_t(i)]), y0 = double(rings.ys[first + std::size_t(i)]);
+                    const double x1 = double(rings.xs[j]), y1 = double(rings.ys[j]);
+                    if (x0 == x1 && y0 == y1) continue;
+                    const int edge = int(mEvents.size());
+                    const int a = newEvent(x0, y0, polygon, edge), b = newEvent(x1, y1, polygon, edge);
+                    mEvents[a].other = b;
+                    mEvents[b].other = a;
+                    mEvents[later(a, b) ? b : a].left = true;
+                    mQueue.push_back(a);
+                    mQueue.push_back(b);
+                }
+            }
+        }
+
+        bool samePoint(int a, int b) const {
+            return mEvents[a].x == mEvents[b].x && mEvents[a].y == mEvents[b].y;
+        }
+
+        bool vertical(int e) const {
+            return mEvents[e].x == mEvents[mEvents[e].other].x;
+        }
+
+        /*
+         * Positive if the edge of e passes below (x, y), zero if through it
+         */
+        double side(int e, double x, double y) const {
+            const Event &a = mEvents[e], &b = mEvents[a.other];
+            return a.left ? detail::clipOrient(a.x, a.y, b.x, b.y, x, y) : detail::clipOrient(b.x, b.y, a.x, a.y, x, y);
+        }
+
+        /*
+         * Whether the edge of e passes below (x, y)
+         */
+        bool below(int e, double x, double y) const {
+            return side(e, x, y) > 0.0;
+        }
+
+        /*
+         * Whether event a comes after event b: from left to right, right ends before left ends
+         * at the same point and lower edges before higher ones.
+         */
+        bool later(int a, int b) const {
+            const Event &e1 = mEvents[a], &e2 = mEvents[b];
+            if (e1.x != e2.x) return e1.x > e2.x;
+            if (e1.y != e2.y) return e1.y > e2.y;
+            if (e1.left != e2.left) return e1.left;
+            const Event &o2 = mEvents[e2.other];
+            if (detail::clipOrient(e1.x, e1.y, mEvents[e1.other].x, mEvents[e1.other].y, o2.x, o2.y) != 0.0) {
+                return !below(a, o2.x, o2.y);
+            }
+            if (e1.polygon != e2.polygon) return e1.polygon > e2.polygon;
+            return a > b;
+        }
+
+        /*
+         * The order of the sweep line: -1 if the edge of left event a is below that of b
+         */
+        int compareSegments(int a, int b) const {
+            if (a == b) return 0;
+            const Event &l1 = mEvents[a], &r1 = mEvents[l1.other], &l2 = mEvents[b], &r2 = mEvents[l2.other];
+            if (detail::clipOrient(l1.x, l1.y, r1.x, r1.y, l2.x, l2.y) != 0.0 ||
+                detail::clipOrient(l1.x, l1.y, r1.x, r1.y, r2.x, r2.y) != 0.0) {
+                // Not collinear: compare at the left end of the edge that entered the sweep line later
+                if (l1.x == l2.x && l1.y == l2.y) return below(a, r2.x, r2.y) ? -1 : 1;
+                if (l1.x == l2.x) return l1.y < l2.y ? -1 : 1;
+                // A left end on the other edge goes by the right end
+                if (later(a, b)) {
+                    const double o = side(b, l1.x, l1.y);
+                    return (o != 0.0 ? o : side(b, r1.x, r1.y)) > 0.0 ? 1 : -1;
+                }
+                const double o = side(a, l2.x, l2.y);
+                return (o != 0.0 ? o : side(a, r2.x, r2.y)) > 0.0 ? -1 : 1;
+            }
+            if (l1.polygon != l2.polygon) return l1.polygon == 0 ? -1 : 1;
+            if (l1.x == l2.x && l1.y == l2.y) {
+                if (r1.x == r2.x && r1.y == r2.y) return 0;
+                return l1.edge > l2.edge ? 1 : -1;
+            }
+            return later(a, b) ? 1 : -1;
+        }
+
+        std::size_t insertSegment(int e) {
+            const std::vector<int>::iterator it = std::lower_bound(mStatus.begin(), mStatus.end(), e,
+                                                                   [this](int a, int b) {
+                                                                       return compareSegments(a, b) < 0;
+                                                                   });
+            const std::size_t pos = std::size_t(it - mStatus.begin());
+            mStatus.insert(it, e);
+            return pos;
+        }
+
+        std::size_t findSegment(int e) const {
+            std::vector<int>::const_iterator it = std::lower_bound(mStatus.begin(), mStatus.end(), e,
+                                                                   [this](int a, int b) {
+                                                                       return compareSegments(a, b) < 0;
+                                                                   });
+            while (it != mStatus.end() && *it != e && compareSegments(*it, e) == 0) ++it;
+            // Rounded intersection points can leave the order slightly inconsistent
+            if (it == mStatus.end() || *it != e) it = std::find(mStatus.begin(), mStatus.end(), e);
+            return std::size_t(it - mStatus.begin());
+        }
+
+        /*
+         * Splits the edges where they meet, so that edges meet only at their ends or are equal
+         */
+        void subdivide(ClipOperation operation, double rightBound, double subjectRight) {
+            while (!mQueue.empty()) {
+                std::pop_heap(mQueue.begin(), mQueue.end(), Later{this});
+                const int e = mQueue.back();
+                mQueue.pop_back();
+                // Nothing right of either polygon is in an intersection, nothing right of the subject in a difference
+                if ((operation == CLIP_INTERSECTION && mEvents[e].x > rightBound) ||
+                    (operation == CLIP_DIFFERENCE && mEvents[e].x > subjectRight)) {
+                    break;
+                }
+                mSorted.push_back(e);
+
+                if (mEvents[e].left) {
+                    const std::size_t pos = insertSegment(e);
+                    if (pos + 1 < mStatus.size()) possibleIntersection(e, mStatus[pos + 1]);
+                    if (pos > 0) possibleIntersection(mStatus[pos - 1], e);
+                } else {
+                    const std::size_t pos = findSegment(mEvents[e].other);
+                    if (pos == mStatus.size()) continue;
+                    const int prev = pos > 0 ? mStatus[pos - 1] : -1;
+                    const int next = pos + 1 < mStatus.size() ? mStatus[pos + 1] : -1;
+                    mStatus.erase(mStatus.begin() + std::ptrdiff_t(pos));
+                    if (prev >= 0 && next >= 0) possibleIntersection(prev, next);
+                }
+            }
+        }
+
+        /*
+         * Sweeps the split edges again and labels each with the inputs it has inside above it.
+         * Equal edges count as one, which crosses the inputs that an odd number of them belong to.
+         */
+        void label(ClipOperation operation) {
+            mEdges.clear();
+            for (std::size_t i = 0; i < mSorted.size(); ++i) {
+                if (mEvents[mSorted[i]].left) mEdges.push_back(mSorted[i]);
+            }
+            std::sort(mEdges.begin(), mEdges.end(), [this](int a, int b) { return edgeLess(a, b); });
+            for (std::size_t i = 0; i < mEdges.size();) {
+                std::size_t j = i + 1;
+                for (; j < mEdges.size() && !edgeLess(mEdges[i], mEdges[j]); ++j) {
+                    mEvents[mEdges[i]].toggles ^= mEvents[mEdges[j]].toggles;
+                    mEvents[mEdges[j]].toggles = 0;
+                }
+                i = j;
+            }
+
+            // The events of the edges that are left, in the order of the sweep
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < mSorted.size(); ++i) {
+                const Event &e = mEvents[mSorted[i]];
+                if ((e.left ? e : mEvents[e.other]).toggles != 0) mSorted[count++] = mSorted[i];
+            }
+            mSorted.resize(count);
+            const auto sweepOrder = [this](int a, int b) { return later(b, a); };
+            if (!std::is_sorted(mSorted.begin(), mSorted.end(), sweepOrder)) {
+                std::sort(mSorted.begin(), mSorted.end(), sweepOrder);
+            }
+
+            mStatus.clear();
+            for (std::size_t i = 0; i < mSorted.size(); ++i) {
+                const int e = mSorted[i];
+                // Neighbours that meet only at their ends keep the whole sweep free of crossings
+                if (mEvents[e].left) {
+                    const std::size_t pos = insertSegment(e);
+                    computeFields(e, pos > 0 ? mStatus[pos - 1] : -1, operation);
+                    if (pos > 0) checkApart(mStatus[pos - 1], e);
+                    if (pos + 1 < mStatus.size()) checkApart(e, mStatus[pos + 1]);
+                } else {
+                    const std::size_t pos = findSegment(mEvents[e].other);
+                    if (pos == mStatus.size()) continue;
+                    mStatus.erase(mStatus.begin() + std::ptrdiff_t(pos));
+                    if (pos > 0 && pos < mStatus.size()) checkApart(mStatus[pos - 1], mStatus[pos]);
+                }
+            }
+        }
+
+        /*
+         * Throws if the split edges of left events a and b meet anywhere but at an end of both,
+         * decided exactly on the rounded points
+         */
+        void checkApart(int a, int b) const {
+            const Event &l1 = mEvents[a], &r1 = mEvents[l1.other], &l2 = mEvents[b], &r2 = mEvents[l2.other];
+            const double o1 = detail::clipOrient(l1.x, l1.y, r1.x, r1.y, l2.x, l2.y);
+            const double o2 = detail::clipOrient(l1.x, l1.y, r1.x, r1.y, r2.x, r2.y);
+            if ((o1 > 0.0 && o2 > 0.0) || (o1 < 0.0 && o2 < 0.0)) return;
+            const double o3 = detail::clipOrient(l2.x, l2.y, r2.x, r2.y, l1.x, l1.y);
+            const double o4 = detail::clipOrient(l2.x, l2.y, r2.x, r2.y, r1.x, r1.y);
+            if ((o3 > 0.0 && o4 > 0.0) || (o3 < 0.0 && o4 < 0.0)) return;
+            if (o1 == 0.0 && o2 == 0.0) {
+                // Collinear, they overlap unless one ends where the other begins
+                if (!detail::sweepLess(l2.x, l2.y, r1.x, r1.y) || !detail::sweepLess(l1.x, l1.y, r2.x, r2.y)) return;
+            } else if (samePoint(a, b) || samePoint(a, l2.other) || samePoint(l1.other, b) ||
+                       samePoint(l1.other, l2.other)) {
+                return;
+            }
+            throw PolygonClippingRoundingException();
+        }
+
+        /*
+         * An order of the edges of left events in which equal edges are neighbours
+         */
+        bool edgeLess(int a, int b) const {
+            const Event &l1 = mEvents[a], &r1 = mEvents[l1.other], &l2 = mEvents[b], &r2 = mEvents[l2.other];
+            if (l1.x != l2.x || l1.y != l2.y) return detail::sweepLess(l1.x, l1.y, l2.x, l2.y);
+            return detail::sweepLess(r1.x, r1.y, r2.x, r2.y);
+        }
+
+        /*
+         * What lies above the left event e, from the edge prev below it
+         */
+        void computeFields(int e, int prev, ClipOperation operation) {
+            Event &event = mEvents[e];
+            unsigned char below = 0;
+            event.prevInResult = -1;
+            if (prev >= 0) {
+                const Event &p = mEvents[prev];
+                // Right of a vertical edge is below it
+                below = vertical(prev) ? (unsigned char) (p.inside ^ p.toggles) : p.inside;
+                event.prevInResult = p.resultTransition == 0 || vertical(prev) ? p.prevInResult : prev;
+            }
+            event.inside = (unsigned char) (below ^ event.toggles);
+            const bool resultBelow = inResult(below, operation), resultAbove = inResult(event.inside, operation);
+            event.resultTransition = (signed char) (resultBelow == resultAbove ? 0 : resultAbove ? 1 : -1);
+        }
+
+        static bool inResult(unsigned char inside, ClipOperation operation) {
+            const bool subject = (inside & 1) != 0, clipping = (inside & 2) != 0;
+            switch (operation) {
+                case CLIP_INTERSECTION:
+                    return subject && clipping;
+                case CLIP_UNION:
+                    return subject || clipping;
+                case CLIP_DIFFERENCE:
+                    return subject && !clipping;
+                case CLIP_XOR:
+                    return subject != clipping;
+            }
+            return false;
+        }
+
+        /*
+         * The points the edges of left events a and b share: none, one, or the two ends of an overlap.
+         * Edges within rounding distance of each other count as meeting, else a part split off an
+         * edge no longer overlaps the edge it lay on and the two are never made equal.
+         */
+        int intersect(int a, int b, double *xs, double *ys) const {
+            const Event &a0 = mEvents[a], &a1 = mEvents[a0.other], &b0 = mEvents[b], &b1 = mEvents[b0.other];
+            const double scale = std::max(std::max(std::fabs(a0.x), std::fabs(a0.y)), std::max(std::fabs(a1.x), std::fabs(a1.y)));
+            const double tolerance = 8.0 * std::numeric_limits<double>::epsilon() *
+                    std::max(scale, std::max(std::max(std::fabs(b0.x), std::fabs(b0.y)), std::max(std::fabs(b1.x), std::fabs(b1.y))));
+            const double bound = tolerance * tolerance;
+            // The orientation is the distance from the line times the length of the edge
+            const double aLength2 = (a1.x - a0.x) * (a1.x - a0.x) + (a1.y - a0.y) * (a1.y - a0.y);
+            const double o1 = detail::clipOrient(a0.x, a0.y, a1.x, a1.y, b0.x, b0.y);
+            const double o2 = detail::clipOrient(a0.x, a0.y, a1.x, a1.y, b1.x, b1.y);
+            const bool b0OnA = o1 * o1 <= bound * aLength2, b1OnA = o2 * o2 <= bound * aLength2;
+            if (!b0OnA && !b1OnA && (o1 > 0.0) == (o2 > 0.0)) return 0;
+            const double bLength2 = (b1.x - b0.x) * (b1.x - b0.x) + (b1.y - b0.y) * (b1.y - b0.y);
+            const double o3 = detail::clipOrient(b0.x, b0.y, b1.x, b1.y, a0.x, a0.y);
+            const double o4 = detail::clipOrient(b0.x, b0.y, b1.x, b1.y, a1.x, a1.y);
+            const bool a0OnB = o3 * o3 <= bound * bLength2, a1OnB = o4 * o4 <= bound * bLength2;
+            if (!a0OnB && !a1OnB && (o3 > 0.0) == (o4 > 0.0)) return 0;
+
+            // The part of the sweep both edges span
+            const bool aOrdered = detail::sweepLess(a0.x, a0.y, a1.x, a1.y);
+            const bool bOrdered = detail::sweepLess(b0.x, b0.y, b1.x, b1.y);
+            const Event &aLow = aOrdered ? a0 : a1, &aHigh = aOrdered ? a1 : a0;
+            const Event &bLow = bOrdered ? b0 : b1, &bHigh = bOrdered ? b1 : b0;
+            const Event &low = detail::sweepLess(aLow.x, aLow.y, bLow.x, bLow.y) ? bLow : aLow;
+            const Event &high = detail::sweepLess(aHigh.x, aHigh.y, bHigh.x, bHigh.y) ? aHigh : bHigh;
+
+            if ((b0OnA && b1OnA) || (a0OnB && a1OnB)) {
+                if (detail::sweepLess(high.x, high.y, low.x, low.y)) return 0;
+                // The line of a part a few units in the last place long points anywhere, so the
+                // ends of the overlap must be on both edges, not just close to one of the lines
+                const auto onBoth = [&](const Event &p) {
+                    return &p == &a0 || &p == &a1 ? (&p == &a0 ? a0OnB : a1OnB) && touches(p, bLow, bHigh)
+                                                   : (&p == &b0 ? b0OnA : b1OnA) && touches(p, aLow, aHigh);
+                };
+                if (onBoth(low) && onBoth(high)) {
+                    xs[0] = low.x;
+                    ys[0] = low.y;
+                    if (low.x == high.x && low.y == high.y) return 1;
+                    xs[1] = high.x;
+                    ys[1] = high.y;
+                    return 2;
+                }
+            }
+
+            // An end on the other edge, within rounding distance. The sides of a point that close
+            // say nothing once the edge has been split at rounded points.
+            const Event *touch = b0OnA && touches(b0, aLow, aHigh) ? &b0 : b1OnA && touches(b1, aLow, aHigh) ? &b1 :
+                                 a0OnB && touches(a0, bLow, bHigh) ? &a0 : a1OnB && touches(a1, bLow, bHigh) ? &a1 : nullptr;
+            if (touch != nullptr) {
+                xs[0] = touch->x;
+                ys[0] = touch->y;
+                return 1;
+            }
+            if ((o1 > 0.0 && o2 > 0.0) || (o1 < 0.0 && o2 < 0.0)) return 0;
+            if ((o3 > 0.0 && o4 > 0.0) || (o3 < 0.0 && o4 < 0.0)) return 0;
+
+            double x, y;
+            crossing(a, b, o3, o4, x, y);
+            // The rounded point stays within both edges
+            x = std::max(x, std::max(std::min(a0.x, a1.x), std::min(b0.x, b1.x)));
+            x = std::min(x, std::min(std::max(a0.x, a1.x), std::max(b0.x, b1.x)));
+            y = std::max(y, std::max(std::min(a0.y, a1.y), std::min(b0.y, b1.y)));
+            y = std::min(y, std::min(std::max(a0.y, a1.y), std::max(b0.y, b1.y)));
+            if (detail::sweepLess(x, y, low.x, low.y)) x = low.x, y = low.y;
+            if (detail::sweepLess(high.x, high.y, x, y)) x = high.x, y = high.y;
+            // A point within rounding distance of an end is that end, a point just next to it
+            // would be split off again and again by the edges through the end. Ends outside
+            // the span are behind the sweep or beyond one of the edges.
+            const Event *ends[4] = {&a0, &a1, &b0, &b1};
+            for (int k = 0; k < 4; ++k) {
+                if (between(*ends[k], low, high) && std::fabs(ends[k]->x - x) <= tolerance &&
+                    std::fabs(ends[k]->y - y) <= tolerance) {
+                    x = ends[k]->x, y = ends[k]->y;
+                    break;
+                }
+            }
+            xs[0] = x;
+            ys[0] = y;
+            return 1;
+        }
+
+        /*
+         * Where the edges of left events a and b cross, taken from the input edges they are parts of.
+         * Parts of an edge end at rounded points and lean a little, the input edge does not, so the
+         * edges through one point all find the same point. With small integer coordinates the
+         * products are exact, so a crossing that is a double comes out exactly.
+         */
+        void crossing(int a, int b, double o3, double o4, double &x, double &y) const {
+            const Event &p0 = mEvents[mEvents[a].edge], &p1 = mEvents[mEvents[a].edge + 1];
+            const Event &q0 = mEvents[mEvents[b].edge], &q1 = mEvents[mEvents[b].edge + 1];
+            const double dx1 = p1.x - p0.x, dy1 = p1.y - p0.y, dx2 = q1.x - q0.x, dy2 = q1.y - q0.y;
+            const double det = dx1 * dy2 - dy1 * dx2;
+            if (det != 0.0) {
+                const double s = (q0.x - p0.x) * dy2 - (q0.y - p0.y) * dx2;
+                x = p0.x + dx1 * s / det;
+                y = p0.y + dy1 * s / det;
+                return;
+            }
+            // The input edges are parallel in floating point while their parts cross
+            const Event &a0 = mEvents[a], &a1 = mEvents[a0.other];
+            const double t = o3 / (o3 - o4);
+            x = a0.x + (a1.x - a0.x) * t;
+            y = a0.y + (a1.y - a0.y) * t;
+        }
+
+        /*
+         * Whether p is from lo to hi in the order of the sweep
+         */
+        static bool between(const Event &p, const Event &lo, const Event &hi) {
+            return !detail::sweepLess(p.x, p.y, lo.x, lo.y) && !detail::sweepLess(hi.x, hi.y, p.x, p.y);
+        }
+
+        /*
+         * Whether p, close to the line through s0 and s1, falls within the edge
+         */
+        static bool onSegment(const Event &p, const Event &s0, const Event &s1) {
+            const double along = (p.x - s0.x) * (s1.x - s0.x) + (p.y - s0.y) * (s1.y - s0.y);
+            return along >= 0.0 && along <= (s1.x - s0.x) * (s1.x - s0.x) + (s1.y - s0.y) * (s1.y - s0.y);
+        }
+
+        /*
+         * Whether p, close to the edge from lo to hi, is on it both along the edge and in the order of the sweep
+         */
+        static bool touches(const Event &p, const Event &lo, const Event &hi) {
+            return onSegment(p, lo, hi) && between(p, lo, hi);
+        }
+
+        /*
+         * Splits the edge of left event e at (x, y)
+         */
+        void divide(int e, double x, double y) {
+            const int polygon = mEvents[e].polygon, edge = mEvents[e].edge;
+            const int r = newEvent(x, y, polygon, edge), l = newEvent(x, y, polygon, edge);
+            const int end = mEvents[e].other;
+            mEvents[r].other = e;
+            mEvents[l].other = end;
+            mEvents[l].left = true;
+            // A rounded point can fall behind the end of the edge, then the two swap
+            if (later(l, end)) {
+                mEvents[end].left = true;
+                mEvents[l].left = false;
+            }
+            mEvents[end].other = l;
+            mEvents[e].other = r;
+            mQueue.push_back(l);
+            std::push_heap(mQueue.begin(), mQueue.end(), Later{this});
+            mQueue.push_back(r);
+            std::push_heap(mQueue.begin(), mQueue.end(), Later{this});
+        }
+
+        /*
+         * Splits the neighbouring edges of left events a and b at the points they share. Where
+         * they overlap, both are split at the ends of the overlap and the middle parts are equal.
+         */
+        void possibleIntersection(int a, int b) {
+            double xs[2], ys[2];
+            // The later point first, a and b stay the parts before it
+            for (int k = intersect(a, b, xs, ys) - 1; k >= 0; --k) {
+                splitAt(a, xs[k], ys[k]);
+                splitAt(b, xs[k], ys[k]);
+            }
+        }
+
+        /*
+         * Splits the edge of left event e at (x, y) unless that is one of its ends, and with it the
+         * edges of the sweep line equal to it, which need not be neighbours of the edge that meets it
+         */
+        void splitAt(int e, double x, double y) {
+            const Event l = mEvents[e], r = mEvents[l.other];
+            if ((l.x == x && l.y == y) || (r.x == x && r.y == y)) return;
+            // No pair of input edges needs more than four parts, more are rounding going round in circles
+            if (mEvents.size() >= mEventLimit) throw PolygonClippingRoundingException();
+            divide(e, x, y);
+            const std::size_t pos = findSegment(e);
+            for (std::size_t k = pos; k-- > 0 && equalEdge(mStatus[k], l, r);) divide(mStatus[k], x, y);
+            for (std::size_t k = pos + 1; k < mStatus.size() && equalEdge(mStatus[k], l, r); ++k) divide(mStatus[k], x, y);
+        }
+
+        /*
+         * Whether the edge of left event e goes from l to r
+         */
+        bool equalEdge(int e, const Event &l, const Event &r) const {
+            const Event &a = mEvents[e], &b = mEvents[a.other];
+            return a.x == l.x && a.y == l.y && b.x == r.x && b.y == r.y;
+        }
+
+        /*
+         * Links the result edges into rings
+         */
+        void connectEdges(PolygonSet<T> &result) {
+            mResult.clear();
+            for (std::size_t i = 0; i < mSorted.size(); ++i) {
+                const Event &e = mEvents[mSorted[i]];
+                if ((e.left ? e : mEvents[e.other]).resultTransition != 0) mResult.push_back(mSorted[i]);
+            }
+            // Splits of overlapping edges can leave the events slightly out of order
+            for (std::size_t i = 1; i < mResult.size(); ++i) {
+                const int e = mResult[i];
+                std::size_t j = i;
+                for (; j > 0 && later(mResult[j - 1], e); --j) mResult[j] = mResult[j - 1];
+                mResult[j] = e;
+            }
+            const int n = int(mResult.size());
+            for (int i = 0; i < n; ++i) mEvents[mResult[i]].position = i;
+            for (int i = 0; i < n; ++i) {
+                Event &e = mEvents[mResult[i]];
+                if (!e.left) std::swap(e.position, mEvents[e.other].position);
+            }
+            // Events at one point are neighbours in the sweep order, the group of a position is the first of them
+            mGroups.resize(std::size_t(n));
+            for (int i = 0; i < n; ++i) mGroups[i] = i > 0 && samePoint(mResult[i], mResult[i - 1]) ? mGroups[i - 1] : i;
+            mSeen.assign(std::size_t(n), -1);
+            pairEdges();
+
+            // Walk from edge to paired edge until the walk is back at its first point
+            mProcessed.assign(std::size_t(n), 0);
+            mLoops.clear();
+            mLoopEdges.clear();
+            for (int i = 0; i < n; ++i) {
+                if (mProcessed[i]) continue;
+                mPath.clear();
+                int pos = i;
+                while (true) {
+                    mProcessed[pos] = 1;
+                    mPath.push_back(pos);
+                    pos = mEvents[mResult[pos]].position;
+                    if (pos < 0 || pos >= n) break;
+                    mProcessed[pos] = 1;
+                    pos = mPartners[pos];
+                    if (pos < 0 || mProcessed[pos]) break;
+                }
+                splitLoops();
+            }
+
+            // Outer rings are below their holes, so the parent of a hole is known when the hole is reached
+            mOrder.resize(mLoops.size());
+            for (std::size_t l = 0; l < mLoops.size(); ++l) mOrder[l] = int(l);
+            std::sort(mOrder.begin(), mOrder.end(), [this](int a, int b) {
+                return mLoops[a].first < mLoops[b].first;
+            });
+            for (std::size_t k = 0; k < mOrder.size(); ++k) {
+                detail::ClipLoop &loop = mLoops[mOrder[k]];
+                const Event &lowest = mEvents[mResult[loop.first]];
+                // Just above the lowest edge is inside the loop
+                if (lowest.resultTransition < 0) {
+                    const int below = lowest.prevInResult;
+                    const int lower = below >= 0 ? mEvents[below].outputContour : -1;
+                    loop.parent = lower < 0 ? -1 : mLoops[lower].parent >= 0 ? mLoops[lower].parent : lower;
+                    // A hole without an outer ring around it bounds nothing
+                    if (loop.parent < 0 || mLoops[loop.parent].ring < 0) continue;
+                }
+                mRing.clear();
+                for (int e = loop.begin; e < loop.end; ++e) {
+                    const Event &start = mEvents[mResult[mLoopEdges[e]]];
+                    mRing.push_back(PackedPoint<double>(start.x, start.y));
+                }
+                loop.ring = emitRing(loop.parent >= 0 ? mLoops[loop.parent].ring : -1, result);
+            }
+        }
+
+        /*
+         * Pairs the result edges at every point with their neighbours in counterclockwise order. Edges
+         * at a point alternate between the two sides of the result, so the rings made of the pairs touch
+         * but never cross.
+         */
+        void pairEdges() {
+            const int n = int(mResult.size());
+            mPartners.assign(std::size_t(n), -1);
+            for (int group = 0; group < n;) {
+                int end = group + 1;
+                while (end < n && mGroups[end] == group) ++end;
+                mAround.clear();
+                for (int pos = group; pos < end; ++pos) mAround.push_back(pos);
+                if (end - group > 2) {
+                    const Event &at = mEvents[mResult[group]];
+                    std::sort(mAround.begin(), mAround.end(), [this, &at](int a, int b) {
+                        const Event &ea = mEvents[mEvents[mResult[a]].other], &eb = mEvents[mEvents[mResult[b]].other];
+                        const bool lowerA = ea.y < at.y || (ea.y == at.y && ea.x < at.x);
+                        const bool lowerB = eb.y < at.y || (eb.y == at.y && eb.x < at.x);
+                        if (lowerA != lowerB) return lowerB;
+                        return detail::clipOrient(at.x, at.y, ea.x, ea.y, eb.x, eb.y) > 0.0;
+                    });
+                }
+                for (std::size_t k = 0; k + 1 < mAround.size(); k += 2) {
+                    mPartners[mAround[k]] = mAround[k + 1];
+                    mPartners[mAround[k + 1]] = mAround[k];
+                }
+                group = end;
+            }
+        }
+
+        /*
+         * Cuts the walked path into loops that visit every point once. Where two result regions
+         * touch in a point the walk can pass from one into the other.
+         */
+        void splitLoops() {
+            mStack.clear();
+            for (std::size_t k = 0; k < mPath.size(); ++k) {
+                const int group = mGroups[mPath[k]];
+                if (mSeen[group] >= 0) {
+                    addLoop(std::size_t(mSeen[group]));
+                }
+                mSeen[group] = int(mStack.size());
+                mStack.push_back(mPath[k]);
+            }
+            if (!mStack.empty()) addLoop(0);
+        }
+
+        /*
+         * Moves the edges from mStack[from] on into a new loop
+         */
+        void addLoop(std::size_t from) {
+            detail::ClipLoop loop = {int(mLoopEdges.size()), 0, -1, -1, -1};
+            const int id = int(mLoops.size());
+            for (std::size_t k = from; k < mStack.size(); ++k) {
+                const int pos = mStack[k], other = mEvents[mResult[pos]].position;
+                mSeen[mGroups[pos]] = -1;
+                mLoopEdges.push_back(pos);
+                mEvents[mResult[pos]].outputContour = id;
+                if (other >= 0 && other < int(mResult.size())) mEvents[mResult[other]].outputContour = id;
+                const int left = mEvents[mResult[pos]].left ? pos : other;
+                if (loop.first < 0 || left < loop.first) loop.first = left;
+            }
+            mStack.resize(from);
+            loop.end = int(mLoopEdges.size());
+            if (loop.first < 0) loop.first = mLoopEdges[loop.begin];
+            mLoops.push_back(loop);
+        }
+
+        /*
+         * Adds mRing to the result without repeated and collinear vertices, counterclockwise
+         * for outer rings and clockwise for holes, the rings with a parent.
+         * @return Returns the ring, -1 if it has no area and was dropped.
+         */
+        int emitRing(int parent, PolygonSet<T> &result) {
+            mClean.clear();
+            for (std::size_t i = 0; i < mRing.size(); ++i) {
+                const PackedPoint<double> p = mRing[i];
+                while (true) {
+                    const std::size_t m = mClean.size();
+                    if (m > 0 && mClean[m - 1].getX() == p.getX() && mClean[m - 1].getY() == p.getY()) break;
+                    if (m >= 2 && orient2d(mClean[m - 2], mClean[m - 1], p) == 0.0) {
+                        mClean.pop_back();
+                        continue;
+                    }
+                    mClean.push_back(p);
+                    break;
+                }
+            }
+            // The same for the vertices around the start of the ring
+            std::size_t begin = 0;
+            while (mClean.size() - begin >= 3) {
+                const PackedPoint<double> &first = mClean[begin], &last = mClean.back();
+                if (last.getX() == first.getX() && last.getY() == first.getY()) {
+                    mClean.pop_back();
+                } else if (orient2d(mClean[mClean.size() - 2], last, first) == 0.0) {
+                    mClean.pop_back();
+                } else if (orient2d(last, first, mClean[begin + 1]) == 0.0) {
+                    ++begin;
+                } else {
+                    break;
+                }
+            }
+            const std::size_t n = mClean.size() - begin;
+            if (n < 3) return -1;
+
+            double area = 0.0;
+            const double ox = mClean[begin].getX(), oy = mClean[begin].getY();
+            for (std::size_t i = begin + 1; i + 1 < mClean.size(); ++i) {
+                area += (mClean[i].getX() - ox) * (mClean[i + 1].getY() - oy) -
+                        (mClean[i + 1].getX() - ox) * (mClean[i].getY() - oy);
+            }
+            if (area == 0.0) return -1;
+
+            const bool reverse = (area > 0.0) == (parent >= 0);
+            for (std::size_t k = 0; k < n; ++k) {
+                const PackedPoint<double> &p = mClean[reverse ? mClean.size() - 1 - k : begin + k];
+                result.push_back(T(p.getX()), T(p.getY()));
+            }
+            result.closeRing(parent);
+            return int(result.ringCount()) - 1;
+        }
+
+        /*
+         * Sutherland-Hodgman: the subject ring cut by every edge of the convex clipping ring
+         */
+        void convexClip(const detail::RingView<T> &subject, const detail::RingView<T> &clipping,
+                        PolygonSet<T> &result) {
+            mRing.clear();
+            for (std::size_t i = 0; i < subject.vertices; ++i) {
+                mRing.push_back(PackedPoint<double>(double(subject.xs[i]), double(subject.ys[i])));
+            }
+            const std::size_t m = clipping.vertices;
+            const bool counterclockwise = detail::ringCross(clipping.xs, clipping.ys, m) > 0.0;
+            for (std::size_t k = 0; k < m && !mRing.empty(); ++k) {
+                // The edges in counterclockwise order, so that the inside is on the left
+                const RingIndex<int> at(int(counterclockwise ? k : m - 1 - k), int(m));
+                const std::size_t i = std::size_t(int(at)), j = std::size_t(counterclockwise ? at + 1 : at - 1);
+                const PackedPoint<double> c0(double(clipping.xs[i]), double(clipping.ys[i]));
+                const PackedPoint<double> c1(double(clipping.xs[j]), double(clipping.ys[j]));
+                mClean.clear();
+                PackedPoint<double> prev = mRing.back();
+                double prevSide = orient2d(c0, c1, prev);
+                for (std::size_t v = 0; v < mRing.size(); ++v) {
+                    const PackedPoint<double> cur = mRing[v];
+                    const double side = orient2d(c0, c1, cur);
+                    if ((side >= 0.0) != (prevSide >= 0.0)) {
+                        const double t = prevSide / (prevSide - side);
+                        mClean.push_back(prev + (cur - prev) * t);
+                    }
+                    if (side >= 0.0) mClean.push_back(cur);
+                    prev = cur;
+                    prevSide = side;
+                }
+                mRing.swap(mClean);
+            }
+            emitRing(-1, result);
+        }
+
+        std::vector<Event> mEvents;
+        std::vector<int> mQueue;
+        std::vector<int> mStatus;
+        std::vector<int> mSorted;
+        std::vector<int> mEdges;
+        std::vector<int> mResult;
+        std::vector<char> mProcessed;
+        std::vector<int> mGroups;
+        std::vector<int> mPartners;
+        std::vector<int> mAround;
+        std::vector<int> mSeen;
+        std::vector<int> mPath;
+        std::vector<int> mStack;
+        std::vector<int> mLoopEdges;
+        std::vector<int> mOrder;
+        std::vector<detail::ClipLoop> mLoops;
+        std::vector<PackedPoint<double> > mRing;
+        std::vector<PackedPoint<double> > mClean;
+        std::size_t mEventLimit;
+        bool mConvex;
+
+    }; // PolygonClipper class
+
+    /**
+     * subject and clipping, each a Polygon<T> or a PolygonSet<T>. For many clips keep a PolygonClipper.
+     */
+    template<class T, template<class> class A, template<class> class B>
+    inline PolygonSet<T> polygonIntersection(const A<T> &subject, const B<T> &clipping) {
+        return PolygonClipper<T>().clip(subject, clipping, CLIP_INTERSECTION);
+    }
+
+    /**
+     * subject or clipping
+     */
+    template<class T, template<class> class A, template<class> class B>
+    inline PolygonSet<T> polygonUnion(const A<T> &subject, const B<T> &clipping) {
+        return PolygonClipper<T>().clip(subject, clipping, CLIP_UNION);
+    }
+
+    /**
+     * subject without clipping
+     */
+    template<class T, template<class> class A, template<class> class B>
+    inline PolygonSet<T> polygonDifference(const A<T> &subject, const B<T> &clipping) {
+        return PolygonClipper<T>().clip(subject, clipping, CLIP_DIFFERENCE);
+    }
+
+    /**
+     * Either subject or clipping but not both
+     */
+    template<class T, template<class> class A, template<class> class B>
+    inline PolygonSet<T> polygonXor(const A<T> &subject, const B<T> &clipping) {
+        return PolygonClipper<T>().clip(subject, clipping, CLIP_XOR);
+    }
+
+};// namespace graph_algo
+
+
+#endif /* POLYGONCLIPPING_H_ */
@@ -0,0 +1,142 @@
+#ifndef PRECISION_H_
+#define PRECISION_H_
+
+#include <cmath>
+
+/**
+ * Precision modes for the length, distance and angle calculations.
+ * A mode is a type with two static functions, hypot(x, y) and atan2(y, x):
+ * - ExactPrecision uses libm hypot and atan2, which is what Point does.
+ * - FastPrecision uses sqrt(x*x + y*y), which is within 1 ulp of hypot but
+ *   can overflow for coordinates beyond ~1e154, and libm atan2.
+ * - ApproxPrecision uses sqrt(x*x + y*y) and a polynomial atan2 whose
+ *   absolute error is below APPROX_ATAN2_MAX_ERROR radians.
+ *
+ * The free functions length, distance and angle take the mode as their
+ * first template argument and work on Point, PackedPoint or any type with
+ * getX() and getY(). PointBuffer takes the same modes for its batch calls.
+ *
+ * For ordering there is no need for any of them: squaredLength orders like
+ * length and pseudoAngle orders like angle, without sqrt or trigonometry.
+ */
+
+namespace graph_algo {
+
+    static const double APPROX_ATAN2_MAX_ERROR = 2e-6;
+
+    /**
+     * Polynomial atan2, max absolute error APPROX_ATAN2_MAX_ERROR.
+     * atan is approximated on [0, 1] by an odd polynomial of degree 11 and
+     * the other octants are folded into that range. atan2(0, 0) is 0.
+     */
+    inline double approxAtan2(double y, double x) {
+        const double ax = std::fabs(x), ay = std::fabs(y);
+        const double mx = ax > ay ? ax : ay, mn = ax > ay ? ay : ax;
+        const double a = mx == 0.0 ? 0.0 : mn / mx;
+        const double s = a * a;
+        double r = ((((-0.01172120 * s + 0.05265332) * s - 0.11643287) * s + 0.19354346) * s - 0.33262347) * s
+                   + 0.99997726;
+        r *= a;
+        if (ay > ax) r = 1.57079632679489661923 - r;
+        if (x < 0.0) r = 3.14159265358979323846 - r;
+        return std::copysign(r, y);
+    }
+
+    /**
+     * A monotone replacement for atan2 in (-2, 2], ordering directions exactly
+     * like atan2(y, x) does but without trigonometry. pseudoAtan2(0, 0) is 0.
+     * Unlike atan2, y = -0.0 counts as 0, so the negative x axis is 2 for both zeros.
+     */
+    inline double pseudoAtan2(double y, double x) {
+        const double d = std::fabs(x) + std::fabs(y);
+        if (d == 0.0) return 0.0;
+        const double r = 1.0 - x / d;
+        return y < 0.0 ? -r : r;
+    }
+
+    struct ExactPrecision {
+        static double hypot(double x, double y) { return std::hypot(x, y); }
+
+        static double atan2(double y, double x) { return std::atan2(y, x); }
+    };
+
+    struct FastPrecision {
+        static double hypot(double x, double y) { return std::sqrt(x * x + y * y); }
+
+        static double atan2(double y, double x) { return std::atan2(y, x); }
+    };
+
+    struct ApproxPrecision {
+        static double hypot(double x, double y) { return std::sqrt(x * x + y * y); }
+
+        static double atan2(double y, double x) { return approxAtan2(y, x); }
+    };
+
+    /**
+     * Length of the vector p, computed with the given precision mode
+     */
+    template<class Precision, class P>
+    inline double length(const P &p) {
+        return Precision::hypot(double(p.getX()), double(p.getY()));
+    }
+
+    /**
+     * Distance between p and q, computed with the given precision mode
+     */
+    template<class Precision, class P>
+    inline double distance(const P &p, const P &q) {
+        return Precision::hypot(double(q.getX() - p.getX()), double(q.getY() - p.getY()));
+    }
+
+    /**
+     * The angle of p in relation to the origin, computed with the given precision mode
+     */
+    template<class Precision, class P>
+    inline double angle(const P &p) {
+        return Precision::atan2(double(p.getY()), double(p.getX()));
+    }
+
+    /**
+     * The angle of p in relation to center, computed with the given precision mode
+     */
+    template<class Precision, class P>
+    inline double angle(const P &p, const P &center) {
+        return Precision::atan2(double(p.getY() - center.getY()), double(p.getX() - center.getX()));
+    }
+
+    /**
+     * Squared length of the vector p. Orders points exactly like length does.
+     */
+    template<class P>
+    inline auto squaredLength(const P &p) -> decltype(p.getX() * p.getX()) {
+        return p.getX() * p.getX() + p.getY() * p.getY();
+    }
+
+    /**
+     * Squared distance between p and q. Orders exactly like distance does.
+     */
+    template<class P>
+    inline auto squaredDistance(const P &p, const P &q) -> decltype(p.getX() * p.getX()) {
+        return (q.getX() - p.getX()) * (q.getX() - p.getX()) + (q.getY() - p.getY()) * (q.getY() - p.getY());
+    }
+
+    /**
+     * Pseudo-angle of p in relation to the origin, see pseudoAtan2
+     */
+    template<class P>
+    inline double pseudoAngle(const P &p) {
+        return pseudoAtan2(double(p.getY()), double(p.getX()));
+    }
+
+    /**
+     * Pseudo-angle of p in relation to center, see pseudoAtan2
+     */
+    template<class P>
+    inline double pseudoAngle(const P &p, const P &center) {
+        return pseudoAtan2(double(p.getY() - center.getY()), double(p.getX() - center.getX()));
+    }
+
+};// namespace graph_algo
+
+
+#endif /* PRECISION_H_ */
@@ -0,0 +1,423 @@
+#ifndef PREDICATES_H_
+#define PREDICATES_H_
+
+#include <cmath>
+#include <vector>
+
+/**
+ * Robust geometric predicates after Shewchuk, "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates" (1997).
+ * - orient2d(a, b, c) is positive if a, b, c are in counterclockwise order,
+ *   negative if clockwise and zero if collinear. It is twice the signed area
+ *   of the triangle, i.e. (a - c) & (b - c).
+ * - incircle(a, b, c, d) is positive if d lies inside the circle through
+ *   a, b, c (given in counterclockwise order), negative if outside and zero
+ *   if the four points are cocircular.
+ *
+ * The sign of the result is always correct. Each predicate first evaluates
+ * the determinant in plain floating-point and checks it against an error
+ * bound. Only when that filter cannot decide the sign does it fall back to
+ * expansion arithmetic, growing the precision until the sign is certain.
+ * orient2dFilter and incircleFilter tell whether the filter alone decides.
+ *
+ * The predicates work on Point<double>, PackedPoint<double> or any type with
+ * getX() and getY() returning double.
+ */
+
+namespace graph_algo {
+
+    namespace expansion {
+
+        /*
+         * Error bounds from Shewchuk's exactinit() for IEEE double with round to nearest.
+         */
+        static const double EPSILON = 1.1102230246251565e-16; // 2^-53
+        static const double SPLITTER = 134217729.0; // 2^27 + 1
+        static const double RESULT_ERRBOUND = (3.0 + 8.0 * EPSILON) * EPSILON;
+        static const double CCW_ERRBOUND_A = (3.0 + 16.0 * EPSILON) * EPSILON;
+        static const double CCW_ERRBOUND_B = (2.0 + 12.0 * EPSILON) * EPSILON;
+        static const double CCW_ERRBOUND_C = (9.0 + 64.0 * EPSILON) * EPSILON * EPSILON;
+        static const double ICC_ERRBOUND_A = (10.0 + 96.0 * EPSILON) * EPSILON;
+        static const double ICC_ERRBOUND_B = (4.0 + 48.0 * EPSILON) * EPSILON;
+
+        /*
+         * x + y = a + b exactly, x is the rounded sum. Requires |a| >= |b|.
+         */
+        inline void fastTwoSum(double a, double b, double &x, double &y) {
+            x = a + b;
+            y = b - (x - a);
+        }
+
+        inline void twoSum(double a, double b, double &x, double &y) {
+            x = a + b;
+            const double bv = x - a, av = x - bv;
+            y = (a - av) + (b - bv);
+        }
+
+        inline void twoDiff(double a, double b, double &x, double &y) {
+            x = a - b;
+            const double bv = a - x, av = x + bv;
+            y = (a - av) + (bv - b);
+        }
+
+        /*
+         * The roundoff of x = a - b, where x was computed earlier.
+         */
+        inline double twoDiffTail(double a, double b, double x) {
+            const double bv = a - x, av = x + bv;
+            return (a - av) + (bv - b);
+        }
+
+        inline void split(double a, double &hi, double &lo) {
+            const double c = SPLITTER * a, big = c - a;
+            hi = c - big;
+            lo = a - hi;
+        }
+
+        /*
+         * x + y = a * b exactly, x is the rounded product.
+         */
+        inline void twoProduct(double a, double b, double &x, double &y) {
+            x = a * b;
+#ifdef FP_FAST_FMA
+            y = std::fma(a, b, -x);
+#else
+            double ahi, alo, bhi, blo;
+            split(a, ahi, alo);
+            split(b, bhi, blo);
+            y = alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+#endif
+        }
+
+        /*
+         * x[0..3] = (a1 + a0) - (b1 + b0) exactly, x[3] is the most significant.
+         */
+        inline void twoTwoDiff(double a1, double a0, double b1, double b0, double *x) {
+            double i, j, k;
+            twoDiff(a0, b0, i, x[0]);
+            twoSum(a1, i, j, k);
+            twoDiff(k, b1, i, x[1]);
+            twoSum(j, i, x[3], x[2]);
+        }
+
+        /*
+         * h = e + f, both nonoverlapping with increasing magnitude. Zero components are dropped.
+         * h needs room for elen + flen components. Returns the length of h.
+         */
+        inline int sum(int elen, const double *e, int flen, const double *f, double *h) {
+            double q, qnew, hh, enow = e[0], fnow = f[0];
+            int eindex = 0, findex = 0, hindex = 0;
+            if ((fnow > enow) == (fnow > -enow)) {
+                q = enow;
+                enow = ++eindex < elen ? e[eindex] : 0.0;
+            } else {
+                q = fnow;
+                fnow = ++findex < flen ? f[findex] : 0.0;
+            }
+            if (eindex < elen && findex < flen) {
+                if ((fnow > enow) == (fnow > -enow)) {
+                    fastTwoSum(enow, q, qnew, hh);
+                    enow = ++eindex < elen ? e[eindex] : 0.0;
+                } else {
+                    fastTwoSum(fnow, q, qnew, hh);
+                    fnow = ++findex < flen ? f[findex] : 0.0;
+                }
+                q = qnew;
+                if (hh != 0.0) h[hindex++] = hh;
+                while (eindex < elen && findex < flen) {
+                    if ((fnow > enow) == (fnow > -enow)) {
+                        twoSum(q, enow, qnew, hh);
+                        enow = ++eindex < elen ? e[eindex] : 0.0;
+                    } else {
+                        twoSum(q, fnow, qnew, hh);
+                        fnow = ++findex < flen ? f[findex] : 0.0;
+                    }
+                    q = qnew;
+                    if (hh != 0.0) h[hindex++] = hh;
+                }
+            }
+            while (eindex < elen) {
+                twoSum(q, enow, qnew, hh);
+                enow = ++eindex < elen ? e[eindex] : 0.0;
+                q = qnew;
+                if (hh != 0.0) h[hindex++] = hh;
+            }
+            while (findex < flen) {
+                twoSum(q, fnow, qnew, hh);
+                fnow = ++findex < flen ? f[findex] : 0.0;
+                q = qnew;
+                if (hh != 0.0) h[hindex++] = hh;
+            }
+            if (q != 0.0 || hindex == 0) h[hindex++] = q;
+            return hindex;
+        }
+
+        /*
+         * h = e * b. Zero components are dropped. h needs room for 2 * elen components.
+         */
+        inline int scale(int elen, const double *e, double b, double *h) {
+            double q, sum, hh, product1, product0;
+            int hindex = 0;
+            twoProduct(e[0], b, q, hh);
+            if (hh != 0.0) h[hindex++] = hh;
+            for (int i = 1; i < elen; ++i) {
+                twoProduct(e[i], b, product1, product0);
+                twoSum(q, product0, sum, hh);
+                if (hh != 0.0) h[hindex++] = hh;
+                fastTwoSum(product1, sum, q, hh);
+                if (hh != 0.0) h[hindex++] = hh;
+            }
+            if (q != 0.0 || hindex == 0) h[hindex++] = q;
+            return hindex;
+        }
+
+        /*
+         * An approximation of the value of the expansion e.
+         */
+        inline double estimate(int elen, const double *e) {
+            double q = e[0];
+            for (int i = 1; i < elen; ++i) q += e[i];
+            return q;
+        }
+
+        /*
+         * An expansion held in a growable array, for the rare exact stages.
+         */
+        typedef std::vector<double> Expansion;
+
+        inline Expansion sum(const Expansion &e, const Expansion &f) {
+            Expansion h(e.size() + f.size());
+            h.resize(sum(int(e.size()), e.data(), int(f.size()), f.data(), h.data()));
+            return h;
+        }
+
+        inline Expansion product(const Expansion &e, const Expansion &f) {
+            Expansion h(1, 0.0), term(2 * e.size());
+            for (std::size_t i = 0; i < f.size(); ++i) {
+                term.resize(2 * e.size());
+                term.resize(scale(int(e.size()), e.data(), f[i], term.data()));
+                h = sum(h, term);
+            }
+            return h;
+        }
+
+        inline Expansion difference(double a, double b) {
+            double x, y;
+            twoDiff(a, b, x, y);
+            Expansion h(1, y);
+            h.push_back(x);
+            return h;
+        }
+
+        inline Expansion negate(Expansion e) {
+            for (std::size_t i = 0; i < e.size(); ++i) e[i] = -e[i];
+            return e;
+        }
+
+    }; // namespace expansion
+
+    namespace detail {
+
+        inline double orient2dAdapt(double ax, double ay, double bx, double by, double cx, double cy, double detsum) {
+            using namespace expansion;
+            const double acx = ax - cx, bcx = bx - cx, acy = ay - cy, bcy = by - cy;
+
+            double detleft, detlefttail, detright, detrighttail;
+            twoProduct(acx, bcy, detleft, detlefttail);
+            twoProduct(acy, bcx, detright, detrighttail);
+            double b[4];
+            twoTwoDiff(detleft, detlefttail, detright, detrighttail, b);
+
+            double det = estimate(4, b);
+            double errbound = CCW_ERRBOUND_B * detsum;
+            if (det >= errbound || -det >= errbound) return det;
+
+            const double acxtail = twoDiffTail(ax, cx, acx), bcxtail = twoDiffTail(bx, cx, bcx);
+            const double acytail = twoDiffTail(ay, cy, acy), bcytail = twoDiffTail(by, cy, bcy);
+            if (acxtail == 0.0 && acytail == 0.0 && bcxtail == 0.0 && bcytail == 0.0) return det;
+
+            errbound = CCW_ERRBOUND_C * detsum + RESULT_ERRBOUND * std::fabs(det);
+            det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+            if (det >= errbound || -det >= errbound) return det;
+
+            double s1, s0, t1, t0, u[4], c1[8], c2[12], d[16];
+            twoProduct(acxtail, bcy, s1, s0);
+            twoProduct(acytail, bcx, t1, t0);
+            twoTwoDiff(s1, s0, t1, t0, u);
+            const int c1length = expansion::sum(4, b, 4, u, c1);
+
+            twoProduct(acx, bcytail, s1, s0);
+            twoProduct(acy, bcxtail, t1, t0);
+            twoTwoDiff(s1, s0, t1, t0, u);
+            const int c2length = expansion::sum(c1length, c1, 4, u, c2);
+
+            twoProduct(acxtail, bcytail, s1, s0);
+            twoProduct(acytail, bcxtail, t1, t0);
+            twoTwoDiff(s1, s0, t1, t0, u);
+            const int dlength = expansion::sum(c2length, c2, 4, u, d);
+
+            return d[dlength - 1];
+        }
+
+        /*
+         * The incircle determinant over exact coordinate differences, with no rounding anywhere.
+         */
+        inline double incircleExact(double ax, double ay, double bx, double by, double cx, double cy,
+                                    double dx, double dy) {
+            using namespace expansion;
+            const Expansion adx = difference(ax, dx), ady = difference(ay, dy);
+            const Expansion bdx = difference(bx, dx), bdy = difference(by, dy);
+            const Expansion cdx = difference(cx, dx), cdy = difference(cy, dy);
+
+            const Expansion alift = expansion::sum(product(adx, adx), product(ady, ady));
+            const Expansion blift = expansion::sum(product(bdx, bdx), product(bdy, bdy));
+            const Expansion clift = expansion::sum(product(cdx, cdx), product(cdy, cdy));
+
+            const Expansion bc = expansion::sum(product(bdx, cdy), negate(product(cdx, bdy)));
+            const Expansion ca = expansion::sum(product(cdx, ady), negate(product(adx, cdy)));
+            const Expansion ab = expansion::sum(product(adx, bdy), negate(product(bdx, ady)));
+
+            const Expansion abTerms = expansion::sum(product(alift, bc), product(blift, ca));
+            const Expansion det = expansion::sum(abTerms, product(clift, ab));
+            return det.back();
+        }
+
+        inline double incircleAdapt(double ax, double ay, double bx, double by, double cx, double cy,
+                                    double dx, double dy, double permanent) {
+            using namespace expansion;
+            const double adx = ax - dx, bdx = bx - dx, cdx = cx - dx;
+            const double ady = ay - dy, bdy = by - dy, cdy = cy - dy;
+
+            double p1, p0, q1, q0;
+            double bc[4], ca[4], ab[4];
+            twoProduct(bdx, cdy, p1, p0);
+            twoProduct(cdx, bdy, q1, q0);
+            twoTwoDiff(p1, p0, q1, q0, bc);
+            twoProduct(cdx, ady, p1, p0);
+            twoProduct(adx, cdy, q1, q0);
+            twoTwoDiff(p1, p0, q1, q0, ca);
+            twoProduct(adx, bdy, p1, p0);
+            twoProduct(bdx, ady, q1, q0);
+            twoTwoDiff(p1, p0, q1, q0, ab);
+
+            // (adx^2 + ady^2) * bc and its rotations, exact for the rounded differences
+            double x8[8], xx16[16], y8[8], yy16[16], a32[32], b32[32], c32[32], ab64[64], fin[96];
+            int xlen = expansion::scale(4, bc, adx, x8), xxlen = expansion::scale(xlen, x8, adx, xx16);
+            int ylen = expansion::scale(4, bc, ady, y8), yylen = expansion::scale(ylen, y8, ady, yy16);
+            const int alen = expansion::sum(xxlen, xx16, yylen, yy16, a32);
+            xlen = expansion::scale(4, ca, bdx, x8), xxlen = expansion::scale(xlen, x8, bdx, xx16);
+            ylen = expansion::scale(4, ca, bdy, y8), yylen = expansion::scale(ylen, y8, bdy, yy16);
+            const int blen = expansion::sum(xxlen, xx16, yylen, yy16, b32);
+            xlen = expansion::scale(4, ab, cdx, x8), xxlen = expansion::scale(xlen, x8, cdx, xx16);
+            ylen = expansion::scale(4, ab, cdy, y8), yylen = expansion::scale(ylen, y8, cdy, yy16);
+            const int clen = expansion::sum(xxlen, xx16, yylen, yy16, c32);
+            const int ablen = expansion::sum(alen, a32, blen, b32, ab64);
+            const int finlength = expansion::sum(ablen, ab64, clen, c32, fin);
+
+            const double det = estimate(finlength, fin);
+            const double errbound = ICC_ERRBOUND_B * permanent;
+            if (det >= errbound || -det >= errbound) return det;
+
+            // The differences were exact, so fin is the exact determinant
+            if (twoDiffTail(ax, dx, adx) == 0.0 && twoDiffTail(bx, dx, bdx) == 0.0 &&
+                twoDiffTail(cx, dx, cdx) == 0.0 && twoDiffTail(ay, dy, ady) == 0.0 &&
+                twoDiffTail(by, dy, bdy) == 0.0 && twoDiffTail(cy, dy, cdy) == 0.0) {
+                return fin[finlength - 1];
+            }
+            return incircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+        }
+
+        inline bool orient2dFilter(double ax, double ay, double bx, double by, double cx, double cy,
+                                   double &det, double &detsum) {
+            const double detleft = (ax - cx) * (by - cy);
+            const double detright = (ay - cy) * (bx - cx);
+            det = detleft - detright;
+
+            if (detleft > 0.0) {
+                if (detright <= 0.0) return true;
+                detsum = detleft + detright;
+            } else if (detleft < 0.0) {
+                if (detright >= 0.0) return true;
+                detsum = -detleft - detright;
+            } else {
+                return true;
+            }
+            const double errbound = expansion::CCW_ERRBOUND_A * detsum;
+            return det >= errbound || -det >= errbound;
+        }
+
+        inline bool incircleFilter(double ax, double ay, double bx, double by, double cx, double cy,
+                                   double dx, double dy, double &det, double &permanent) {
+            const double adx = ax - dx, bdx = bx - dx, cdx = cx - dx;
+            const double ady = ay - dy, bdy = by - dy, cdy = cy - dy;
+
+            const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+            const double alift = adx * adx + ady * ady;
+            const double cdxady = cdx * ady, adxcdy = adx * cdy;
+            const double blift = bdx * bdx + bdy * bdy;
+            const double adxbdy = adx * bdy, bdxady = bdx * ady;
+            const double clift = cdx * cdx + cdy * cdy;
+
+            det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+            permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift +
+                        (std::fabs(cdxady) + std::fabs(adxcdy)) * blift +
+                        (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+            const double errbound = expansion::ICC_ERRBOUND_A * permanent;
+            return det > errbound || -det > errbound;
+        }
+
+    }; // namespace detail
+
+    /**
+     * Orientation of the triangle a, b, c.
+     * @return Returns a positive value if a, b, c are counterclockwise, negative if clockwise
+     * and zero if they are collinear. The sign is exact.
+     */
+    template<class P>
+    inline double orient2d(const P &a, const P &b, const P &c) {
+        double det, detsum;
+        if (detail::orient2dFilter(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY(), det, detsum)) {
+            return det;
+        }
+        return detail::orient2dAdapt(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY(), detsum);
+    }
+
+    /**
+     * Position of d relative to the circle through a, b and c, which must be counterclockwise.
+     * @return Returns a positive value if d is inside the circle, negative if outside and zero
+     * if the four points are cocircular. The sign is exact.
+     */
+    template<class P>
+    inline double incircle(const P &a, const P &b, const P &c, const P &d) {
+        double det, permanent;
+        if (detail::incircleFilter(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY(),
+                                   d.getX(), d.getY(), det, permanent)) {
+            return det;
+        }
+        return detail::incircleAdapt(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY(),
+                                     d.getX(), d.getY(), permanent);
+    }
+
+    /**
+     * Whether the floating-point filter of orient2d alone decides the sign for these points.
+     */
+    template<class P>
+    inline bool orient2dFilter(const P &a, const P &b, const P &c) {
+        double det, detsum;
+        return detail::orient2dFilter(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY(), det, detsum);
+    }
+
+    /**
+     * Whether the floating-point filter of incircle alone decides the sign for these points.
+     */
+    template<class P>
+    inline bool incircleFilter(const P &a, const P &b, const P &c, const P &d) {
+        double det, permanent;
+        return detail::incircleFilter(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY(),
+                                      d.getX(), d.getY(), det, permanent);
+    }
+
+};// namespace graph_algo
+
+
+#endif /* PREDICATES_H_ */
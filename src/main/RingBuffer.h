@@ -0,0 +1,234 @@
+#ifndef RINGBUFFER_H_
+#define RINGBUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "AlignedAllocator.h"
+#include "RingIndex.h"
+
+/**
+ * Bounded lock-free queues for handing work between threads.
+ * - SpscRingBuffer is for exactly one producer thread and one consumer thread.
+ * - MpmcRingBuffer is for any number of producers and consumers (after Vyukov's
+ *   bounded MPMC queue, with a sequence number per slot).
+ *
+ * Both hold N slots, N must be a power of two. Producers and consumers count
+ * positions upwards without bound and the slot of a position is a
+ * RingIndex<std::size_t, N>, i.e. the position masked to the ring.
+ * The producer and consumer positions live on separate cache lines so that the
+ * two sides do not invalidate each other's line on every operation.
+ *
+ * Nothing blocks: tryPush fails on a full queue and tryPop on an empty one.
+ * The batch calls move as many items as fit and return how many they moved.
+ */
+
+namespace graph_algo {
+
+    template<class T, std::size_t N>
+    class SpscRingBuffer {
+    public:
+        static_assert(N > 0 && (N & (N - 1)) == 0, "the capacity must be a power of two");
+
+        SpscRingBuffer() : mHead(0), mTailCache(0), mTail(0), mHeadCache(0), mSlots(N) {}
+
+        static constexpr std::size_t capacity() { return N; }
+
+        /**
+         * Approximate number of queued items, exact when neither side is running
+         */
+        std::size_t size() const {
+            return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+
+        /**
+         * Producer side. Returns false if the queue is full.
+         */
+        bool tryPush(const T &item) {
+            return tryPushBatch(&item, 1) == 1;
+        }
+
+        /**
+         * Producer side. Pushes up to n items in order and returns how many were pushed.
+         */
+        std::size_t tryPushBatch(const T *items, std::size_t n) {
+            const std::size_t tail = mTail.load(std::memory_order_relaxed);
+            std::size_t free = N - (tail - mHeadCache);
+            if (free < n) {
+                mHeadCache = mHead.load(std::memory_order_acquire);
+                free = N - (tail - mHeadCache);
+            }
+            if (n > free) n = free;
+            for (std::size_t i = 0; i < n; ++i) {
+                mSlots[slot(tail + i)] = items[i];
+            }
+            if (n > 0) mTail.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        /**
+         * Consumer side. Returns false if the queue is empty.
+         */
+        bool tryPop(T &item) {
+            return tryPopBatch(&item, 1) == 1;
+        }
+
+        /**
+         * Consumer side. Pops up to n items in order into out and returns how many were popped.
+         */
+        std::size_t tryPopBatch(T *out, std::size_t n) {
+            const std::size_t head = mHead.load(std::memory_order_relaxed);
+            std::size_t available = mTailCache - head;
+            if (available < n) {
+                mTailCache = mTail.load(std::memory_order_acquire);
+                available = mTailCache - head;
+            }
+            if (n > available) n = available;
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = std::move(mSlots[slot(head + i)]);
+            }
+            if (n > 0) mHead.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+    private:
+        static std::size_t slot(std::size_t position) {
+            return RingIndex<std::size_t, N>() + position;
+        }
+
+        char mPad0[CACHE_LINE_SIZE];
+        // Consumer line
+        std::atomic<std::size_t> mHead;
+        std::size_t mTailCache;
+        char mPad1[CACHE_LINE_SIZE];
+        // Producer line
+        std::atomic<std::size_t> mTail;
+        std::size_t mHeadCache;
+        char mPad2[CACHE_LINE_SIZE];
+        std::vector<T, AlignedAllocator<T> > mSlots;
+
+    }; // SpscRingBuffer class
+
+    template<class T, std::size_t N>
+    class MpmcRingBuffer {
+    public:
+        static_assert(N > 0 && (N & (N - 1)) == 0, "the capacity must be a power of two");
+
+        MpmcRingBuffer() : mEnqueue(0), mDequeue(0), mCells(N) {
+            for (std::size_t i = 0; i < N; ++i) {
+                mCells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        static constexpr std::size_t capacity() { return N; }
+
+        /**
+         * Approximate number of queued items, exact when no thread is running
+         */
+        std::size_t size() const {
+            return mEnqueue.load(std::memory_order_acquire) - mDequeue.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+
+        /**
+         * Returns false if the queue is full.
+         */
+        bool tryPush(const T &item) {
+            return tryPushBatch(&item, 1) == 1;
+        }
+
+        /**
+         * Pushes up to n items as one consecutive run and returns how many were pushed.
+         * Items of one batch stay in order, batches of different producers may interleave.
+         */
+        std::size_t tryPushBatch(const T *items, std::size_t n) {
+            std::size_t position = mEnqueue.load(std::memory_order_relaxed);
+            std::size_t count;
+            do {
+                // A free slot has sequence == position, the run ends at the first slot still in use
+                count = 0;
+                while (count < n && mCells[slot(position + count)].sequence.load(std::memory_order_acquire) ==
+                                    position + count) {
+                    ++count;
+                }
+                if (count == 0) {
+                    const std::size_t current = mEnqueue.load(std::memory_order_relaxed);
+                    if (current == position) return 0;
+                    position = current;
+                    continue;
+                }
+            } while (count == 0 ||
+                     !mEnqueue.compare_exchange_weak(position, position + count, std::memory_order_relaxed));
+
+            for (std::size_t i = 0; i < count; ++i) {
+                Cell &cell = mCells[slot(position + i)];
+                cell.data = items[i];
+                cell.sequence.store(position + i + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        /**
+         * Returns false if the queue is empty.
+         */
+        bool tryPop(T &item) {
+            return tryPopBatch(&item, 1) == 1;
+        }
+
+        /**
+         * Pops up to n consecutive items into out and returns how many were popped.
+         */
+        std::size_t tryPopBatch(T *out, std::size_t n) {
+            std::size_t position = mDequeue.load(std::memory_order_relaxed);
+            std::size_t count;
+            do {
+                // A filled slot has sequence == position + 1
+                count = 0;
+                while (count < n && mCells[slot(position + count)].sequence.load(std::memory_order_acquire) ==
+                                    position + count + 1) {
+                    ++count;
+                }
+                if (count == 0) {
+                    const std::size_t current = mDequeue.load(std::memory_order_relaxed);
+                    if (current == position) return 0;
+                    position = current;
+                    continue;
+                }
+            } while (count == 0 ||
+                     !mDequeue.compare_exchange_weak(position, position + count, std::memory_order_relaxed));
+
+            for (std::size_t i = 0; i < count; ++i) {
+                Cell &cell = mCells[slot(position + i)];
+                out[i] = std::move(cell.data);
+                cell.sequence.store(position + i + N, std::memory_order_release);
+            }
+            return count;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T data;
+        };
+
+        static std::size_t slot(std::size_t position) {
+            return RingIndex<std::size_t, N>() + position;
+        }
+
+        char mPad0[CACHE_LINE_SIZE];
+        std::atomic<std::size_t> mEnqueue;
+        char mPad1[CACHE_LINE_SIZE];
+        std::atomic<std::size_t> mDequeue;
+        char mPad2[CACHE_LINE_SIZE];
+        std::vector<Cell, AlignedAllocator<Cell> > mCells;
+
+    }; // MpmcRingBuffer class
+
+};// namespace graph_algo
+
+
+#endif /* RINGBUFFER_H_ */
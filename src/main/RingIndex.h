@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <exception>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 
 namespace graph_algo {
@@ -22,121 +23,154 @@ namespace graph_algo {
 
     };
 
+    namespace detail {
+
+        /*
+         * v mod n in [0, n), also for negative v
+         */
+        template<class T>
+        constexpr T ringWrap(T v, T n) noexcept {
+            const T r = v % n;
+            return r < 0 ? r + n : r;
+        }
+
+        /*
+         * (i + v) mod n for i in [0, n). Steps smaller than the ring only need a conditional subtract.
+         */
+        template<class T>
+        constexpr T ringAdd(T i, T v, T n) noexcept {
+            if (v >= 0 && v < n) {
+                const T t = i + v;
+                return t >= n ? t - n : t;
+            }
+            return ringWrap(T(i + v % n), n);
+        }
+
+        /*
+         * (i - v) mod n for i in [0, n). Steps smaller than the ring only need a conditional add.
+         */
+        template<class T>
+        constexpr T ringSub(T i, T v, T n) noexcept {
+            if (v >= 0 && v < n) {
+                const T t = i - v;
+                return t < 0 ? t + n : t;
+            }
+            return ringWrap(T(i - v % n), n);
+        }
+
+    }; // namespace detail
+
 /**
- * A special list index, defined in such that it raps around instead of going out of bounds
+ * A special list index, defined in such that it raps around instead of going out of bounds.
+ *
+ * RingIndex<T> stores the ring size next to the index. RingIndex<T, N> has the size N fixed
+ * at compile time and stores only the index. When N is a power of two all wrapping is a mask.
+ * Both are literal types: everything but the checking constructors is constexpr and noexcept,
+ * so index tables and stencils over a ring can be computed at compile time.
  */
-    template<class T = int>
-    class RingIndex {
+    template<class T = int, std::size_t N = 0>
+    class RingIndex;
+
+    template<class T>
+    class RingIndex<T, 0> {
     public:
-        RingIndex() : mIndex(0), mSize(1) {}
+        constexpr RingIndex() noexcept : mIndex(0), mSize(1) {}
+
+        constexpr RingIndex(const RingIndex &) noexcept = default;
 
-        RingIndex(const T v) : mIndex(v), mSize(v + 1) {}
+        constexpr RingIndex(const T v) noexcept : mIndex(v), mSize(v + 1) {}
 
-        RingIndex(const T v, const T ringSize) : mIndex(v), mSize(ringSize) {
+        constexpr RingIndex(const T v, const T ringSize) : mIndex(v), mSize(ringSize) {
             if (ringSize <= v) throw RingIndexOutOfBoundException();
         }
 
-        RingIndex &operator=(const T v) {
-            if (v >= mSize) {
-                mIndex = v % mSize;
-            } else if (v >= 0) {
-                mIndex = v;
-            } else {
-                mIndex = (mSize + (v % mSize));
-            }
+        constexpr RingIndex &operator=(const T v) noexcept {
+            mIndex = v >= 0 && v < mSize ? v : detail::ringWrap(v, mSize);
             return *this;
         }
 
-        RingIndex &operator=(const RingIndex &ref) {
+        constexpr RingIndex &operator=(const RingIndex &ref) noexcept {
             mIndex = ref.mIndex;
             mSize = ref.mSize;
             return *this;
         }
 
-        T operator+(T v) const {
-            T t = mIndex + v;
-            if (t >= mSize)
-                t = t % mSize;
-            return t;
+        constexpr T operator+(T v) const noexcept {
+            return detail::ringAdd(mIndex, v, mSize);
         }
 
-        T operator-(const T v) const {
-            if (mIndex - v < 0) {
-                return mSize - (std::abs(mIndex - v) % mSize);
-            }
-            return mIndex - v;
+        constexpr T operator-(const T v) const noexcept {
+            return detail::ringSub(mIndex, v, mSize);
         }
 
-        operator T() const { return mIndex; }
+        constexpr operator T() const noexcept { return mIndex; }
 
-        friend inline bool operator<(const T &lhs, const RingIndex &rhs) {
+        friend constexpr bool operator<(const T &lhs, const RingIndex &rhs) noexcept {
             return lhs < rhs.mIndex;
         }
 
-        friend inline bool operator<(const RingIndex &lhs, const T &rhs) {
+        friend constexpr bool operator<(const RingIndex &lhs, const T &rhs) noexcept {
             return lhs.mIndex < rhs;
         }
 
-        inline bool operator<(const RingIndex &other) const {
+        constexpr bool operator<(const RingIndex &other) const noexcept {
             return mIndex < other.mIndex;
         }
 
-        friend inline bool operator>(const T &lhs, const RingIndex &rhs) {
+        friend constexpr bool operator>(const T &lhs, const RingIndex &rhs) noexcept {
             return lhs > rhs.mIndex;
         }
 
-        friend inline bool operator>(const RingIndex &lhs, const T &rhs) {
+        friend constexpr bool operator>(const RingIndex &lhs, const T &rhs) noexcept {
             return lhs.mIndex > rhs;
         }
 
-        inline bool operator>(const RingIndex &other) const {
+        constexpr bool operator>(const RingIndex &other) const noexcept {
             return mIndex > other.mIndex;
         }
 
-        friend inline bool operator==(const T &lhs, const RingIndex &rhs) {
+        friend constexpr bool operator==(const T &lhs, const RingIndex &rhs) noexcept {
             return lhs == rhs.mIndex;
         }
 
-        friend inline bool operator==(const RingIndex &lhs, const T &rhs) {
+        friend constexpr bool operator==(const RingIndex &lhs, const T &rhs) noexcept {
             return rhs == lhs.mIndex;
         }
 
-        inline bool operator==(const RingIndex &other) const {
+        constexpr bool operator==(const RingIndex &other) const noexcept {
             return other.mIndex == mIndex;
         }
 
-        const T operator++(T) { /* Suffix */
+        constexpr const T operator++(int) noexcept { /* Suffix */
             T tmp = mIndex;
             this->operator++();
             return tmp;
         }
 
-        const T operator++() { /* prefix */
-            if (mIndex >= mSize - 1) { mIndex = 0; }
-            else { ++mIndex; }
+        constexpr const T operator++() noexcept { /* prefix */
+            mIndex = mIndex + 1 == mSize ? 0 : mIndex + 1;
             return mIndex;
         }
 
-        const T operator--(T) { /* Suffix */
+        constexpr const T operator--(int) noexcept { /* Suffix */
             T tmp = mIndex;
             this->operator--();
             return tmp;
         }
 
-        const T operator--() { /* prefix */
-            if (mIndex == 0) { mIndex = mSize - 1; }
-            else { --mIndex; }
+        constexpr const T operator--() noexcept { /* prefix */
+            mIndex = mIndex == 0 ? mSize - 1 : mIndex - 1;
             return mIndex;
         }
 
-        void setSize(T ringSize) {
+        constexpr void setSize(T ringSize) noexcept {
             if (mIndex >= ringSize) {
                 mIndex %= ringSize;
             }
             mSize = ringSize;
         }
 
-        const T size() const {
+        constexpr T size() const noexcept {
             return mSize;
         }
 
@@ -146,6 +180,108 @@ namespace graph_algo {
 
     };
 
+    template<class T, std::size_t N>
+    class RingIndex {
+    public:
+        static_assert(N > 0, "the ring must not be empty");
+
+        constexpr RingIndex() noexcept : mIndex(0) {}
+
+        constexpr RingIndex(const T v) : mIndex(v) {
+            if (v < 0 || std::size_t(v) >= N) throw RingIndexOutOfBoundException();
+        }
+
+        constexpr RingIndex &operator=(const T v) noexcept {
+            mIndex = wrap(v);
+            return *this;
+        }
+
+        constexpr T operator+(T v) const noexcept {
+            return POWER_OF_TWO ? wrap(T(mIndex + v)) : detail::ringAdd(mIndex, v, T(N));
+        }
+
+        constexpr T operator-(const T v) const noexcept {
+            return POWER_OF_TWO ? wrap(T(mIndex - v)) : detail::ringSub(mIndex, v, T(N));
+        }
+
+        constexpr operator T() const noexcept { return mIndex; }
+
+        friend constexpr bool operator<(const T &lhs, const RingIndex &rhs) noexcept {
+            return lhs < rhs.mIndex;
+        }
+
+        friend constexpr bool operator<(const RingIndex &lhs, const T &rhs) noexcept {
+            return lhs.mIndex < rhs;
+        }
+
+        constexpr bool operator<(const RingIndex &other) const noexcept {
+            return mIndex < other.mIndex;
+        }
+
+        friend constexpr bool operator>(const T &lhs, const RingIndex &rhs) noexcept {
+            return lhs > rhs.mIndex;
+        }
+
+        friend constexpr bool operator>(const RingIndex &lhs, const T &rhs) noexcept {
+            return lhs.mIndex > rhs;
+        }
+
+        constexpr bool operator>(const RingIndex &other) const noexcept {
+            return mIndex > other.mIndex;
+        }
+
+        friend constexpr bool operator==(const T &lhs, const RingIndex &rhs) noexcept {
+            return lhs == rhs.mIndex;
+        }
+
+        friend constexpr bool operator==(const RingIndex &lhs, const T &rhs) noexcept {
+            return rhs == lhs.mIndex;
+        }
+
+        constexpr bool operator==(const RingIndex &other) const noexcept {
+            return other.mIndex == mIndex;
+        }
+
+        constexpr const T operator++(int) noexcept { /* Suffix */
+            T tmp = mIndex;
+            this->operator++();
+            return tmp;
+        }
+
+        constexpr const T operator++() noexcept { /* prefix */
+            mIndex = POWER_OF_TWO ? wrap(T(mIndex + 1)) : (mIndex + 1 == T(N) ? 0 : mIndex + 1);
+            return mIndex;
+        }
+
+        constexpr const T operator--(int) noexcept { /* Suffix */
+            T tmp = mIndex;
+            this->operator--();
+            return tmp;
+        }
+
+        constexpr const T operator--() noexcept { /* prefix */
+            mIndex = POWER_OF_TWO ? wrap(T(mIndex - 1)) : (mIndex == 0 ? T(N) - 1 : mIndex - 1);
+            return mIndex;
+        }
+
+        static constexpr T size() noexcept {
+            return T(N);
+        }
+
+    private:
+        static constexpr bool POWER_OF_TWO = (N & (N - 1)) == 0;
+
+        /*
+         * v mod N, a mask when N is a power of two. The unsigned cast keeps the mask right for negative v.
+         */
+        static constexpr T wrap(T v) noexcept {
+            return POWER_OF_TWO ? T(std::size_t(v) & (N - 1)) : detail::ringWrap(v, T(N));
+        }
+
+        T mIndex;
+
+    };
+
 }; //namespace graph_algo
 
 
@@ -0,0 +1,542 @@
+#ifndef SEGMENTINTERSECTION_H_
+#define SEGMENTINTERSECTION_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+#include "Predicates.h"
+
+/**
+ * All pairs of intersecting line segments with the sweep of Bentley and Ottmann, in
+ * O((n + k) log n) for n segments and k pairs.
+ *
+ * Segment i runs from endpoints[2i] to endpoints[2i + 1] of a PointBuffer and is closed:
+ * segments that touch, share an endpoint or overlap intersect, and a segment of length
+ * zero is a point. Every pair a < b is passed to report(a, b) once, as the sweep finds it,
+ * so the pairs are never collected unless the caller does so.
+ *
+ * The sweep line moves from left to right and stops at endpoints and crossings, in the
+ * order of x and then y. The segments that cross it are kept sorted from bottom to top in
+ * a vector, which is cheaper to search and to shift than a tree for the lengths sweep lines
+ * reach in practice. At a stop p the segments that start, end or pass through p are
+ * reported against each other, and those that go on are put back in their order right of
+ * p, the handling of degenerate cases by de Berg et al., "Computational Geometry" (2008).
+ * Only the new neighbours are tested for crossings ahead of the sweep line.
+ *
+ * Whether two segments meet is decided exactly with orient2d. Segments that touch, at an
+ * endpoint or along an overlap, are reported at their first common point, which is exact.
+ * The point of a proper crossing is rounded, so segments through one point may get stops a
+ * little apart; such a pair is reported at the stop where it changes places in the sweep
+ * line instead, which happens once however the rounding falls. Neighbours whose crossing
+ * rounds to behind the sweep line change places as soon as they are found. The slopes that
+ * order the segments right of a stop are compared exactly, and the segments that pass a stop
+ * closer than rounding are handled with the ones through it, so a crossing rounded to the
+ * wrong side of an endpoint still finds its pairs.
+ *
+ * With threads > 1 the plane is cut into vertical strips with about equally many segments,
+ * each strip sweeps the segments that reach into it on its own thread and reports the pairs
+ * that meet inside it. report is then called from several threads at once.
+ *
+ * SegmentIntersector keeps its event lists and sweep lines between calls. Not thread safe,
+ * use one intersector per thread.
+ */
+
+namespace graph_algo {
+
+    /**
+     * Strips with fewer segments than this are not worth a thread of their own
+     */
+    static const std::size_t PARALLEL_SEGMENT_GRAIN = 1 << 14;
+
+    namespace detail {
+
+        typedef PackedPoint<double> SweepPoint;
+
+        /*
+         * a before b in the order of the sweep, by x and then by y
+         */
+        inline bool sweepBefore(const SweepPoint &a, const SweepPoint &b) {
+            return a.getX() < b.getX() || (a.getX() == b.getX() && a.getY() < b.getY());
+        }
+
+        inline bool samePoint(const SweepPoint &a, const SweepPoint &b) {
+            return a.getX() == b.getX() && a.getY() == b.getY();
+        }
+
+        /*
+         * (a1 - a0) & (b1 - b0) with the sign always correct, by the filter of orient2d and
+         * expansion arithmetic when it cannot decide
+         */
+        inline double crossDifferences(const SweepPoint &a0, const SweepPoint &a1, const SweepPoint &b0,
+                                       const SweepPoint &b1) {
+            using namespace expansion;
+            const double left = (a1.getX() - a0.getX()) * (b1.getY() - b0.getY());
+            const double right = (a1.getY() - a0.getY()) * (b1.getX() - b0.getX());
+            const double det = left - right;
+            if (std::fabs(det) > CCW_ERRBOUND_A * (std::fabs(left) + std::fabs(right))) return det;
+            const Expansion exact = sum(product(difference(a1.getX(), a0.getX()), difference(b1.getY(), b0.getY())),
+                                        negate(product(difference(a1.getY(), a0.getY()), difference(b1.getX(), b0.getX()))));
+            return exact.back();
+        }
+
+        /*
+         * The segments of an endpoint buffer, left end first
+         */
+        template<class T>
+        struct SegmentTable {
+            const T *xs, *ys;
+
+            SweepPoint left(std::uint32_t s) const {
+                const SweepPoint a = point(2 * std::size_t(s)), b = point(2 * std::size_t(s) + 1);
+                return sweepBefore(b, a) ? b : a;
+            }
+
+            SweepPoint right(std::uint32_t s) const {
+                const SweepPoint a = point(2 * std::size_t(s)), b = point(2 * std::size_t(s) + 1);
+                return sweepBefore(b, a) ? a : b;
+            }
+
+            SweepPoint point(std::size_t i) const {
+                return SweepPoint(double(xs[i]), double(ys[i]));
+            }
+
+            /*
+             * Whether the closed segments a and b meet, and where their first common point in the
+             * order of the sweep is: an endpoint when one lies on the other, else the rounded crossing.
+             * proper is set when they cross inside both, which is when at is rounded.
+             */
+            bool meet(std::uint32_t a, std::uint32_t b, SweepPoint &at, bool &proper) const {
+                proper = false;
+                if (a > b) std::swap(a, b);
+                const SweepPoint a0 = left(a), a1 = right(a), b0 = left(b), b1 = right(b);
+                if (a1.getX() < b0.getX() || b1.getX() < a0.getX()) return false;
+                if (samePoint(a0, a1)) {
+                    at = a0;
+                    return contains(b0, b1, a0);
+                }
+                if (samePoint(b0, b1)) {
+                    at = b0;
+                    return contains(a0, a1, b0);
+                }
+                const double o1 = orient2d(a0, a1, b0), o2 = orient2d(a0, a1, b1);
+                if (o1 == 0.0 && o2 == 0.0) {
+                    // Collinear, they overlap from the later of the left ends on
+                    at = sweepBefore(a0, b0) ? b0 : a0;
+                    return !sweepBefore(a1, b0) && !sweepBefore(b1, a0);
+                }
+                if ((o1 > 0.0 && o2 > 0.0) || (o1 < 0.0 && o2 < 0.0)) return false;
+                const double o3 = orient2d(b0, b1, a0), o4 = orient2d(b0, b1, a1);
+                if ((o3 > 0.0 && o4 > 0.0) || (o3 < 0.0 && o4 < 0.0)) return false;
+                if (o1 == 0.0) {
+                    at = b0;
+                } else if (o2 == 0.0) {
+                    at = b1;
+                } else if (o3 == 0.0) {
+                    at = a0;
+                } else if (o4 == 0.0) {
+                    at = a1;
+                } else {
+                    // In the order of the ends rather than of the ids, so that equal segments round alike
+                    const bool swapped = sweepBefore(b0, a0) || (samePoint(a0, b0) && sweepBefore(b1, a1));
+                    at = swapped ? crossing(b0, b1, a0, a1) : crossing(a0, a1, b0, b1);
+                    proper = true;
+                }
+                return true;
+            }
+
+            /*
+             * Whether p lies on the segment from a to b, a before b
+             */
+            static bool contains(const SweepPoint &a, const SweepPoint &b, const SweepPoint &p) {
+                if (sweepBefore(p, a) || sweepBefore(b, p)) return false;
+                return samePoint(a, b) ? samePoint(a, p) : orient2d(a, b, p) == 0.0;
+            }
+
+            /*
+             * The crossing of two segments that cross properly, kept between the later left end
+             * and the earlier right end so that both segments are on the sweep line there
+             */
+            static SweepPoint crossing(const SweepPoint &a0, const SweepPoint &a1, const SweepPoint &b0,
+                                       const SweepPoint &b1) {
+                const double dax = a1.getX() - a0.getX(), day = a1.getY() - a0.getY();
+                const double dbx = b1.getX() - b0.getX(), dby = b1.getY() - b0.getY();
+                double x, y;
+                if (dax == 0.0 || dbx == 0.0) {
+                    // On a vertical segment, every crossing at one height rounds the same
+                    const SweepPoint &c = dax == 0.0 ? b0 : a0;
+                    const double dx = dax == 0.0 ? dbx : dax, dy = dax == 0.0 ? dby : day;
+                    x = dax == 0.0 ? a0.getX() : b0.getX();
+                    y = c.getY() + (x - c.getX()) * dy / dx;
+                } else if (day == 0.0 || dby == 0.0) {
+                    const SweepPoint &c = day == 0.0 ? b0 : a0;
+                    const double dx = day == 0.0 ? dbx : dax, dy = day == 0.0 ? dby : day;
+                    y = day == 0.0 ? a0.getY() : b0.getY();
+                    x = c.getX() + (y - c.getY()) * dx / dy;
+                } else {
+                    const double t = ((b0.getX() - a0.getX()) * dby - (b0.getY() - a0.getY()) * dbx) / (dax * dby - day * dbx);
+                    x = a0.getX() + t * dax;
+                    y = a0.getY() + t * day;
+                }
+                x = std::min(std::max(x, std::max(a0.getX(), b0.getX())), std::min(a1.getX(), b1.getX()));
+                y = std::min(std::max(y, std::max(std::min(a0.getY(), a1.getY()), std::min(b0.getY(), b1.getY()))),
+                             std::min(std::max(a0.getY(), a1.getY()), std::max(b0.getY(), b1.getY())));
+                SweepPoint at(x, y);
+                const SweepPoint first = sweepBefore(a0, b0) ? b0 : a0, last = sweepBefore(a1, b1) ? a1 : b1;
+                if (sweepBefore(at, first)) at = first;
+                if (sweepBefore(last, at)) at = last;
+                return at;
+            }
+        };
+
+        /*
+         * A crossing ahead of the sweep line, for the heap of SegmentSweep
+         */
+        struct SweepCrossing {
+            SweepPoint point;
+            std::uint32_t a, b;
+
+            bool operator<(const SweepCrossing &c) const {
+                // The earliest point on top of the heap
+                return sweepBefore(c.point, point);
+            }
+        };
+
+        /*
+         * The sweep over the segments of one strip
+         */
+        template<class T>
+        class SegmentSweep {
+        public:
+            /**
+             * Sweeps the given segments and reports the pairs that meet at an x in [x0, x1)
+             */
+            template<class F>
+            void run(const SegmentTable<T> &table, const std::vector<std::uint32_t> &segments, double x0, double x1,
+                     F &report) {
+                mTable = &table;
+                sortByPoint(segments, true, mByLeft);
+                sortByPoint(segments, false, mByRight);
+                mCrossings.clear();
+                mStatus.clear();
+
+                std::size_t nextLeft = 0, nextRight = 0;
+                const std::size_t n = segments.size();
+                while (nextRight < n) {
+                    // The next stop is the earliest of the next left end, right end and crossing
+                    SweepPoint p = table.right(mByRight[nextRight]);
+                    if (nextLeft < n && sweepBefore(table.left(mByLeft[nextLeft]), p)) p = table.left(mByLeft[nextLeft]);
+                    if (!mCrossings.empty() && sweepBefore(mCrossings.front().point, p)) p = mCrossings.front().point;
+                    if (p.getX() >= x1) break;
+
+                    mStarting.clear();
+                    mNamed.clear();
+                    for (; nextLeft < n && samePoint(table.left(mByLeft[nextLeft]), p); ++nextLeft) {
+                        mStarting.push_back(mByLeft[nextLeft]);
+                    }
+                    for (; nextRight < n && samePoint(table.right(mByRight[nextRight]), p); ++nextRight) {
+                        if (!samePoint(table.left(mByRight[nextRight]), p)) mNamed.push_back(mByRight[nextRight]);
+                    }
+                    while (!mCrossings.empty() && samePoint(mCrossings.front().point, p)) {
+                        mNamed.push_back(mCrossings.front().a);
+                        mNamed.push_back(mCrossings.front().b);
+                        std::pop_heap(mCrossings.begin(), mCrossings.end());
+                        mCrossings.pop_back();
+                    }
+                    stop(p, p.getX() >= x0, report);
+                }
+            }
+
+            std::size_t memoryUsage() const {
+                return (mByLeft.capacity() + mByRight.capacity() + mStatus.capacity() + mStarting.capacity() +
+                        mNamed.capacity() + mGroup.capacity()) * sizeof(std::uint32_t) +
+                       mCrossings.capacity() * sizeof(SweepCrossing) + mKeys.capacity() * sizeof(Key);
+            }
+
+        private:
+            struct Key {
+                SweepPoint point;
+                std::uint32_t segment;
+
+                bool operator<(const Key &k) const { return sweepBefore(point, k.point); }
+            };
+
+            /*
+             * The segments in the order of their left or right ends, sorted on copies of the ends
+             */
+            void sortByPoint(const std::vector<std::uint32_t> &segments, bool left, std::vector<std::uint32_t> &out) {
+                mKeys.resize(segments.size());
+                for (std::size_t i = 0; i < segments.size(); ++i) {
+                    const Key key = {left ? mTable->left(segments[i]) : mTable->right(segments[i]), segments[i]};
+                    mKeys[i] = key;
+                }
+                std::sort(mKeys.begin(), mKeys.end());
+                out.resize(segments.size());
+                for (std::size_t i = 0; i < segments.size(); ++i) out[i] = mKeys[i].segment;
+            }
+
+            /*
+             * Handles the segments that start, end or pass through p
+             */
+            template<class F>
+            void stop(const SweepPoint &p, bool reporting, F &report) {
+                // The segments through p are together in the sweep line, the ones named by ends and
+                // crossings may be a little apart after rounding
+                std::size_t lo = lowerBound(p), hi = lo;
+                while (hi < mStatus.size() && orient(mStatus[hi], p) == 0.0) ++hi;
+                for (std::size_t k = 0; k < mNamed.size(); ++k) {
+                    const std::uint32_t s = mNamed[k];
+                    if (std::find(mStatus.begin() + lo, mStatus.begin() + hi, s) != mStatus.begin() + hi) continue;
+                    std::size_t below = lo, above = hi;
+                    while (below > 0 || above < mStatus.size()) {
+                        if (below > 0 && mStatus[--below] == s) {
+                            lo = below;
+                            break;
+                        }
+                        if (above < mStatus.size() && mStatus[above++] == s) {
+                            hi = above;
+                            break;
+                        }
+                    }
+                }
+                // Neighbours that meet one of them at p, or overlap one, are at p as well. Left
+                // out, they would keep their place while the group is reordered around them. So
+                // are the ones that pass closer to p than rounding: crossings rounded to the wrong
+                // side of p leave them out of order around it.
+                while (lo > 0 && (near(mStatus[lo - 1], p) || joins(mStatus[lo - 1], lo, hi, p))) --lo;
+                while (hi < mStatus.size() && (near(mStatus[hi], p) || joins(mStatus[hi], lo, hi, p))) ++hi;
+
+                // Every pair of the segments at p that first touches at p or crosses here, the
+                // segments of the sweep line from bottom to top and then the starting ones
+                mGroup.assign(mStatus.begin() + lo, mStatus.begin() + hi);
+                mGroup.insert(mGroup.end(), mStarting.begin(), mStarting.end());
+                if (reporting && mGroup.size() > 1) {
+                    for (std::size_t i = 0; i < mGroup.size(); ++i) {
+                        for (std::size_t j = i + 1; j < mGroup.size(); ++j) {
+                            reportAt(mGroup[i], mGroup[j], j < hi - lo, p, report);
+                        }
+                    }
+                }
+
+                // The segments that go on, in their order right of p
+                std::size_t count = 0;
+                for (std::size_t k = 0; k < mGroup.size(); ++k) {
+                    if (!samePoint(mTable->right(mGroup[k]), p)) mGroup[count++] = mGroup[k];
+                }
+                mGroup.resize(count);
+                std::sort(mGroup.begin(), mGroup.end(), [this](std::uint32_t a, std::uint32_t b) {
+                    return steeper(b, a);
+                });
+                mStatus.erase(mStatus.begin() + lo, mStatus.begin() + hi);
+                mStatus.insert(mStatus.begin() + lo, mGroup.begin(), mGroup.end());
+
+                if (lo > 0 && lo < mStatus.size()) check(lo, p, reporting, report);
+                if (count > 0 && lo + count < mStatus.size()) check(lo + count, p, reporting, report);
+            }
+
+            /*
+             * The neighbours mStatus[i - 1] and mStatus[i] get a stop where they meet ahead of p.
+             * If rounding put their crossing behind p they are swapped here instead.
+             */
+            template<class F>
+            void check(std::size_t i, const SweepPoint &p, bool reporting, F &report) {
+                const std::uint32_t a = mStatus[i - 1], b = mStatus[i];
+                SweepPoint at;
+                bool proper;
+                if (!mTable->meet(a, b, at, proper)) return;
+                if (sweepBefore(p, at)) {
+                    const SweepCrossing crossing = {at, a, b};
+                    mCrossings.push_back(crossing);
+                    std::push_heap(mCrossings.begin(), mCrossings.end());
+                } else if (proper) {
+                    if (!steeper(a, b)) return;
+                    std::swap(mStatus[i - 1], mStatus[i]);
+                    if (reporting) report(std::min(a, b), std::max(a, b));
+                    if (i > 1) check(i - 1, p, reporting, report);
+                    if (i + 1 < mStatus.size()) check(i + 1, p, reporting, report);
+                } else if (reporting && samePoint(at, p)) {
+                    // Rounding left one of them out of the segments at p
+                    report(std::min(a, b), std::max(a, b));
+                }
+            }
+
+            /*
+             * Whether s meets one of the segments mStatus[lo, hi) or mStarting at p, or overlaps one
+             */
+            bool joins(std::uint32_t s, std::size_t lo, std::size_t hi, const SweepPoint &p) const {
+                for (std::size_t k = lo; k < hi + mStarting.size(); ++k) {
+                    const std::uint32_t other = k < hi ? mStatus[k] : mStarting[k - hi];
+                    SweepPoint at;
+                    bool proper;
+                    if (!mTable->meet(s, other, at, proper)) continue;
+                    if (samePoint(at, p)) return true;
+                    if (orient(s, mTable->left(other)) == 0.0 && orient(s, mTable->right(other)) == 0.0) return true;
+                }
+                return false;
+            }
+
+            /*
+             * Touching pairs are reported at their first common point, which is exact. Crossing
+             * pairs are reported where they change places in the sweep line, which happens once
+             * wherever their rounded crossing falls: a is below b and would not be above it
+             * right of p yet, or b starts at p and takes its place right of p at once.
+             */
+            template<class F>
+            void reportAt(std::uint32_t a, std::uint32_t b, bool below, const SweepPoint &p, F &report) const {
+                SweepPoint at;
+                bool proper;
+                if (!mTable->meet(a, b, at, proper)) return;
+                if (proper ? !below || steeper(a, b) : samePoint(at, p)) report(std::min(a, b), std::max(a, b));
+            }
+
+            /*
+             * Positive if p is above segment s
+             */
+            double orient(std::uint32_t s, const SweepPoint &p) const {
+                return orient2d(mTable->left(s), mTable->right(s), p);
+            }
+
+            /*
+             * Whether s passes p closer than the rounding of a crossing can move it, a few ulps of
+             * the largest coordinate
+             */
+            bool near(std::uint32_t s, const SweepPoint &p) const {
+                const SweepPoint a = mTable->left(s), b = mTable->right(s);
+                const double largest = std::max(std::max(std::max(std::fabs(a.getX()), std::fabs(a.getY())),
+                                                         std::max(std::fabs(b.getX()), std::fabs(b.getY()))),
+                                                std::max(std::fabs(p.getX()), std::fabs(p.getY())));
+                const double tolerance = 64.0 * std::numeric_limits<double>::epsilon() * largest, area = orient(s, p);
+                return area * area <= tolerance * tolerance * (b - a).squaredLength();
+            }
+
+            /*
+             * The first segment of the sweep line that is not below p
+             */
+            std::size_t lowerBound(const SweepPoint &p) const {
+                std::size_t first = 0, count = mStatus.size();
+                while (count > 0) {
+                    const std::size_t half = count / 2;
+                    if (orient(mStatus[first + half], p) > 0.0) {
+                        first += half + 1;
+                        count -= half + 1;
+                    } else {
+                        count = half;
+                    }
+                }
+                return first;
+            }
+
+            /*
+             * Whether a rises more steeply than b, vertical segments the most. Ties go by id.
+             */
+            bool steeper(std::uint32_t a, std::uint32_t b) const {
+                const double turn = crossDifferences(mTable->left(b), mTable->right(b), mTable->left(a), mTable->right(a));
+                return turn != 0.0 ? turn > 0.0 : a > b;
+            }
+
+            const SegmentTable<T> *mTable = nullptr;
+            std::vector<std::uint32_t> mByLeft;
+            std::vector<std::uint32_t> mByRight;
+            std::vector<SweepCrossing> mCrossings;
+            std::vector<std::uint32_t> mStatus;
+            std::vector<std::uint32_t> mStarting;
+            std::vector<std::uint32_t> mNamed;
+            std::vector<std::uint32_t> mGroup;
+            std::vector<Key> mKeys;
+        };
+
+    }; // namespace detail
+
+    template<class T = double>
+    class SegmentIntersector {
+    public:
+        /**
+         * Calls report(a, b) for every pair a < b of segments that meet.
+         * @param endpoints Segment i runs from endpoints[2i] to endpoints[2i + 1].
+         * @param threads The number of strips swept in parallel, 0 for one per core. With more
+         * than one, report is called from several threads at once.
+         */
+        template<class F>
+        void forEachIntersection(const PointBuffer<T> &endpoints, F report, unsigned threads = 1) {
+            const detail::SegmentTable<T> table = {endpoints.xs(), endpoints.ys()};
+            const std::size_t n = endpoints.size() / 2;
+            const unsigned strips = detail::chunkCount(n, threads, PARALLEL_SEGMENT_GRAIN);
+            if (mSweeps.size() < strips) mSweeps.resize(strips);
+            if (mStrips.size() < strips) mStrips.resize(strips);
+            const double infinity = std::numeric_limits<double>::infinity();
+            if (strips == 1) {
+                mStrips[0].resize(n);
+                for (std::size_t s = 0; s < n; ++s) mStrips[0][s] = std::uint32_t(s);
+                mSweeps[0].run(table, mStrips[0], -infinity, infinity, report);
+                return;
+            }
+
+            // Strip boundaries at quantiles of a sample of the left ends
+            mBounds.clear();
+            const std::size_t step = std::max<std::size_t>(1, n / 65536);
+            for (std::size_t s = 0; s < n; s += step) mBounds.push_back(table.left(std::uint32_t(s)).getX());
+            std::sort(mBounds.begin(), mBounds.end());
+            std::vector<double> cuts(strips + 1);
+            cuts[0] = -infinity;
+            cuts[strips] = infinity;
+            for (unsigned c = 1; c < strips; ++c) cuts[c] = mBounds[c * mBounds.size() / strips];
+
+            // A strip sweeps every segment that reaches into it
+            for (unsigned c = 0; c < strips; ++c) mStrips[c].clear();
+            for (std::size_t s = 0; s < n; ++s) {
+                const double left = table.left(std::uint32_t(s)).getX(), right = table.right(std::uint32_t(s)).getX();
+                const unsigned first = unsigned(std::upper_bound(cuts.begin() + 1, cuts.end() - 1, left) - cuts.begin()) - 1;
+                for (unsigned c = first; c < strips && cuts[c] <= right; ++c) mStrips[c].push_back(std::uint32_t(s));
+            }
+            detail::forEachChunk(strips, strips, [&](unsigned c, std::size_t, std::size_t) {
+                mSweeps[c].run(table, mStrips[c], cuts[c], cuts[c + 1], report);
+            });
+        }
+
+        template<class F, class P>
+        void forEachIntersection(const std::vector<P> &endpoints, F report, unsigned threads = 1) {
+            forEachIntersection(PointBuffer<T>(endpoints), report, threads);
+        }
+
+        std::size_t memoryUsage() const {
+            std::size_t bytes = mBounds.capacity() * sizeof(double);
+            for (std::size_t c = 0; c < mSweeps.size(); ++c) bytes += mSweeps[c].memoryUsage();
+            for (std::size_t c = 0; c < mStrips.size(); ++c) bytes += mStrips[c].capacity() * sizeof(std::uint32_t);
+            return bytes;
+        }
+
+    private:
+        std::vector<detail::SegmentSweep<T> > mSweeps;
+        std::vector<std::vector<std::uint32_t> > mStrips;
+        std::vector<double> mBounds;
+
+    }; // SegmentIntersector class
+
+    /**
+     * Every pair a < b of segments that meet, sorted.
+     * @param endpoints Segment i runs from endpoints[2i] to endpoints[2i + 1].
+     */
+    template<class T>
+    std::vector<std::pair<std::uint32_t, std::uint32_t> > segmentIntersections(const PointBuffer<T> &endpoints,
+                                                                               unsigned threads = 1) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t> > pairs;
+        std::mutex mutex;
+        SegmentIntersector<T>().forEachIntersection(endpoints, [&pairs, &mutex](std::uint32_t a, std::uint32_t b) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pairs.push_back(std::make_pair(a, b));
+        }, threads);
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+};// namespace graph_algo
+
+
+#endif /* SEGMENTINTERSECTION_H_ */
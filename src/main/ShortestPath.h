@@ -0,0 +1,627 @@
+#ifndef SHORTESTPATH_H_
+#define SHORTESTPATH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * Single source shortest paths over a CsrGraph with non-negative edge weights.
+ * - dijkstra is Dijkstra's algorithm on a radix heap.
+ * - astar is A* from a source to a target. The heuristic is the Euclidean distance
+ *   (operator| of the vertex coordinates) to the target, times a scale. It needs the
+ *   graph coordinates and is exact as long as no edge is shorter than scale times the
+ *   distance of its ends, e.g. scale 1 for lengths or 1 / top speed for travel times.
+ * - deltaStepping is Meyer and Sanders' delta-stepping on several threads. The vertices
+ *   are put in buckets of width delta. The vertices of the lowest bucket are settled
+ *   together, relaxing their light edges (weight <= delta) until the bucket stays empty,
+ *   then their heavy edges once. The buckets are a ring of slots that only needs to span
+ *   the largest edge weight, and a delta so small that the ring would need more than
+ *   DELTA_STEPPING_MAX_BUCKETS slots is raised to fit.
+ *
+ * The source and target vertices are of the graph's index type, so a literal such as
+ * dijkstra(graph, 0) converts to it.
+ *
+ * ShortestPathSearch keeps its arrays between queries and only resets the vertices the
+ * previous query touched, so a point to point query costs the part of the graph it
+ * explores rather than the whole graph.
+ */
+
+namespace graph_algo {
+
+    /**
+     * Phases of delta-stepping smaller than this per thread are not worth splitting
+     */
+    static const std::size_t PARALLEL_SSSP_GRAIN = 1 << 10;
+
+    /**
+     * The most buckets delta-stepping keeps, each thread has a ring of this many slots at most
+     */
+    static const std::size_t DELTA_STEPPING_MAX_BUCKETS = 1 << 14;
+
+    namespace detail {
+
+        template<class Weight>
+        inline Weight unreachable() {
+            return std::numeric_limits<Weight>::has_infinity ? std::numeric_limits<Weight>::infinity()
+                                                             : std::numeric_limits<Weight>::max();
+        }
+
+        /*
+         * The bits of a non-negative key as an unsigned integer of the same order.
+         * Non-negative IEEE floating point numbers order like their bit patterns.
+         */
+        template<class Key, class Enable = void>
+        struct RadixKey {
+            typedef typename std::make_unsigned<Key>::type bits_type;
+
+            static bits_type toBits(Key key) { return bits_type(key); }
+
+            static Key fromBits(bits_type bits) { return Key(bits); }
+        };
+
+        template<class Key, class Bits>
+        struct FloatRadixKey {
+            typedef Bits bits_type;
+
+            static bits_type toBits(Key key) {
+                bits_type bits;
+                std::memcpy(&bits, &key, sizeof(bits));
+                return bits;
+            }
+
+            static Key fromBits(bits_type bits) {
+                Key key;
+                std::memcpy(&key, &bits, sizeof(key));
+                return key;
+            }
+        };
+
+        template<>
+        struct RadixKey<float> : FloatRadixKey<float, std::uint32_t> {
+        };
+
+        template<>
+        struct RadixKey<double> : FloatRadixKey<double, std::uint64_t> {
+        };
+
+        inline int highestBit(std::uint64_t v) {
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(v);
+#else
+            int bit = 0;
+            while (v >>= 1) ++bit;
+            return bit;
+#endif
+        }
+
+        /*
+         * A reusable barrier for a fixed number of threads, spinning with yield
+         */
+        class SpinBarrier {
+        public:
+            explicit SpinBarrier(unsigned threads) : mThreads(threads), mWaiting(0), mGeneration(0) {}
+
+            void wait() {
+                const unsigned generation = mGeneration.load(std::memory_order_acquire);
+                if (mWaiting.fetch_add(1, std::memory_order_acq_rel) + 1 == mThreads) {
+                    mWaiting.store(0, std::memory_order_relaxed);
+                    mGeneration.store(generation + 1, std::memory_order_release);
+                } else {
+                    while (mGeneration.load(std::memory_order_acquire) == generation) std::this_thread::yield();
+                }
+            }
+
+        private:
+            const unsigned mThreads;
+            std::atomic<unsigned> mWaiting;
+            std::atomic<unsigned> mGeneration;
+
+        }; // SpinBarrier class
+
+    }; // namespace detail
+
+    /**
+     * A monotone priority queue: a popped key is never larger than any key pushed after it,
+     * which holds for Dijkstra. Keys are non-negative numbers, a key goes into the bucket of
+     * the highest bit in which it differs from the last popped key, so that every element
+     * moves between buckets at most once per bit and push and pop are O(1) amortized.
+     * The elements only keep the bits of their key, 8 bytes for float keys and 32 bit values.
+     */
+    template<class Key, class Value>
+    class RadixHeap {
+    public:
+        RadixHeap() : mSize(0), mLast(0) {}
+
+        std::size_t size() const { return mSize; }
+
+        bool empty() const { return mSize == 0; }
+
+        void clear() {
+            for (int b = 0; b < BUCKETS; ++b) mBuckets[b].clear();
+            mSize = 0;
+            mLast = 0;
+        }
+
+        /**
+         * The last popped key, the lower bound of every key that may still be pushed
+         */
+        Key lastKey() const { return traits::fromBits(mLast); }
+
+        /**
+         * Pushes value with a key not smaller than lastKey()
+         */
+        void push(Key key, const Value &value) {
+            const bits_type bits = traits::toBits(key);
+            mBuckets[bucket(bits)].push_back(Entry(bits, value));
+            ++mSize;
+        }
+
+        /**
+         * Removes an element of the smallest key, the heap must not be empty
+         */
+        std::pair<Key, Value> pop() {
+            if (mBuckets[0].empty()) {
+                int b = 1;
+                while (mBuckets[b].empty()) ++b;
+                // The smallest key of the first nonempty bucket becomes the new last key
+                std::vector<Entry> &from = mBuckets[b];
+                bits_type smallest = from[0].bits;
+                for (std::size_t i = 1; i < from.size(); ++i) {
+                    smallest = std::min(smallest, from[i].bits);
+                }
+                mLast = smallest;
+                for (std::size_t i = 0; i < from.size(); ++i) {
+                    mBuckets[bucket(from[i].bits)].push_back(from[i]);
+                }
+                from.clear();
+            }
+            const Entry entry = mBuckets[0].back();
+            mBuckets[0].pop_back();
+            --mSize;
+            return std::make_pair(traits::fromBits(entry.bits), entry.value);
+        }
+
+    private:
+        typedef detail::RadixKey<Key> traits;
+        typedef typename traits::bits_type bits_type;
+
+        static const int BUCKETS = 8 * sizeof(bits_type) + 1;
+
+        struct Entry {
+            Entry(bits_type b, const Value &v) : bits(b), value(v) {}
+
+            bits_type bits;
+            Value value;
+        };
+
+        int bucket(bits_type bits) const {
+            return bits == mLast ? 0 : detail::highestBit(std::uint64_t(bits ^ mLast)) + 1;
+        }
+
+        std::vector<Entry> mBuckets[BUCKETS];
+        std::size_t mSize;
+        bits_type mLast;
+
+    }; // RadixHeap class
+
+    /**
+     * The result of a single source shortest path computation
+     */
+    template<class Index, class Weight>
+    class ShortestPaths {
+    public:
+        static const Index NO_VERTEX = std::numeric_limits<Index>::max();
+
+        ShortestPaths() : mSource(NO_VERTEX) {}
+
+        ShortestPaths(Index source, std::vector<Weight> distances, std::vector<Index> parents)
+                : mSource(source), mDistances(std::move(distances)), mParents(std::move(parents)) {}
+
+        Index source() const { return mSource; }
+
+        bool reached(Index v) const { return mParents[v] != NO_VERTEX; }
+
+        /**
+         * The length of a shortest path to v, infinity (or the largest Weight) if v is not reached
+         */
+        Weight distance(Index v) const { return mDistances[v]; }
+
+        /**
+         * The vertex before v on a shortest path, the source for itself and NO_VERTEX if v is not reached
+         */
+        Index parent(Index v) const { return mParents[v]; }
+
+        /**
+         * The vertices of a shortest path from the source to v, empty if v is not reached
+         */
+        std::vector<Index> path(Index v) const {
+            std::vector<Index> vertices;
+            if (!reached(v)) return vertices;
+            for (; v != mSource; v = mParents[v]) vertices.push_back(v);
+            vertices.push_back(mSource);
+            std::reverse(vertices.begin(), vertices.end());
+            return vertices;
+        }
+
+        const std::vector<Weight> &distances() const { return mDistances; }
+
+        const std::vector<Index> &parents() const { return mParents; }
+
+    private:
+        Index mSource;
+        std::vector<Weight> mDistances;
+        std::vector<Index> mParents;
+
+    }; // ShortestPaths class
+
+    template<class Index, class Weight>
+    const Index ShortestPaths<Index, Weight>::NO_VERTEX;
+
+    /**
+     * Dijkstra and A* queries on one graph that reuse their arrays.
+     * Not thread safe, use one search per thread.
+     */
+    template<class Index, class Weight, class Coord>
+    class ShortestPathSearch {
+    public:
+        typedef CsrGraph<Index, Weight, Coord> graph_type;
+
+        static const Index NO_VERTEX = ShortestPaths<Index, Weight>::NO_VERTEX;
+
+        explicit ShortestPathSearch(const graph_type &graph)
+                : mGraph(graph), mSource(NO_VERTEX), mDistances(graph.vertexCount(), detail::unreachable<Weight>()),
+                  mParents(graph.vertexCount(), NO_VERTEX), mSettled(graph.vertexCount(), false), mSettledCount(0) {}
+
+        /**
+         * Shortest paths from source to every vertex
+         */
+        void dijkstra(Index source) {
+            search(source, NO_VERTEX, 0.0);
+        }
+
+        /**
+         * A shortest path from source to target, with the Euclidean distance to target times
+         * scale as heuristic. Only the vertices on the way to target get their final distance.
+         * @return Returns whether target is reachable.
+         */
+        bool astar(Index source, Index target, double scale = 1.0) {
+            search(source, target, mGraph.hasCoordinates() ? scale : 0.0);
+            return reached(target);
+        }
+
+        /**
+         * The number of vertices the last query settled
+         */
+        std::size_t settledCount() const { return mSettledCount; }
+
+        bool reached(Index v) const { return mParents[v] != NO_VERTEX; }
+
+        Weight distance(Index v) const { return mDistances[v]; }
+
+        Index parent(Index v) const { return mParents[v]; }
+
+        std::vector<Index> path(Index v) const {
+            std::vector<Index> vertices;
+            if (!reached(v)) return vertices;
+            for (; v != mSource; v = mParents[v]) vertices.push_back(v);
+            vertices.push_back(mSource);
+            std::reverse(vertices.begin(), vertices.end());
+            return vertices;
+        }
+
+        /**
+         * The result of the last query
+         */
+        ShortestPaths<Index, Weight> result() const {
+            return ShortestPaths<Index, Weight>(mSource, mDistances, mParents);
+        }
+
+    private:
+        void reset() {
+            for (std::size_t i = 0; i < mTouched.size(); ++i) {
+                const Index v = mTouched[i];
+                mDistances[v] = detail::unreachable<Weight>();
+                mParents[v] = NO_VERTEX;
+                mSettled[v] = false;
+            }
+            mTouched.clear();
+            mHeap.clear();
+            mSettledCount = 0;
+        }
+
+        double heuristic(Index v, Index target, double scale) const {
+            return scale == 0.0 ? 0.0 : scale * double(mGraph.coordinate(v) | mGraph.coordinate(target));
+        }
+
+        /*
+         * Dijkstra if target is NO_VERTEX, A* otherwise. The heap key is distance plus heuristic,
+         * which a consistent heuristic keeps monotone. Rounding can make it drop slightly, so keys
+         * are clamped to the last popped key and a vertex whose distance still improves after it
+         * was settled is opened again.
+         */
+        void search(Index source, Index target, double scale) {
+            reset();
+            mSource = source;
+            mDistances[source] = Weight(0);
+            mParents[source] = source;
+            mTouched.push_back(source);
+            mHeap.push(target == NO_VERTEX ? Weight(0) : Weight(heuristic(source, target, scale)), source);
+            while (!mHeap.empty()) {
+                const Index u = mHeap.pop().second;
+                if (mSettled[u]) continue;
+                mSettled[u] = true;
+                ++mSettledCount;
+                if (u == target) break;
+                const Weight du = mDistances[u];
+                for (Index e = mGraph.edgeBegin(u); e < mGraph.edgeEnd(u); ++e) {
+                    const Index v = mGraph.target(e);
+                    const Weight dv = du + mGraph.weight(e);
+                    if (dv < mDistances[v]) {
+                        if (mParents[v] == NO_VERTEX) mTouched.push_back(v);
+                        mDistances[v] = dv;
+                        mParents[v] = u;
+                        mSettled[v] = false;
+                        const Weight key = target == NO_VERTEX ? dv : Weight(double(dv) + heuristic(v, target, scale));
+                        mHeap.push(std::max(key, mHeap.lastKey()), v);
+                    }
+                }
+            }
+        }
+
+        const graph_type &mGraph;
+        Index mSource;
+        std::vector<Weight> mDistances;
+        std::vector<Index> mParents;
+        std::vector<bool> mSettled;
+        std::vector<Index> mTouched;
+        RadixHeap<Weight, Index> mHeap;
+        std::size_t mSettledCount;
+
+    }; // ShortestPathSearch class
+
+    template<class Index, class Weight, class Coord>
+    const Index ShortestPathSearch<Index, Weight, Coord>::NO_VERTEX;
+
+    /**
+     * Dijkstra's algorithm from source on a radix heap
+     */
+    template<class Index, class Weight, class Coord>
+    ShortestPaths<Index, Weight> dijkstra(const CsrGraph<Index, Weight, Coord> &graph,
+                                          typename CsrGraph<Index, Weight, Coord>::index_type source) {
+        ShortestPathSearch<Index, Weight, Coord> search(graph);
+        search.dijkstra(source);
+        return search.result();
+    }
+
+    /**
+     * A* from source to target with the scaled Euclidean distance to target as heuristic.
+     * Without coordinates in the graph this is Dijkstra stopped at target.
+     */
+    template<class Index, class Weight, class Coord>
+    ShortestPaths<Index, Weight> astar(const CsrGraph<Index, Weight, Coord> &graph,
+                                       typename CsrGraph<Index, Weight, Coord>::index_type source,
+                                       typename CsrGraph<Index, Weight, Coord>::index_type target,
+                                       double scale = 1.0) {
+        ShortestPathSearch<Index, Weight, Coord> search(graph);
+        search.astar(source, target, scale);
+        return search.result();
+    }
+
+    namespace detail {
+
+        /*
+         * The smallest bucket width at which buckets buckets cover the weights up to maxWeight
+         */
+        template<class Weight>
+        inline Weight bucketWidth(Weight maxWeight, std::size_t buckets) {
+            Weight width = Weight(double(maxWeight) / double(buckets));
+            if (std::is_integral<Weight>::value && double(width) * double(buckets) < double(maxWeight)) ++width;
+            return width;
+        }
+
+        /*
+         * Delta-stepping, run by all threads together in lock step.
+         * Thread 0 plans every phase between two barriers, then all threads work on their
+         * share of the frontier. Each thread keeps its own ring of buckets, so relaxations
+         * only need the per vertex lock that keeps distance and parent in step.
+         */
+        template<class Index, class Weight, class Coord>
+        class DeltaStepping {
+        public:
+            typedef CsrGraph<Index, Weight, Coord> graph_type;
+
+            DeltaStepping(const graph_type &graph, Weight delta, Weight maxWeight, unsigned threads)
+                    : mGraph(graph), mDelta(delta), mThreads(threads),
+                      mSlots(std::size_t(maxWeight / delta) + 2), mDistances(graph.vertexCount()),
+                      mParents(graph.vertexCount(), ShortestPaths<Index, Weight>::NO_VERTEX),
+                      mLocks(graph.vertexCount()), mPhases(graph.vertexCount()), mWorkers(threads),
+                      mBarrier(threads), mBucket(0), mPhase(0), mMode(LIGHT) {
+                for (Index v = 0; v < graph.vertexCount(); ++v) {
+                    mDistances[v].store(unreachable<Weight>(), std::memory_order_relaxed);
+                    mLocks[v].store(false, std::memory_order_relaxed);
+                    mPhases[v].store(0, std::memory_order_relaxed);
+                }
+                for (unsigned t = 0; t < threads; ++t) mWorkers[t].buckets.resize(mSlots);
+            }
+
+            ShortestPaths<Index, Weight> run(Index source) {
+                mDistances[source].store(Weight(0), std::memory_order_relaxed);
+                mParents[source] = source;
+                mWorkers[0].buckets[0].push_back(source);
+
+                std::vector<std::thread> threads;
+                for (unsigned t = 1; t < mThreads; ++t) {
+                    threads.push_back(std::thread(&DeltaStepping::work, this, t));
+                }
+                work(0);
+                for (std::size_t t = 0; t < threads.size(); ++t) threads[t].join();
+
+                std::vector<Weight> distances(mDistances.size());
+                for (std::size_t v = 0; v < distances.size(); ++v) {
+                    distances[v] = mDistances[v].load(std::memory_order_relaxed);
+                }
+                return ShortestPaths<Index, Weight>(source, std::move(distances), std::move(mParents));
+            }
+
+        private:
+            enum Mode {
+                LIGHT, HEAVY, DONE
+            };
+
+            struct Worker {
+                std::vector<std::vector<Index> > buckets;
+                std::vector<Index> settled;
+                char pad[CACHE_LINE_SIZE];
+            };
+
+            std::size_t bucketOf(Weight d) const { return std::size_t(d / mDelta); }
+
+            void work(unsigned t) {
+                for (;;) {
+                    mBarrier.wait();
+                    if (t == 0) plan();
+                    mBarrier.wait();
+                    if (mMode == DONE) return;
+
+                    // Small frontiers go to thread 0 alone
+                    const std::size_t n = mFrontier.size();
+                    const unsigned parts = n < PARALLEL_SSSP_GRAIN ? 1 : mThreads;
+                    const std::size_t chunk = (n + parts - 1) / parts;
+                    const std::size_t first = t < parts ? std::min(t * chunk, n) : n;
+                    const std::size_t last = t < parts ? std::min(first + chunk, n) : n;
+                    Worker &worker = mWorkers[t];
+                    for (std::size_t i = first; i < last; ++i) {
+                        const Index u = mFrontier[i];
+                        const Weight du = mDistances[u].load(std::memory_order_relaxed);
+                        if (mMode == LIGHT) {
+                            // Skip stale entries and vertices already taken in this phase
+                            if (bucketOf(du) != mBucket) continue;
+                            if (mPhases[u].exchange(mPhase, std::memory_order_relaxed) == mPhase) continue;
+                            worker.settled.push_back(u);
+                        }
+                        for (Index e = mGraph.edgeBegin(u); e < mGraph.edgeEnd(u); ++e) {
+                            const Weight w = mGraph.weight(e);
+                            if ((w <= mDelta) == (mMode == LIGHT)) relax(worker, u, mGraph.target(e), du + w);
+                        }
+                    }
+                }
+            }
+
+            void relax(Worker &worker, Index u, Index v, Weight dv) {
+                if (!(dv < mDistances[v].load(std::memory_order_relaxed))) return;
+                while (mLocks[v].exchange(true, std::memory_order_acquire)) std::this_thread::yield();
+                const bool improved = dv < mDistances[v].load(std::memory_order_relaxed);
+                if (improved) {
+                    mDistances[v].store(dv, std::memory_order_relaxed);
+                    mParents[v] = u;
+                }
+                mLocks[v].store(false, std::memory_order_release);
+                if (improved) worker.buckets[bucketOf(dv) % mSlots].push_back(v);
+            }
+
+            /*
+             * Gathers the next frontier: the current bucket while it refills, then the heavy edges
+             * of the vertices it settled, then the next nonempty bucket
+             */
+            void plan() {
+                mFrontier.clear();
+                if (gather(mBucket)) {
+                    mMode = LIGHT;
+                    ++mPhase;
+                    return;
+                }
+                for (unsigned t = 0; t < mThreads; ++t) {
+                    mFrontier.insert(mFrontier.end(), mWorkers[t].settled.begin(), mWorkers[t].settled.end());
+                    mWorkers[t].settled.clear();
+                }
+                if (!mFrontier.empty()) {
+                    mMode = HEAVY;
+                    return;
+                }
+                for (std::size_t step = 1; step < mSlots; ++step) {
+                    if (gather(mBucket + step)) {
+                        mBucket += step;
+                        mMode = LIGHT;
+                        ++mPhase;
+                        return;
+                    }
+                }
+                mMode = DONE;
+            }
+
+            bool gather(std::size_t bucket) {
+                const std::size_t slot = bucket % mSlots;
+                for (unsigned t = 0; t < mThreads; ++t) {
+                    std::vector<Index> &items = mWorkers[t].buckets[slot];
+                    mFrontier.insert(mFrontier.end(), items.begin(), items.end());
+                    items.clear();
+                }
+                return !mFrontier.empty();
+            }
+
+            const graph_type &mGraph;
+            const Weight mDelta;
+            const unsigned mThreads;
+            const std::size_t mSlots;
+            std::vector<std::atomic<Weight> > mDistances;
+            std::vector<Index> mParents;
+            std::vector<std::atomic<bool> > mLocks;
+            std::vector<std::atomic<std::uint32_t> > mPhases;
+            std::vector<Worker> mWorkers;
+            SpinBarrier mBarrier;
+            std::vector<Index> mFrontier;
+            std::size_t mBucket;
+            std::uint32_t mPhase;
+            Mode mMode;
+
+        }; // DeltaStepping class
+
+    }; // namespace detail
+
+    /**
+     * Delta-stepping from source on several threads.
+     * @param graph The graph, with non-negative weights.
+     * @param source The source vertex.
+     * @param delta The bucket width, 0 picks the largest edge weight over the average degree.
+     *      One below the largest edge weight over DELTA_STEPPING_MAX_BUCKETS is raised to that.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     * @throws std::invalid_argument if delta is negative or NaN
+     */
+    template<class Index, class Weight, class Coord>
+    ShortestPaths<Index, Weight> deltaStepping(const CsrGraph<Index, Weight, Coord> &graph,
+                                               typename CsrGraph<Index, Weight, Coord>::index_type source,
+                                               typename CsrGraph<Index, Weight, Coord>::weight_type delta = Weight(0),
+                                               unsigned threads = 0) {
+        if (!(delta >= Weight(0))) throw std::invalid_argument("deltaStepping: delta must not be negative");
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        Weight maxWeight = graph.hasWeights() || graph.edgeCount() == 0 ? Weight(0) : Weight(1);
+        if (graph.hasWeights()) {
+            maxWeight = *std::max_element(graph.weights().begin(), graph.weights().end());
+        }
+        if (delta == Weight(0)) {
+            const double degree = graph.vertexCount() == 0 ? 1.0 : double(graph.edgeCount()) / graph.vertexCount();
+            delta = Weight(double(maxWeight) / std::max(1.0, degree));
+            if (!(delta > Weight(0))) delta = maxWeight > Weight(0) ? maxWeight : Weight(1);
+        }
+        if (double(maxWeight) / double(delta) > double(DELTA_STEPPING_MAX_BUCKETS)) {
+            delta = detail::bucketWidth(maxWeight, DELTA_STEPPING_MAX_BUCKETS);
+        }
+        detail::DeltaStepping<Index, Weight, Coord> solver(graph, delta, maxWeight, threads);
+        return solver.run(source);
+    }
+
+};// namespace graph_algo
+
+
+#endif /* SHORTESTPATH_H_ */
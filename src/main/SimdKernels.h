@@ -0,0 +1,412 @@
+#ifndef SIMDKERNELS_H_
+#define SIMDKERNELS_H_
+
+#include <cmath>
+#include <cstddef>
+#include "Precision.h"
+
+/**
+ * Batch kernels over structure-of-arrays coordinates (separate x and y arrays).
+ * Each kernel exists as a portable scalar loop and, on x86 with GCC or Clang,
+ * as SSE2 and AVX2 versions. kernels() picks the widest version the running
+ * CPU supports the first time it is called.
+ *
+ * Define GRAPH_ALGO_NO_SIMD to force the scalar versions.
+ *
+ * Lengths and distances are computed as sqrt(x*x + y*y), which vectorizes,
+ * but unlike hypot it can overflow for coordinates beyond ~1e154.
+ * Angles are computed with approxAtan2 from Precision.h, see ApproxPrecision.
+ * edgeSums accumulates the shoelace sums over the open chain of edges
+ * (xs[i], ys[i]) -> (xs[i + 1], ys[i + 1]), which Polygon closes and finishes.
+ */
+
+#if !defined(GRAPH_ALGO_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define GRAPH_ALGO_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace graph_algo {
+    namespace simd {
+
+        /**
+         * Table of batch kernels for double coordinates.
+         * n is the number of points, out has room for n values.
+         */
+        struct DoubleKernels {
+            const char *name;
+
+            void (*translate)(double *xs, double *ys, std::size_t n, double dx, double dy);
+
+            void (*scale)(double *xs, double *ys, std::size_t n, double s);
+
+            void (*divide)(double *xs, double *ys, std::size_t n, double s);
+
+            void (*dot)(const double *xs, const double *ys, std::size_t n, double px, double py, double *out);
+
+            void (*cross)(const double *xs, const double *ys, std::size_t n, double px, double py, double *out);
+
+            void (*distance)(const double *xs, const double *ys, std::size_t n, double px, double py, double *out);
+
+            void (*angle)(const double *xs, const double *ys, std::size_t n, double cx, double cy, double *out);
+
+            /*
+             * Over the n - 1 edges of the chain, with coordinates taken relative to (ox, oy):
+             * out[0] = sum of cross products, out[1] and out[2] = sums of (x_i + x_i+1) and (y_i + y_i+1)
+             * times the cross product, out[3] = sum of edge lengths.
+             */
+            void (*edgeSums)(const double *xs, const double *ys, std::size_t n, double ox, double oy, double *out);
+        };
+
+        namespace scalar {
+
+            inline void translate(double *xs, double *ys, std::size_t n, double dx, double dy) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    xs[i] += dx;
+                    ys[i] += dy;
+                }
+            }
+
+            inline void scale(double *xs, double *ys, std::size_t n, double s) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    xs[i] *= s;
+                    ys[i] *= s;
+                }
+            }
+
+            inline void divide(double *xs, double *ys, std::size_t n, double s) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    xs[i] /= s;
+                    ys[i] /= s;
+                }
+            }
+
+            inline void dot(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    out[i] = xs[i] * px + ys[i] * py;
+                }
+            }
+
+            inline void cross(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    out[i] = xs[i] * py - px * ys[i];
+                }
+            }
+
+            inline void distance(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double dx = xs[i] - px, dy = ys[i] - py;
+                    out[i] = std::sqrt(dx * dx + dy * dy);
+                }
+            }
+
+            inline void angle(const double *xs, const double *ys, std::size_t n, double cx, double cy, double *out) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    out[i] = approxAtan2(ys[i] - cy, xs[i] - cx);
+                }
+            }
+
+            inline void edgeSums(const double *xs, const double *ys, std::size_t n, double ox, double oy, double *out) {
+                double cross = 0.0, sx = 0.0, sy = 0.0, length = 0.0;
+                for (std::size_t i = 0; i + 1 < n; ++i) {
+                    const double x0 = xs[i] - ox, y0 = ys[i] - oy, x1 = xs[i + 1] - ox, y1 = ys[i + 1] - oy;
+                    const double c = x0 * y1 - x1 * y0, dx = x1 - x0, dy = y1 - y0;
+                    cross += c;
+                    sx += (x0 + x1) * c;
+                    sy += (y0 + y1) * c;
+                    length += std::sqrt(dx * dx + dy * dy);
+                }
+                out[0] = cross;
+                out[1] = sx;
+                out[2] = sy;
+                out[3] = length;
+            }
+
+        }; // namespace scalar
+
+#ifdef GRAPH_ALGO_X86_SIMD
+
+        namespace sse2 {
+
+            inline void translate(double *xs, double *ys, std::size_t n, double dx, double dy) {
+                const __m128d vdx = _mm_set1_pd(dx), vdy = _mm_set1_pd(dy);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    _mm_storeu_pd(xs + i, _mm_add_pd(_mm_loadu_pd(xs + i), vdx));
+                    _mm_storeu_pd(ys + i, _mm_add_pd(_mm_loadu_pd(ys + i), vdy));
+                }
+                scalar::translate(xs + i, ys + i, n - i, dx, dy);
+            }
+
+            inline void scale(double *xs, double *ys, std::size_t n, double s) {
+                const __m128d vs = _mm_set1_pd(s);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    _mm_storeu_pd(xs + i, _mm_mul_pd(_mm_loadu_pd(xs + i), vs));
+                    _mm_storeu_pd(ys + i, _mm_mul_pd(_mm_loadu_pd(ys + i), vs));
+                }
+                scalar::scale(xs + i, ys + i, n - i, s);
+            }
+
+            inline void divide(double *xs, double *ys, std::size_t n, double s) {
+                const __m128d vs = _mm_set1_pd(s);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    _mm_storeu_pd(xs + i, _mm_div_pd(_mm_loadu_pd(xs + i), vs));
+                    _mm_storeu_pd(ys + i, _mm_div_pd(_mm_loadu_pd(ys + i), vs));
+                }
+                scalar::divide(xs + i, ys + i, n - i, s);
+            }
+
+            inline void dot(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                const __m128d vpx = _mm_set1_pd(px), vpy = _mm_set1_pd(py);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    const __m128d x = _mm_loadu_pd(xs + i), y = _mm_loadu_pd(ys + i);
+                    _mm_storeu_pd(out + i, _mm_add_pd(_mm_mul_pd(x, vpx), _mm_mul_pd(y, vpy)));
+                }
+                scalar::dot(xs + i, ys + i, n - i, px, py, out + i);
+            }
+
+            inline void cross(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                const __m128d vpx = _mm_set1_pd(px), vpy = _mm_set1_pd(py);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    const __m128d x = _mm_loadu_pd(xs + i), y = _mm_loadu_pd(ys + i);
+                    _mm_storeu_pd(out + i, _mm_sub_pd(_mm_mul_pd(x, vpy), _mm_mul_pd(vpx, y)));
+                }
+                scalar::cross(xs + i, ys + i, n - i, px, py, out + i);
+            }
+
+            inline void distance(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                const __m128d vpx = _mm_set1_pd(px), vpy = _mm_set1_pd(py);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    const __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), vpx);
+                    const __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), vpy);
+                    _mm_storeu_pd(out + i, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+                }
+                scalar::distance(xs + i, ys + i, n - i, px, py, out + i);
+            }
+
+            inline __m128d select(__m128d mask, __m128d a, __m128d b) {
+                return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+            }
+
+            inline void angle(const double *xs, const double *ys, std::size_t n, double cx, double cy, double *out) {
+                const __m128d vcx = _mm_set1_pd(cx), vcy = _mm_set1_pd(cy);
+                const __m128d sign = _mm_set1_pd(-0.0), zero = _mm_setzero_pd();
+                const __m128d halfPi = _mm_set1_pd(1.57079632679489661923), pi = _mm_set1_pd(3.14159265358979323846);
+                std::size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    const __m128d x = _mm_sub_pd(_mm_loadu_pd(xs + i), vcx);
+                    const __m128d y = _mm_sub_pd(_mm_loadu_pd(ys + i), vcy);
+                    const __m128d ax = _mm_andnot_pd(sign, x), ay = _mm_andnot_pd(sign, y);
+                    const __m128d mx = _mm_max_pd(ax, ay), mn = _mm_min_pd(ax, ay);
+                    const __m128d a = select(_mm_cmpeq_pd(mx, zero), _mm_div_pd(mn, mx), zero);
+                    const __m128d s = _mm_mul_pd(a, a);
+                    __m128d r = _mm_set1_pd(-0.01172120);
+                    r = _mm_add_pd(_mm_mul_pd(r, s), _mm_set1_pd(0.05265332));
+                    r = _mm_sub_pd(_mm_mul_pd(r, s), _mm_set1_pd(0.11643287));
+                    r = _mm_add_pd(_mm_mul_pd(r, s), _mm_set1_pd(0.19354346));
+                    r = _mm_sub_pd(_mm_mul_pd(r, s), _mm_set1_pd(0.33262347));
+                    r = _mm_add_pd(_mm_mul_pd(r, s), _mm_set1_pd(0.99997726));
+                    r = _mm_mul_pd(r, a);
+                    r = select(_mm_cmpgt_pd(ay, ax), r, _mm_sub_pd(halfPi, r));
+                    r = select(_mm_cmplt_pd(x, zero), r, _mm_sub_pd(pi, r));
+                    _mm_storeu_pd(out + i, _mm_or_pd(_mm_andnot_pd(sign, r), _mm_and_pd(sign, y)));
+                }
+                scalar::angle(xs + i, ys + i, n - i, cx, cy, out + i);
+            }
+
+            inline double horizontalSum(__m128d v) {
+                return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+            }
+
+            inline void edgeSums(const double *xs, const double *ys, std::size_t n, double ox, double oy, double *out) {
+                const __m128d vox = _mm_set1_pd(ox), voy = _mm_set1_pd(oy);
+                __m128d cross = _mm_setzero_pd(), sx = cross, sy = cross, length = cross;
+                std::size_t i = 0;
+                for (; i + 3 <= n; i += 2) {
+                    const __m128d x0 = _mm_sub_pd(_mm_loadu_pd(xs + i), vox), y0 = _mm_sub_pd(_mm_loadu_pd(ys + i), voy);
+                    const __m128d x1 = _mm_sub_pd(_mm_loadu_pd(xs + i + 1), vox);
+                    const __m128d y1 = _mm_sub_pd(_mm_loadu_pd(ys + i + 1), voy);
+                    const __m128d c = _mm_sub_pd(_mm_mul_pd(x0, y1), _mm_mul_pd(x1, y0));
+                    const __m128d dx = _mm_sub_pd(x1, x0), dy = _mm_sub_pd(y1, y0);
+                    cross = _mm_add_pd(cross, c);
+                    sx = _mm_add_pd(sx, _mm_mul_pd(_mm_add_pd(x0, x1), c));
+                    sy = _mm_add_pd(sy, _mm_mul_pd(_mm_add_pd(y0, y1), c));
+                    length = _mm_add_pd(length, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+                }
+                scalar::edgeSums(xs + i, ys + i, n - i, ox, oy, out);
+                out[0] += horizontalSum(cross);
+                out[1] += horizontalSum(sx);
+                out[2] += horizontalSum(sy);
+                out[3] += horizontalSum(length);
+            }
+
+        }; // namespace sse2
+
+        namespace avx2 {
+
+            __attribute__((target("avx2")))
+            inline void translate(double *xs, double *ys, std::size_t n, double dx, double dy) {
+                const __m256d vdx = _mm256_set1_pd(dx), vdy = _mm256_set1_pd(dy);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    _mm256_storeu_pd(xs + i, _mm256_add_pd(_mm256_loadu_pd(xs + i), vdx));
+                    _mm256_storeu_pd(ys + i, _mm256_add_pd(_mm256_loadu_pd(ys + i), vdy));
+                }
+                scalar::translate(xs + i, ys + i, n - i, dx, dy);
+            }
+
+            __attribute__((target("avx2")))
+            inline void scale(double *xs, double *ys, std::size_t n, double s) {
+                const __m256d vs = _mm256_set1_pd(s);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    _mm256_storeu_pd(xs + i, _mm256_mul_pd(_mm256_loadu_pd(xs + i), vs));
+                    _mm256_storeu_pd(ys + i, _mm256_mul_pd(_mm256_loadu_pd(ys + i), vs));
+                }
+                scalar::scale(xs + i, ys + i, n - i, s);
+            }
+
+            __attribute__((target("avx2")))
+            inline void divide(double *xs, double *ys, std::size_t n, double s) {
+                const __m256d vs = _mm256_set1_pd(s);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    _mm256_storeu_pd(xs + i, _mm256_div_pd(_mm256_loadu_pd(xs + i), vs));
+                    _mm256_storeu_pd(ys + i, _mm256_div_pd(_mm256_loadu_pd(ys + i), vs));
+                }
+                scalar::divide(xs + i, ys + i, n - i, s);
+            }
+
+            __attribute__((target("avx2")))
+            inline void dot(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                const __m256d vpx = _mm256_set1_pd(px), vpy = _mm256_set1_pd(py);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const __m256d x = _mm256_loadu_pd(xs + i), y = _mm256_loadu_pd(ys + i);
+                    _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(x, vpx), _mm256_mul_pd(y, vpy)));
+                }
+                scalar::dot(xs + i, ys + i, n - i, px, py, out + i);
+            }
+
+            __attribute__((target("avx2")))
+            inline void cross(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                const __m256d vpx = _mm256_set1_pd(px), vpy = _mm256_set1_pd(py);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const __m256d x = _mm256_loadu_pd(xs + i), y = _mm256_loadu_pd(ys + i);
+                    _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_mul_pd(x, vpy), _mm256_mul_pd(vpx, y)));
+                }
+                scalar::cross(xs + i, ys + i, n - i, px, py, out + i);
+            }
+
+            __attribute__((target("avx2")))
+            inline void distance(const double *xs, const double *ys, std::size_t n, double px, double py, double *out) {
+                const __m256d vpx = _mm256_set1_pd(px), vpy = _mm256_set1_pd(py);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), vpx);
+                    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), vpy);
+                    _mm256_storeu_pd(out + i,
+                                     _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+                }
+                scalar::distance(xs + i, ys + i, n - i, px, py, out + i);
+            }
+
+            __attribute__((target("avx2")))
+            inline void angle(const double *xs, const double *ys, std::size_t n, double cx, double cy, double *out) {
+                const __m256d vcx = _mm256_set1_pd(cx), vcy = _mm256_set1_pd(cy);
+                const __m256d sign = _mm256_set1_pd(-0.0), zero = _mm256_setzero_pd();
+                const __m256d halfPi = _mm256_set1_pd(1.57079632679489661923);
+                const __m256d pi = _mm256_set1_pd(3.14159265358979323846);
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const __m256d x = _mm256_sub_pd(_mm256_loadu_pd(xs + i), vcx);
+                    const __m256d y = _mm256_sub_pd(_mm256_loadu_pd(ys + i), vcy);
+                    const __m256d ax = _mm256_andnot_pd(sign, x), ay = _mm256_andnot_pd(sign, y);
+                    const __m256d mx = _mm256_max_pd(ax, ay), mn = _mm256_min_pd(ax, ay);
+                    const __m256d a = _mm256_blendv_pd(_mm256_div_pd(mn, mx), zero,
+                                                       _mm256_cmp_pd(mx, zero, _CMP_EQ_OQ));
+                    const __m256d s = _mm256_mul_pd(a, a);
+                    __m256d r = _mm256_set1_pd(-0.01172120);
+                    r = _mm256_add_pd(_mm256_mul_pd(r, s), _mm256_set1_pd(0.05265332));
+                    r = _mm256_sub_pd(_mm256_mul_pd(r, s), _mm256_set1_pd(0.11643287));
+                    r = _mm256_add_pd(_mm256_mul_pd(r, s), _mm256_set1_pd(0.19354346));
+                    r = _mm256_sub_pd(_mm256_mul_pd(r, s), _mm256_set1_pd(0.33262347));
+                    r = _mm256_add_pd(_mm256_mul_pd(r, s), _mm256_set1_pd(0.99997726));
+                    r = _mm256_mul_pd(r, a);
+                    r = _mm256_blendv_pd(r, _mm256_sub_pd(halfPi, r), _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+                    r = _mm256_blendv_pd(r, _mm256_sub_pd(pi, r), _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+                    _mm256_storeu_pd(out + i, _mm256_or_pd(_mm256_andnot_pd(sign, r), _mm256_and_pd(sign, y)));
+                }
+                scalar::angle(xs + i, ys + i, n - i, cx, cy, out + i);
+            }
+
+            __attribute__((target("avx2")))
+            inline double horizontalSum(__m256d v) {
+                const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+            }
+
+            __attribute__((target("avx2")))
+            inline void edgeSums(const double *xs, const double *ys, std::size_t n, double ox, double oy, double *out) {
+                const __m256d vox = _mm256_set1_pd(ox), voy = _mm256_set1_pd(oy);
+                __m256d cross = _mm256_setzero_pd(), sx = cross, sy = cross, length = cross;
+                std::size_t i = 0;
+                for (; i + 5 <= n; i += 4) {
+                    const __m256d x0 = _mm256_sub_pd(_mm256_loadu_pd(xs + i), vox);
+                    const __m256d y0 = _mm256_sub_pd(_mm256_loadu_pd(ys + i), voy);
+                    const __m256d x1 = _mm256_sub_pd(_mm256_loadu_pd(xs + i + 1), vox);
+                    const __m256d y1 = _mm256_sub_pd(_mm256_loadu_pd(ys + i + 1), voy);
+                    const __m256d c = _mm256_sub_pd(_mm256_mul_pd(x0, y1), _mm256_mul_pd(x1, y0));
+                    const __m256d dx = _mm256_sub_pd(x1, x0), dy = _mm256_sub_pd(y1, y0);
+                    cross = _mm256_add_pd(cross, c);
+                    sx = _mm256_add_pd(sx, _mm256_mul_pd(_mm256_add_pd(x0, x1), c));
+                    sy = _mm256_add_pd(sy, _mm256_mul_pd(_mm256_add_pd(y0, y1), c));
+                    length = _mm256_add_pd(length,
+                                           _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+                }
+                scalar::edgeSums(xs + i, ys + i, n - i, ox, oy, out);
+                out[0] += horizontalSum(cross);
+                out[1] += horizontalSum(sx);
+                out[2] += horizontalSum(sy);
+                out[3] += horizontalSum(length);
+            }
+
+        }; // namespace avx2
+
+#endif /* GRAPH_ALGO_X86_SIMD */
+
+        inline const DoubleKernels &scalarKernels() {
+            static const DoubleKernels k = {"scalar", scalar::translate, scalar::scale, scalar::divide,
+                                            scalar::dot, scalar::cross, scalar::distance, scalar::angle,
+                                            scalar::edgeSums};
+            return k;
+        }
+
+        /**
+         * The kernels for the widest instruction set supported by the running CPU.
+         */
+        inline const DoubleKernels &kernels() {
+#ifdef GRAPH_ALGO_X86_SIMD
+            static const DoubleKernels sse2Kernels = {"sse2", sse2::translate, sse2::scale, sse2::divide,
+                                                      sse2::dot, sse2::cross, sse2::distance, sse2::angle,
+                                                      sse2::edgeSums};
+            static const DoubleKernels avx2Kernels = {"avx2", avx2::translate, avx2::scale, avx2::divide,
+                                                      avx2::dot, avx2::cross, avx2::distance, avx2::angle,
+                                                      avx2::edgeSums};
+            static const DoubleKernels &best = __builtin_cpu_supports("avx2") ? avx2Kernels : sse2Kernels;
+            return best;
+#else
+            return scalarKernels();
+#endif
+        }
+
+    }; // namespace simd
+};// namespace graph_algo
+
+
+#endif /* SIMDKERNELS_H_ */
@@ -0,0 +1,465 @@
+#ifndef SIMPLIFICATION_H_
+#define SIMPLIFICATION_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "RingIndex.h"
+
+/**
+ * Polyline simplification.
+ * - PolylineSimplifier::douglasPeucker keeps the vertices that lie farther than a distance
+ *   tolerance from the simplified line (Douglas-Peucker, iterative).
+ * - PolylineSimplifier::visvalingam drops the vertex that spans the smallest triangle with its
+ *   neighbours until every remaining one spans more than an area tolerance, or until a target
+ *   vertex count is reached (Visvalingam-Whyatt).
+ * - RadialDistanceStream thins a stream of points to one per tolerance radius in constant
+ *   memory, for GPS tracks and other input that never ends.
+ *
+ * The simplifier takes a std::vector of any point type with getX() and getY(), or a PointBuffer,
+ * and returns the indices of the vertices it keeps in increasing order. A closed ring lists every
+ * vertex once. Ring positions are RingIndex values, so a ring is walked across its seam like
+ * anywhere else: no vertex is pinned just because it was stored first.
+ */
+
+namespace graph_algo {
+
+    namespace detail {
+
+        /*
+         * Squared distance of p from the segment a b, or from a if the segment is a point
+         */
+        template<class P>
+        inline double segmentDistance2(const P &a, const P &b, const P &p) {
+            const double dx = double(b.getX()) - double(a.getX()), dy = double(b.getY()) - double(a.getY());
+            double px = double(p.getX()) - double(a.getX()), py = double(p.getY()) - double(a.getY());
+            const double length2 = dx * dx + dy * dy;
+            if (length2 > 0.0) {
+                const double t = std::min(1.0, std::max(0.0, (px * dx + py * dy) / length2));
+                px -= t * dx;
+                py -= t * dy;
+            }
+            return px * px + py * py;
+        }
+
+        template<class P>
+        inline double pointDistance2(const P &a, const P &b) {
+            const double dx = double(b.getX()) - double(a.getX()), dy = double(b.getY()) - double(a.getY());
+            return dx * dx + dy * dy;
+        }
+
+        /*
+         * Area of the triangle a b c. Only compared against other areas and a tolerance, so
+         * plain floating point is exact enough and the exact orient2d is not needed.
+         */
+        template<class P>
+        inline double triangleArea(const P &a, const P &b, const P &c) {
+            const double abx = double(b.getX()) - double(a.getX()), aby = double(b.getY()) - double(a.getY());
+            const double acx = double(c.getX()) - double(a.getX()), acy = double(c.getY()) - double(a.getY());
+            return 0.5 * std::fabs(abx * acy - aby * acx);
+        }
+
+        /*
+         * A binary min heap over the ids 0..n-1 that knows where every id sits, so that the key of
+         * any id can change in O(log n). All storage is sized by reset and reused afterwards.
+         */
+        class IndexedMinHeap {
+        public:
+            static constexpr std::uint32_t ABSENT = ~std::uint32_t(0);
+
+            void reset(std::size_t n) {
+                mHeap.clear();
+                mHeap.reserve(n);
+                mPositions.assign(n, ABSENT);
+                mKeys.resize(n);
+            }
+
+            bool empty() const { return mHeap.empty(); }
+
+            std::size_t size() const { return mHeap.size(); }
+
+            bool contains(std::uint32_t id) const { return mPositions[id] != ABSENT; }
+
+            std::uint32_t top() const { return mHeap[0]; }
+
+            double key(std::uint32_t id) const { return mKeys[id]; }
+
+            /*
+             * Adds id without restoring the heap order, build() must follow before the next pop or update
+             */
+            void append(std::uint32_t id, double key) {
+                mKeys[id] = key;
+                mPositions[id] = std::uint32_t(mHeap.size());
+                mHeap.push_back(id);
+            }
+
+            /*
+             * Restores the heap order after append, in O(n)
+             */
+            void build() {
+                for (std::size_t at = mHeap.size() / 2; at-- > 0;) down(at);
+            }
+
+            std::uint32_t pop() {
+                const std::uint32_t id = mHeap[0];
+                mPositions[id] = ABSENT;
+                const std::uint32_t last = mHeap.back();
+                mHeap.pop_back();
+                if (!mHeap.empty()) {
+                    mHeap[0] = last;
+                    mPositions[last] = 0;
+                    down(0);
+                }
+                return id;
+            }
+
+            void update(std::uint32_t id, double key) {
+                const double old = mKeys[id];
+                mKeys[id] = key;
+                if (key < old) {
+                    up(mPositions[id]);
+                } else {
+                    down(mPositions[id]);
+                }
+            }
+
+            std::size_t memoryUsage() const {
+                return mHeap.capacity() * sizeof(std::uint32_t) + mPositions.capacity() * sizeof(std::uint32_t) +
+                       mKeys.capacity() * sizeof(double);
+            }
+
+        private:
+            void place(std::size_t at, std::uint32_t id) {
+                mHeap[at] = id;
+                mPositions[id] = std::uint32_t(at);
+            }
+
+            void up(std::size_t at) {
+                const std::uint32_t id = mHeap[at];
+                const double key = mKeys[id];
+                while (at > 0) {
+                    const std::size_t parent = (at - 1) / 2;
+                    if (!(key < mKeys[mHeap[parent]])) break;
+                    place(at, mHeap[parent]);
+                    at = parent;
+                }
+                place(at, id);
+            }
+
+            void down(std::size_t at) {
+                const std::uint32_t id = mHeap[at];
+                const double key = mKeys[id];
+                const std::size_t n = mHeap.size();
+                for (;;) {
+                    std::size_t child = 2 * at + 1;
+                    if (child >= n) break;
+                    if (child + 1 < n && mKeys[mHeap[child + 1]] < mKeys[mHeap[child]]) ++child;
+                    if (!(mKeys[mHeap[child]] < key)) break;
+                    place(at, mHeap[child]);
+                    at = child;
+                }
+                place(at, id);
+            }
+
+            std::vector<std::uint32_t> mHeap;
+            std::vector<std::uint32_t> mPositions;
+            std::vector<double> mKeys;
+
+        }; // IndexedMinHeap class
+
+    }; // namespace detail
+
+    /**
+     * Simplifies polylines and rings. Keeps its scratch space between calls, so simplifying many
+     * lines with one PolylineSimplifier allocates only while the lines keep getting longer.
+     * Not thread safe, use one PolylineSimplifier per thread.
+     */
+    class PolylineSimplifier {
+    public:
+        typedef RingIndex<int> index_type;
+
+        /**
+         * Douglas-Peucker simplification
+         *
+         * @param points the vertices, a std::vector of points with getX() and getY() or a PointBuffer
+         * @param tolerance vertices within this distance of the simplified line are dropped
+         * @param closed whether the last vertex connects back to the first
+         * @return the indices of the kept vertices in increasing order, valid until the next call.
+         * An open line keeps both ends, a ring keeps at least 3 vertices if it has them.
+         */
+        template<class Points>
+        const std::vector<int> &douglasPeucker(const Points &points, double tolerance, bool closed = false) {
+            const int n = int(points.size());
+            mKeep.assign(std::size_t(n), 0);
+            if (n <= (closed ? 3 : 2)) return keepAll(n);
+
+            const double tolerance2 = tolerance * tolerance;
+            mSpans.clear();
+            if (closed) {
+                // Anchor on the leftmost vertex (lowest x, then lowest y), which is a hull vertex, and the
+                // vertex farthest from it
+                int first = 0;
+                for (int i = 1; i < n; ++i) {
+                    if (points[i].getX() < points[first].getX() ||
+                        (points[i].getX() == points[first].getX() && points[i].getY() < points[first].getY())) {
+                        first = i;
+                    }
+                }
+                const index_type anchor(first, n);
+                int far = 1;
+                double farthest = -1.0;
+                for (int k = 1; k < n; ++k) {
+                    const double d = detail::pointDistance2(points[first], points[anchor + k]);
+                    if (d > farthest) {
+                        farthest = d;
+                        far = k;
+                    }
+                }
+                mKeep[std::size_t(first)] = 1;
+                mKeep[std::size_t(anchor + far)] = 1;
+                mSpans.push_back(std::make_pair(first, far));
+                mSpans.push_back(std::make_pair(int(anchor + far), n - far));
+            } else {
+                mKeep[0] = 1;
+                mKeep[std::size_t(n - 1)] = 1;
+                mSpans.push_back(std::make_pair(0, n - 1));
+            }
+
+            while (!mSpans.empty()) {
+                const index_type from(mSpans.back().first, n);
+                const int steps = mSpans.back().second;
+                mSpans.pop_back();
+                const int to = from + steps;
+                int split = 0;
+                double farthest = tolerance2;
+                for (int k = 1; k < steps; ++k) {
+                    const double d = detail::segmentDistance2(points[int(from)], points[to], points[from + k]);
+                    if (d > farthest) {
+                        farthest = d;
+                        split = k;
+                    }
+                }
+                if (split == 0) continue;
+                mKeep[std::size_t(from + split)] = 1;
+                if (split > 1) mSpans.push_back(std::make_pair(int(from), split));
+                if (steps - split > 1) mSpans.push_back(std::make_pair(int(from + split), steps - split));
+            }
+            collect(n);
+            if (closed && mKept.size() < 3) {
+                // Everything is within tolerance of the chord between the anchors, keep the farthest vertex
+                // off it so that the ring does not collapse
+                const int a = mKept[0], b = mKept[1];
+                int split = -1;
+                double farthest = -1.0;
+                for (int i = 0; i < n; ++i) {
+                    const double d = detail::segmentDistance2(points[a], points[b], points[i]);
+                    if (i != a && i != b && d > farthest) {
+                        farthest = d;
+                        split = i;
+                    }
+                }
+                mKeep[std::size_t(split)] = 1;
+                collect(n);
+            }
+            return mKept;
+        }
+
+        /**
+         * Visvalingam-Whyatt simplification by area
+         *
+         * @param points the vertices, a std::vector of points with getX() and getY() or a PointBuffer
+         * @param area vertices are dropped while the smallest effective area is at most this
+         * @param closed whether the last vertex connects back to the first
+         * @return the indices of the kept vertices in increasing order, valid until the next call
+         */
+        template<class Points>
+        const std::vector<int> &visvalingam(const Points &points, double area, bool closed = false) {
+            return visvalingam(points, area, 0, closed);
+        }
+
+        /**
+         * Visvalingam-Whyatt simplification to a vertex count
+         *
+         * @param points the vertices, a std::vector of points with getX() and getY() or a PointBuffer
+         * @param count the number of vertices to keep, at least 2 for a line and 3 for a ring
+         * @param closed whether the last vertex connects back to the first
+         * @return the indices of the kept vertices in increasing order, valid until the next call
+         */
+        template<class Points>
+        const std::vector<int> &visvalingamCount(const Points &points, std::size_t count, bool closed = false) {
+            return visvalingam(points, HUGE_VAL, count, closed);
+        }
+
+        /**
+         * Bytes held in scratch space
+         */
+        std::size_t memoryUsage() const {
+            return mKeep.capacity() + mKept.capacity() * sizeof(int) + mSpans.capacity() * sizeof(mSpans[0]) +
+                   mPrev.capacity() * sizeof(int) + mNext.capacity() * sizeof(int) + mHeap.memoryUsage();
+        }
+
+    private:
+        const std::vector<int> &keepAll(int n) {
+            mKept.clear();
+            for (int i = 0; i < n; ++i) mKept.push_back(i);
+            return mKept;
+        }
+
+        const std::vector<int> &collect(int n) {
+            mKept.clear();
+            for (int i = 0; i < n; ++i) {
+                if (mKeep[std::size_t(i)]) mKept.push_back(i);
+            }
+            return mKept;
+        }
+
+        template<class Points>
+        double triangle(const Points &points, int i) const {
+            return detail::triangleArea(points[mPrev[std::size_t(i)]], points[i], points[mNext[std::size_t(i)]]);
+        }
+
+        /*
+         * Removes the vertex with the smallest effective area while that area is at most area and
+         * more than count vertices remain. The effective area of a vertex never drops below that of
+         * a vertex removed before it, so the removal order is a ranking of the vertices.
+         */
+        template<class Points>
+        const std::vector<int> &visvalingam(const Points &points, double area, std::size_t count, bool closed) {
+            const int n = int(points.size());
+            const std::size_t least = std::max(count, std::size_t(closed ? 3 : 2));
+            if (std::size_t(n) <= least) return keepAll(n);
+
+            mPrev.resize(std::size_t(n));
+            mNext.resize(std::size_t(n));
+            for (int i = 0; i < n; ++i) {
+                const index_type at(i, n);
+                mPrev[std::size_t(i)] = at - 1;
+                mNext[std::size_t(i)] = at + 1;
+            }
+            mHeap.reset(std::size_t(n));
+            for (int i = closed ? 0 : 1; i < (closed ? n : n - 1); ++i) mHeap.append(std::uint32_t(i), triangle(points, i));
+            mHeap.build();
+
+            mKeep.assign(std::size_t(n), 1);
+            std::size_t remaining = std::size_t(n);
+            while (remaining > least && mHeap.key(mHeap.top()) <= area) {
+                const double removed = mHeap.key(mHeap.top());
+                const int i = int(mHeap.pop());
+                const int prev = mPrev[std::size_t(i)], next = mNext[std::size_t(i)];
+                mNext[std::size_t(prev)] = next;
+                mPrev[std::size_t(next)] = prev;
+                mKeep[std::size_t(i)] = 0;
+                --remaining;
+                if (mHeap.contains(std::uint32_t(prev))) {
+                    mHeap.update(std::uint32_t(prev), std::max(removed, triangle(points, prev)));
+                }
+                if (mHeap.contains(std::uint32_t(next))) {
+                    mHeap.update(std::uint32_t(next), std::max(removed, triangle(points, next)));
+                }
+            }
+            return collect(n);
+        }
+
+        std::vector<std::uint8_t> mKeep;
+        std::vector<int> mKept;
+        std::vector<std::pair<int, int> > mSpans;
+        std::vector<int> mPrev;
+        std::vector<int> mNext;
+        detail::IndexedMinHeap mHeap;
+
+    }; // PolylineSimplifier class
+
+    /**
+     * Radial distance simplification of an unbounded stream of points in constant memory.
+     * The first point is kept, then every point at least tolerance away from the last kept one,
+     * and finish() keeps the last point of the stream if it was dropped.
+     * Kept points go to the callback passed to push and finish as soon as they are known.
+     */
+    template<class P>
+    class RadialDistanceStream {
+    public:
+        /**
+         * @param tolerance points closer than this to the last kept point are dropped
+         */
+        explicit RadialDistanceStream(double tolerance) : mTolerance2(tolerance * tolerance), mSeen(0), mKept(0),
+                                                          mPending(false) {}
+
+        /**
+         * Offers the next point of the stream, calls emit(p) if p is kept
+         */
+        template<class F>
+        void push(const P &p, F emit) {
+            if (mSeen++ == 0 || detail::pointDistance2(mLastKept, p) >= mTolerance2) {
+                mLastKept = p;
+                mPending = false;
+                ++mKept;
+                emit(p);
+            } else {
+                mLast = p;
+                mPending = true;
+            }
+        }
+
+        /**
+         * Ends the stream, calls emit with its last point if that was dropped. The stream can be
+         * reused for a new track afterwards.
+         */
+        template<class F>
+        void finish(F emit) {
+            if (mPending) {
+                ++mKept;
+                emit(mLast);
+            }
+            mSeen = 0;
+            mPending = false;
+        }
+
+        /**
+         * Points pushed since the last finish
+         */
+        std::size_t seen() const { return mSeen; }
+
+        /**
+         * Points kept in total
+         */
+        std::size_t kept() const { return mKept; }
+
+    private:
+        double mTolerance2;
+        std::size_t mSeen;
+        std::size_t mKept;
+        bool mPending;
+        P mLastKept;
+        P mLast;
+
+    }; // RadialDistanceStream class
+
+    /**
+     * The vertices of points that Douglas-Peucker keeps, see PolylineSimplifier::douglasPeucker
+     */
+    template<class P>
+    std::vector<P> douglasPeucker(const std::vector<P> &points, double tolerance, bool closed = false) {
+        PolylineSimplifier simplifier;
+        std::vector<P> out;
+        for (int i : simplifier.douglasPeucker(points, tolerance, closed)) out.push_back(points[std::size_t(i)]);
+        return out;
+    }
+
+    /**
+     * The vertices of points that Visvalingam-Whyatt keeps, see PolylineSimplifier::visvalingam
+     */
+    template<class P>
+    std::vector<P> visvalingam(const std::vector<P> &points, double area, bool closed = false) {
+        PolylineSimplifier simplifier;
+        std::vector<P> out;
+        for (int i : simplifier.visvalingam(points, area, closed)) out.push_back(points[std::size_t(i)]);
+        return out;
+    }
+
+};// namespace graph_algo
+
+
+#endif /* SIMPLIFICATION_H_ */
@@ -0,0 +1,442 @@
+#ifndef SPACEFILLINGCURVE_H_
+#define SPACEFILLINGCURVE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+
+/**
+ * Space filling curves over a 2^32 x 2^32 grid, and sorting points along them.
+ *
+ * A curve is a type with two static functions, encode(x, y) giving the 64 bit position of
+ * grid cell (x, y) on the curve and decode(key, x, y) its inverse:
+ * - MortonCurve interleaves the bits of x and y, x on the even bits. It is the Z-order curve.
+ *   With BMI2 the bits are deposited with pdep, otherwise spread with shifts and masks.
+ * - HilbertCurve is the Hilbert curve from (0, 0) to (2^32 - 1, 0). It runs a four state
+ *   automaton over the bits of x and y, four levels per lookup in a 1024 entry table.
+ * Nearby keys are nearby cells for both, the Hilbert curve has no jumps between far apart
+ * cells and so keeps neighbourhoods together better, at about twice the encoding cost.
+ *
+ * CurveGrid maps points to grid cells: the square over the bounding box of the points is cut
+ * into 2^32 x 2^32 cells. curveKeys gives the keys of a PointBuffer, curveOrder the
+ * permutation that sorts it along a curve, by a parallel LSD radix sort, and curveSort applies
+ * it. permuteVertices in Graph.h applies such an order to the vertices of a graph.
+ *
+ * BMI2 is used when the compiler targets it (-mbmi2, -march=native), otherwise curveKeys
+ * checks the running CPU once. Define GRAPH_ALGO_NO_SIMD to always use the portable code.
+ */
+
+#if !defined(GRAPH_ALGO_NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define GRAPH_ALGO_X86_BMI2 1
+#include <immintrin.h>
+#endif
+
+namespace graph_algo {
+
+    /**
+     * Inputs smaller than this per thread are not worth splitting in curveKeys and curveOrder
+     */
+    static const std::size_t PARALLEL_CURVE_GRAIN = 1 << 16;
+
+    namespace detail {
+
+        /*
+         * Moves bit i of v to bit 2i
+         */
+        inline std::uint64_t spreadBits(std::uint32_t v) {
+            std::uint64_t x = v;
+            x = (x | x << 16) & 0x0000FFFF0000FFFFull;
+            x = (x | x << 8) & 0x00FF00FF00FF00FFull;
+            x = (x | x << 4) & 0x0F0F0F0F0F0F0F0Full;
+            x = (x | x << 2) & 0x3333333333333333ull;
+            return (x | x << 1) & 0x5555555555555555ull;
+        }
+
+        /*
+         * Moves bit 2i of v to bit i, the inverse of spreadBits
+         */
+        inline std::uint32_t compactBits(std::uint64_t v) {
+            std::uint64_t x = v & 0x5555555555555555ull;
+            x = (x | x >> 1) & 0x3333333333333333ull;
+            x = (x | x >> 2) & 0x0F0F0F0F0F0F0F0Full;
+            x = (x | x >> 4) & 0x00FF00FF00FF00FFull;
+            x = (x | x >> 8) & 0x0000FFFF0000FFFFull;
+            return std::uint32_t(x | x >> 16);
+        }
+
+        /*
+         * The Hilbert automaton four levels at a time. The state is the transformation of the
+         * remaining lower levels, bit 0 for swapping x and y and bit 1 for complementing both.
+         * encode[state << 8 | x << 4 | y] for 4 bit x and y holds the 8 bit curve digits << 2 | next state,
+         * decode[state << 8 | digits] holds x << 6 | y << 2 | next state.
+         */
+        struct HilbertTables {
+            HilbertTables() {
+                for (unsigned state = 0; state < 4; ++state) {
+                    for (unsigned x = 0; x < 16; ++x) {
+                        for (unsigned y = 0; y < 16; ++y) {
+                            unsigned s = state, digits = 0;
+                            for (int level = 3; level >= 0; --level) {
+                                unsigned rx = (x >> level) & 1, ry = (y >> level) & 1;
+                                if (s & 2) {
+                                    rx ^= 1;
+                                    ry ^= 1;
+                                }
+                                if (s & 1) std::swap(rx, ry);
+                                digits = digits << 2 | ((3 * rx) ^ ry);
+                                // The lower quadrants are rotated in the first and last quadrant
+                                if (ry == 0) s ^= rx == 1 ? 3 : 1;
+                            }
+                            encode[state << 8 | x << 4 | y] = std::uint16_t(digits << 2 | s);
+                            decode[state << 8 | digits] = std::uint16_t(x << 6 | y << 2 | s);
+                        }
+                    }
+                }
+            }
+
+            std::uint16_t encode[1024];
+            std::uint16_t decode[1024];
+        };
+
+        inline const HilbertTables &hilbertTables() {
+            static const HilbertTables tables;
+            return tables;
+        }
+
+#ifdef GRAPH_ALGO_X86_BMI2
+
+        __attribute__((target("bmi2")))
+        inline std::uint64_t mortonPdep(std::uint32_t x, std::uint32_t y) {
+            return _pdep_u64(x, 0x5555555555555555ull) | _pdep_u64(y, 0xAAAAAAAAAAAAAAAAull);
+        }
+
+        __attribute__((target("bmi2")))
+        inline void mortonPext(std::uint64_t key, std::uint32_t &x, std::uint32_t &y) {
+            x = std::uint32_t(_pext_u64(key, 0x5555555555555555ull));
+            y = std::uint32_t(_pext_u64(key, 0xAAAAAAAAAAAAAAAAull));
+        }
+
+#endif /* GRAPH_ALGO_X86_BMI2 */
+
+    }; // namespace detail
+
+    struct MortonCurve {
+        static std::uint64_t encode(std::uint32_t x, std::uint32_t y) {
+#if defined(GRAPH_ALGO_X86_BMI2) && defined(__BMI2__)
+            return detail::mortonPdep(x, y);
+#else
+            return detail::spreadBits(x) | detail::spreadBits(y) << 1;
+#endif
+        }
+
+        static void decode(std::uint64_t key, std::uint32_t &x, std::uint32_t &y) {
+#if defined(GRAPH_ALGO_X86_BMI2) && defined(__BMI2__)
+            detail::mortonPext(key, x, y);
+#else
+            x = detail::compactBits(key);
+            y = detail::compactBits(key >> 1);
+#endif
+        }
+    };
+
+    struct HilbertCurve {
+        static std::uint64_t encode(std::uint32_t x, std::uint32_t y) {
+            const std::uint16_t *table = detail::hilbertTables().encode;
+            std::uint64_t key = 0;
+            unsigned state = 0;
+            for (int shift = 28; shift >= 0; shift -= 4) {
+                const unsigned entry = table[state << 8 | ((x >> shift) & 15) << 4 | ((y >> shift) & 15)];
+                key = key << 8 | entry >> 2;
+                state = entry & 3;
+            }
+            return key;
+        }
+
+        static void decode(std::uint64_t key, std::uint32_t &x, std::uint32_t &y) {
+            const std::uint16_t *table = detail::hilbertTables().decode;
+            x = y = 0;
+            unsigned state = 0;
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                const unsigned entry = table[state << 8 | unsigned(key >> shift & 255)];
+                x = x << 4 | entry >> 6;
+                y = y << 4 | (entry >> 2 & 15);
+                state = entry & 3;
+            }
+        }
+    };
+
+    /**
+     * The square [minX, minX + size] x [minY, minY + size] cut into 2^32 x 2^32 cells
+     */
+    template<class T = double>
+    class CurveGrid {
+    public:
+        typedef PackedPoint<T> point_type;
+
+        /**
+         * Constructor, the grid over the square of side size with lower left corner (minX, minY)
+         */
+        CurveGrid(T minX = T(0), T minY = T(0), T size = T(1))
+                : mMinX(double(minX)), mMinY(double(minY)),
+                  mScale(size > T(0) ? MAX_CELL / double(size) : 0.0) {}
+
+        /**
+         * Constructor, the grid over the bounding square of the points
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        explicit CurveGrid(const PointBuffer<T> &points, unsigned threads = 1) : mMinX(0.0), mMinY(0.0), mScale(0.0) {
+            const std::size_t n = points.size();
+            if (n == 0) return;
+            const T *xs = points.xs(), *ys = points.ys();
+            const unsigned chunks = detail::chunkCount(n, threads, PARALLEL_CURVE_GRAIN);
+            std::vector<double> bounds(4 * chunks);
+            detail::forEachChunk(n, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                double minX = double(xs[first]), minY = double(ys[first]), maxX = minX, maxY = minY;
+                for (std::size_t i = first + 1; i < last; ++i) {
+                    minX = std::min(minX, double(xs[i]));
+                    maxX = std::max(maxX, double(xs[i]));
+                    minY = std::min(minY, double(ys[i]));
+                    maxY = std::max(maxY, double(ys[i]));
+                }
+                bounds[4 * c] = minX;
+                bounds[4 * c + 1] = minY;
+                bounds[4 * c + 2] = maxX;
+                bounds[4 * c + 3] = maxY;
+            });
+            double maxX = bounds[2], maxY = bounds[3];
+            mMinX = bounds[0];
+            mMinY = bounds[1];
+            for (unsigned c = 1; c < chunks; ++c) {
+                mMinX = std::min(mMinX, bounds[4 * c]);
+                mMinY = std::min(mMinY, bounds[4 * c + 1]);
+                maxX = std::max(maxX, bounds[4 * c + 2]);
+                maxY = std::max(maxY, bounds[4 * c + 3]);
+            }
+            const double size = std::max(maxX - mMinX, maxY - mMinY);
+            mScale = size > 0.0 ? MAX_CELL / size : 0.0;
+        }
+
+        /**
+         * The cell column of x, clamped to the grid
+         */
+        std::uint32_t column(T x) const { return quantize((double(x) - mMinX) * mScale); }
+
+        std::uint32_t row(T y) const { return quantize((double(y) - mMinY) * mScale); }
+
+        /**
+         * The key of the cell of p on the curve
+         */
+        template<class Curve, class P>
+        std::uint64_t key(const P &p) const {
+            return Curve::encode(column(T(p.getX())), row(T(p.getY())));
+        }
+
+        template<class P>
+        std::uint64_t morton(const P &p) const { return key<MortonCurve>(p); }
+
+        template<class P>
+        std::uint64_t hilbert(const P &p) const { return key<HilbertCurve>(p); }
+
+        /**
+         * The lower left corner of the cell with the given key
+         */
+        template<class Curve>
+        point_type corner(std::uint64_t key) const {
+            std::uint32_t x, y;
+            Curve::decode(key, x, y);
+            const double inverse = mScale > 0.0 ? 1.0 / mScale : 0.0;
+            return point_type(T(mMinX + double(x) * inverse), T(mMinY + double(y) * inverse));
+        }
+
+    private:
+        static constexpr double MAX_CELL = 4294967295.0;
+
+        static std::uint32_t quantize(double q) {
+            if (!(q > 0.0)) return 0;
+            if (q >= MAX_CELL) return std::numeric_limits<std::uint32_t>::max();
+            return std::uint32_t(q);
+        }
+
+        double mMinX;
+        double mMinY;
+        // Cells per unit
+        double mScale;
+
+    }; // CurveGrid class
+
+    template<class T>
+    constexpr double CurveGrid<T>::MAX_CELL;
+
+    namespace detail {
+
+        template<class Curve, class T>
+        inline void curveKeys(Curve, const CurveGrid<T> &grid, const T *xs, const T *ys, std::size_t n,
+                              std::uint64_t *keys) {
+            for (std::size_t i = 0; i < n; ++i) keys[i] = Curve::encode(grid.column(xs[i]), grid.row(ys[i]));
+        }
+
+#if defined(GRAPH_ALGO_X86_BMI2) && !defined(__BMI2__)
+
+        template<class T>
+        __attribute__((target("bmi2")))
+        void mortonKeysBmi2(const CurveGrid<T> &grid, const T *xs, const T *ys, std::size_t n, std::uint64_t *keys) {
+            for (std::size_t i = 0; i < n; ++i) keys[i] = mortonPdep(grid.column(xs[i]), grid.row(ys[i]));
+        }
+
+        template<class T>
+        inline void curveKeys(MortonCurve, const CurveGrid<T> &grid, const T *xs, const T *ys, std::size_t n,
+                              std::uint64_t *keys) {
+            static const bool bmi2 = __builtin_cpu_supports("bmi2");
+            if (bmi2) {
+                mortonKeysBmi2(grid, xs, ys, n, keys);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) keys[i] = MortonCurve::encode(grid.column(xs[i]), grid.row(ys[i]));
+            }
+        }
+
+#endif
+
+        /*
+         * Sorts the keys and carries the values along: a stable LSD radix sort with 11 bit digits.
+         * One read of the keys counts all digits, so that digits that are the same for all keys are
+         * skipped. Every chunk scatters its range to its own slots, which takes a recount per chunk
+         * once keys have moved between chunks.
+         */
+        inline void radixSort(std::vector<std::uint64_t> &keys, std::vector<std::uint32_t> &values, unsigned threads) {
+            const std::size_t n = keys.size();
+            if (n < 1024) {
+                std::vector<std::size_t> order(n);
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::stable_sort(order.begin(), order.end(), [&keys](std::size_t a, std::size_t b) {
+                    return keys[a] < keys[b];
+                });
+                std::vector<std::uint64_t> sortedKeys(n);
+                std::vector<std::uint32_t> sortedValues(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    sortedKeys[i] = keys[order[i]];
+                    sortedValues[i] = values[order[i]];
+                }
+                keys.swap(sortedKeys);
+                values.swap(sortedValues);
+                return;
+            }
+            const std::size_t digits = 1 << 11, passes = 6;
+            const unsigned chunks = chunkCount(n, threads, PARALLEL_CURVE_GRAIN);
+            std::vector<std::size_t> counts(chunks * passes * digits, 0);
+            forEachChunk(n, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                std::size_t *count = &counts[c * passes * digits];
+                for (std::size_t i = first; i < last; ++i) {
+                    const std::uint64_t key = keys[i];
+                    for (std::size_t pass = 0; pass < passes; ++pass) {
+                        ++count[pass * digits + ((key >> (11 * pass)) & (digits - 1))];
+                    }
+                }
+            });
+            std::vector<std::uint64_t> keyBuffer;
+            std::vector<std::uint32_t> valueBuffer;
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                bool trivial = false;
+                for (std::size_t d = 0; d < digits && !trivial; ++d) {
+                    std::size_t total = 0;
+                    for (unsigned c = 0; c < chunks; ++c) total += counts[(c * passes + pass) * digits + d];
+                    trivial = total == n;
+                }
+                if (trivial) continue;
+                const unsigned shift = unsigned(11 * pass);
+                if (keyBuffer.empty()) {
+                    keyBuffer.resize(n);
+                    valueBuffer.resize(n);
+                } else if (chunks > 1) {
+                    forEachChunk(n, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                        std::size_t *count = &counts[(c * passes + pass) * digits];
+                        std::fill(count, count + digits, 0);
+                        for (std::size_t i = first; i < last; ++i) ++count[(keys[i] >> shift) & (digits - 1)];
+                    });
+                }
+                // The slots of digit d in chunk c follow those of d in the chunks before c
+                std::size_t sum = 0;
+                for (std::size_t d = 0; d < digits; ++d) {
+                    for (unsigned c = 0; c < chunks; ++c) {
+                        std::size_t &count = counts[(c * passes + pass) * digits + d];
+                        const std::size_t chunkSize = count;
+                        count = sum;
+                        sum += chunkSize;
+                    }
+                }
+                forEachChunk(n, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                    std::size_t *cursor = &counts[(c * passes + pass) * digits];
+                    for (std::size_t i = first; i < last; ++i) {
+                        const std::size_t slot = cursor[(keys[i] >> shift) & (digits - 1)]++;
+                        keyBuffer[slot] = keys[i];
+                        valueBuffer[slot] = values[i];
+                    }
+                });
+                keys.swap(keyBuffer);
+                values.swap(valueBuffer);
+            }
+        }
+
+    }; // namespace detail
+
+    /**
+     * The key of every point on the curve, over grid
+     * @param keys Receives points.size() keys.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class Curve, class T>
+    void curveKeys(const PointBuffer<T> &points, const CurveGrid<T> &grid, std::uint64_t *keys, unsigned threads = 1) {
+        const T *xs = points.xs(), *ys = points.ys();
+        const unsigned chunks = detail::chunkCount(points.size(), threads, PARALLEL_CURVE_GRAIN);
+        detail::forEachChunk(points.size(), chunks, [&](unsigned, std::size_t first, std::size_t last) {
+            detail::curveKeys(Curve(), grid, xs + first, ys + first, last - first, keys + first);
+        });
+    }
+
+    /**
+     * The order of the points along the curve over their bounding square: order[k] is the index
+     * of the k-th point. Points in the same cell keep their input order.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class Curve = HilbertCurve, class T>
+    std::vector<std::uint32_t> curveOrder(const PointBuffer<T> &points, unsigned threads = 1) {
+        const std::size_t n = points.size();
+        if (n >= std::size_t(std::numeric_limits<std::uint32_t>::max())) throw GraphTooLargeException();
+        std::vector<std::uint64_t> keys(n);
+        curveKeys<Curve>(points, CurveGrid<T>(points, threads), keys.data(), threads);
+        std::vector<std::uint32_t> order(n);
+        std::iota(order.begin(), order.end(), std::uint32_t(0));
+        detail::radixSort(keys, order, threads);
+        return order;
+    }
+
+    /**
+     * Reorders the points along the curve, see curveOrder.
+     * @return Returns the order, order[k] is the input index of the point now at k.
+     */
+    template<class Curve = HilbertCurve, class T>
+    std::vector<std::uint32_t> curveSort(PointBuffer<T> &points, unsigned threads = 1) {
+        const std::vector<std::uint32_t> order = curveOrder<Curve>(points, threads);
+        PointBuffer<T> sorted;
+        sorted.resize(points.size());
+        const unsigned chunks = detail::chunkCount(points.size(), threads, PARALLEL_CURVE_GRAIN);
+        detail::forEachChunk(points.size(), chunks, [&](unsigned, std::size_t first, std::size_t last) {
+            for (std::size_t k = first; k < last; ++k) {
+                sorted.xs()[k] = points.xs()[order[k]];
+                sorted.ys()[k] = points.ys()[order[k]];
+            }
+        });
+        std::swap(points, sorted);
+        return order;
+    }
+
+};// namespace graph_algo
+
+
+#endif /* SPACEFILLINGCURVE_H_ */
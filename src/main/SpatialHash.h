@@ -0,0 +1,596 @@
+#ifndef SPATIALHASH_H_
+#define SPATIALHASH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+
+/**
+ * A uniform grid over a dynamic set of points, for points that move every tick.
+ *
+ * Points have caller chosen ids in [0, 2^32 - 1) and sit in square cells of a fixed size,
+ * cell (floor(x / cellSize), floor(y / cellSize)). Only the non-empty cells exist:
+ * - they live in an open addressing table with linear probing, keyed on their coordinates.
+ *   Erased cells are closed with backward shifts, so there are no tombstones.
+ * - the table is hashed by tiles of 4 x 4 cells: a tile goes to a pseudo random group of
+ *   16 slots and its cells to fixed slots of the group. The neighbours of a cell are then
+ *   mostly in the same few cache lines, which is what radius and pair queries look up.
+ * - the points of a cell are one contiguous block of (x, y, id) entries in a shared pool.
+ *   Blocks hold a power of two entries and are recycled through a free list per size,
+ *   a full block moves to one twice as large.
+ * - every id knows its entry, so insert, move and remove are O(1): a point is removed by
+ *   moving the last entry of its cell into its place.
+ * Moving a point within its cell only rewrites its entry, which is the common case when the
+ * cells are about as large as the query distance.
+ *
+ * rebuild and moveAll are the bulk updates. rebuild lays the blocks out in table order, so
+ * that the queries walking the table read the pool mostly in order. moveAll updates the
+ * points that stay in their cell in parallel, then moves the others one at a time.
+ */
+
+#if defined(__GNUC__)
+#define GRAPH_ALGO_PREFETCH_WRITE(address) __builtin_prefetch(address, 1)
+#else
+#define GRAPH_ALGO_PREFETCH_WRITE(address) ((void) 0)
+#endif
+
+namespace graph_algo {
+
+    struct SpatialHashPointNotFoundException : public std::exception {
+        const char *what() const throw() {
+            return "The point id is not in the spatial hash.";
+        }
+
+    };
+
+    /**
+     * Inputs smaller than this per thread are not worth splitting in the bulk operations
+     */
+    static const std::size_t PARALLEL_SPATIAL_HASH_GRAIN = 1 << 14;
+
+    template<class T = double>
+    class SpatialHash {
+    public:
+        typedef PackedPoint<T> point_type;
+        typedef std::pair<std::uint32_t, std::uint32_t> id_pair;
+
+        static const std::uint32_t NO_POINT = std::numeric_limits<std::uint32_t>::max();
+
+        /**
+         * Constructor.
+         * @param cellSize The side of the cells, about the usual query distance.
+         */
+        explicit SpatialHash(T cellSize = T(1)) : mCellSize(cellSize), mInverse(1.0 / double(cellSize)) {
+            clear();
+        }
+
+        T cellSize() const { return mCellSize; }
+
+        /**
+         * The number of points
+         */
+        std::size_t size() const { return mSize; }
+
+        bool empty() const { return mSize == 0; }
+
+        /**
+         * The number of non-empty cells
+         */
+        std::size_t cellCount() const { return mCellCount; }
+
+        bool contains(std::uint32_t id) const {
+            return id < mEntryOf.size() && mEntryOf[id] != NO_ENTRY;
+        }
+
+        /**
+         * The position of point id, throws SpatialHashPointNotFoundException if there is no such point
+         */
+        point_type point(std::uint32_t id) const {
+            if (!contains(id)) throw SpatialHashPointNotFoundException();
+            const Entry &entry = mEntries[mEntryOf[id]];
+            return point_type(entry.x, entry.y);
+        }
+
+        /**
+         * Approximate heap memory in bytes
+         */
+        std::size_t memoryUsage() const {
+            return mEntries.capacity() * sizeof(Entry) + mTable.capacity() * sizeof(Cell)
+                   + mEntryOf.capacity() * sizeof(std::uint32_t);
+        }
+
+        /**
+         * Removes all points
+         */
+        void clear() {
+            mSize = 0;
+            mCellCount = 0;
+            mEntryOf.clear();
+            mEntries.clear();
+            for (std::size_t c = 0; c < BLOCK_CLASSES; ++c) mFreeBlocks[c].clear();
+            mTable.clear();
+            resizeTable(MIN_TABLE_SIZE);
+        }
+
+        /**
+         * Adds point id at (x, y), or moves it there if it is already in
+         */
+        void insert(std::uint32_t id, T x, T y) {
+            if (id == NO_POINT) throw GraphTooLargeException();
+            if (contains(id)) {
+                move(id, x, y);
+                return;
+            }
+            if (id >= mEntryOf.size()) mEntryOf.resize(std::size_t(id) + 1, NO_ENTRY);
+            attach(id, x, y);
+            ++mSize;
+        }
+
+        template<class P>
+        void insert(std::uint32_t id, const P &p) {
+            insert(id, T(p.getX()), T(p.getY()));
+        }
+
+        /**
+         * Moves point id to (x, y), throws SpatialHashPointNotFoundException if there is no such point
+         */
+        void move(std::uint32_t id, T x, T y) {
+            if (!contains(id)) throw SpatialHashPointNotFoundException();
+            Entry &entry = mEntries[mEntryOf[id]];
+            if (sameCell(entry, x, y)) {
+                entry.x = x;
+                entry.y = y;
+                return;
+            }
+            detach(id);
+            attach(id, x, y);
+        }
+
+        template<class P>
+        void move(std::uint32_t id, const P &p) {
+            move(id, T(p.getX()), T(p.getY()));
+        }
+
+        /**
+         * Removes point id.
+         * @return Returns false if there was no such point.
+         */
+        bool remove(std::uint32_t id) {
+            if (!contains(id)) return false;
+            detach(id);
+            --mSize;
+            return true;
+        }
+
+        /**
+         * Replaces the content with the points, point i gets id i
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        void rebuild(const PointBuffer<T> &points, unsigned threads = 1) {
+            const std::size_t n = points.size();
+            if (n >= std::size_t(NO_POINT)) throw GraphTooLargeException();
+            clear();
+            const T *xs = points.xs(), *ys = points.ys();
+
+            // Count the points of every cell
+            std::int32_t lastX = 0, lastY = 0;
+            std::size_t lastSlot = NO_SLOT;
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::int32_t x = cellOf(xs[i]), y = cellOf(ys[i]);
+                if (lastSlot == NO_SLOT || x != lastX || y != lastY) {
+                    lastX = x;
+                    lastY = y;
+                    lastSlot = find(x, y);
+                    if (lastSlot == NO_SLOT) lastSlot = addCell(x, y);
+                }
+                ++mTable[lastSlot].count;
+            }
+
+            // A block per cell in table order, large enough for its points
+            std::size_t total = 0;
+            for (std::size_t s = 0; s < mTable.size(); ++s) {
+                Cell &cell = mTable[s];
+                if (cell.count == 0) continue;
+                while (blockSize(cell.sizeClass) < cell.count) ++cell.sizeClass;
+                cell.first = std::uint32_t(total);
+                total += blockSize(cell.sizeClass);
+                if (total >= std::size_t(NO_ENTRY)) throw GraphTooLargeException();
+            }
+            mEntries.resize(total);
+            mEntryOf.resize(n);
+
+            // The slot of every point and the points of every chunk per slot, then every chunk
+            // starts in every cell after the points of the chunks before it and fills its points
+            // in, so that the cells are in id order
+            const unsigned chunks = detail::chunkCount(n, threads, PARALLEL_SPATIAL_HASH_GRAIN);
+            const std::size_t tableSize = mTable.size();
+            std::vector<std::uint32_t> slots(n);
+            std::vector<std::vector<std::uint32_t> > cursors(chunks);
+            detail::forEachChunk(n, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                std::vector<std::uint32_t> &counts = cursors[c];
+                counts.assign(tableSize, 0);
+                for (std::size_t i = first; i < last; ++i) {
+                    slots[i] = std::uint32_t(find(cellOf(xs[i]), cellOf(ys[i])));
+                    ++counts[slots[i]];
+                }
+            });
+            detail::forEachChunk(tableSize, chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                for (std::size_t s = first; s < last; ++s) {
+                    std::uint32_t at = mTable[s].first;
+                    for (unsigned c = 0; c < chunks; ++c) {
+                        const std::uint32_t count = cursors[c][s];
+                        cursors[c][s] = at;
+                        at += count;
+                    }
+                }
+            });
+            detail::forEachChunk(n, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                std::vector<std::uint32_t> &cursor = cursors[c];
+                for (std::size_t i = first; i < last; ++i) {
+                    const std::uint32_t e = cursor[slots[i]]++;
+                    mEntries[e].x = xs[i];
+                    mEntries[e].y = ys[i];
+                    mEntries[e].id = std::uint32_t(i);
+                    mEntryOf[i] = e;
+                }
+            });
+            mSize = n;
+        }
+
+        template<class P>
+        void rebuild(const std::vector<P> &points, unsigned threads = 1) {
+            rebuild(PointBuffer<T>(points), threads);
+        }
+
+        /**
+         * Moves point i to points[i] for every i, inserting the points that are not in yet.
+         * Points with ids beyond points.size() are not touched.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        void moveAll(const PointBuffer<T> &points, unsigned threads = 1) {
+            const std::size_t n = points.size();
+            if (n >= std::size_t(NO_POINT)) throw GraphTooLargeException();
+            const T *xs = points.xs(), *ys = points.ys();
+            const std::size_t known = std::min(n, mEntryOf.size());
+            const unsigned chunks = detail::chunkCount(known, threads, PARALLEL_SPATIAL_HASH_GRAIN);
+
+            // The points that stay in their cell are updated in place, every chunk lists the others
+            std::vector<std::vector<std::uint32_t> > leaving(chunks);
+            detail::forEachChunk(known, chunks, [&](unsigned c, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) {
+                    // The entries are scattered over the pool, fetch them ahead
+                    if (i + PREFETCH_DISTANCE < last && mEntryOf[i + PREFETCH_DISTANCE] != NO_ENTRY) {
+                        GRAPH_ALGO_PREFETCH_WRITE(&mEntries[mEntryOf[i + PREFETCH_DISTANCE]]);
+                    }
+                    if (mEntryOf[i] == NO_ENTRY) {
+                        leaving[c].push_back(std::uint32_t(i));
+                        continue;
+                    }
+                    Entry &entry = mEntries[mEntryOf[i]];
+                    if (!sameCell(entry, xs[i], ys[i])) {
+                        leaving[c].push_back(std::uint32_t(i));
+                        continue;
+                    }
+                    entry.x = xs[i];
+                    entry.y = ys[i];
+                }
+            });
+            for (std::size_t c = 0; c < leaving.size(); ++c) {
+                for (std::size_t j = 0; j < leaving[c].size(); ++j) {
+                    const std::uint32_t i = leaving[c][j];
+                    insert(i, xs[i], ys[i]);
+                }
+            }
+            for (std::size_t i = known; i < n; ++i) insert(std::uint32_t(i), xs[i], ys[i]);
+        }
+
+        /**
+         * Appends the ids of all points within distance r of q to out, in no particular order.
+         * @return Returns the number of ids appended.
+         */
+        template<class P>
+        std::size_t radius(const P &q, T r, std::vector<std::uint32_t> &out) const {
+            const std::size_t before = out.size();
+            const T qx = T(q.getX()), qy = T(q.getY()), r2 = r * r;
+            const std::int32_t minX = cellOf(qx - r), maxX = cellOf(qx + r);
+            const std::int32_t minY = cellOf(qy - r), maxY = cellOf(qy + r);
+            const double span = (double(maxX) - double(minX) + 1.0) * (double(maxY) - double(minY) + 1.0);
+            if (span > double(mCellCount)) {
+                // Fewer cells than lookups
+                for (std::size_t s = 0; s < mTable.size(); ++s) collect(mTable[s], qx, qy, r2, out);
+            } else {
+                for (std::int64_t x = minX; x <= maxX; ++x) {
+                    for (std::int64_t y = minY; y <= maxY; ++y) {
+                        const std::size_t s = find(std::int32_t(x), std::int32_t(y));
+                        if (s != NO_SLOT) collect(mTable[s], qx, qy, r2, out);
+                    }
+                }
+            }
+            return out.size() - before;
+        }
+
+        /**
+         * All pairs of points within distance d of each other, each pair once with the smaller id first,
+         * in no particular order.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        std::vector<id_pair> pairsWithin(T d, unsigned threads = 1) const {
+            const T d2 = d * d;
+            // Cells further apart than reach cells hold no pair
+            const std::int64_t reach = std::int64_t(std::ceil(double(d) * mInverse));
+            const unsigned chunks = detail::chunkCount(mTable.size(), threads, PARALLEL_SPATIAL_HASH_GRAIN);
+            std::vector<std::vector<id_pair> > found(chunks);
+            detail::forEachChunk(mTable.size(), chunks, [&](unsigned chunk, std::size_t first, std::size_t last) {
+                std::vector<id_pair> &out = found[chunk];
+                for (std::size_t s = first; s < last; ++s) {
+                    const Cell &cell = mTable[s];
+                    if (cell.count == 0) continue;
+                    const Entry *entries = &mEntries[cell.first];
+                    for (std::uint32_t i = 0; i < cell.count; ++i) {
+                        for (std::uint32_t j = i + 1; j < cell.count; ++j) {
+                            if (squaredDistance(entries[i], entries[j]) <= d2) out.push_back(ordered(entries[i].id, entries[j].id));
+                        }
+                    }
+                    // The neighbours after this cell, so that every pair of cells is visited once
+                    for (std::int64_t dx = 0; dx <= reach; ++dx) {
+                        for (std::int64_t dy = dx == 0 ? 1 : -reach; dy <= reach; ++dy) {
+                            const std::int64_t x = std::int64_t(cell.x) + dx, y = std::int64_t(cell.y) + dy;
+                            if (x > MAX_CELL || y < MIN_CELL || y > MAX_CELL) continue;
+                            const std::size_t other = find(std::int32_t(x), std::int32_t(y));
+                            if (other == NO_SLOT) continue;
+                            const Entry *neighbours = &mEntries[mTable[other].first];
+                            for (std::uint32_t i = 0; i < cell.count; ++i) {
+                                for (std::uint32_t j = 0; j < mTable[other].count; ++j) {
+                                    if (squaredDistance(entries[i], neighbours[j]) <= d2) {
+                                        out.push_back(ordered(entries[i].id, neighbours[j].id));
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+            if (found.size() == 1) return found[0];
+            std::size_t total = 0;
+            for (std::size_t c = 0; c < found.size(); ++c) total += found[c].size();
+            std::vector<id_pair> pairs;
+            pairs.reserve(total);
+            for (std::size_t c = 0; c < found.size(); ++c) pairs.insert(pairs.end(), found[c].begin(), found[c].end());
+            return pairs;
+        }
+
+    private:
+        static const std::uint32_t NO_ENTRY = std::numeric_limits<std::uint32_t>::max();
+        static const std::size_t NO_SLOT = std::numeric_limits<std::size_t>::max();
+        static const std::int64_t MIN_CELL = std::numeric_limits<std::int32_t>::min();
+        static const std::int64_t MAX_CELL = std::numeric_limits<std::int32_t>::max();
+        static const std::size_t MIN_TABLE_SIZE = 64;
+        static const std::size_t BLOCK_CLASSES = 32;
+        static const std::size_t PREFETCH_DISTANCE = 16;
+
+        struct Entry {
+            T x, y;
+            std::uint32_t id;
+        };
+
+        /*
+         * A slot of the table, empty if count is 0
+         */
+        struct Cell {
+            Cell() : x(0), y(0), first(0), count(0), sizeClass(0) {}
+
+            std::int32_t x, y;
+            // The block of the cell's entries in mEntries, of blockSize(sizeClass) entries
+            std::uint32_t first;
+            std::uint32_t count;
+            std::uint32_t sizeClass;
+        };
+
+        static std::uint32_t blockSize(std::uint32_t sizeClass) { return 1u << sizeClass; }
+
+        static id_pair ordered(std::uint32_t a, std::uint32_t b) {
+            return a < b ? id_pair(a, b) : id_pair(b, a);
+        }
+
+        static T squaredDistance(const Entry &a, const Entry &b) {
+            const T dx = a.x - b.x, dy = a.y - b.y;
+            return dx * dx + dy * dy;
+        }
+
+        /*
+         * The cell coordinate of x, clamped to the range of std::int32_t
+         */
+        std::int32_t cellOf(T x) const {
+            const double c = std::floor(double(x) * mInverse);
+            if (!(c > double(MIN_CELL))) return std::int32_t(MIN_CELL);
+            if (c >= double(MAX_CELL)) return std::int32_t(MAX_CELL);
+            return std::int32_t(c);
+        }
+
+        bool sameCell(const Entry &entry, T x, T y) const {
+            return cellOf(entry.x) == cellOf(x) && cellOf(entry.y) == cellOf(y);
+        }
+
+        /*
+         * The first slot to probe for cell (x, y): Fibonacci hashing of its tile picks a group of
+         * 16 slots, the low bits of x and y the slot in the group
+         */
+        std::size_t home(std::int32_t x, std::int32_t y) const {
+            const std::uint32_t ux = std::uint32_t(x), uy = std::uint32_t(y);
+            const std::uint64_t tile = std::uint64_t(ux >> 2) << 32 | (uy >> 2);
+            return std::size_t((tile * 0x9E3779B97F4A7C15ull) >> mShift) << 4 | (ux & 3) << 2 | (uy & 3);
+        }
+
+        std::size_t find(std::int32_t x, std::int32_t y) const {
+            const std::size_t mask = mTable.size() - 1;
+            for (std::size_t s = home(x, y);; s = (s + 1) & mask) {
+                const Cell &cell = mTable[s];
+                if (cell.count == 0) return NO_SLOT;
+                if (cell.x == x && cell.y == y) return s;
+            }
+        }
+
+        /*
+         * An empty slot for cell (x, y), which is not in the table
+         */
+        std::size_t place(std::int32_t x, std::int32_t y) {
+            const std::size_t mask = mTable.size() - 1;
+            std::size_t s = home(x, y);
+            while (mTable[s].count != 0) s = (s + 1) & mask;
+            return s;
+        }
+
+        void resizeTable(std::size_t size) {
+            std::vector<Cell> old(size);
+            old.swap(mTable);
+            mShift = 64;
+            for (std::size_t groups = size >> 4; groups > 1; groups >>= 1) --mShift;
+            for (std::size_t s = 0; s < old.size(); ++s) {
+                if (old[s].count != 0) mTable[place(old[s].x, old[s].y)] = old[s];
+            }
+        }
+
+        /*
+         * Takes cell s out of the table and shifts back the cells of its probe sequence
+         */
+        void erase(std::size_t s) {
+            const std::size_t mask = mTable.size() - 1;
+            for (std::size_t next = (s + 1) & mask; mTable[next].count != 0; next = (next + 1) & mask) {
+                // A cell can fill the hole unless its home lies between the hole and it
+                if (((next - home(mTable[next].x, mTable[next].y)) & mask) >= ((next - s) & mask)) {
+                    mTable[s] = mTable[next];
+                    s = next;
+                }
+            }
+            mTable[s] = Cell();
+        }
+
+        /*
+         * A new cell without points or block, its count has to be raised before the next table change
+         */
+        std::size_t addCell(std::int32_t x, std::int32_t y) {
+            // Keep the load factor under 1/2
+            if (2 * (mCellCount + 1) > mTable.size()) resizeTable(2 * mTable.size());
+            const std::size_t s = place(x, y);
+            mTable[s] = Cell();
+            mTable[s].x = x;
+            mTable[s].y = y;
+            ++mCellCount;
+            return s;
+        }
+
+        std::uint32_t allocate(std::uint32_t sizeClass) {
+            std::vector<std::uint32_t> &free = mFreeBlocks[sizeClass];
+            if (!free.empty()) {
+                const std::uint32_t first = free.back();
+                free.pop_back();
+                return first;
+            }
+            const std::size_t first = mEntries.size();
+            if (first + blockSize(sizeClass) >= std::size_t(NO_ENTRY)) throw GraphTooLargeException();
+            mEntries.resize(first + blockSize(sizeClass));
+            return std::uint32_t(first);
+        }
+
+        void attach(std::uint32_t id, T x, T y) {
+            const std::int32_t cx = cellOf(x), cy = cellOf(y);
+            std::size_t s = find(cx, cy);
+            if (s == NO_SLOT) {
+                s = addCell(cx, cy);
+                mTable[s].first = allocate(0);
+            } else if (mTable[s].count == blockSize(mTable[s].sizeClass)) {
+                // Move to a block twice as large
+                const std::uint32_t first = allocate(mTable[s].sizeClass + 1);
+                Cell &cell = mTable[s];
+                std::copy(mEntries.begin() + cell.first, mEntries.begin() + cell.first + cell.count,
+                          mEntries.begin() + first);
+                for (std::uint32_t i = 0; i < cell.count; ++i) mEntryOf[mEntries[first + i].id] = first + i;
+                mFreeBlocks[cell.sizeClass].push_back(cell.first);
+                cell.first = first;
+                ++cell.sizeClass;
+            }
+            Cell &cell = mTable[s];
+            const std::uint32_t e = cell.first + cell.count++;
+            mEntries[e].x = x;
+            mEntries[e].y = y;
+            mEntries[e].id = id;
+            mEntryOf[id] = e;
+        }
+
+        void detach(std::uint32_t id) {
+            const std::uint32_t e = mEntryOf[id];
+            const std::size_t s = find(cellOf(mEntries[e].x), cellOf(mEntries[e].y));
+            Cell &cell = mTable[s];
+            const std::uint32_t last = cell.first + --cell.count;
+            if (e != last) {
+                mEntries[e] = mEntries[last];
+                mEntryOf[mEntries[e].id] = e;
+            }
+            mEntryOf[id] = NO_ENTRY;
+            if (cell.count == 0) {
+                mFreeBlocks[cell.sizeClass].push_back(cell.first);
+                erase(s);
+                --mCellCount;
+            }
+        }
+
+        void collect(const Cell &cell, T qx, T qy, T r2, std::vector<std::uint32_t> &out) const {
+            if (cell.count == 0) return;
+            const Entry *entries = &mEntries[cell.first];
+            for (std::uint32_t i = 0; i < cell.count; ++i) {
+                const T dx = entries[i].x - qx, dy = entries[i].y - qy;
+                if (dx * dx + dy * dy <= r2) out.push_back(entries[i].id);
+            }
+        }
+
+        T mCellSize;
+        double mInverse;
+        std::size_t mSize;
+        std::size_t mCellCount;
+        // The entry of every id, NO_ENTRY for ids that are not in
+        std::vector<std::uint32_t> mEntryOf;
+        // The pool of cell blocks
+        std::vector<Entry> mEntries;
+        std::vector<std::uint32_t> mFreeBlocks[BLOCK_CLASSES];
+        std::vector<Cell> mTable;
+        // 64 minus the number of bits of the group of a slot
+        unsigned mShift;
+
+    }; // SpatialHash class
+
+    template<class T>
+    const std::uint32_t SpatialHash<T>::NO_POINT;
+
+    template<class T>
+    const std::uint32_t SpatialHash<T>::NO_ENTRY;
+
+    template<class T>
+    const std::size_t SpatialHash<T>::NO_SLOT;
+
+    template<class T>
+    const std::int64_t SpatialHash<T>::MIN_CELL;
+
+    template<class T>
+    const std::int64_t SpatialHash<T>::MAX_CELL;
+
+    template<class T>
+    const std::size_t SpatialHash<T>::MIN_TABLE_SIZE;
+
+    template<class T>
+    const std::size_t SpatialHash<T>::BLOCK_CLASSES;
+
+    template<class T>
+    const std::size_t SpatialHash<T>::PREFETCH_DISTANCE;
+
+};// namespace graph_algo
+
+
+#endif /* SPATIALHASH_H_ */
@@ -0,0 +1,422 @@
+#ifndef TEXTPARSER_H_
+#define TEXTPARSER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+#include <vector>
+#include "BinaryFile.h"
+#include "Graph.h"
+#include "PointBuffer.h"
+
+/**
+ * Parsers for point and edge lists in text form, one point or edge per line:
+ * - points are "x y", edges are "u v" or "u v w" with vertex ids from 0,
+ * - numbers are separated by spaces or tabs, or by one comma or semicolon, i.e. CSV works,
+ * - empty lines and lines starting with '#' are skipped, and the first line may be a header
+ *   such as "x,y" if it does not start with a number,
+ * - lines end with "\n" or "\r\n".
+ *
+ * readPoints and readEdges map the file (MappedFile in BinaryFile.h) and split it into one
+ * chunk per thread at line boundaries. Every thread parses its chunk straight into its own
+ * coordinate or edge arrays, which are then concatenated in file order. Numbers go through
+ * parseNumber, a from_chars style routine that reads the digits once and multiplies or divides
+ * by an exact power of ten, in double for up to 53 bit mantissas and in long double for up to
+ * 19 digits. Only what that cannot round correctly, e.g. more digits or exponents beyond 27,
+ * goes through std::strtod, which depends on the C locale for the decimal point.
+ * parsePoints and parseEdges do the same for text in memory.
+ * Like the other bulk operations they run on one thread unless given more.
+ */
+
+namespace graph_algo {
+
+    /**
+     * A line that is neither a point or edge, a comment nor empty
+     */
+    struct TextParseException : public std::exception {
+        explicit TextParseException(std::size_t line)
+                : mLine(line), mMessage("Line " + std::to_string(line) + " is not a point or edge of the expected form.") {}
+
+        const char *what() const throw() {
+            return mMessage.c_str();
+        }
+
+        /**
+         * The number of the line, from 1
+         */
+        std::size_t line() const { return mLine; }
+
+    private:
+        std::size_t mLine;
+        std::string mMessage;
+
+    };
+
+    /**
+     * Texts smaller than this per thread are not worth splitting
+     */
+    static const std::size_t PARALLEL_PARSE_GRAIN = 1 << 20;
+
+    namespace detail {
+
+        // The powers of ten that are exact doubles and exact x87 long doubles
+        static const double EXACT_POWERS_OF_TEN[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        static const long double EXACT_LONG_POWERS_OF_TEN[] = {
+                1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+                1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+        };
+
+        inline bool isDigit(char c) { return unsigned(c - '0') < 10u; }
+
+        inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        /*
+         * Compares the letters at p with word, ignoring case
+         */
+        inline bool startsWith(const char *p, const char *end, const char *word) {
+            for (; *word; ++p, ++word) {
+                if (p == end || (*p | 0x20) != *word) return false;
+            }
+            return true;
+        }
+
+        /*
+         * Parses a decimal floating point number, "nan" or "inf" at p.
+         * @return Returns the end of the number, or nullptr if there is none.
+         */
+        inline const char *parseNumber(const char *p, const char *end, double &value) {
+            const char *start = p;
+            const bool negative = p < end && *p == '-';
+            if (p < end && (*p == '-' || *p == '+')) ++p;
+            std::uint64_t mantissa = 0;
+            int significant = 0, exponent = 0;
+            bool exact = true, digits = false;
+            for (; p < end && isDigit(*p); ++p) {
+                digits = true;
+                if (significant < 19) {
+                    mantissa = mantissa * 10 + unsigned(*p - '0');
+                    significant += mantissa != 0;
+                } else {
+                    ++exponent;
+                    exact = exact && *p == '0';
+                }
+            }
+            if (p < end && *p == '.') {
+                for (++p; p < end && isDigit(*p); ++p) {
+                    digits = true;
+                    if (significant < 19) {
+                        mantissa = mantissa * 10 + unsigned(*p - '0');
+                        significant += mantissa != 0;
+                        --exponent;
+                    } else {
+                        exact = exact && *p == '0';
+                    }
+                }
+            }
+            if (!digits) {
+                if (startsWith(p, end, "nan")) {
+                    value = std::numeric_limits<double>::quiet_NaN();
+                    return p + 3;
+                }
+                if (startsWith(p, end, "inf")) {
+                    value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+                    return startsWith(p, end, "infinity") ? p + 8 : p + 3;
+                }
+                return nullptr;
+            }
+            if (p < end && (*p == 'e' || *p == 'E')) {
+                const char *q = p + 1;
+                const bool negativeExponent = q < end && *q == '-';
+                if (q < end && (*q == '-' || *q == '+')) ++q;
+                if (q < end && isDigit(*q)) {
+                    int e = 0;
+                    for (; q < end && isDigit(*q); ++q) e = std::min(e * 10 + (*q - '0'), 100000);
+                    exponent += negativeExponent ? -e : e;
+                    p = q;
+                }
+            }
+            // A mantissa of at most 53 bits and an exact power of ten give a correctly rounded
+            // product or quotient
+            if (exact && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+                const double m = double(mantissa);
+                value = exponent < 0 ? m / EXACT_POWERS_OF_TEN[-exponent] : m * EXACT_POWERS_OF_TEN[exponent];
+                if (negative) value = -value;
+                return p;
+            }
+            // Up to 19 digits are exact in a 64 bit long double mantissa, and so are the powers of
+            // ten up to 10^27, so the product or quotient is rounded once. Rounding that to double
+            // is only wrong if it lies halfway between two doubles, which goes to strtod.
+            if (std::numeric_limits<long double>::digits >= 64 && exact && exponent >= -27 && exponent <= 27) {
+                const long double m = (long double) mantissa;
+                const long double x = exponent < 0 ? m / EXACT_LONG_POWERS_OF_TEN[-exponent]
+                                                   : m * EXACT_LONG_POWERS_OF_TEN[exponent];
+                const double rounded = double(x);
+                const double other = std::nextafter(rounded, x > rounded ? HUGE_VAL : -HUGE_VAL);
+                if (x == (long double) rounded || x - rounded != other - x) {
+                    value = negative ? -rounded : rounded;
+                    return p;
+                }
+            }
+            char buffer[64];
+            const std::size_t length = std::size_t(p - start);
+            if (length < sizeof(buffer)) {
+                std::memcpy(buffer, start, length);
+                buffer[length] = '\0';
+                value = std::strtod(buffer, nullptr);
+            } else {
+                value = std::strtod(std::string(start, p).c_str(), nullptr);
+            }
+            return p;
+        }
+
+        /*
+         * Parses an unsigned decimal integer at p.
+         * @return Returns the end of the number, or nullptr if there is none or it does not fit 64 bits.
+         */
+        inline const char *parseUnsigned(const char *p, const char *end, std::uint64_t &value) {
+            if (p == end || !isDigit(*p)) return nullptr;
+            value = 0;
+            for (; p < end && isDigit(*p); ++p) {
+                const unsigned d = unsigned(*p - '0');
+                if (value > (std::numeric_limits<std::uint64_t>::max() - d) / 10) return nullptr;
+                value = value * 10 + d;
+            }
+            return p;
+        }
+
+        /*
+         * Skips the separator between two numbers: blanks, or one comma or semicolon between blanks.
+         * @return Returns nullptr if there is no separator.
+         */
+        inline const char *skipSeparator(const char *p, const char *end) {
+            const char *start = p;
+            while (p < end && isBlank(*p)) ++p;
+            if (p < end && (*p == ',' || *p == ';')) {
+                ++p;
+                while (p < end && isBlank(*p)) ++p;
+            }
+            return p == start || p == end || *p == '\n' ? nullptr : p;
+        }
+
+        /*
+         * Skips blanks and the line break.
+         * @return Returns nullptr if there is something else before the end of the line.
+         */
+        inline const char *skipLineEnd(const char *p, const char *end) {
+            while (p < end && isBlank(*p)) ++p;
+            if (p == end) return p;
+            return *p == '\n' ? p + 1 : nullptr;
+        }
+
+        /*
+         * The points of a chunk of text
+         */
+        template<class T>
+        struct PointRows {
+            PointBuffer<T> points;
+
+            const char *parse(const char *p, const char *end) {
+                double x, y;
+                if (!(p = parseNumber(p, end, x)) || !(p = skipSeparator(p, end)) || !(p = parseNumber(p, end, y))) {
+                    return nullptr;
+                }
+                points.push_back(T(x), T(y));
+                return skipLineEnd(p, end);
+            }
+        };
+
+        /*
+         * The edges of a chunk of text. Edges without a weight get weight 1.
+         */
+        template<class Index, class Weight>
+        struct EdgeRows {
+            typedef typename CsrGraph<Index, Weight>::index_array index_array;
+            typedef typename CsrGraph<Index, Weight>::weight_array weight_array;
+
+            index_array sources, targets;
+            weight_array weights;
+            std::uint64_t vertices = 0;
+            bool weighted = false;
+
+            const char *parse(const char *p, const char *end) {
+                std::uint64_t u, v;
+                if (!(p = parseUnsigned(p, end, u)) || !(p = skipSeparator(p, end)) || !(p = parseUnsigned(p, end, v)) ||
+                    std::max(u, v) >= std::uint64_t(std::numeric_limits<Index>::max()) - 1) {
+                    return nullptr;
+                }
+                double w = 1.0;
+                const char *next = skipLineEnd(p, end);
+                if (next == nullptr) {
+                    if (!(p = skipSeparator(p, end)) || !(p = parseNumber(p, end, w)) || !(next = skipLineEnd(p, end))) {
+                        return nullptr;
+                    }
+                    weighted = true;
+                }
+                sources.push_back(Index(u));
+                targets.push_back(Index(v));
+                weights.push_back(Weight(w));
+                vertices = std::max(vertices, std::max(u, v) + 1);
+                return next;
+            }
+        };
+
+        /*
+         * Parses the lines [first, last) into rows.
+         * @return Returns 0, or the number of the first bad line within the chunk.
+         */
+        template<class Rows>
+        std::size_t parseLines(const char *first, const char *last, bool header, Rows &rows, std::size_t &lines) {
+            const char *p = first;
+            while (p < last) {
+                ++lines;
+                while (p < last && isBlank(*p)) ++p;
+                if (p == last) break;
+                if (*p == '\n' || *p == '#') {
+                    const void *eol = std::memchr(p, '\n', std::size_t(last - p));
+                    p = eol ? static_cast<const char *>(eol) + 1 : last;
+                    continue;
+                }
+                const char *next = rows.parse(p, last);
+                if (next == nullptr) {
+                    if (!header || isDigit(*p) || *p == '-' || *p == '+' || *p == '.') return lines;
+                    const void *eol = std::memchr(p, '\n', std::size_t(last - p));
+                    next = eol ? static_cast<const char *>(eol) + 1 : last;
+                }
+                header = false;
+                p = next;
+            }
+            return 0;
+        }
+
+        /*
+         * Splits [first, last) into up to one chunk per thread at line breaks and parses every chunk
+         * into its own rows. Throws TextParseException for the first bad line.
+         */
+        template<class Rows>
+        std::vector<Rows> parseChunks(const char *first, const char *last, unsigned threads) {
+            const std::size_t bytes = std::size_t(last - first);
+            const unsigned chunks = chunkCount(bytes, threads, PARALLEL_PARSE_GRAIN);
+            std::vector<const char *> bounds(chunks + 1, last);
+            bounds[0] = first;
+            for (unsigned c = 1; c < chunks; ++c) {
+                const char *p = std::max(bounds[c - 1], first + bytes / chunks * c - 1);
+                const void *eol = p < last ? std::memchr(p, '\n', std::size_t(last - p)) : nullptr;
+                bounds[c] = eol ? static_cast<const char *>(eol) + 1 : last;
+            }
+            std::vector<Rows> rows(chunks);
+            std::vector<std::size_t> lines(chunks, 0), errors(chunks, 0);
+            forEachChunk(chunks, chunks, [&](unsigned, std::size_t c, std::size_t) {
+                errors[c] = parseLines(bounds[c], bounds[c + 1], c == 0, rows[c], lines[c]);
+            });
+            std::size_t before = 0;
+            for (unsigned c = 0; c < chunks; ++c) {
+                if (errors[c] != 0) throw TextParseException(before + errors[c]);
+                before += lines[c];
+            }
+            return rows;
+        }
+
+        /*
+         * Copies the arrays of every chunk behind those of the chunks before it, one thread per chunk
+         */
+        template<class Array, class Rows, class Get>
+        void concatenate(Array &out, const std::vector<Rows> &rows, Get get) {
+            std::vector<std::size_t> offsets(rows.size() + 1, 0);
+            for (std::size_t c = 0; c < rows.size(); ++c) offsets[c + 1] = offsets[c] + get(rows[c]).size();
+            out.resize(offsets.back());
+            forEachChunk(rows.size(), unsigned(rows.size()), [&](unsigned, std::size_t c, std::size_t) {
+                std::copy(get(rows[c]).begin(), get(rows[c]).end(), out.begin() + offsets[c]);
+            });
+        }
+
+    }; // namespace detail
+
+    /**
+     * Parses a point list from text in memory, see the top of this file.
+     * Throws TextParseException for a line that is not a point.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class T = double>
+    PointBuffer<T> parsePoints(const char *first, const char *last, unsigned threads = 1) {
+        const std::vector<detail::PointRows<T> > rows = detail::parseChunks<detail::PointRows<T> >(first, last, threads);
+        if (rows.size() == 1) return rows[0].points;
+        std::size_t n = 0;
+        for (std::size_t c = 0; c < rows.size(); ++c) n += rows[c].points.size();
+        PointBuffer<T> points;
+        points.resize(n);
+        std::vector<std::size_t> offsets(rows.size(), 0);
+        for (std::size_t c = 1; c < rows.size(); ++c) offsets[c] = offsets[c - 1] + rows[c - 1].points.size();
+        detail::forEachChunk(rows.size(), unsigned(rows.size()), [&](unsigned, std::size_t c, std::size_t) {
+            const PointBuffer<T> &chunk = rows[c].points;
+            std::copy(chunk.xs(), chunk.xs() + chunk.size(), points.xs() + offsets[c]);
+            std::copy(chunk.ys(), chunk.ys() + chunk.size(), points.ys() + offsets[c]);
+        });
+        return points;
+    }
+
+    /**
+     * Parses a point list file, see the top of this file.
+     * Throws BinaryFileIOException if the file cannot be mapped and TextParseException for a line
+     * that is not a point.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class T = double>
+    PointBuffer<T> readPoints(const std::string &path, unsigned threads = 1) {
+        const MappedFile file(path);
+        const char *text = reinterpret_cast<const char *>(file.data());
+        return parsePoints<T>(text, text + file.size(), threads);
+    }
+
+    /**
+     * Parses an edge list from text in memory, see the top of this file. The graph has the
+     * vertices [0, largest id], and weights if any edge has one; the others get weight 1.
+     * Throws TextParseException for a line that is not an edge, or has an id that does not fit Index.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class Index = std::uint32_t, class Weight = double, class Coord = double>
+    GraphBuilder<Index, Weight, Coord> parseEdges(const char *first, const char *last, unsigned threads = 1) {
+        typedef detail::EdgeRows<Index, Weight> Rows;
+        const std::vector<Rows> rows = detail::parseChunks<Rows>(first, last, threads);
+        typename Rows::index_array sources, targets;
+        typename Rows::weight_array weights;
+        std::uint64_t vertices = 0;
+        bool weighted = false;
+        for (std::size_t c = 0; c < rows.size(); ++c) {
+            vertices = std::max(vertices, rows[c].vertices);
+            weighted = weighted || rows[c].weighted;
+        }
+        detail::concatenate(sources, rows, [](const Rows &r) -> const typename Rows::index_array & { return r.sources; });
+        detail::concatenate(targets, rows, [](const Rows &r) -> const typename Rows::index_array & { return r.targets; });
+        if (weighted) {
+            detail::concatenate(weights, rows, [](const Rows &r) -> const typename Rows::weight_array & { return r.weights; });
+        }
+        return GraphBuilder<Index, Weight, Coord>(Index(vertices), std::move(sources), std::move(targets), std::move(weights));
+    }
+
+    /**
+     * Parses an edge list file, see parseEdges.
+     * Throws BinaryFileIOException if the file cannot be mapped and TextParseException for a line
+     * that is not an edge.
+     * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+     */
+    template<class Index = std::uint32_t, class Weight = double, class Coord = double>
+    GraphBuilder<Index, Weight, Coord> readEdges(const std::string &path, unsigned threads = 1) {
+        const MappedFile file(path);
+        const char *text = reinterpret_cast<const char *>(file.data());
+        return parseEdges<Index, Weight, Coord>(text, text + file.size(), threads);
+    }
+
+};// namespace graph_algo
+
+
+#endif /* TEXTPARSER_H_ */
@@ -0,0 +1,158 @@
+#ifndef TOLERANCE_H_
+#define TOLERANCE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <ratio>
+#include <type_traits>
+
+/**
+ * Comparison policies for Point and PackedPoint.
+ * Instead of every point carrying its own epsilon, the tolerance is a
+ * template argument of the point type, so it costs no memory per point.
+ *
+ * - EpsilonTolerance compares with a fixed epsilon given as a std::ratio,
+ *   the default is DEFAULT_EPSILON.
+ * - ExactTolerance compares coordinates and squared lengths exactly, which
+ *   is what integer coordinates want. The squared lengths are summed in a
+ *   wider unsigned type, exact for any 32 bit coordinates and, where the
+ *   compiler has a 128 bit integer, any 64 bit ones. Otherwise 64 bit
+ *   coordinates must keep |x|, |y| < 2^31.
+ * - StoredTolerance is the epsilon each Point stores itself, set when it is
+ *   constructed or with setEpsilon. It is the default of Point<double>.
+ *
+ * Two coordinates are equal when they differ by less than epsilon, and
+ * |a| < |b| only when |b| - |a| is more than epsilon.
+ *
+ * A policy provides:
+ *   static bool equal(const P &a, const P &b)
+ *   static bool lessLength(const P &a, const P &b)  (|a| < |b|)
+ */
+
+namespace graph_algo {
+
+    static const double DEFAULT_EPSILON = 0.00000000001;
+
+    namespace detail {
+
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 WidestUnsigned;
+#else
+        typedef unsigned long long WidestUnsigned;
+#endif
+
+        /*
+         * x * x + y * y without overflow: integers are squared as magnitudes in an unsigned type
+         * twice their width, which holds the sum of two squares of the most negative value too
+         */
+        template<class T, bool = std::is_integral<T>::value>
+        struct SquaredLength {
+            typedef T type;
+
+            static type of(T x, T y) { return x * x + y * y; }
+        };
+
+        template<class T>
+        struct SquaredLength<T, true> {
+            typedef typename std::conditional<(sizeof(T) * 2 <= sizeof(unsigned long long)),
+                    unsigned long long, WidestUnsigned>::type type;
+
+            static type magnitude(T v) { return v < 0 ? type(0) - type(v) : type(v); }
+
+            static type of(T x, T y) {
+                const type a = magnitude(x), b = magnitude(y);
+                return a * a + b * b;
+            }
+        };
+
+    }; // namespace detail
+
+    typedef std::ratio<1, 100000000000> DefaultEpsilonRatio;
+
+    template<class T = double, class Epsilon = DefaultEpsilonRatio>
+    struct EpsilonTolerance {
+
+        static double epsilon() {
+            return double(Epsilon::num) / double(Epsilon::den);
+        }
+
+        template<class P>
+        static bool equal(const P &a, const P &b) {
+            return std::fabs(a.getX() - b.getX()) < epsilon() && std::fabs(a.getY() - b.getY()) < epsilon();
+        }
+
+        template<class P>
+        static bool lessLength(const P &a, const P &b) {
+            const double l = a.length(), r = b.length();
+            return l < r && (r - l) > epsilon();
+        }
+    };
+
+    template<class T = long long>
+    struct ExactTolerance {
+
+        static double epsilon() {
+            return 0.0;
+        }
+
+        template<class P>
+        static bool equal(const P &a, const P &b) {
+            return a.getX() == b.getX() && a.getY() == b.getY();
+        }
+
+        template<class P>
+        static bool lessLength(const P &a, const P &b) {
+            return squared(a) < squared(b);
+        }
+
+    private:
+        typedef detail::SquaredLength<T> Squared;
+
+        template<class P>
+        static typename Squared::type squared(const P &p) {
+            return Squared::of(p.getX(), p.getY());
+        }
+    };
+
+    /**
+     * The epsilon a point stores itself. As with a per point epsilon before the
+     * policies, equality uses the epsilon of the left point and the length
+     * comparison the larger of the two.
+     */
+    struct StoredTolerance {
+
+        template<class P>
+        static bool equal(const P &a, const P &b) {
+            return std::fabs(a.getX() - b.getX()) < a.getEpsilon() && std::fabs(a.getY() - b.getY()) < a.getEpsilon();
+        }
+
+        template<class P>
+        static bool lessLength(const P &a, const P &b) {
+            const double l = a.length(), r = b.length();
+            return l < r && (r - l) > std::max(a.getEpsilon(), b.getEpsilon());
+        }
+    };
+
+    /**
+     * Integral coordinates compare exactly, everything else with DEFAULT_EPSILON.
+     */
+    template<class T>
+    struct DefaultTolerance {
+        typedef typename std::conditional<std::is_integral<T>::value,
+                ExactTolerance<T>, EpsilonTolerance<T> >::type type;
+    };
+
+    /**
+     * The default of Point: integral coordinates compare exactly, everything else with the
+     * epsilon of the point, DEFAULT_EPSILON unless given
+     */
+    template<class T>
+    struct DefaultPointTolerance {
+        typedef typename std::conditional<std::is_integral<T>::value,
+                ExactTolerance<T>, StoredTolerance>::type type;
+    };
+
+};// namespace graph_algo
+
+
+#endif /* TOLERANCE_H_ */
@@ -0,0 +1,163 @@
+#ifndef VORONOI_H_
+#define VORONOI_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Delaunay.h"
+#include "Graph.h"
+#include "PackedPoint.h"
+#include "PointBuffer.h"
+#include "Polygon.h"
+
+/**
+ * The Voronoi diagram of a set of points, derived from their Delaunay triangulation.
+ * The Voronoi vertices are the circumcenters of the Delaunay triangles, vertex t belongs to
+ * triangle t. The cell of a point is the ring of the triangles around it, in CSR order:
+ * cell(i) lists the vertex ids of cell i counterclockwise.
+ *
+ * The cells of hull points are unbounded. Their vertex list starts and ends at the vertices
+ * of the two hull edges of the point, where the cell continues as a ray along the outward
+ * normal of the edge. clippedCell gives any cell, bounded or not, cut to a box.
+ * Duplicate points have empty cells.
+ */
+
+namespace graph_algo {
+
+    class VoronoiDiagram {
+    public:
+        typedef PackedPoint<double> point_type;
+
+        /**
+         * Constructor, computes the vertices and cells of the triangulation's dual.
+         * @param triangulation The Delaunay triangulation, must outlive the diagram.
+         * @param threads The number of threads, 0 uses std::thread::hardware_concurrency().
+         */
+        explicit VoronoiDiagram(const DelaunayTriangulation &triangulation, unsigned threads = 1)
+                : mTriangulation(&triangulation) {
+            const std::vector<std::uint32_t> &triangles = triangulation.triangles();
+            const std::vector<std::uint32_t> &halfedges = triangulation.halfedges();
+            const std::size_t n = triangulation.pointCount(), m = triangulation.triangleCount();
+            const double *xs = triangulation.points().xs(), *ys = triangulation.points().ys();
+
+            mVertices.resize(m);
+            double *vx = mVertices.xs(), *vy = mVertices.ys();
+            const unsigned chunks = detail::chunkCount(m, threads, PARALLEL_DELAUNAY_GRAIN);
+            detail::forEachChunk(m, chunks, [&](unsigned, std::size_t first, std::size_t last) {
+                for (std::size_t t = first; t < last; ++t) {
+                    const std::uint32_t a = triangles[3 * t], b = triangles[3 * t + 1], c = triangles[3 * t + 2];
+                    const double dx = xs[b] - xs[a], dy = ys[b] - ys[a];
+                    const double ex = xs[c] - xs[a], ey = ys[c] - ys[a];
+                    const double bl = dx * dx + dy * dy, cl = ex * ex + ey * ey;
+                    const double d = 0.5 / (dx * ey - dy * ex);
+                    vx[t] = xs[a] + (ey * bl - dy * cl) * d;
+                    vy[t] = ys[a] + (dx * cl - ex * bl) * d;
+                }
+            });
+
+            // Every triangle corner is one vertex of the cell of its point
+            mOffsets.assign(n + 1, 0);
+            for (std::size_t e = 0; e < triangles.size(); ++e) ++mOffsets[triangles[e] + 1];
+            for (std::size_t i = 0; i < n; ++i) mOffsets[i + 1] += mOffsets[i];
+            mCells.resize(triangles.size());
+            const unsigned cellChunks = detail::chunkCount(n, threads, PARALLEL_DELAUNAY_GRAIN);
+            detail::forEachChunk(n, cellChunks, [&](unsigned, std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) {
+                    if (mOffsets[i] == mOffsets[i + 1]) continue;
+                    const std::uint32_t start = triangulation.outgoing(std::uint32_t(i));
+                    std::uint32_t e = start, k = mOffsets[i];
+                    do {
+                        mCells[k++] = e / 3;
+                        e = halfedges[DelaunayTriangulation::prevHalfedge(e)];
+                    } while (e != DELAUNAY_NONE && e != start);
+                }
+            });
+        }
+
+        std::size_t cellCount() const { return mOffsets.size() - 1; }
+
+        std::size_t vertexCount() const { return mVertices.size(); }
+
+        /**
+         * The Voronoi vertices, the circumcenter of every Delaunay triangle
+         */
+        const PointBuffer<double> &vertices() const { return mVertices; }
+
+        point_type vertex(std::uint32_t t) const { return mVertices[t]; }
+
+        /**
+         * The vertex ids of the cell of point i, counterclockwise
+         */
+        ArrayRange<std::uint32_t> cell(std::uint32_t i) const {
+            return ArrayRange<std::uint32_t>(mCells.data() + mOffsets[i], mCells.data() + mOffsets[i + 1]);
+        }
+
+        /**
+         * Whether the cell of point i is a closed polygon, false for hull points and duplicates
+         */
+        bool isBounded(std::uint32_t i) const {
+            const std::uint32_t e = mTriangulation->outgoing(i);
+            return mOffsets[i] != mOffsets[i + 1] && mTriangulation->halfedges()[e] != DELAUNAY_NONE;
+        }
+
+        /**
+         * The cell of point i as a polygon, for bounded cells only
+         */
+        Polygon<double> cellPolygon(std::uint32_t i) const {
+            Polygon<double> polygon;
+            const ArrayRange<std::uint32_t> ids = cell(i);
+            polygon.reserve(ids.size());
+            for (std::size_t k = 0; k < ids.size(); ++k) polygon.push_back(mVertices[ids[k]]);
+            return polygon;
+        }
+
+        /**
+         * The cell of point i cut to the box [minX, maxX] x [minY, maxY], counterclockwise.
+         * The box is clipped by the bisector of i and each of its Delaunay neighbours, which works
+         * the same for bounded and unbounded cells and for collinear points. Empty for duplicates
+         * and for cells outside the box.
+         */
+        Polygon<double> clippedCell(std::uint32_t i, double minX, double minY, double maxX, double maxY) const {
+            std::vector<point_type> ring;
+            if (mTriangulation->outgoing(i) == DELAUNAY_NONE) return Polygon<double>(ring);
+            const std::vector<std::uint32_t> neighbors = mTriangulation->neighbors(i);
+            ring.push_back(point_type(minX, minY));
+            ring.push_back(point_type(maxX, minY));
+            ring.push_back(point_type(maxX, maxY));
+            ring.push_back(point_type(minX, maxY));
+
+            const point_type p = mTriangulation->point(i);
+            std::vector<point_type> clipped;
+            for (std::size_t k = 0; k < neighbors.size() && !ring.empty(); ++k) {
+                // Keep the side of the bisector towards p: (x - mid) . (q - p) <= 0
+                const point_type q = mTriangulation->point(neighbors[k]);
+                const double nx = q.getX() - p.getX(), ny = q.getY() - p.getY();
+                const double c = nx * (p.getX() + q.getX()) / 2.0 + ny * (p.getY() + q.getY()) / 2.0;
+                clipped.clear();
+                for (std::size_t j = 0; j < ring.size(); ++j) {
+                    const point_type &a = ring[j], &b = ring[(j + 1) % ring.size()];
+                    const double da = nx * a.getX() + ny * a.getY() - c, db = nx * b.getX() + ny * b.getY() - c;
+                    if (da <= 0.0) clipped.push_back(a);
+                    if ((da < 0.0 && db > 0.0) || (da > 0.0 && db < 0.0)) {
+                        const double s = da / (da - db);
+                        clipped.push_back(point_type(a.getX() + s * (b.getX() - a.getX()),
+                                                     a.getY() + s * (b.getY() - a.getY())));
+                    }
+                }
+                ring.swap(clipped);
+            }
+            return Polygon<double>(ring);
+        }
+
+    private:
+        const DelaunayTriangulation *mTriangulation;
+        PointBuffer<double> mVertices;
+        std::vector<std::uint32_t> mOffsets;
+        std::vector<std::uint32_t> mCells;
+
+    }; // VoronoiDiagram class
+
+};// namespace graph_algo
+
+
+#endif /* VORONOI_H_ */
@@ -0,0 +1,197 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/BinaryFile.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::randomPoints;
+
+static std::string tempPath(const std::string &name) {
+    return testing::TempDir() + "graph_algo_" + name;
+}
+
+static std::vector<char> readBytes(const std::string &path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+static void writeBytes(const std::string &path, const std::vector<char> &bytes) {
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), std::streamsize(bytes.size()));
+}
+
+TEST(BinaryFile, points) {
+    const std::string path = tempPath("points.bin");
+    const PointBuffer<double> points = randomPoints(2500, 1);
+    writePoints(path, points, 1000);
+    {
+        const MappedPoints<double> mapped(path);
+        ASSERT_EQ(points.size(), mapped.size());
+        // The arrays are used in place, at the alignment of PointBuffer
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(mapped.xs()) % BINARY_FILE_ALIGNMENT);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(mapped.ys()) % BINARY_FILE_ALIGNMENT);
+        for (std::size_t i = 0; i < points.size(); ++i) EXPECT_EQ(points[i], mapped[i]);
+        const PointBuffer<double> copy = mapped.buffer();
+        EXPECT_EQ(points[2499], copy[2499]);
+
+        ASSERT_EQ(1000u, mapped.chunkSize());
+        ASSERT_EQ(3u, mapped.chunkCount());
+        const BinaryChunk last = mapped.chunk(2);
+        EXPECT_EQ(2000u, last.first);
+        EXPECT_EQ(2500u, last.last);
+        for (std::size_t c = 0; c < mapped.chunkCount(); ++c) {
+            const BinaryChunk chunk = mapped.chunk(c);
+            for (std::size_t i = chunk.first; i < chunk.last; ++i) {
+                EXPECT_LE(chunk.minX, mapped.xs()[i]);
+                EXPECT_GE(chunk.maxX, mapped.xs()[i]);
+                EXPECT_LE(chunk.minY, mapped.ys()[i]);
+                EXPECT_GE(chunk.maxY, mapped.ys()[i]);
+            }
+        }
+        EXPECT_TRUE(validateBinaryFile(path).empty());
+    }
+
+    // Other coordinate types and kinds of data
+    EXPECT_THROW(MappedPoints<float> floats(path), BinaryFileTypeException);
+    EXPECT_THROW(MappedPolygons<double> polygons(path), BinaryFileTypeException);
+
+    PointBuffer<float> small;
+    small.push_back(1.5f, -2.0f);
+    writePoints(path, small);
+    const MappedPoints<float> mapped(path);
+    ASSERT_EQ(1u, mapped.size());
+    EXPECT_EQ(PackedPoint<float>(1.5f, -2.0f), mapped[0]);
+    EXPECT_EQ(0u, mapped.chunkCount());
+
+    writePoints(path, PointBuffer<double>());
+    EXPECT_TRUE(MappedPoints<double>(path).empty());
+    std::remove(path.c_str());
+}
+
+TEST(BinaryFile, polygons) {
+    const std::string path = tempPath("polygons.bin");
+    std::vector<Polygon<double> > polygons(3);
+    polygons[0].push_back(0.0, 0.0);
+    polygons[0].push_back(4.0, 0.0);
+    polygons[0].push_back(4.0, 3.0);
+    polygons[2].push_back(-1.0, -1.0);
+    polygons[2].push_back(1.0, -1.0);
+    polygons[2].push_back(1.0, 1.0);
+    polygons[2].push_back(-1.0, 1.0);
+    writePolygons(path, polygons);
+
+    const MappedPolygons<double> mapped(path);
+    ASSERT_EQ(3u, mapped.size());
+    EXPECT_EQ(7u, mapped.vertexCount());
+    EXPECT_EQ(0u, mapped.size(1));
+    EXPECT_EQ(3u, mapped.first(2));
+    EXPECT_EQ(PackedPoint<double>(4.0, 3.0), mapped.vertex(2));
+    EXPECT_DOUBLE_EQ(6.0, mapped.polygon(0).area());
+    EXPECT_DOUBLE_EQ(4.0, mapped.polygon(2).area());
+    EXPECT_TRUE(mapped.polygon(1).empty());
+    EXPECT_TRUE(validateBinaryFile(path).empty());
+    std::remove(path.c_str());
+}
+
+TEST(BinaryFile, graph) {
+    const std::string path = tempPath("graph.bin");
+    GraphBuilder<std::uint32_t, double, double> builder(5);
+    builder.addEdge(0, 1, 2.5);
+    builder.addEdge(0, 3, 1.0);
+    builder.addEdge(3, 4, 7.0);
+    builder.addEdge(4, 0, 0.5);
+    builder.setCoordinates(randomPoints(5, 2));
+    const CsrGraph<std::uint32_t, double, double> graph = builder.build(1, true);
+    writeGraph(path, graph);
+
+    const MappedGraph<std::uint32_t, double, double> mapped(path);
+    EXPECT_EQ(5u, mapped.vertexCount());
+    EXPECT_EQ(4u, mapped.edgeCount());
+    EXPECT_TRUE(mapped.hasWeights());
+    EXPECT_TRUE(mapped.hasCoordinates());
+    EXPECT_TRUE(mapped.hasInEdges());
+    EXPECT_EQ(2u, mapped.degree(0));
+    EXPECT_EQ(3u, mapped.neighbors(0)[1]);
+    EXPECT_EQ(7.0, mapped.weight(2));
+    EXPECT_EQ(graph.coordinate(4), mapped.coordinate(4));
+
+    const CsrGraph<std::uint32_t, double, double> copy = mapped.graph();
+    EXPECT_EQ(graph.offsets(), copy.offsets());
+    EXPECT_EQ(graph.targets(), copy.targets());
+    EXPECT_EQ(graph.weights(), copy.weights());
+    EXPECT_EQ(graph.inOffsets(), copy.inOffsets());
+    EXPECT_EQ(graph.inSources(), copy.inSources());
+    EXPECT_EQ(graph.inEdges(), copy.inEdges());
+    EXPECT_EQ(graph.coordinate(2), copy.coordinate(2));
+    EXPECT_TRUE(validateBinaryFile(path).empty());
+
+    // The index and weight types are part of the file
+    EXPECT_THROW((MappedGraph<std::uint64_t, double, double>(path)), BinaryFileTypeException);
+    EXPECT_THROW((MappedGraph<std::uint32_t, float, double>(path)), BinaryFileTypeException);
+
+    // Without weights, coordinates and in-edges
+    GraphBuilder<std::uint64_t, double, double> plain(3);
+    plain.addEdge(2, 0);
+    writeGraph(path, plain.build());
+    const MappedGraph<std::uint64_t, double, double> unweighted(path);
+    EXPECT_FALSE(unweighted.hasCoordinates());
+    EXPECT_FALSE(unweighted.hasInEdges());
+    EXPECT_EQ(1.0, unweighted.weight(0));
+    EXPECT_EQ(1u, unweighted.graph().edgeCount());
+    std::remove(path.c_str());
+}
+
+TEST(BinaryFile, damagedFiles) {
+    const std::string path = tempPath("damaged.bin");
+    EXPECT_THROW(BinaryFile missing(tempPath("missing.bin")), BinaryFileIOException);
+    EXPECT_FALSE(validateBinaryFile(tempPath("missing.bin")).empty());
+
+    GraphBuilder<std::uint32_t, double, double> builder(4);
+    builder.addEdge(0, 1, 1.0);
+    builder.addEdge(1, 2, 1.0);
+    builder.addEdge(2, 3, 1.0);
+    writeGraph(path, builder.build());
+    const std::vector<char> bytes = readBytes(path);
+    const BinarySectionHeader targets = *BinaryFile(path).section(SECTION_TARGETS);
+
+    // A target that is not a vertex, with and without a matching checksum
+    std::vector<char> damaged = bytes;
+    const std::uint32_t outside = 9;
+    std::memcpy(&damaged[std::size_t(targets.offset)], &outside, sizeof(outside));
+    writeBytes(path, damaged);
+    EXPECT_EQ(2u, validateBinaryFile(path).size());
+    for (std::size_t s = 0; s < BinaryFile(path).sections().size(); ++s) {
+        const std::size_t entry = sizeof(BinaryFileHeader) + s * sizeof(BinarySectionHeader);
+        BinarySectionHeader section;
+        std::memcpy(&section, &damaged[entry], sizeof(section));
+        if (section.tag != SECTION_TARGETS) continue;
+        section.checksum = detail::checksum(&damaged[std::size_t(section.offset)], std::size_t(4 * section.count));
+        std::memcpy(&damaged[entry], &section, sizeof(section));
+    }
+    writeBytes(path, damaged);
+    const std::vector<std::string> problems = validateBinaryFile(path);
+    ASSERT_EQ(1u, problems.size());
+    EXPECT_NE(std::string::npos, problems[0].find("targets"));
+
+    // A truncated file, another version and another magic
+    writeBytes(path, std::vector<char>(bytes.begin(), bytes.end() - 64));
+    EXPECT_THROW(BinaryFile truncated(path), BinaryFileFormatException);
+    damaged = bytes;
+    damaged[8] = 2;
+    writeBytes(path, damaged);
+    EXPECT_THROW(BinaryFile version(path), BinaryFileFormatException);
+    damaged = bytes;
+    damaged[0] = 'X';
+    writeBytes(path, damaged);
+    EXPECT_THROW(BinaryFile magic(path), BinaryFileFormatException);
+    EXPECT_EQ(1u, validateBinaryFile(path).size());
+    writeBytes(path, std::vector<char>());
+    EXPECT_THROW(BinaryFile empty(path), BinaryFileFormatException);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/Comparators.h"
+#include "../main/PackedPoint.h"
+#include "../main/Point.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<Point<T> > makePoints() {
+    std::vector<Point<T> > points;
+    for (int i = 0; i < 200; ++i) {
+        points.push_back(Point<T>(T(i * 37 % 101) - 50.0, T(i * 53 % 89) - 44.0));
+    }
+    return points;
+}
+
+TEST(ComparatorsTest, lessAndGreaterLength) {
+    const Point<T> p1(1.0, 1.0), p2(3.0, 4.0);
+    ASSERT_TRUE(LessLength()(p1, p2));
+    ASSERT_FALSE(LessLength()(p2, p1));
+    ASSERT_FALSE(LessLength()(p1, p1));
+    ASSERT_TRUE(GreaterLength()(p2, p1));
+    ASSERT_FALSE(GreaterLength()(p1, p1));
+    ASSERT_TRUE(LessLength()(PackedPoint<int>(0, 2), PackedPoint<int>(-3, 0)));
+}
+
+TEST(ComparatorsTest, sortMatchesPointOrdering) {
+    std::vector<Point<T> > points = makePoints();
+    std::sort(points.begin(), points.end(), LessLength());
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        ASSERT_LE(points[i - 1].length(), points[i].length());
+        ASSERT_FALSE(points[i] < points[i - 1]);
+    }
+    std::sort(points.begin(), points.end(), GreaterLength());
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        ASSERT_GE(points[i - 1].length(), points[i].length());
+    }
+}
+
+TEST(ComparatorsTest, distanceTo) {
+    const Point<T> center(10.0, -5.0);
+    std::vector<Point<T> > points = makePoints();
+    std::sort(points.begin(), points.end(), lessDistanceTo(center));
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        ASSERT_LE(points[i - 1] | center, points[i] | center);
+    }
+    std::sort(points.begin(), points.end(), greaterDistanceTo(center));
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        ASSERT_GE(points[i - 1] | center, points[i] | center);
+    }
+}
+
+TEST(ComparatorsTest, sortByLength) {
+    std::vector<Point<T> > points = makePoints();
+    std::vector<Point<T> > expected = points;
+    std::stable_sort(expected.begin(), expected.end(), LessLength());
+    sortByLength(points);
+    ASSERT_EQ(expected.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        ASSERT_EQ(expected[i].getX(), points[i].getX());
+        ASSERT_EQ(expected[i].getY(), points[i].getY());
+    }
+
+    std::vector<Point<T> > empty;
+    sortByLength(empty);
+    ASSERT_TRUE(empty.empty());
+}
+
+TEST(ComparatorsTest, sortByDistanceTo) {
+    const PackedPoint<T> center(-20.0, 7.5);
+    std::vector<PackedPoint<T> > points;
+    for (const Point<T> &p : makePoints()) {
+        points.push_back(PackedPoint<T>(p));
+    }
+    std::vector<PackedPoint<T> > expected = points;
+    std::stable_sort(expected.begin(), expected.end(), lessDistanceTo(center));
+    sortByDistanceTo(points, center);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        ASSERT_EQ(expected[i].getX(), points[i].getX());
+        ASSERT_EQ(expected[i].getY(), points[i].getY());
+    }
+}
+
+TEST(ComparatorsTest, sortByKey) {
+    std::vector<PackedPoint<int> > points;
+    points.push_back(PackedPoint<int>(3, 1));
+    points.push_back(PackedPoint<int>(-1, 2));
+    points.push_back(PackedPoint<int>(0, 0));
+    sortByKey(points, [](const PackedPoint<int> &p) { return p.getX(); });
+    ASSERT_EQ(-1, points[0].getX());
+    ASSERT_EQ(0, points[1].getX());
+    ASSERT_EQ(3, points[2].getX());
+}
@@ -0,0 +1,127 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/ConvexHull.h"
+#include "../main/PackedPoint.h"
+#include "../main/Point.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<PackedPoint<T> > randomPoints(std::size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dist(-100.0, 100.0);
+    std::vector<PackedPoint<T> > points;
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(PackedPoint<T>(dist(gen), dist(gen)));
+    }
+    return points;
+}
+
+template<class P>
+static void expectSameHull(const Hull<P> &expected, const Hull<P> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected.vertices()[i].getX(), actual.vertices()[i].getX()) << i;
+        ASSERT_EQ(expected.vertices()[i].getY(), actual.vertices()[i].getY()) << i;
+    }
+}
+
+template<class P>
+static void expectConvexAndEnclosing(const Hull<P> &hull, const std::vector<P> &points) {
+    for (int i = 0; i < hull.size(); ++i) {
+        typename Hull<P>::index_type a = hull.index(i), b = a, c = a;
+        ++b;
+        ++c;
+        ++c;
+        ASSERT_GT(orient2d(hull[a], hull[b], hull[c]), 0.0);
+        for (const P &p : points) {
+            ASSERT_GE(orient2d(hull[a], hull[b], p), 0.0);
+        }
+    }
+}
+
+TEST(ConvexHullTest, square) {
+    std::vector<Point<T> > points;
+    points.push_back(Point<T>(1.0, 1.0));
+    points.push_back(Point<T>(0.0, 0.0));
+    points.push_back(Point<T>(0.5, 0.5));
+    points.push_back(Point<T>(0.0, 1.0));
+    points.push_back(Point<T>(1.0, 0.0));
+    points.push_back(Point<T>(0.5, 0.0));
+    points.push_back(Point<T>(1.0, 1.0));
+
+    const Hull<Point<T> > hull = monotoneChainHull(points);
+    ASSERT_EQ(4, hull.size());
+    ASSERT_EQ(0.0, hull[hull.index(0)].getX());
+    ASSERT_EQ(0.0, hull[hull.index(0)].getY());
+    ASSERT_EQ(1.0, hull[hull.index(1)].getX());
+    ASSERT_EQ(0.0, hull[hull.index(1)].getY());
+    ASSERT_EQ(1.0, hull[hull.index(2)].getY());
+    ASSERT_EQ(0.0, hull[hull.index(3)].getX());
+
+    Hull<Point<T> >::index_type last = hull.index(3);
+    ++last;
+    ASSERT_EQ(0, last);
+    expectSameHull(hull, chanHull(points));
+}
+
+TEST(ConvexHullTest, degenerate) {
+    std::vector<PackedPoint<T> > none;
+    ASSERT_TRUE(monotoneChainHull(none).empty());
+    ASSERT_TRUE(chanHull(none).empty());
+
+    std::vector<PackedPoint<T> > same(5, PackedPoint<T>(2.0, 3.0));
+    ASSERT_EQ(1, monotoneChainHull(same).size());
+    expectSameHull(monotoneChainHull(same), chanHull(same));
+
+    std::vector<PackedPoint<T> > line;
+    for (int i = 0; i < 50; ++i) {
+        line.push_back(PackedPoint<T>(T(i * 7 % 50), T(i * 7 % 50) * 0.5));
+    }
+    const Hull<PackedPoint<T> > segment = monotoneChainHull(line);
+    ASSERT_EQ(2, segment.size());
+    expectSameHull(segment, chanHull(line));
+
+    // A grid has many collinear points on every hull edge
+    std::vector<PackedPoint<T> > grid;
+    for (int i = 0; i < 40; ++i) {
+        for (int j = 0; j < 30; ++j) {
+            grid.push_back(PackedPoint<T>(T((i * 17) % 40), T((j * 11) % 30)));
+        }
+    }
+    ASSERT_EQ(4, monotoneChainHull(grid).size());
+    expectSameHull(monotoneChainHull(grid), chanHull(grid));
+}
+
+TEST(ConvexHullTest, randomPointsAllAlgorithmsAgree) {
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        const std::vector<PackedPoint<T> > points = randomPoints(seed * 97, seed);
+        const Hull<PackedPoint<T> > hull = monotoneChainHull(points);
+        expectConvexAndEnclosing(hull, points);
+        expectSameHull(hull, chanHull(points));
+        expectSameHull(hull, parallelHull(points, 4));
+    }
+}
+
+TEST(ConvexHullTest, circle) {
+    // Every point is on the hull, the worst case for Chan's algorithm
+    std::vector<PackedPoint<T> > points;
+    for (int i = 0; i < 1000; ++i) {
+        const double t = 2.0 * M_PI * double(i * 367 % 1000) / 1000.0;
+        points.push_back(PackedPoint<T>(std::cos(t), std::sin(t)));
+    }
+    const Hull<PackedPoint<T> > hull = monotoneChainHull(points);
+    ASSERT_EQ(1000, hull.size());
+    expectSameHull(hull, chanHull(points));
+}
+
+TEST(ConvexHullTest, parallel) {
+    const std::vector<PackedPoint<T> > points = randomPoints(4 * PARALLEL_HULL_GRAIN + 123, 7);
+    const Hull<PackedPoint<T> > hull = monotoneChainHull(points);
+    expectSameHull(hull, parallelHull(points, 4));
+    expectSameHull(hull, parallelHull(points));
+    expectSameHull(hull, chanHull(points));
+}
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/Delaunay.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::randomPoints;
+
+static PointBuffer<double> gridPoints(std::uint32_t w, std::uint32_t h) {
+    PointBuffer<double> points;
+    for (std::uint32_t y = 0; y < h; ++y) {
+        for (std::uint32_t x = 0; x < w; ++x) points.push_back(double(x), double(y));
+    }
+    return points;
+}
+
+/*
+ * Checks the mesh: counterclockwise triangles, consistent opposite half-edges, a closed
+ * counterclockwise hull, every edge Delaunay and 2n - 2 - h triangles for the n points in the mesh
+ */
+static void expectValid(const DelaunayTriangulation &triangulation) {
+    const std::vector<std::uint32_t> &triangles = triangulation.triangles();
+    const std::vector<std::uint32_t> &halfedges = triangulation.halfedges();
+    ASSERT_EQ(triangles.size(), halfedges.size());
+    for (std::uint32_t t = 0; t < triangles.size(); t += 3) {
+        ASSERT_GT(orient2d(triangulation.point(triangles[t]), triangulation.point(triangles[t + 1]),
+                           triangulation.point(triangles[t + 2])), 0.0);
+    }
+    std::size_t hullEdges = 0;
+    for (std::uint32_t e = 0; e < halfedges.size(); ++e) {
+        const std::uint32_t b = halfedges[e];
+        if (b == DELAUNAY_NONE) {
+            ++hullEdges;
+            continue;
+        }
+        ASSERT_EQ(e, halfedges[b]);
+        ASSERT_EQ(triangles[e], triangles[DelaunayTriangulation::nextHalfedge(b)]);
+        ASSERT_EQ(triangles[b], triangles[DelaunayTriangulation::nextHalfedge(e)]);
+    }
+    const std::vector<std::uint32_t> &hull = triangulation.hull();
+    EXPECT_EQ(hullEdges, hull.size());
+    for (std::size_t k = 0; k < hull.size(); ++k) {
+        EXPECT_GE(orient2d(triangulation.point(hull[k]), triangulation.point(hull[(k + 1) % hull.size()]),
+                           triangulation.point(hull[(k + 2) % hull.size()])), 0.0);
+    }
+    EXPECT_TRUE(triangulation.isDelaunay());
+    const std::size_t n = triangulation.pointCount() - triangulation.duplicates().size();
+    EXPECT_EQ(2 * n - 2 - hull.size(), triangulation.triangleCount());
+}
+
+static double totalWeight(const CsrGraph<std::uint32_t, double, double> &graph) {
+    double sum = 0.0;
+    for (std::uint32_t e = 0; e < graph.edgeCount(); ++e) sum += graph.weight(e);
+    return sum;
+}
+
+/*
+ * Prim's algorithm on the complete graph
+ */
+static double bruteForceMst(const PointBuffer<double> &points) {
+    const std::size_t n = points.size();
+    std::vector<double> best(n, INFINITY);
+    std::vector<bool> done(n, false);
+    double sum = 0.0;
+    best[0] = 0.0;
+    for (std::size_t step = 0; step < n; ++step) {
+        std::size_t u = n;
+        for (std::size_t v = 0; v < n; ++v) {
+            if (!done[v] && (u == n || best[v] < best[u])) u = v;
+        }
+        done[u] = true;
+        sum += best[u];
+        for (std::size_t v = 0; v < n; ++v) {
+            const double dx = points.xs()[u] - points.xs()[v], dy = points.ys()[u] - points.ys()[v];
+            best[v] = std::min(best[v], std::sqrt(dx * dx + dy * dy));
+        }
+    }
+    return sum;
+}
+
+TEST(Delaunay, smallInputs) {
+    PointBuffer<double> points;
+    DelaunayTriangulation empty(points);
+    EXPECT_EQ(0u, empty.triangleCount());
+    EXPECT_TRUE(empty.hull().empty());
+
+    points.push_back(1.0, 2.0);
+    DelaunayTriangulation one(points);
+    EXPECT_EQ(0u, one.triangleCount());
+    EXPECT_EQ(1u, one.hull().size());
+    EXPECT_TRUE(one.neighbors(0).empty());
+
+    points.push_back(3.0, 2.0);
+    DelaunayTriangulation two(points);
+    EXPECT_EQ(0u, two.triangleCount());
+    EXPECT_EQ(1u, two.delaunayGraph().degree(0));
+
+    points.push_back(2.0, 0.0);
+    DelaunayTriangulation three(points);
+    EXPECT_EQ(1u, three.triangleCount());
+    EXPECT_EQ(3u, three.hull().size());
+    expectValid(three);
+}
+
+TEST(Delaunay, randomPoints) {
+    const PointBuffer<double> points = randomPoints(5000, 1, -1000.0, 1000.0);
+    DelaunayTriangulation triangulation(points);
+    expectValid(triangulation);
+    EXPECT_TRUE(triangulation.duplicates().empty());
+    // Every point has an outgoing half-edge starting at it
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        ASSERT_NE(DELAUNAY_NONE, triangulation.outgoing(i));
+        ASSERT_EQ(i, triangulation.triangles()[triangulation.outgoing(i)]);
+    }
+}
+
+TEST(Delaunay, neighbors) {
+    const PointBuffer<double> points = randomPoints(500, 2, -1000.0, 1000.0);
+    DelaunayTriangulation triangulation(points);
+    const CsrGraph<std::uint32_t, double, double> graph = triangulation.delaunayGraph();
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        std::vector<std::uint32_t> neighbors = triangulation.neighbors(i);
+        ASSERT_EQ(graph.degree(i), neighbors.size());
+        for (std::size_t k = 0; k < neighbors.size(); ++k) EXPECT_TRUE(graph.hasEdge(i, neighbors[k]));
+    }
+}
+
+TEST(Delaunay, grid) {
+    // Every cell of the grid is cocircular, the exact incircle test must not flip back and forth
+    DelaunayTriangulation triangulation(gridPoints(40, 30));
+    expectValid(triangulation);
+    EXPECT_EQ(2u * 39 * 29, triangulation.triangleCount());
+}
+
+TEST(Delaunay, collinear) {
+    PointBuffer<double> points;
+    for (int i = 0; i < 10; ++i) points.push_back(double(9 - i) * 0.5, double(9 - i) * 1.5);
+    points.push_back(1.0, 3.0);
+    DelaunayTriangulation triangulation(points);
+    EXPECT_EQ(0u, triangulation.triangleCount());
+    ASSERT_EQ(10u, triangulation.hull().size());
+    EXPECT_EQ(9u, triangulation.hull().front());
+    EXPECT_EQ(0u, triangulation.hull().back());
+    EXPECT_EQ(1u, triangulation.duplicates().size());
+    const CsrGraph<std::uint32_t, double, double> tree = triangulation.minimumSpanningTree();
+    EXPECT_EQ(2u * 10, tree.edgeCount());
+    EXPECT_NEAR(2.0 * 9.0 * std::sqrt(2.5), totalWeight(tree), 1e-9);
+}
+
+TEST(Delaunay, nearlyCollinear) {
+    // Points within an ulp of a line: inserting inside the hull splits triangles next to hull vertices
+    PointBuffer<double> points;
+    points.push_back(0.953125, 0.4765625);
+    points.push_back(0.203125, 0.1015625);
+    points.push_back(0.03125, 0.015625000000000028);
+    points.push_back(-1.46875, -0.734375);
+    points.push_back(-0.203125, -0.10156250000000003);
+    points.push_back(-0.21875, -0.109375);
+    const DelaunayTriangulation triangulation(points, 1);
+    expectValid(triangulation);
+    EXPECT_EQ(4u, triangulation.hull().size());
+
+    // The same on many small sets around a few lines
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> step(-128, 127), coin(0, 3);
+    for (int round = 0; round < 500; ++round) {
+        PointBuffer<double> near;
+        for (int i = 0; i < 3 + round % 40; ++i) {
+            const double x = step(gen) / 64.0;
+            double y = round % 2 == 0 ? x / 2.0 : x * 0.3;
+            // Off the line by an ulp, but not into subnormals at the origin
+            if (y != 0.0 && coin(gen) == 0) y = std::nextafter(y, coin(gen) < 2 ? 1.0 : -1.0);
+            near.push_back(x, y);
+        }
+        const DelaunayTriangulation mesh(near, 1);
+        if (mesh.triangleCount() > 0) {
+            expectValid(mesh);
+        }
+    }
+}
+
+TEST(Delaunay, duplicates) {
+    PointBuffer<double> points = randomPoints(1000, 3, -1000.0, 1000.0);
+    for (std::uint32_t i = 0; i < 200; ++i) points.push_back(points[i * 5]);
+    points.push_back(points[1000]);
+    DelaunayTriangulation triangulation(points);
+    expectValid(triangulation);
+    EXPECT_EQ(201u, triangulation.duplicates().size());
+    for (std::size_t k = 0; k < triangulation.duplicates().size(); ++k) {
+        const std::uint32_t d = triangulation.duplicates()[k].first, p = triangulation.duplicates()[k].second;
+        EXPECT_EQ(points[d].getX(), points[p].getX());
+        EXPECT_EQ(points[d].getY(), points[p].getY());
+        EXPECT_EQ(DELAUNAY_NONE, triangulation.outgoing(d));
+    }
+    // Duplicates hang off their point with zero length edges
+    const CsrGraph<std::uint32_t, double, double> tree = triangulation.minimumSpanningTree();
+    EXPECT_EQ(2u * (points.size() - 1), tree.edgeCount());
+    const CsrGraph<std::uint32_t, double, double> nearest = triangulation.nearestNeighborGraph();
+    EXPECT_EQ(points.size(), nearest.edgeCount());
+}
+
+TEST(Delaunay, minimumSpanningTree) {
+    const PointBuffer<double> points = randomPoints(400, 4, -1000.0, 1000.0);
+    DelaunayTriangulation triangulation(points);
+    const CsrGraph<std::uint32_t, double, double> tree = triangulation.minimumSpanningTree();
+    EXPECT_EQ(2u * 399, tree.edgeCount());
+    EXPECT_TRUE(tree.hasCoordinates());
+    EXPECT_NEAR(bruteForceMst(points), totalWeight(tree) / 2.0, 1e-6);
+}
+
+TEST(Delaunay, nearestNeighborGraph) {
+    const PointBuffer<double> points = randomPoints(400, 5, -1000.0, 1000.0);
+    DelaunayTriangulation triangulation(points);
+    const CsrGraph<std::uint32_t, double, double> nearest = triangulation.nearestNeighborGraph();
+    ASSERT_EQ(points.size(), nearest.edgeCount());
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        double best = INFINITY;
+        for (std::uint32_t j = 0; j < points.size(); ++j) {
+            if (j == i) continue;
+            const double dx = points.xs()[i] - points.xs()[j], dy = points.ys()[i] - points.ys()[j];
+            best = std::min(best, std::sqrt(dx * dx + dy * dy));
+        }
+        ASSERT_EQ(1u, nearest.degree(i));
+        EXPECT_DOUBLE_EQ(best, nearest.weight(nearest.edgeBegin(i)));
+    }
+}
+
+TEST(Delaunay, parallelMatchesSequential) {
+    const PointBuffer<double> points = randomPoints(3 * PARALLEL_DELAUNAY_GRAIN, 6, -1000.0, 1000.0);
+    DelaunayTriangulation sequential(points, 1);
+    DelaunayTriangulation parallel(points, 3);
+    expectValid(parallel);
+    EXPECT_EQ(sequential.triangleCount(), parallel.triangleCount());
+    EXPECT_EQ(std::set<std::uint32_t>(sequential.hull().begin(), sequential.hull().end()),
+              std::set<std::uint32_t>(parallel.hull().begin(), parallel.hull().end()));
+    // Points in general position have a unique triangulation
+    const std::vector<std::pair<std::uint32_t, std::uint32_t> > a = sequential.edges(), b = parallel.edges();
+    std::set<std::pair<std::uint32_t, std::uint32_t> > edgesA, edgesB;
+    for (std::size_t k = 0; k < a.size(); ++k) edgesA.insert(std::minmax(a[k].first, a[k].second));
+    for (std::size_t k = 0; k < b.size(); ++k) edgesB.insert(std::minmax(b[k].first, b[k].second));
+    EXPECT_EQ(edgesA, edgesB);
+}
+
+TEST(Delaunay, parallelGrid) {
+    // Strips split between grid columns, the seams are full of collinear and cocircular points
+    const PointBuffer<double> points = gridPoints(600, 250);
+    DelaunayTriangulation triangulation(points, 2);
+    expectValid(triangulation);
+    EXPECT_EQ(2u * 599 * 249, triangulation.triangleCount());
+}
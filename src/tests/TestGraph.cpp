@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/Graph.h"
+
+using namespace graph_algo;
+
+typedef CsrGraph<std::uint32_t, double> Graph;
+typedef GraphBuilder<std::uint32_t, double> Builder;
+
+static Builder diamond() {
+    // 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3, 3 -> 0, added out of order
+    Builder builder(4);
+    builder.addEdge(3, 0, 5.0);
+    builder.addEdge(0, 2, 2.0);
+    builder.addEdge(2, 3, 4.0);
+    builder.addEdge(0, 1, 1.0);
+    builder.addEdge(1, 3, 3.0);
+    return builder;
+}
+
+TEST(GraphTest, empty) {
+    const Graph graph;
+    ASSERT_EQ(0u, graph.vertexCount());
+    ASSERT_EQ(0u, graph.edgeCount());
+    const Graph built = Builder(3).build();
+    ASSERT_EQ(3u, built.vertexCount());
+    ASSERT_EQ(0u, built.edgeCount());
+    ASSERT_FALSE(built.hasWeights());
+    ASSERT_TRUE(built.neighbors(1).empty());
+}
+
+TEST(GraphTest, outEdges) {
+    const Graph graph = diamond().build();
+    ASSERT_EQ(4u, graph.vertexCount());
+    ASSERT_EQ(5u, graph.edgeCount());
+    ASSERT_TRUE(graph.hasWeights());
+    ASSERT_FALSE(graph.hasInEdges());
+    ASSERT_FALSE(graph.hasCoordinates());
+
+    ASSERT_EQ(2u, graph.degree(0));
+    ASSERT_EQ(1u, graph.neighbors(0)[0]);
+    ASSERT_EQ(2u, graph.neighbors(0)[1]);
+    ASSERT_EQ(1.0, graph.weight(graph.edgeBegin(0)));
+    ASSERT_EQ(2.0, graph.weight(graph.edgeBegin(0) + 1));
+    ASSERT_EQ(0u, graph.neighbors(3)[0]);
+    ASSERT_EQ(5.0, graph.weight(graph.edgeBegin(3)));
+
+    ASSERT_TRUE(graph.hasEdge(2, 3));
+    ASSERT_FALSE(graph.hasEdge(3, 2));
+    ASSERT_EQ(3.0, graph.weight(graph.findEdge(1, 3)));
+    ASSERT_EQ(graph.edgeCount(), graph.findEdge(1, 2));
+}
+
+TEST(GraphTest, inEdges) {
+    const Graph graph = diamond().build(1, true);
+    ASSERT_TRUE(graph.hasInEdges());
+    ASSERT_EQ(2u, graph.inDegree(3));
+    ASSERT_EQ(1u, graph.inNeighbors(3)[0]);
+    ASSERT_EQ(2u, graph.inNeighbors(3)[1]);
+    ASSERT_EQ(4.0, graph.weight(graph.inEdge(graph.inEdgeBegin(3) + 1)));
+    ASSERT_EQ(1u, graph.inDegree(0));
+    ASSERT_EQ(3u, graph.inSource(graph.inEdgeBegin(0)));
+    ASSERT_EQ(5.0, graph.weight(graph.inEdge(graph.inEdgeBegin(0))));
+}
+
+TEST(GraphTest, unweighted) {
+    Builder builder(3);
+    builder.addEdge(0, 1);
+    builder.addEdge(1, 2);
+    Graph graph = builder.build();
+    ASSERT_FALSE(graph.hasWeights());
+    ASSERT_EQ(1.0, graph.weight(0));
+
+    // The first weighted edge gives the earlier ones weight 1
+    builder.addEdge(2, 0, 7.0);
+    graph = builder.build();
+    ASSERT_TRUE(graph.hasWeights());
+    ASSERT_EQ(1.0, graph.weight(graph.findEdge(0, 1)));
+    ASSERT_EQ(7.0, graph.weight(graph.findEdge(2, 0)));
+}
+
+TEST(GraphTest, coordinates) {
+    Builder builder(2);
+    builder.addUndirectedEdge(0, 1, 2.5);
+    PointBuffer<double> points;
+    points.push_back(1.0, 2.0);
+    ASSERT_THROW(builder.setCoordinates(points), GraphVertexOutOfBoundException);
+    points.push_back(3.0, 4.0);
+    builder.setCoordinates(points);
+    const Graph graph = builder.build();
+    ASSERT_TRUE(graph.hasCoordinates());
+    ASSERT_EQ(3.0, graph.coordinate(1).getX());
+    ASSERT_EQ(2.5, graph.weight(graph.findEdge(1, 0)));
+}
+
+TEST(GraphTest, invalidEdges) {
+    Builder builder(2);
+    ASSERT_THROW(builder.addEdge(0, 2), GraphVertexOutOfBoundException);
+    ASSERT_THROW(builder.addEdge(2, 0, 1.0), GraphVertexOutOfBoundException);
+
+    Builder::index_array sources(2, 0), targets(1, 0);
+    ASSERT_THROW(Builder(2, sources, targets), GraphEdgeListMismatchException);
+    targets.push_back(5);
+    ASSERT_THROW(Builder(2, sources, targets), GraphVertexOutOfBoundException);
+}
+
+/*
+ * A random multigraph, built on several threads, against a sorted edge list
+ */
+template<class Index>
+static void checkRandom(unsigned threads) {
+    typedef GraphBuilder<Index, float> B;
+    const Index n = 5000;
+    const std::size_t m = 300000;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<Index> vertex(0, n - 1);
+    std::uniform_int_distribution<int> weight(0, 3);
+
+    typename B::index_array sources(m), targets(m);
+    typename B::weight_array weights(m);
+    std::vector<std::tuple<Index, Index, float> > expected;
+    for (std::size_t i = 0; i < m; ++i) {
+        sources[i] = vertex(gen);
+        targets[i] = i % 10 == 0 ? 0 : vertex(gen);
+        weights[i] = float(weight(gen));
+        expected.push_back(std::make_tuple(sources[i], targets[i], weights[i]));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    const CsrGraph<Index, float> graph = B(n, sources, targets, weights).build(threads, true);
+    ASSERT_EQ(Index(m), graph.edgeCount());
+    for (std::size_t e = 0, v = 0; e < m; ++e) {
+        while (graph.edgeEnd(Index(v)) <= e) ++v;
+        ASSERT_EQ(std::get<0>(expected[e]), Index(v));
+        ASSERT_EQ(std::get<1>(expected[e]), graph.target(Index(e)));
+        ASSERT_EQ(std::get<2>(expected[e]), graph.weight(Index(e)));
+    }
+
+    // Every in-edge points back at a CSR edge with the same ends, in source order
+    std::size_t inEdges = 0;
+    for (Index v = 0; v < n; ++v) {
+        for (Index i = graph.inEdgeBegin(v); i < graph.inEdgeEnd(v); ++i, ++inEdges) {
+            const Index e = graph.inEdge(i);
+            ASSERT_EQ(v, graph.target(e));
+            ASSERT_TRUE(graph.edgeBegin(graph.inSource(i)) <= e && e < graph.edgeEnd(graph.inSource(i)));
+            if (i > graph.inEdgeBegin(v)) {
+                ASSERT_LT(graph.inEdge(i - 1), e);
+            }
+        }
+    }
+    ASSERT_EQ(m, inEdges);
+}
+
+TEST(GraphTest, randomSerial) {
+    checkRandom<std::uint32_t>(1);
+}
+
+TEST(GraphTest, randomParallel) {
+    checkRandom<std::uint32_t>(4);
+    checkRandom<std::uint64_t>(3);
+}
+
+TEST(GraphTest, permuteVertices) {
+    Builder builder = diamond();
+    PointBuffer<double> points;
+    for (int v = 0; v < 4; ++v) points.push_back(double(v), -double(v));
+    builder.setCoordinates(points);
+    const Graph graph = builder.build(1, true);
+    // Vertex k of the result is vertex order[k]
+    const std::vector<std::uint32_t> order = {2, 0, 3, 1}, rank = {1, 3, 0, 2};
+    const Graph permuted = permuteVertices(graph, order, 2);
+    ASSERT_EQ(graph.edgeCount(), permuted.edgeCount());
+    ASSERT_TRUE(permuted.hasInEdges());
+    for (std::uint32_t u = 0; u < 4; ++u) {
+        ASSERT_EQ(graph.coordinate(u), permuted.coordinate(rank[u]));
+        ASSERT_EQ(graph.inDegree(u), permuted.inDegree(rank[u]));
+        for (std::uint32_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            const std::uint32_t f = permuted.findEdge(rank[u], rank[graph.target(e)]);
+            ASSERT_NE(permuted.edgeCount(), f);
+            ASSERT_EQ(graph.weight(e), permuted.weight(f));
+        }
+    }
+
+    const std::vector<std::uint32_t> repeated = {0, 1, 1, 3}, outside = {0, 1, 2, 4};
+    ASSERT_THROW(permuteVertices(graph, repeated), GraphVertexOutOfBoundException);
+    ASSERT_THROW(permuteVertices(graph, outside), GraphVertexOutOfBoundException);
+    ASSERT_THROW(permuteVertices(graph, std::vector<std::uint32_t>(3)), GraphVertexOutOfBoundException);
+}
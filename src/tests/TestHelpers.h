@@ -0,0 +1,52 @@
+#ifndef TESTHELPERS_H_
+#define TESTHELPERS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "../main/PointBuffer.h"
+#include "../main/Polygon.h"
+
+/**
+ * Inputs shared by the tests
+ */
+
+namespace graph_algo {
+
+    namespace test {
+
+        /**
+         * n points uniformly distributed in the square low..high, the same for the same seed
+         */
+        inline PointBuffer<double> randomPoints(std::size_t n, unsigned seed, double low = -100.0, double high = 100.0) {
+            std::mt19937 gen(seed);
+            std::uniform_real_distribution<double> coordinate(low, high);
+            PointBuffer<double> points;
+            for (std::size_t i = 0; i < n; ++i) points.push_back(coordinate(gen), coordinate(gen));
+            return points;
+        }
+
+        /**
+         * A random simple polygon: n vertices around (cx, cy) at increasing angles
+         */
+        inline Polygon<double> star(std::mt19937 &gen, int n, double cx, double cy, double radius) {
+            std::uniform_real_distribution<double> unit(0.2, 1.0), angle(0.0, 6.283185307179586);
+            std::vector<double> angles(n);
+            for (int i = 0; i < n; ++i) angles[i] = angle(gen);
+            std::sort(angles.begin(), angles.end());
+            Polygon<double> polygon;
+            for (int i = 0; i < n; ++i) {
+                const double r = radius * unit(gen);
+                polygon.push_back(cx + r * std::cos(angles[i]), cy + r * std::sin(angles[i]));
+            }
+            return polygon;
+        }
+
+    }; // namespace test
+
+};// namespace graph_algo
+
+
+#endif /* TESTHELPERS_H_ */
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/KdTree.h"
+#include "../main/Point.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::randomPoints;
+
+static double squaredDistance(const PointBuffer<double> &points, std::size_t i, double x, double y) {
+    const double dx = points.xs()[i] - x, dy = points.ys()[i] - y;
+    return dx * dx + dy * dy;
+}
+
+/*
+ * The k smallest squared distances to (x, y), by sorting all of them
+ */
+static std::vector<double> bruteForce(const PointBuffer<double> &points, double x, double y, std::size_t k) {
+    std::vector<double> distances(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) distances[i] = squaredDistance(points, i, x, y);
+    std::sort(distances.begin(), distances.end());
+    distances.resize(std::min(k, distances.size()));
+    return distances;
+}
+
+TEST(KdTree, empty) {
+    KdTree<double> tree((PointBuffer<double>()));
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(KdTree<double>::NO_POINT, tree.nearest(PackedPoint<double>(1.0, 2.0)));
+    std::vector<std::uint32_t> out;
+    EXPECT_EQ(0u, tree.radius(PackedPoint<double>(1.0, 2.0), 10.0, out));
+    EXPECT_EQ(0u, tree.box(0.0, 0.0, 1.0, 1.0, out));
+}
+
+TEST(KdTree, nearestMatchesBruteForce) {
+    const PointBuffer<double> points = randomPoints(5000, 1);
+    KdTree<double> tree(points);
+    ASSERT_EQ(points.size(), tree.size());
+    const PointBuffer<double> queries = randomPoints(300, 2);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        const double x = queries.xs()[q], y = queries.ys()[q];
+        const std::uint32_t nearest = tree.nearest(queries[q]);
+        EXPECT_DOUBLE_EQ(bruteForce(points, x, y, 1)[0], squaredDistance(points, nearest, x, y));
+    }
+    // A point of the tree is its own nearest neighbour
+    for (std::uint32_t i = 0; i < 100; ++i) EXPECT_EQ(i, tree.nearest(points[i]));
+}
+
+TEST(KdTree, kNearest) {
+    const PointBuffer<double> points = randomPoints(3000, 3);
+    KdTree<double> tree(points);
+    const PointBuffer<double> queries = randomPoints(100, 4);
+    for (std::size_t k : {1u, 5u, 32u}) {
+        std::vector<std::uint32_t> indices(k);
+        std::vector<double> distances(k);
+        for (std::size_t q = 0; q < queries.size(); ++q) {
+            const double x = queries.xs()[q], y = queries.ys()[q];
+            ASSERT_EQ(k, tree.nearest(queries[q], k, indices.data(), distances.data()));
+            const std::vector<double> expected = bruteForce(points, x, y, k);
+            for (std::size_t i = 0; i < k; ++i) {
+                EXPECT_DOUBLE_EQ(expected[i], distances[i]);
+                EXPECT_DOUBLE_EQ(expected[i], squaredDistance(points, indices[i], x, y));
+            }
+        }
+    }
+    // More neighbours than points
+    KdTree<double> small(randomPoints(5, 5));
+    EXPECT_EQ(5u, small.nearest(PackedPoint<double>(0.0, 0.0), 10).size());
+}
+
+TEST(KdTree, radius) {
+    const PointBuffer<double> points = randomPoints(4000, 6);
+    KdTree<double> tree(points);
+    const PointBuffer<double> queries = randomPoints(100, 7);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        const double x = queries.xs()[q], y = queries.ys()[q];
+        std::vector<std::uint32_t> found;
+        tree.radius(queries[q], 15.0, found);
+        std::sort(found.begin(), found.end());
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t i = 0; i < points.size(); ++i) {
+            if (squaredDistance(points, i, x, y) <= 15.0 * 15.0) expected.push_back(i);
+        }
+        EXPECT_EQ(expected, found);
+    }
+}
+
+TEST(KdTree, box) {
+    const PointBuffer<double> points = randomPoints(4000, 8);
+    KdTree<double> tree(points);
+    std::mt19937 gen(9);
+    std::uniform_real_distribution<double> coordinate(-120.0, 120.0);
+    for (int q = 0; q < 100; ++q) {
+        double x0 = coordinate(gen), x1 = coordinate(gen), y0 = coordinate(gen), y1 = coordinate(gen);
+        if (x0 > x1) std::swap(x0, x1);
+        if (y0 > y1) std::swap(y0, y1);
+        std::vector<std::uint32_t> found;
+        tree.box(x0, y0, x1, y1, found);
+        std::sort(found.begin(), found.end());
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t i = 0; i < points.size(); ++i) {
+            const double x = points.xs()[i], y = points.ys()[i];
+            if (x >= x0 && x <= x1 && y >= y0 && y <= y1) expected.push_back(i);
+        }
+        EXPECT_EQ(expected, found);
+    }
+}
+
+TEST(KdTree, duplicatesAndGrid) {
+    // Many equal coordinates on both axes
+    std::vector<Point<double> > points;
+    for (int i = 0; i < 2000; ++i) points.push_back(Point<double>(double(i % 7), double(i % 11)));
+    KdTree<double> tree(points);
+    std::vector<std::uint32_t> found;
+    tree.box(2.0, 3.0, 2.0, 3.0, found);
+    EXPECT_EQ(2000u / 77 + 1, found.size());
+    std::vector<std::uint32_t> indices(30);
+    std::vector<double> distances(30);
+    tree.nearest(Point<double>(2.0, 3.0), 30, indices.data(), distances.data());
+    EXPECT_EQ(0.0, distances[found.size() - 1]);
+    EXPECT_EQ(1.0, distances[found.size()]);
+}
+
+TEST(KdTree, batchesMatchSingleQueries) {
+    const PointBuffer<double> points = randomPoints(20000, 10);
+    KdTree<double> tree(points, 4);
+    const PointBuffer<double> queries = randomPoints(2 * PARALLEL_KDTREE_GRAIN, 11);
+    const std::size_t k = 4;
+    std::vector<std::uint32_t> indices(queries.size() * k);
+    std::vector<double> distances(queries.size() * k);
+    tree.nearestBatch(queries, k, indices.data(), distances.data(), 2);
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint32_t> within;
+    tree.radiusBatch(queries, 2.0, offsets, within, 2);
+    ASSERT_EQ(queries.size() + 1, offsets.size());
+    for (std::size_t q = 0; q < queries.size(); q += 97) {
+        std::vector<std::uint32_t> single(k);
+        std::vector<double> singleDistances(k);
+        tree.nearest(queries[q], k, single.data(), singleDistances.data());
+        for (std::size_t i = 0; i < k; ++i) EXPECT_EQ(singleDistances[i], distances[q * k + i]);
+        std::vector<std::uint32_t> expected;
+        tree.radius(queries[q], 2.0, expected);
+        std::vector<std::uint32_t> batch(within.begin() + offsets[q], within.begin() + offsets[q + 1]);
+        std::sort(expected.begin(), expected.end());
+        std::sort(batch.begin(), batch.end());
+        EXPECT_EQ(expected, batch);
+    }
+}
+
+TEST(KdTree, parallelBuild) {
+    const PointBuffer<double> points = randomPoints(4 * PARALLEL_KDTREE_GRAIN, 12);
+    KdTree<double> sequential(points, 1), parallel(points, 4);
+    // The layout does not depend on the number of threads
+    EXPECT_EQ(sequential.indices(), parallel.indices());
+    const PointBuffer<double> queries = randomPoints(200, 13);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        EXPECT_EQ(sequential.nearest(queries[q]), parallel.nearest(queries[q]));
+    }
+}
+
+TEST(KdTree, floatCoordinates) {
+    std::vector<PackedPoint<float> > points;
+    for (int i = 0; i < 100; ++i) points.push_back(PackedPoint<float>(float(i), float(i * i % 17)));
+    KdTree<float> tree(points);
+    EXPECT_EQ(42u, tree.nearest(PackedPoint<float>(42.1f, float(42 * 42 % 17))));
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/MemoryArena.h"
+#include "../main/PointBuffer.h"
+
+using namespace graph_algo;
+
+/*
+ * Counts what goes to and comes back from the heap
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0;
+
+protected:
+    void *do_allocate(std::size_t n, std::size_t alignment) override {
+        ++allocations;
+        bytes += n;
+        return std::pmr::new_delete_resource()->allocate(n, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t n, std::size_t alignment) override {
+        ++deallocations;
+        bytes -= n;
+        std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+static bool aligned(const void *p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+TEST(MemoryArenaTest, arenaBumpsAndRewinds) {
+    CountingResource heap;
+    {
+        MonotonicArena arena(1024, &heap);
+        EXPECT_EQ(0u, heap.allocations);
+
+        char *a = static_cast<char *>(arena.allocate(10, 1));
+        char *b = static_cast<char *>(arena.allocate(8, 8));
+        EXPECT_TRUE(aligned(b, 8));
+        EXPECT_LE(a + 10, b);
+        EXPECT_LT(b - a, 24);
+        EXPECT_TRUE(aligned(arena.allocate(100, 256), 256));
+        EXPECT_EQ(1u, heap.allocations);
+
+        const MonotonicArena::Mark mark = arena.mark();
+        const std::size_t used = arena.used();
+        void *c = arena.allocate(64, 8);
+        // A request larger than the block gets a block of its own
+        EXPECT_NE(nullptr, arena.allocate(5000, 16));
+        EXPECT_EQ(2u, heap.allocations);
+        arena.rewind(mark);
+        EXPECT_EQ(used, arena.used());
+        EXPECT_EQ(c, arena.allocate(64, 8));
+
+        // The blocks are reused after a reset, nothing new comes from the heap
+        for (int round = 0; round < 10; ++round) {
+            arena.reset();
+            EXPECT_EQ(a, arena.allocate(10, 1));
+            for (int i = 0; i < 50; ++i) EXPECT_NE(nullptr, arena.allocate(100, 8));
+        }
+        const std::size_t held = arena.memoryUsage();
+        EXPECT_EQ(heap.bytes, held);
+        EXPECT_GE(held, arena.used());
+        EXPECT_EQ(0u, heap.deallocations);
+
+        arena.release();
+        EXPECT_EQ(0u, heap.bytes);
+        EXPECT_EQ(0u, arena.memoryUsage());
+        EXPECT_NE(nullptr, arena.allocate(1, 1));
+    }
+    EXPECT_EQ(heap.allocations, heap.deallocations);
+    EXPECT_EQ(0u, heap.bytes);
+}
+
+TEST(MemoryArenaTest, arenaAlignsPastTheBlockEnd) {
+    // Aligning the cursor can land beyond the end of the block, the request must then go to a new block
+    CountingResource heap;
+    MonotonicArena arena(4000, &heap);
+    char *a = static_cast<char *>(arena.allocate(4000 - CACHE_LINE_SIZE - 8, 1));
+    char *b = static_cast<char *>(arena.allocate(16, 256));
+    EXPECT_TRUE(aligned(b, 256));
+    EXPECT_TRUE(b + 16 <= a || b >= a + 4000);
+    EXPECT_EQ(2u, heap.allocations);
+
+    // The same after an oversized request, whose block is sized to fit it exactly
+    MonotonicArena small(256, &heap);
+    EXPECT_NE(nullptr, small.allocate(1001, 1));
+    for (int i = 0; i < 100; ++i) {
+        char *p = static_cast<char *>(small.allocate(12, 4));
+        EXPECT_TRUE(aligned(p, 4));
+        p[11] = 'x';
+    }
+}
+
+TEST(MemoryArenaTest, arenaScope) {
+    CountingResource heap;
+    MonotonicArena arena(4096, &heap);
+    EXPECT_NE(nullptr, arena.allocate(100, 8));
+    const std::size_t used = arena.used();
+    for (int query = 0; query < 100; ++query) {
+        ArenaScope scope(arena);
+        std::pmr::vector<int> scratch(&arena);
+        for (int i = 0; i < 1000; ++i) scratch.push_back(i);
+        EXPECT_EQ(999, scratch.back());
+    }
+    EXPECT_EQ(used, arena.used());
+    // 100 queries of growing vectors fit in the blocks of the first one
+    EXPECT_LE(heap.allocations, 4u);
+}
+
+TEST(MemoryArenaTest, poolReusesBlocks) {
+    CountingResource heap;
+    {
+        FixedPool pool(24, 16, &heap);
+        EXPECT_EQ(32u, pool.blockSize());
+        EXPECT_EQ(32u, pool.blockAlignment());
+
+        std::vector<void *> blocks;
+        for (int i = 0; i < 40; ++i) {
+            blocks.push_back(pool.allocate(24, 8));
+            EXPECT_TRUE(aligned(blocks.back(), 32));
+        }
+        EXPECT_EQ(3u, heap.allocations);
+        EXPECT_EQ(40u, pool.blocksInUse());
+        for (int i = 0; i < 40; i += 2) pool.deallocate(blocks[std::size_t(i)], 24, 8);
+        EXPECT_EQ(20u, pool.blocksInUse());
+        for (int i = 0; i < 20; ++i) EXPECT_NE(nullptr, pool.allocate(16, 16));
+        EXPECT_EQ(3u, heap.allocations);
+
+        // Requests the pool does not serve go upstream both ways
+        void *big = pool.allocate(100, 8);
+        void *strict = pool.allocate(8, 64);
+        EXPECT_EQ(5u, heap.allocations);
+        pool.deallocate(big, 100, 8);
+        pool.deallocate(strict, 8, 64);
+        EXPECT_EQ(2u, heap.deallocations);
+        EXPECT_EQ(pool.memoryUsage(), heap.bytes);
+    }
+    EXPECT_EQ(heap.allocations, heap.deallocations);
+}
+
+TEST(MemoryArenaTest, poolBacksNodeContainers) {
+    CountingResource heap;
+    FixedPool pool(64, 256, &heap);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> value(0, 999);
+    std::pmr::set<int> reference;
+    {
+        std::pmr::set<int> set(&pool);
+        std::pmr::list<double> list(&pool);
+        for (int i = 0; i < 20000; ++i) {
+            const int v = value(gen);
+            if (i % 3 == 0) {
+                set.erase(v);
+                reference.erase(v);
+            } else {
+                set.insert(v);
+                reference.insert(v);
+            }
+            list.push_back(v);
+            if (list.size() > 100) list.pop_front();
+        }
+        EXPECT_TRUE(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+        // At most 1100 nodes live at a time
+        EXPECT_LE(pool.memoryUsage(), 5u * (64u * 256u + CACHE_LINE_SIZE));
+    }
+    EXPECT_EQ(0u, pool.blocksInUse());
+}
+
+TEST(MemoryArenaTest, pointBufferInArena) {
+    CountingResource heap;
+    MonotonicArena arena(1 << 12, &heap);
+    PointBuffer<double> points(&arena);
+    EXPECT_EQ(&arena, points.resource());
+    for (int i = 0; i < 1000; ++i) points.push_back(double(i), -double(i));
+    EXPECT_TRUE(aligned(points.xs(), CACHE_LINE_SIZE));
+    EXPECT_TRUE(aligned(points.ys(), CACHE_LINE_SIZE));
+    EXPECT_EQ(999.0, points[999].getX());
+    EXPECT_LE(heap.allocations, 4u);
+
+    // Copies live on the heap and outlive the arena's contents
+    PointBuffer<double> copy(points);
+    EXPECT_EQ(nullptr, copy.resource());
+    arena.reset();
+    PointBuffer<double> zeros(100, &arena);
+    EXPECT_EQ(0.0, zeros[99].getY());
+    EXPECT_EQ(-999.0, copy[999].getY());
+    EXPECT_EQ(nullptr, PointBuffer<double>().resource());
+}
@@ -0,0 +1,177 @@
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/PackedPoint.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+TEST(PackedPointTest, layout) {
+    ASSERT_TRUE(std::is_trivially_copyable<PackedPoint<T> >::value);
+    ASSERT_TRUE(std::is_standard_layout<PackedPoint<T> >::value);
+    ASSERT_EQ(2 * sizeof(T), sizeof(PackedPoint<T>));
+    ASSERT_EQ(2 * sizeof(float), sizeof(PackedPoint<float>));
+}
+
+TEST(PackedPointTest, constexprArithmetic) {
+    constexpr PackedPoint<T> p1(2.0, 3.0);
+    constexpr PackedPoint<T> p2(1.0, -1.0);
+    constexpr PackedPoint<T> sum = p1 + p2;
+    constexpr PackedPoint<T> scaled = (p1 - p2) * 2.0;
+    constexpr T dot = p1 ^ p2;
+    constexpr T cross = p1 & p2;
+
+    static_assert(sum.getX() == 3.0 && sum.getY() == 2.0, "constexpr addition");
+    static_assert(scaled.getX() == 2.0 && scaled.getY() == 8.0, "constexpr scaling");
+    static_assert(dot == -1.0, "constexpr dot product");
+    static_assert(cross == -5.0, "constexpr cross product");
+    ASSERT_EQ(3.0, sum.getX());
+}
+
+/*
+ * The corners of an axis-aligned square, scaled and moved at compile time
+ */
+struct UnitSquare {
+    PackedPoint<T> corners[4];
+
+    constexpr UnitSquare(T size, PackedPoint<T> origin) : corners() {
+        const PackedPoint<T> unit[4] = {PackedPoint<T>(0, 0), PackedPoint<T>(1, 0), PackedPoint<T>(1, 1), PackedPoint<T>(0, 1)};
+        for (int i = 0; i < 4; ++i) corners[i] = origin + unit[i] * size;
+    }
+};
+
+TEST(PackedPointTest, constexprShapes) {
+    constexpr UnitSquare square(2.0, PackedPoint<T>(-1.0, -1.0));
+    static_assert(square.corners[2].getX() == 1.0 && square.corners[2].getY() == 1.0, "constexpr corner");
+    static_assert(((square.corners[1] - square.corners[0]) & (square.corners[3] - square.corners[0])) == 4.0,
+                  "constexpr area of the square");
+    static_assert(noexcept(square.corners[0] | square.corners[1]) && noexcept(square.corners[0].angle()),
+                  "the operators do not throw");
+    static_assert(noexcept(Point<T>(1.0, 2.0) + Point<T>()) && noexcept(Point<T>().length()),
+                  "neither do those of Point");
+    ASSERT_EQ(-1.0, square.corners[0].getX());
+}
+
+TEST(PackedPointTest, memcpyRoundTrip) {
+    std::vector<PackedPoint<T> > src;
+    for (int i = 0; i < 100; ++i) {
+        src.push_back(PackedPoint<T>(i * 0.5, -i * 1.5));
+    }
+    std::vector<PackedPoint<T> > dst(src.size());
+    std::memcpy(dst.data(), src.data(), src.size() * sizeof(PackedPoint<T>));
+
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        ASSERT_EQ(src[i].getX(), dst[i].getX());
+        ASSERT_EQ(src[i].getY(), dst[i].getY());
+    }
+}
+
+TEST(PackedPointTest, matchesPoint) {
+    Point<T> a(2.2, 3.1);
+    Point<T> b(-1.2, 4.7);
+    PackedPoint<T> pa(a);
+    PackedPoint<T> pb(b);
+
+    ASSERT_EQ((a + b).getX(), (pa + pb).getX());
+    ASSERT_EQ((a - b).getY(), (pa - pb).getY());
+    ASSERT_EQ((a * 3).getX(), (pa * 3).getX());
+    ASSERT_EQ((a / 2).getY(), (pa / 2).getY());
+    ASSERT_EQ(a | b, pa | pb);
+    ASSERT_EQ(a ^ b, pa ^ pb);
+    ASSERT_EQ(a & b, pa & pb);
+    ASSERT_EQ(a.length(), pa.length());
+    ASSERT_EQ(a.angle(), pa.angle());
+    ASSERT_EQ(a.angle(b), pa.angle(pb));
+    ASSERT_EQ(a < b, pa < pb);
+    ASSERT_EQ(a > b, pa > pb);
+    ASSERT_EQ(a <= b, pa <= pb);
+    ASSERT_EQ(a >= b, pa >= pb);
+
+    Point<T> back = pa.toPoint();
+    ASSERT_EQ(a.getX(), back.getX());
+    ASSERT_EQ(a.getY(), back.getY());
+}
+
+TEST(PackedPointTest, compare) {
+    PackedPoint<T> p0;
+    PackedPoint<T> p1(2.2, 3.1);
+    PackedPoint<T> p1_2(2.2, 3.1);
+    PackedPoint<T> p2(2.3, 2.2);
+
+    ASSERT_TRUE(p0 < p1);
+    ASSERT_FALSE(p0 < p0);
+    ASSERT_TRUE(p1 > p2);
+    ASSERT_TRUE(p1 == p1_2);
+    ASSERT_TRUE(p1 != p2);
+    ASSERT_TRUE(p1 <= p1_2);
+    ASSERT_TRUE(p1 >= p1_2);
+    ASSERT_FALSE(p0 >= p1);
+}
+
+TEST(PackedPointTest, setXY) {
+    PackedPoint<T> p1(2.2, 3.1);
+    p1.setX(11.2);
+    p1.setY(23.2);
+
+    ASSERT_EQ(p1.getX(), 11.2);
+    ASSERT_EQ(p1.getY(), 23.2);
+}
+
+TEST(PackedPointTest, defaultToleranceIsExactForIntegers) {
+    ASSERT_TRUE((std::is_same<DefaultTolerance<long long>::type, ExactTolerance<long long> >::value));
+    ASSERT_TRUE((std::is_same<DefaultTolerance<T>::type, EpsilonTolerance<T> >::value));
+    ASSERT_EQ(2 * sizeof(long long), sizeof(PackedPoint<long long>));
+}
+
+TEST(PackedPointTest, exactIntegerCompare) {
+    PackedPoint<long long> p0;
+    PackedPoint<long long> p1(3, 4);
+    PackedPoint<long long> p2(4, 3);
+    PackedPoint<long long> p3(0, 6);
+    // The squared lengths are summed wider than int64_t
+    PackedPoint<long long> big(3000000000LL, 1);
+    PackedPoint<long long> bigger(3000000000LL, 2);
+    PackedPoint<int> small(46341, 0);
+    PackedPoint<int> large(-2147483647 - 1, -2147483647 - 1);
+
+    ASSERT_TRUE(p0 < p1);
+    ASSERT_FALSE(p1 < p2);
+    ASSERT_FALSE(p2 < p1);
+    ASSERT_FALSE(p1 == p2);
+    ASSERT_TRUE(p1 == PackedPoint<long long>(3, 4));
+    ASSERT_TRUE(p2 < p3);
+    ASSERT_TRUE(p3 > p1);
+    ASSERT_TRUE(big < bigger);
+    ASSERT_FALSE(big == bigger);
+    ASSERT_TRUE(small < large);
+    ASSERT_TRUE(PackedPoint<int>(-2147483647, -2147483647 - 1) < large);
+}
+
+TEST(PackedPointTest, customEpsilonPolicy) {
+    typedef PackedPoint<T, EpsilonTolerance<T, std::milli> > CoarsePoint;
+    CoarsePoint p1(1.0, 1.0);
+    CoarsePoint p2(1.0005, 0.9995);
+    CoarsePoint p3(1.002, 1.0);
+
+    ASSERT_EQ(0.001, (EpsilonTolerance<T, std::milli>::epsilon()));
+    ASSERT_EQ(DEFAULT_EPSILON, EpsilonTolerance<T>::epsilon());
+    ASSERT_TRUE(p1 == p2);
+    ASSERT_FALSE(p1 == p3);
+    ASSERT_FALSE(p1 < p2);
+    ASSERT_TRUE(p1 < p3);
+}
+
+TEST(PackedPointTest, runtimeEpsilon) {
+    PackedPoint<T> p1(1.0, 1.0);
+    PackedPoint<T> p2(1.0005, 0.9995);
+
+    ASSERT_FALSE(p1 == p2);
+    ASSERT_TRUE(p1.equals(p2, 0.001));
+    ASSERT_FALSE(p1.equals(p2, 0.0001));
+    // Less than epsilon, like the policies
+    ASSERT_FALSE(PackedPoint<T>(1.0, 1.0).equals(PackedPoint<T>(1.25, 0.75), 0.25));
+    ASSERT_TRUE(PackedPoint<long long>(2, 3).equals(PackedPoint<long long>(2, 3), 1));
+    ASSERT_FALSE(PackedPoint<long long>(2, 3).equals(PackedPoint<long long>(2, 4), 1));
+}
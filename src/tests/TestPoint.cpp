@@ -1,5 +1,6 @@
 #include <iostream>
 #include <typeinfo>
+#include <ratio>
 #include <gtest/gtest.h>
 #include "../main/Point.h"
 
@@ -429,4 +430,41 @@ TEST(PointTest, setXY_epsilon) {
 
     ASSERT_NE(p1.getX(), 2.2);
     ASSERT_NE(p1.getY(), 3.1);
-}
\ No newline at end of file
+}
+
+TEST(PointTest, tolerancePolicy) {
+    typedef Point<T, EpsilonTolerance<T, std::milli> > CoarsePoint;
+    CoarsePoint p1(1.0, 1.0);
+    CoarsePoint p2(1.0005, 0.9995);
+    CoarsePoint p3(1.002, 1.0);
+
+    ASSERT_EQ(0.001, p1.getEpsilon());
+    ASSERT_TRUE(p1 == p2);
+    ASSERT_FALSE(p1 == p3);
+    ASSERT_FALSE(p1 < p2);
+    ASSERT_TRUE(p1 < p3);
+    ASSERT_FALSE(Point<T>(1.0, 1.0) == Point<T>(1.0005, 0.9995));
+    ASSERT_TRUE(Point<T>(1.0, 1.0, 0.001) == Point<T>(1.0005, 0.9995));
+
+    // A policy point holds no epsilon of its own
+    ASSERT_EQ(sizeof(Point<T>), sizeof(CoarsePoint) + sizeof(T));
+}
+
+TEST(PointTest, exactIntegerCompare) {
+    ASSERT_EQ(2 * sizeof(long long) + sizeof(void *), sizeof(Point<long long>));
+    Point<long long> p1(3, 4);
+    Point<long long> p2(4, 3);
+    // The squared lengths are summed wider than int64_t
+    Point<long long> p3(3000000000LL, 1);
+    Point<long long> p4(3000000000LL, 2);
+
+    ASSERT_EQ(0, p1.getEpsilon());
+    ASSERT_TRUE(p1 == Point<long long>(3, 4));
+    ASSERT_FALSE(p1 == p2);
+    ASSERT_FALSE(p1 < p2);
+    ASSERT_FALSE(p2 > p1);
+    ASSERT_TRUE(p3 < p4);
+    ASSERT_TRUE(p4 > p3);
+    ASSERT_FALSE(p3 == p4);
+    ASSERT_TRUE(Point<int>(46341, 0) < Point<int>(-2147483647 - 1, 0));
+}
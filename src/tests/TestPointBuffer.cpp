@@ -0,0 +1,164 @@
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/PointBuffer.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static PointBuffer<T> makeBuffer(std::size_t n) {
+    PointBuffer<T> buffer;
+    for (std::size_t i = 0; i < n; ++i) {
+        buffer.push_back(T(i) * 0.75 - 3.0, 5.0 - T(i) * 1.25);
+    }
+    return buffer;
+}
+
+TEST(PointBufferTest, construct) {
+    PointBuffer<T> empty;
+    ASSERT_TRUE(empty.empty());
+
+    PointBuffer<T> zeros(5);
+    ASSERT_EQ(5u, zeros.size());
+    ASSERT_EQ(0.0, zeros[4].getX());
+    ASSERT_EQ(0.0, zeros[4].getY());
+
+    std::vector<Point<T> > points;
+    points.push_back(Point<T>(1.0, 2.0));
+    points.push_back(Point<T>(3.0, 4.0));
+    PointBuffer<T> buffer(points);
+    ASSERT_EQ(2u, buffer.size());
+    ASSERT_EQ(3.0, buffer[1].getX());
+    ASSERT_EQ(4.0, buffer.ys()[1]);
+
+    buffer.set(0, PackedPoint<T>(-1.0, -2.0));
+    ASSERT_EQ(-1.0, buffer.xs()[0]);
+}
+
+TEST(PointBufferTest, aligned) {
+    PointBuffer<T> buffer = makeBuffer(33);
+    ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(buffer.xs()) % CACHE_LINE_SIZE);
+    ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(buffer.ys()) % CACHE_LINE_SIZE);
+}
+
+TEST(PointBufferTest, translateAndScale) {
+    // Odd sizes exercise the scalar tail after the vector loop
+    for (std::size_t n = 0; n < 19; ++n) {
+        const PointBuffer<T> original = makeBuffer(n);
+        PointBuffer<T> buffer = original;
+        const PackedPoint<T> offset(0.5, -2.25);
+
+        buffer += offset;
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ((original[i] + offset).getX(), buffer[i].getX());
+            ASSERT_EQ((original[i] + offset).getY(), buffer[i].getY());
+        }
+        buffer -= offset;
+        buffer *= 3.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ((original[i] * 3.0).getX(), buffer[i].getX());
+            ASSERT_EQ((original[i] * 3.0).getY(), buffer[i].getY());
+        }
+        buffer /= 3.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_DOUBLE_EQ(original[i].getX(), buffer[i].getX());
+            ASSERT_DOUBLE_EQ(original[i].getY(), buffer[i].getY());
+        }
+    }
+}
+
+TEST(PointBufferTest, products) {
+    for (std::size_t n = 0; n < 19; ++n) {
+        const PointBuffer<T> buffer = makeBuffer(n);
+        const PackedPoint<T> p(1.5, -0.5);
+        std::vector<T> dots(n), crosses(n);
+        buffer.dot(p, dots.data());
+        buffer.cross(p, crosses.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(buffer[i] ^ p, dots[i]);
+            ASSERT_EQ(buffer[i] & p, crosses[i]);
+        }
+    }
+}
+
+TEST(PointBufferTest, lengthsDistancesAngles) {
+    for (std::size_t n = 0; n < 19; ++n) {
+        const PointBuffer<T> buffer = makeBuffer(n);
+        const PackedPoint<T> p(2.0, 1.0);
+        std::vector<T> lengths(n), distances(n), angles(n), anglesToP(n);
+        buffer.lengths(lengths.data());
+        buffer.distances(p, distances.data());
+        buffer.angles(angles.data());
+        buffer.angles(p, anglesToP.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_DOUBLE_EQ(buffer[i].length(), lengths[i]);
+            ASSERT_DOUBLE_EQ(buffer[i] | p, distances[i]);
+            ASSERT_EQ(buffer[i].angle(), angles[i]);
+            ASSERT_EQ(buffer[i].angle(p), anglesToP[i]);
+        }
+    }
+}
+
+TEST(PointBufferTest, precisionModes) {
+    for (std::size_t n = 0; n < 19; ++n) {
+        const PointBuffer<T> buffer = makeBuffer(n);
+        const PackedPoint<T> p(2.0, 1.0);
+        std::vector<T> exactLengths(n), exactDistances(n), approxAngles(n), approxAnglesToP(n);
+        std::vector<T> squaredLengths(n), squaredDistances(n), pseudoAngles(n), pseudoAnglesToP(n);
+        buffer.lengths<ExactPrecision>(exactLengths.data());
+        buffer.distances<ExactPrecision>(p, exactDistances.data());
+        buffer.angles<ApproxPrecision>(approxAngles.data());
+        buffer.angles<ApproxPrecision>(p, approxAnglesToP.data());
+        buffer.squaredLengths(squaredLengths.data());
+        buffer.squaredDistances(p, squaredDistances.data());
+        buffer.pseudoAngles(pseudoAngles.data());
+        buffer.pseudoAngles(p, pseudoAnglesToP.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(buffer[i].length(), exactLengths[i]);
+            ASSERT_EQ(buffer[i] | p, exactDistances[i]);
+            ASSERT_NEAR(buffer[i].angle(), approxAngles[i], APPROX_ATAN2_MAX_ERROR);
+            ASSERT_NEAR(buffer[i].angle(p), approxAnglesToP[i], APPROX_ATAN2_MAX_ERROR);
+            ASSERT_EQ(buffer[i].squaredLength(), squaredLengths[i]);
+            ASSERT_EQ(squaredDistance(buffer[i], p), squaredDistances[i]);
+            ASSERT_EQ(buffer[i].pseudoAngle(), pseudoAngles[i]);
+            ASSERT_EQ(pseudoAngle(buffer[i], p), pseudoAnglesToP[i]);
+        }
+    }
+}
+
+TEST(PointBufferTest, dispatchedKernelsMatchScalar) {
+    const PointBuffer<T> buffer = makeBuffer(37);
+    const simd::DoubleKernels &best = simd::kernels();
+    const simd::DoubleKernels &scalar = simd::scalarKernels();
+    std::vector<T> expected(buffer.size()), actual(buffer.size());
+
+    scalar.distance(buffer.xs(), buffer.ys(), buffer.size(), 0.25, -1.0, expected.data());
+    best.distance(buffer.xs(), buffer.ys(), buffer.size(), 0.25, -1.0, actual.data());
+    ASSERT_EQ(expected, actual);
+
+    scalar.cross(buffer.xs(), buffer.ys(), buffer.size(), 0.25, -1.0, expected.data());
+    best.cross(buffer.xs(), buffer.ys(), buffer.size(), 0.25, -1.0, actual.data());
+    ASSERT_EQ(expected, actual);
+
+    scalar.angle(buffer.xs(), buffer.ys(), buffer.size(), 0.25, -1.0, expected.data());
+    best.angle(buffer.xs(), buffer.ys(), buffer.size(), 0.25, -1.0, actual.data());
+    ASSERT_EQ(expected, actual);
+}
+
+TEST(PointBufferTest, integerCoordinates) {
+    PointBuffer<int> buffer;
+    buffer.push_back(3, 4);
+    buffer.push_back(-6, 8);
+    buffer += PackedPoint<int>(1, 1);
+    buffer *= 2;
+    ASSERT_EQ(8, buffer[0].getX());
+    ASSERT_EQ(10, buffer[0].getY());
+
+    std::vector<double> lengths(2);
+    buffer /= 2;
+    buffer -= PackedPoint<int>(1, 1);
+    buffer.lengths(lengths.data());
+    ASSERT_DOUBLE_EQ(5.0, lengths[0]);
+    ASSERT_DOUBLE_EQ(10.0, lengths[1]);
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/PointInPolygon.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::star;
+
+typedef double T;
+
+static const std::uint32_t NONE = PolygonLocator<T>::NO_POLYGON;
+
+/*
+ * Even-odd ray casting over every edge
+ */
+static bool rayCast(const PolygonSet<T> &polygons, T x, T y) {
+    bool in = false;
+    for (std::size_t r = 0; r < polygons.ringCount(); ++r) {
+        const std::size_t first = polygons.first(r), n = polygons.size(r);
+        for (std::size_t i = 0, j = n - 1; i < n; j = i++) {
+            const T xi = polygons.xs()[first + i], yi = polygons.ys()[first + i];
+            const T xj = polygons.xs()[first + j], yj = polygons.ys()[first + j];
+            if ((yi > y) != (yj > y) && x < xi + (y - yi) / (yj - yi) * (xj - xi)) in = !in;
+        }
+    }
+    return in;
+}
+
+TEST(PointInPolygon, square) {
+    Polygon<T> square;
+    square.push_back(0.0, 0.0);
+    square.push_back(2.0, 0.0);
+    square.push_back(2.0, 2.0);
+    square.push_back(0.0, 2.0);
+    const PolygonLocator<T> locator(square);
+    ASSERT_EQ(1u, locator.size());
+    EXPECT_TRUE(locator.contains(0, 1.0, 1.0));
+    EXPECT_TRUE(locator.contains(0, PackedPoint<T>(0.5, 1.9)));
+    EXPECT_FALSE(locator.contains(0, 3.0, 1.0));
+    EXPECT_FALSE(locator.contains(0, -1.0, 1.0));
+    EXPECT_FALSE(locator.contains(0, 1.0, -1e-9));
+    EXPECT_FALSE(locator.contains(0, std::nan(""), 1.0));
+    EXPECT_EQ(0u, locator.locate(1.0, 1.0));
+    EXPECT_EQ(NONE, locator.locate(5.0, 5.0));
+
+    // Without area nothing is inside
+    Polygon<T> line;
+    line.push_back(0.0, 0.0);
+    line.push_back(1.0, 0.0);
+    const PolygonLocator<T> flat(line);
+    EXPECT_FALSE(flat.contains(0, 0.5, 0.0));
+    EXPECT_EQ(NONE, flat.locate(0.5, 0.0));
+    EXPECT_EQ(NONE, PolygonLocator<T>().locate(0.0, 0.0));
+}
+
+TEST(PointInPolygon, matchesRayCasting) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<T> coordinate(-12.0, 12.0);
+    for (int round = 0; round < 20; ++round) {
+        // A hole, and vertices on a grid so that points meet vertices and horizontal edges
+        PolygonSet<T> polygon;
+        polygon.addRing(star(gen, 200, 0.0, 0.0, 10.0));
+        polygon.addRing(star(gen, 30, 0.0, 0.0, 3.0));
+        if (round % 2 == 1) {
+            PolygonSet<T> rounded;
+            for (std::size_t r = 0; r < polygon.ringCount(); ++r) {
+                for (std::size_t i = polygon.first(r); i < polygon.first(r) + polygon.size(r); ++i) {
+                    rounded.push_back(std::round(polygon.xs()[i]), std::round(polygon.ys()[i]));
+                }
+                rounded.closeRing();
+            }
+            polygon = rounded;
+        }
+        const PolygonLocator<T> locator(polygon);
+        PointBuffer<T> points;
+        for (int i = 0; i < 5000; ++i) {
+            const T x = coordinate(gen), y = coordinate(gen);
+            points.push_back(x, i % 2 == 1 ? std::round(y) : y);
+        }
+        std::vector<std::uint8_t> inside(points.size());
+        locator.contains(0, points, inside.data(), 3);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const bool expected = rayCast(polygon, points.xs()[i], points.ys()[i]);
+            ASSERT_EQ(expected, locator.contains(0, points.xs()[i], points.ys()[i])) << round << " " << i;
+            ASSERT_EQ(expected, inside[i] != 0);
+        }
+    }
+}
+
+TEST(PointInPolygon, manyPolygons) {
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<T> coordinate(0.0, 1000.0), unit(0.0, 1.0);
+    // Overlapping zones of very different sizes
+    std::vector<PolygonSet<T> > zones;
+    for (int z = 0; z < 300; ++z) {
+        const T radius = z % 50 == 0 ? 300.0 : 5.0 + 30.0 * unit(gen);
+        PolygonSet<T> zone;
+        zone.addRing(star(gen, 12, coordinate(gen), coordinate(gen), radius));
+        zones.push_back(zone);
+    }
+    const PolygonLocator<T> locator(zones);
+    ASSERT_EQ(zones.size(), locator.size());
+
+    PointBuffer<T> points;
+    for (int i = 0; i < 20000; ++i) points.push_back(-50.0 + 1100.0 * unit(gen), -50.0 + 1100.0 * unit(gen));
+    std::vector<std::uint32_t> located(points.size()), all;
+    locator.locate(points, located.data(), 4);
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const T x = points.xs()[i], y = points.ys()[i];
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t z = 0; z < zones.size(); ++z) {
+            if (rayCast(zones[z], x, y)) expected.push_back(z);
+        }
+        all.clear();
+        EXPECT_EQ(expected.size(), locator.locateAll(x, y, all));
+        ASSERT_EQ(expected, all) << i;
+        EXPECT_EQ(expected.empty() ? NONE : expected[0], located[i]);
+        EXPECT_EQ(located[i], locator.locate(points[i]));
+        hits += expected.size();
+    }
+    EXPECT_GT(hits, points.size() / 4);
+    EXPECT_GT(locator.memoryUsage(), 0u);
+}
@@ -0,0 +1,162 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/ConvexHull.h"
+#include "../main/Point.h"
+#include "../main/Polygon.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static Polygon<T> square(T x, T y, T side) {
+    Polygon<T> polygon;
+    polygon.push_back(x, y);
+    polygon.push_back(x + side, y);
+    polygon.push_back(x + side, y + side);
+    polygon.push_back(x, y + side);
+    return polygon;
+}
+
+TEST(PolygonTest, ringAccess) {
+    const Polygon<T> polygon = square(0.0, 0.0, 2.0);
+    ASSERT_EQ(4, polygon.size());
+    Polygon<T>::index_type i = polygon.index(3);
+    ASSERT_EQ(0.0, polygon[i].getX());
+    ASSERT_EQ(2.0, polygon[i].getY());
+    ASSERT_EQ(0.0, polygon.next(i).getY());
+    ASSERT_EQ(2.0, polygon.prev(i).getX());
+    ++i;
+    ASSERT_EQ(0, i);
+    ASSERT_EQ(0.0, polygon.prev(polygon.index(1)).getX());
+    ASSERT_EQ(0.0, polygon.prev(i).getX());
+    ASSERT_EQ(2.0, polygon.prev(i).getY());
+    ASSERT_THROW(polygon.index(4), RingIndexOutOfBoundException);
+
+    Polygon<T> single;
+    single.push_back(1.0, 2.0);
+    ASSERT_EQ(1.0, single.prev(single.index(0)).getX());
+    ASSERT_EQ(1.0, single.next(single.index(0)).getX());
+}
+
+TEST(PolygonTest, metrics) {
+    const Polygon<T> polygon = square(1.0, -3.0, 2.0);
+    const PolygonMetrics m = polygon.metrics();
+    ASSERT_DOUBLE_EQ(4.0, m.area);
+    ASSERT_DOUBLE_EQ(8.0, m.perimeter);
+    ASSERT_DOUBLE_EQ(2.0, m.centroidX);
+    ASSERT_DOUBLE_EQ(-2.0, m.centroidY);
+    ASSERT_EQ(1, polygon.orientation());
+
+    std::vector<Point<T> > clockwise;
+    clockwise.push_back(Point<T>(0.0, 0.0));
+    clockwise.push_back(Point<T>(0.0, 3.0));
+    clockwise.push_back(Point<T>(4.0, 0.0));
+    const Polygon<T> triangle(clockwise);
+    ASSERT_DOUBLE_EQ(-6.0, triangle.signedArea());
+    ASSERT_DOUBLE_EQ(6.0, triangle.area());
+    ASSERT_DOUBLE_EQ(12.0, triangle.perimeter());
+    ASSERT_DOUBLE_EQ(4.0 / 3.0, triangle.centroid().getX());
+    ASSERT_DOUBLE_EQ(1.0, triangle.centroid().getY());
+    ASSERT_EQ(-1, triangle.orientation());
+}
+
+TEST(PolygonTest, metricsOfRegularPolygon) {
+    // Sizes around the vector width exercise the kernel tails
+    for (int n = 3; n < 40; ++n) {
+        Polygon<T> polygon;
+        const double r = 3.0, cx = 1e6, cy = -2e6;
+        for (int i = 0; i < n; ++i) {
+            const double t = 2.0 * M_PI * i / n;
+            polygon.push_back(cx + r * std::cos(t), cy + r * std::sin(t));
+        }
+        const PolygonMetrics m = polygon.metrics();
+        ASSERT_NEAR(0.5 * n * r * r * std::sin(2.0 * M_PI / n), m.area, 1e-8);
+        ASSERT_NEAR(2.0 * n * r * std::sin(M_PI / n), m.perimeter, 1e-8);
+        ASSERT_NEAR(cx, m.centroidX, 1e-8);
+        ASSERT_NEAR(cy, m.centroidY, 1e-8);
+        ASSERT_TRUE(polygon.isConvex());
+    }
+}
+
+TEST(PolygonTest, dispatchedKernelMatchesScalar) {
+    std::vector<T> xs, ys;
+    for (int i = 0; i < 37; ++i) {
+        xs.push_back(std::cos(i * 0.3) * (i % 5 + 1));
+        ys.push_back(std::sin(i * 0.7) * (i % 3 + 1));
+    }
+    double expected[4], actual[4];
+    simd::scalarKernels().edgeSums(xs.data(), ys.data(), xs.size(), 0.5, -0.25, expected);
+    simd::kernels().edgeSums(xs.data(), ys.data(), xs.size(), 0.5, -0.25, actual);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NEAR(expected[i], actual[i], 1e-12 * (1.0 + std::fabs(expected[i])));
+    }
+}
+
+TEST(PolygonTest, degenerate) {
+    Polygon<T> empty;
+    ASSERT_EQ(0.0, empty.area());
+    ASSERT_EQ(0, empty.orientation());
+    ASSERT_FALSE(empty.isConvex());
+
+    Polygon<T> segment;
+    segment.push_back(0.0, 0.0);
+    segment.push_back(4.0, 2.0);
+    ASSERT_EQ(0.0, segment.area());
+    ASSERT_DOUBLE_EQ(2.0, segment.centroid().getX());
+    ASSERT_DOUBLE_EQ(1.0, segment.centroid().getY());
+    ASSERT_DOUBLE_EQ(2.0 * std::sqrt(20.0), segment.perimeter());
+    ASSERT_FALSE(segment.isConvex());
+}
+
+TEST(PolygonTest, convexity) {
+    ASSERT_TRUE(square(0.0, 0.0, 1.0).isConvex());
+
+    // Collinear vertices are fine
+    Polygon<T> withCollinear = square(0.0, 0.0, 2.0);
+    withCollinear.push_back(0.0, 1.0);
+    ASSERT_TRUE(withCollinear.isConvex());
+
+    Polygon<T> arrow;
+    arrow.push_back(0.0, 0.0);
+    arrow.push_back(2.0, 1.0);
+    arrow.push_back(0.0, 2.0);
+    arrow.push_back(1.0, 1.0);
+    ASSERT_FALSE(arrow.isConvex());
+
+    // A repeated vertex does not hide the turn at it, wherever it falls in the ring
+    for (int start = 0; start < 6; ++start) {
+        const double xs[6] = {4.0, 4.0, 7.0, 4.0, 2.0, 4.0}, ys[6] = {6.0, 6.0, 1.0, 3.0, 5.0, 8.0};
+        Polygon<T> repeated;
+        for (int i = 0; i < 6; ++i) repeated.push_back(xs[(start + i) % 6], ys[(start + i) % 6]);
+        ASSERT_FALSE(repeated.isConvex()) << start;
+    }
+    Polygon<T> repeatedCorner = square(0.0, 0.0, 1.0);
+    repeatedCorner.push_back(0.0, 0.0);
+    ASSERT_TRUE(repeatedCorner.isConvex());
+
+    // Every turn of a pentagram goes the same way, but it winds twice
+    Polygon<T> pentagram;
+    for (int i = 0; i < 5; ++i) {
+        const double t = 4.0 * M_PI * i / 5;
+        pentagram.push_back(std::cos(t), std::sin(t));
+    }
+    ASSERT_FALSE(pentagram.isConvex());
+
+    Polygon<int> integral;
+    integral.push_back(0, 0);
+    integral.push_back(3, 0);
+    integral.push_back(0, 3);
+    ASSERT_TRUE(integral.isConvex());
+    ASSERT_DOUBLE_EQ(4.5, integral.area());
+}
+
+TEST(PolygonTest, fromHull) {
+    std::vector<Point<T> > points;
+    for (int i = 0; i < 100; ++i) {
+        points.push_back(Point<T>(T(i * 37 % 101), T(i * 53 % 89)));
+    }
+    const Polygon<T> polygon(monotoneChainHull(points).vertices());
+    ASSERT_TRUE(polygon.isConvex());
+    ASSERT_EQ(1, polygon.orientation());
+}
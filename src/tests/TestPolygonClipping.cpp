@@ -0,0 +1,356 @@
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/ConvexHull.h"
+#include "../main/PolygonClipping.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::star;
+
+typedef double T;
+
+static Polygon<T> rectangle(T x0, T y0, T x1, T y1) {
+    Polygon<T> polygon;
+    polygon.push_back(x0, y0);
+    polygon.push_back(x1, y0);
+    polygon.push_back(x1, y1);
+    polygon.push_back(x0, y1);
+    return polygon;
+}
+
+/*
+ * Adds the ring x0, y0, x1, y1, ... to polygons
+ */
+static void addRing(PolygonSet<T> &polygons, const std::vector<T> &coordinates) {
+    for (std::size_t i = 0; i + 1 < coordinates.size(); i += 2) polygons.push_back(coordinates[i], coordinates[i + 1]);
+    polygons.closeRing();
+}
+
+/*
+ * Even-odd containment, the fill rule of the inputs
+ */
+static bool inside(const PolygonSet<T> &polygons, T x, T y) {
+    bool in = false;
+    for (std::size_t r = 0; r < polygons.ringCount(); ++r) {
+        const std::size_t first = polygons.first(r), n = polygons.size(r);
+        for (std::size_t i = 0, j = n - 1; i < n; j = i++) {
+            const T xi = polygons.xs()[first + i], yi = polygons.ys()[first + i];
+            const T xj = polygons.xs()[first + j], yj = polygons.ys()[first + j];
+            if ((yi > y) != (yj > y) && x < xi + (y - yi) / (yj - yi) * (xj - xi)) in = !in;
+        }
+    }
+    return in;
+}
+
+/*
+ * Outer rings counterclockwise, holes clockwise and inside their parent
+ */
+static void expectWellFormed(const PolygonSet<T> &result) {
+    for (std::size_t r = 0; r < result.ringCount(); ++r) {
+        const double area = result.ring(r).signedArea();
+        if (result.isHole(r)) {
+            EXPECT_LT(area, 0.0) << r;
+            ASSERT_LT(std::size_t(result.parent(r)), r);
+            EXPECT_FALSE(result.isHole(std::size_t(result.parent(r))));
+        } else {
+            EXPECT_GT(area, 0.0) << r;
+        }
+    }
+}
+
+TEST(PolygonClipping, overlappingRectangles) {
+    const Polygon<T> a = rectangle(0.0, 0.0, 2.0, 2.0), b = rectangle(1.0, 1.0, 3.0, 4.0);
+    PolygonClipper<T> clipper;
+    PolygonSet<T> result;
+    clipper.clip(a, b, CLIP_INTERSECTION, result);
+    EXPECT_TRUE(clipper.convexClipped());
+    ASSERT_EQ(1u, result.ringCount());
+    EXPECT_EQ(4u, result.size(0));
+    EXPECT_DOUBLE_EQ(1.0, result.signedArea());
+
+    clipper.clip(a, b, CLIP_UNION, result);
+    EXPECT_FALSE(clipper.convexClipped());
+    ASSERT_EQ(1u, result.ringCount());
+    EXPECT_EQ(8u, result.size(0));
+    EXPECT_DOUBLE_EQ(9.0, result.signedArea());
+    clipper.clip(a, b, CLIP_DIFFERENCE, result);
+    EXPECT_DOUBLE_EQ(3.0, result.signedArea());
+    clipper.clip(b, a, CLIP_DIFFERENCE, result);
+    EXPECT_DOUBLE_EQ(5.0, result.signedArea());
+    clipper.clip(a, b, CLIP_XOR, result);
+    EXPECT_EQ(2u, result.ringCount());
+    EXPECT_DOUBLE_EQ(8.0, result.signedArea());
+    expectWellFormed(result);
+
+    // Clockwise inputs give the same results
+    PolygonSet<T> reversed;
+    for (int i = 3; i >= 0; --i) reversed.push_back(b.xs()[i], b.ys()[i]);
+    reversed.closeRing();
+    EXPECT_DOUBLE_EQ(9.0, polygonUnion(a, reversed).signedArea());
+    EXPECT_DOUBLE_EQ(1.0, polygonIntersection(reversed, a).signedArea());
+}
+
+TEST(PolygonClipping, sharedEdgesAndEqualPolygons) {
+    const Polygon<T> a = rectangle(0.0, 0.0, 1.0, 1.0), b = rectangle(1.0, 0.0, 2.0, 1.0);
+    // The shared edge disappears, and with it the split vertices
+    const PolygonSet<T> joined = polygonUnion(a, b);
+    ASSERT_EQ(1u, joined.ringCount());
+    EXPECT_EQ(4u, joined.size(0));
+    EXPECT_DOUBLE_EQ(2.0, joined.signedArea());
+    EXPECT_TRUE(polygonIntersection(a, b).empty());
+    EXPECT_DOUBLE_EQ(1.0, polygonDifference(a, b).signedArea());
+
+    const PolygonSet<T> same = polygonIntersection(a, PolygonSet<T>(a));
+    ASSERT_EQ(1u, same.ringCount());
+    EXPECT_DOUBLE_EQ(1.0, same.signedArea());
+    EXPECT_DOUBLE_EQ(1.0, polygonUnion(PolygonSet<T>(a), a).signedArea());
+    EXPECT_TRUE(polygonDifference(PolygonSet<T>(a), a).empty());
+    EXPECT_TRUE(polygonXor(PolygonSet<T>(a), a).empty());
+
+    // Partly overlapping edges
+    const Polygon<T> c = rectangle(0.5, 1.0, 1.5, 2.0);
+    const PolygonSet<T> merged = polygonUnion(PolygonSet<T>(a), c);
+    ASSERT_EQ(1u, merged.ringCount());
+    EXPECT_EQ(8u, merged.size(0));
+    EXPECT_DOUBLE_EQ(2.0, merged.signedArea());
+}
+
+TEST(PolygonClipping, vertexOnEdge) {
+    // A vertex of b on the bottom edge of a, and an edge of b ending inside a
+    PolygonSet<T> a, b;
+    addRing(a, {1.0, 0.0, 5.0, 0.0, 3.0, 6.0});
+    addRing(b, {3.0, 1.0, 3.0, 0.0, 5.0, 6.0});
+    PolygonClipper<T> clipper;
+    PolygonSet<T> result;
+    const ClipOperation operations[4] = {CLIP_INTERSECTION, CLIP_UNION, CLIP_DIFFERENCE, CLIP_XOR};
+    const double areas[4] = {8.0 / 11.0, 135.0 / 11.0, 124.0 / 11.0, 127.0 / 11.0};
+    for (int k = 0; k < 4; ++k) {
+        clipper.clip(a, b, operations[k], result);
+        expectWellFormed(result);
+        EXPECT_NEAR(areas[k], result.signedArea(), 1e-12) << k;
+    }
+}
+
+TEST(PolygonClipping, degenerateRings) {
+    // Rings of zero area and repeated vertices once split the same edges over and over
+    PolygonSet<T> a, b;
+    addRing(a, {7.0, 6.0, 0.0, 2.0, 0.0, 2.0});
+    addRing(b, {5.0, 6.0, 0.0, 5.0, 5.0, 6.0});
+    addRing(b, {1.0, 5.0, 5.0, 7.0, 6.0, 6.0});
+    const PolygonSet<T> joined = polygonUnion(a, b);
+    expectWellFormed(joined);
+    EXPECT_NEAR(3.0, joined.signedArea(), 1e-12);
+    EXPECT_TRUE(polygonIntersection(a, b).empty());
+
+    // The same edge twice in one ring cancels, in both directions
+    PolygonSet<T> c, d;
+    addRing(c, {8.0, 7.0, 0.0, 5.0, 5.0, 3.0});
+    addRing(d, {0.0, 3.0, 2.0, 1.0, 5.0, 4.0, 0.0, 3.0, 5.0, 1.0});
+    const PolygonSet<T> both = polygonUnion(c, d);
+    expectWellFormed(both);
+    ASSERT_EQ(1u, both.ringCount());
+    EXPECT_NEAR(13.0 + 6.0 - 10.0 / 21.0, both.signedArea(), 1e-12);
+    EXPECT_NEAR(10.0 / 21.0, polygonIntersection(c, d).signedArea(), 1e-12);
+}
+
+TEST(PolygonClipping, emptyAndDisjoint) {
+    const Polygon<T> a = rectangle(0.0, 0.0, 1.0, 1.0), b = rectangle(5.0, 5.0, 6.0, 7.0);
+    const Polygon<T> none;
+    EXPECT_TRUE(polygonIntersection(a, b).empty());
+    EXPECT_TRUE(polygonIntersection(a, none).empty());
+    EXPECT_TRUE(polygonDifference(none, a).empty());
+    EXPECT_DOUBLE_EQ(1.0, polygonDifference(a, none).signedArea());
+    EXPECT_DOUBLE_EQ(1.0, polygonDifference(a, b).signedArea());
+    EXPECT_DOUBLE_EQ(1.0, polygonUnion(none, a).signedArea());
+    const PolygonSet<T> both = polygonUnion(a, b);
+    EXPECT_EQ(2u, both.ringCount());
+    EXPECT_DOUBLE_EQ(3.0, both.signedArea());
+    EXPECT_DOUBLE_EQ(3.0, polygonXor(a, b).signedArea());
+    // Touching at a corner only
+    EXPECT_TRUE(polygonIntersection(a, rectangle(1.0, 1.0, 2.0, 2.0)).empty());
+}
+
+TEST(PolygonClipping, holes) {
+    // A 4 x 4 square with a 2 x 2 hole, given in either orientation
+    PolygonSet<T> frame;
+    frame.addRing(rectangle(0.0, 0.0, 4.0, 4.0));
+    frame.addRing(rectangle(1.0, 1.0, 3.0, 3.0));
+    const Polygon<T> band = rectangle(-1.0, 1.5, 5.0, 2.5);
+
+    const PolygonSet<T> cut = polygonIntersection(frame, band);
+    EXPECT_EQ(2u, cut.ringCount());
+    EXPECT_DOUBLE_EQ(2.0, cut.signedArea());
+    const PolygonSet<T> rest = polygonDifference(frame, band);
+    EXPECT_DOUBLE_EQ(10.0, rest.signedArea());
+    expectWellFormed(rest);
+
+    // Filling the hole leaves one ring, a smaller patch leaves a hole of its own
+    EXPECT_EQ(1u, polygonUnion(frame, rectangle(0.5, 0.5, 3.5, 3.5)).ringCount());
+    const PolygonSet<T> patched = polygonUnion(frame, rectangle(1.5, 1.5, 2.5, 2.5));
+    ASSERT_EQ(3u, patched.ringCount());
+    EXPECT_DOUBLE_EQ(13.0, patched.signedArea());
+    expectWellFormed(patched);
+
+    // Four bars make a frame: the union has a hole whose parent is the outer ring
+    PolygonSet<T> left, right;
+    left.addRing(rectangle(0.0, 0.0, 1.0, 4.0));
+    left.addRing(rectangle(1.0, 3.0, 4.0, 4.0));
+    right.addRing(rectangle(3.0, 0.0, 4.0, 3.0));
+    right.addRing(rectangle(1.0, 0.0, 3.0, 1.0));
+    PolygonClipper<T> clipper;
+    PolygonSet<T> result;
+    clipper.clip(left, right, CLIP_UNION, result);
+    ASSERT_EQ(2u, result.ringCount());
+    EXPECT_DOUBLE_EQ(12.0, result.signedArea());
+    expectWellFormed(result);
+    EXPECT_TRUE(result.isHole(1));
+    EXPECT_EQ(0, result.parent(1));
+}
+
+TEST(PolygonClipping, convexMatchesSweep) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<T> coordinate(-10.0, 10.0);
+    PolygonClipper<T> clipper;
+    PolygonSet<T> intersection, difference;
+    for (int round = 0; round < 200; ++round) {
+        std::vector<PackedPoint<T> > pa, pb;
+        for (int i = 0; i < 12; ++i) pa.push_back(PackedPoint<T>(coordinate(gen), coordinate(gen)));
+        for (int i = 0; i < 12; ++i) pb.push_back(PackedPoint<T>(coordinate(gen) + 5.0, coordinate(gen)));
+        const Polygon<T> a(monotoneChainHull(pa).vertices()), b(monotoneChainHull(pb).vertices());
+        clipper.clip(a, b, CLIP_INTERSECTION, intersection);
+        ASSERT_TRUE(clipper.convexClipped());
+        expectWellFormed(intersection);
+        EXPECT_LE(intersection.ringCount(), 1u);
+        // a and b is a without (a without b), which takes the sweep
+        clipper.clip(a, b, CLIP_DIFFERENCE, difference);
+        ASSERT_FALSE(clipper.convexClipped());
+        EXPECT_NEAR(a.area() - difference.signedArea(), intersection.signedArea(), 1e-9 * a.area()) << round;
+    }
+}
+
+TEST(PolygonClipping, randomPolygons) {
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<T> unit(0.0, 1.0);
+    PolygonClipper<T> clipper;
+    PolygonSet<T> results[4];
+    const ClipOperation operations[4] = {CLIP_INTERSECTION, CLIP_UNION, CLIP_DIFFERENCE, CLIP_XOR};
+    for (int round = 0; round < 100; ++round) {
+        // A polygon with a hole against a concave polygon
+        PolygonSet<T> a, b;
+        a.addRing(star(gen, 20, 0.0, 0.0, 10.0));
+        a.addRing(star(gen, 8, 0.0, 0.0, 1.5));
+        b.addRing(star(gen, 30, 4.0 * unit(gen), 4.0 * unit(gen), 8.0));
+        for (int k = 0; k < 4; ++k) {
+            clipper.clip(a, b, operations[k], results[k]);
+            expectWellFormed(results[k]);
+        }
+        // The hole need not lie inside the outer ring, so only b has a known area
+        const double areaB = b.ring(0).area(), both = results[0].signedArea(), either = results[1].signedArea();
+        EXPECT_NEAR(results[2].signedArea() + areaB, either, 1e-9 * either) << round;
+        EXPECT_NEAR(either - both, results[3].signedArea(), 1e-9 * either) << round;
+
+        // Points away from the edges are in each result exactly when the operation says so
+        for (int s = 0; s < 200; ++s) {
+            const T x = -12.0 + 24.0 * unit(gen), y = -12.0 + 24.0 * unit(gen);
+            const bool inA = inside(a, x, y), inB = inside(b, x, y);
+            const bool expected[4] = {inA && inB, inA || inB, inA && !inB, inA != inB};
+            for (int k = 0; k < 4; ++k) EXPECT_EQ(expected[k], inside(results[k], x, y)) << round << " " << k;
+        }
+    }
+}
+
+TEST(PolygonClipping, integerGrid) {
+    // Small integer coordinates make vertices on edges, overlapping edges and many edges through
+    // one point, compared with even-odd containment at random points
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> coordinate(0, 6);
+    std::uniform_real_distribution<T> unit(0.0, 6.0);
+    PolygonClipper<T> clipper;
+    PolygonSet<T> results[4];
+    const ClipOperation operations[4] = {CLIP_INTERSECTION, CLIP_UNION, CLIP_DIFFERENCE, CLIP_XOR};
+    for (int round = 0; round < 300; ++round) {
+        PolygonSet<T> a, b;
+        for (PolygonSet<T> *polygons : {&a, &b}) {
+            for (int r = 0, rings = 1 + round % 2; r < rings; ++r) {
+                for (int i = 0, n = 3 + int(gen() % 5); i < n; ++i) polygons->push_back(coordinate(gen), coordinate(gen));
+                polygons->closeRing();
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            clipper.clip(a, b, operations[k], results[k]);
+            expectWellFormed(results[k]);
+        }
+        EXPECT_NEAR(results[1].signedArea(), results[0].signedArea() + results[3].signedArea(), 1e-9) << round;
+        for (int s = 0; s < 100; ++s) {
+            const T x = unit(gen), y = unit(gen);
+            const bool inA = inside(a, x, y), inB = inside(b, x, y);
+            const bool expected[4] = {inA && inB, inA || inB, inA && !inB, inA != inB};
+            for (int k = 0; k < 4; ++k) EXPECT_EQ(expected[k], inside(results[k], x, y)) << round << " " << k;
+        }
+    }
+}
+
+TEST(PolygonClipping, decimalGrid) {
+    // The integer grid scaled by 0.1 and moved away from the origin: points that are one point
+    // exactly come out a unit in the last place apart, and parts of edges that short point anywhere
+    const ClipOperation operations[4] = {CLIP_INTERSECTION, CLIP_UNION, CLIP_DIFFERENCE, CLIP_XOR};
+    const auto decimal = [](const PolygonSet<T> &polygons) {
+        PolygonSet<T> moved;
+        for (std::size_t r = 0; r < polygons.ringCount(); ++r) {
+            for (std::size_t i = polygons.first(r); i < polygons.first(r) + polygons.size(r); ++i) {
+                moved.push_back(polygons.xs()[i] * 0.1 + 1000.3, polygons.ys()[i] * 0.1 - 77.7);
+            }
+            moved.closeRing();
+        }
+        return moved;
+    };
+    PolygonClipper<T> clipper;
+    PolygonSet<T> exact, rounded;
+
+    // Each of these lost or gained a sliver of the area
+    PolygonSet<T> a, b, c, d;
+    addRing(a, {3, 8, 3, 1, 2, 3, 4, 0});
+    addRing(a, {7, 2, 2, 1, 6, 3});
+    addRing(b, {3, 0, 8, 4, 4, 7, 3, 7, 6, 4});
+    addRing(b, {0, 7, 1, 4, 0, 0});
+    addRing(c, {2, 0, 4, 6, 7, 5, 2, 6, 5, 1});
+    addRing(c, {4, 0, 2, 2, 2, 1, 5, 0});
+    addRing(d, {4, 1, 1, 1, 5, 5, 3, 4, 3, 1});
+    addRing(d, {3, 2, 8, 0, 3, 8, 3, 8});
+    for (int k = 0; k < 4; ++k) {
+        clipper.clip(a, b, operations[k], exact);
+        clipper.clip(decimal(a), decimal(b), operations[k], rounded);
+        EXPECT_NEAR(0.01 * exact.signedArea(), rounded.signedArea(), 1e-9) << k;
+        clipper.clip(c, d, operations[k], exact);
+        clipper.clip(decimal(c), decimal(d), operations[k], rounded);
+        EXPECT_NEAR(0.01 * exact.signedArea(), rounded.signedArea(), 1e-9) << k;
+    }
+
+    // Either the area of the exact clip or an exception, and the exception only rarely
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> coordinate(0, 8);
+    int thrown = 0;
+    for (int round = 0; round < 500; ++round) {
+        PolygonSet<T> p, q;
+        for (PolygonSet<T> *polygons : {&p, &q}) {
+            for (int r = 0, rings = 1 + round % 2; r < rings; ++r) {
+                for (int i = 0, n = 3 + int(gen() % 4); i < n; ++i) polygons->push_back(coordinate(gen), coordinate(gen));
+                polygons->closeRing();
+            }
+        }
+        const PolygonSet<T> movedP = decimal(p), movedQ = decimal(q);
+        for (int k = 0; k < 4; ++k) {
+            clipper.clip(p, q, operations[k], exact);
+            try {
+                clipper.clip(movedP, movedQ, operations[k], rounded);
+            } catch (const PolygonClippingRoundingException &) {
+                ++thrown;
+                continue;
+            }
+            expectWellFormed(rounded);
+            EXPECT_NEAR(0.01 * exact.signedArea(), rounded.signedArea(), 1e-9) << round << " " << k;
+        }
+    }
+    EXPECT_LT(thrown, 20);
+}
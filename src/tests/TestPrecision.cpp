@@ -0,0 +1,86 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/Point.h"
+#include "../main/PackedPoint.h"
+#include "../main/Precision.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static std::vector<Point<T> > circlePoints(std::size_t n, T radius) {
+    std::vector<Point<T> > points;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double t = -M_PI + 2.0 * M_PI * double(i) / double(n);
+        points.push_back(Point<T>(radius * std::cos(t), radius * std::sin(t)));
+    }
+    return points;
+}
+
+TEST(PrecisionTest, exactMatchesPoint) {
+    const Point<T> p(3.5, -1.25), q(-2.0, 7.0);
+    ASSERT_EQ(p.length(), length<ExactPrecision>(p));
+    ASSERT_EQ(p | q, distance<ExactPrecision>(p, q));
+    ASSERT_EQ(p.angle(), angle<ExactPrecision>(p));
+    ASSERT_EQ(p.angle(q), angle<ExactPrecision>(p, q));
+}
+
+TEST(PrecisionTest, fastLengthError) {
+    for (double radius = 1e-3; radius < 1e12; radius *= 7.0) {
+        for (const Point<T> &p : circlePoints(1000, radius)) {
+            const double exact = length<ExactPrecision>(p);
+            ASSERT_NEAR(exact, length<FastPrecision>(p), 4 * exact * std::numeric_limits<double>::epsilon());
+        }
+    }
+}
+
+TEST(PrecisionTest, approxAngleError) {
+    for (double radius = 1e-3; radius < 1e12; radius *= 7.0) {
+        for (const Point<T> &p : circlePoints(10007, radius)) {
+            ASSERT_NEAR(angle<ExactPrecision>(p), angle<ApproxPrecision>(p), APPROX_ATAN2_MAX_ERROR);
+        }
+    }
+    ASSERT_EQ(0.0, approxAtan2(0.0, 0.0));
+    ASSERT_NEAR(M_PI, approxAtan2(0.0, -1.0), APPROX_ATAN2_MAX_ERROR);
+    ASSERT_NEAR(M_PI / 2, approxAtan2(1.0, 0.0), APPROX_ATAN2_MAX_ERROR);
+    ASSERT_NEAR(-M_PI / 2, approxAtan2(-1.0, 0.0), APPROX_ATAN2_MAX_ERROR);
+}
+
+TEST(PrecisionTest, squaredLengthOrdersLikeLength) {
+    const PackedPoint<T> p(3.0, 4.0), q(-1.0, 2.0);
+    ASSERT_EQ(25.0, p.squaredLength());
+    ASSERT_EQ(25.0, Point<T>(3.0, 4.0).squaredLength());
+    ASSERT_EQ(20.0, squaredDistance(p, q));
+    ASSERT_EQ(7 * 7 + 12 * 12, squaredLength(PackedPoint<int>(-7, 12)));
+
+    std::vector<Point<T> > points = circlePoints(50, 1.0);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = points[i] * (1.0 + double(i * 37 % 50));
+    }
+    for (const Point<T> &a : points) {
+        for (const Point<T> &b : points) {
+            ASSERT_EQ(a.length() < b.length(), a.squaredLength() < b.squaredLength());
+        }
+    }
+}
+
+TEST(PrecisionTest, pseudoAngleOrdersLikeAngle) {
+    const std::vector<Point<T> > points = circlePoints(997, 3.0);
+    for (std::size_t i = 1; i < points.size(); ++i) {
+        ASSERT_LT(points[i - 1].pseudoAngle(), points[i].pseudoAngle());
+        ASSERT_LT(pseudoAngle(points[i - 1]), pseudoAngle(points[i]));
+    }
+    ASSERT_EQ(0.0, PackedPoint<T>(5.0, 0.0).pseudoAngle());
+    ASSERT_EQ(1.0, PackedPoint<T>(0.0, 5.0).pseudoAngle());
+    ASSERT_EQ(2.0, PackedPoint<T>(-5.0, 0.0).pseudoAngle());
+    ASSERT_EQ(-1.0, PackedPoint<T>(0.0, -5.0).pseudoAngle());
+    ASSERT_EQ(0.0, PackedPoint<T>().pseudoAngle());
+    // The negative x axis is 2 for y = -0.0 as well, the range stays (-2, 2]
+    ASSERT_EQ(2.0, pseudoAtan2(-0.0, -5.0));
+    ASSERT_EQ(0.0, pseudoAtan2(-0.0, 5.0));
+
+    const PackedPoint<T> center(1.0, 1.0);
+    ASSERT_EQ(1.0, pseudoAngle(PackedPoint<T>(1.0, 4.0), center));
+}
@@ -0,0 +1,114 @@
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/PackedPoint.h"
+#include "../main/Point.h"
+#include "../main/Predicates.h"
+
+using namespace graph_algo;
+
+typedef double T;
+
+static int sign(double v) {
+    return (v > 0.0) - (v < 0.0);
+}
+
+// The exact references need a 128 bit integer, the checks against them are left out without one
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 Exact;
+
+static int sign(Exact v) {
+    return (v > 0) - (v < 0);
+}
+
+/*
+ * Exact orientation for coordinates that are integers times 2^-53 below 2^5
+ */
+static int exactOrient(const Point<T> &a, const Point<T> &b, const Point<T> &c) {
+    const double s = std::ldexp(1.0, 53);
+    const Exact acx = Exact(a.getX() * s) - Exact(c.getX() * s), acy = Exact(a.getY() * s) - Exact(c.getY() * s);
+    const Exact bcx = Exact(b.getX() * s) - Exact(c.getX() * s), bcy = Exact(b.getY() * s) - Exact(c.getY() * s);
+    return sign(acx * bcy - acy * bcx);
+}
+
+/*
+ * Exact incircle for integer coordinates below 2^25
+ */
+static int exactIncircle(const Point<T> &a, const Point<T> &b, const Point<T> &c, const Point<T> &d) {
+    const Exact adx = Exact(a.getX() - d.getX()), ady = Exact(a.getY() - d.getY());
+    const Exact bdx = Exact(b.getX() - d.getX()), bdy = Exact(b.getY() - d.getY());
+    const Exact cdx = Exact(c.getX() - d.getX()), cdy = Exact(c.getY() - d.getY());
+    return sign((adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) +
+                (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+                (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady));
+}
+#endif
+
+TEST(PredicatesTest, orient2dSimple) {
+    const Point<T> a(0.0, 0.0), b(1.0, 0.0), c(0.0, 1.0), d(2.0, 0.0);
+    ASSERT_GT(orient2d(a, b, c), 0.0);
+    ASSERT_LT(orient2d(a, c, b), 0.0);
+    ASSERT_EQ(0.0, orient2d(a, b, d));
+    ASSERT_EQ(-((a - c) & (b - c)), -orient2d(a, b, c));
+    ASSERT_GT(orient2d(PackedPoint<T>(0.0, 0.0), PackedPoint<T>(1.0, 0.0), PackedPoint<T>(0.0, 1.0)), 0.0);
+}
+
+TEST(PredicatesTest, orient2dNearlyCollinear) {
+    // Shewchuk's classic failure case for the naive cross product
+    const Point<T> b(12.0, 12.0), c(24.0, 24.0);
+    const double ulp = std::ldexp(1.0, -53);
+    int filterMisses = 0;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            const Point<T> a(0.5 + i * ulp, 0.5 + j * ulp);
+#if defined(__SIZEOF_INT128__)
+            ASSERT_EQ(exactOrient(a, b, c), sign(orient2d(a, b, c))) << i << " " << j;
+            ASSERT_EQ(-exactOrient(a, b, c), sign(orient2d(a, c, b))) << i << " " << j;
+#endif
+            ASSERT_EQ(-sign(orient2d(a, b, c)), sign(orient2d(a, c, b))) << i << " " << j;
+            filterMisses += !orient2dFilter(a, b, c);
+        }
+    }
+    ASSERT_GT(filterMisses, 0);
+}
+
+TEST(PredicatesTest, incircleSimple) {
+    const Point<T> a(1.0, 0.0), b(0.0, 1.0), c(-1.0, 0.0);
+    ASSERT_GT(incircle(a, b, c, Point<T>(0.0, 0.0)), 0.0);
+    ASSERT_LT(incircle(a, b, c, Point<T>(2.0, 2.0)), 0.0);
+    ASSERT_EQ(0.0, incircle(a, b, c, Point<T>(0.0, -1.0)));
+    ASSERT_LT(incircle(a, c, b, Point<T>(0.0, 0.0)), 0.0);
+}
+
+TEST(PredicatesTest, incircleNearlyCocircular) {
+    // Integer points on a circle of radius 5 * 2^22, far from the origin, perturbed by one unit
+    const double k = std::ldexp(1.0, 22), cx = 3.0 * k, cy = -2.0 * k;
+    const Point<T> a(cx + 5 * k, cy), b(cx + 3 * k, cy + 4 * k), c(cx - 4 * k, cy + 3 * k);
+    const double dxs[] = {0.0, -4 * k, 4 * k, 3 * k};
+    const double dys[] = {-5 * k, -3 * k, -3 * k, -4 * k};
+    int filterMisses = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int px = -2; px <= 2; ++px) {
+            for (int py = -2; py <= 2; ++py) {
+                const Point<T> d(cx + dxs[i] + px, cy + dys[i] + py);
+#if defined(__SIZEOF_INT128__)
+                ASSERT_EQ(exactIncircle(a, b, c, d), sign(incircle(a, b, c, d))) << i << " " << px << " " << py;
+                ASSERT_EQ(-exactIncircle(a, b, c, d), sign(incircle(b, a, c, d)));
+#endif
+                ASSERT_EQ(-sign(incircle(a, b, c, d)), sign(incircle(b, a, c, d)));
+                filterMisses += !incircleFilter(a, b, c, d);
+            }
+        }
+    }
+    ASSERT_GT(filterMisses, 0);
+}
+
+TEST(PredicatesTest, incircleInexactDifferences) {
+    // d.x - a.x does not fit a double, which forces the exact fallback
+    const double e = std::ldexp(1.0, -60), ulp = std::ldexp(1.0, -53);
+    const Point<T> a(1.0, 0.0), b(0.0, 1.0), c(-1.0, 0.0);
+    ASSERT_LT(incircle(a, b, c, Point<T>(e, -1.0)), 0.0);
+    ASSERT_GT(incircle(a, b, c, Point<T>(e, -1.0 + ulp)), 0.0);
+    ASSERT_GT(incircle(a, b, c, Point<T>(-e, -1.0 + ulp)), 0.0);
+    ASSERT_LT(incircle(a, b, c, Point<T>(-e, -1.0)), 0.0);
+}
@@ -0,0 +1,135 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/PackedPoint.h"
+#include "../main/RingBuffer.h"
+
+using namespace graph_algo;
+
+template<class Queue>
+static void fillAndDrain() {
+    Queue queue;
+    ASSERT_TRUE(queue.empty());
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_TRUE(queue.tryPush(round * 10 + i));
+        }
+        ASSERT_FALSE(queue.tryPush(99));
+        ASSERT_EQ(8u, queue.size());
+        int value;
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_TRUE(queue.tryPop(value));
+            ASSERT_EQ(round * 10 + i, value);
+        }
+        ASSERT_FALSE(queue.tryPop(value));
+        ASSERT_TRUE(queue.empty());
+    }
+}
+
+template<class Queue>
+static void batches() {
+    Queue queue;
+    const int items[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    ASSERT_EQ(5u, queue.tryPushBatch(items, 5));
+    ASSERT_EQ(3u, queue.tryPushBatch(items + 5, 5));
+    ASSERT_EQ(0u, queue.tryPushBatch(items, 1));
+
+    int out[10];
+    ASSERT_EQ(6u, queue.tryPopBatch(out, 6));
+    for (int i = 0; i < 6; ++i) ASSERT_EQ(i + 1, out[i]);
+    ASSERT_EQ(6u, queue.tryPushBatch(items, 10));
+    ASSERT_EQ(8u, queue.tryPopBatch(out, 10));
+    ASSERT_EQ(7, out[0]);
+    ASSERT_EQ(8, out[1]);
+    ASSERT_EQ(1, out[2]);
+    ASSERT_EQ(6, out[7]);
+    ASSERT_EQ(0u, queue.tryPopBatch(out, 10));
+}
+
+TEST(RingBufferTest, spscFillAndDrain) {
+    fillAndDrain<SpscRingBuffer<int, 8> >();
+}
+
+TEST(RingBufferTest, mpmcFillAndDrain) {
+    fillAndDrain<MpmcRingBuffer<int, 8> >();
+}
+
+TEST(RingBufferTest, spscBatches) {
+    batches<SpscRingBuffer<int, 8> >();
+}
+
+TEST(RingBufferTest, mpmcBatches) {
+    batches<MpmcRingBuffer<int, 8> >();
+}
+
+TEST(RingBufferTest, spscAcrossThreadsKeepsOrder) {
+    const int count = 200000;
+    SpscRingBuffer<PackedPoint<int>, 256> queue;
+    std::thread producer([&queue, count]() {
+        for (int i = 0; i < count;) {
+            if (queue.tryPush(PackedPoint<int>(i, -i))) ++i;
+            else std::this_thread::yield();
+        }
+    });
+    PackedPoint<int> batch[32];
+    int expected = 0;
+    while (expected < count) {
+        const std::size_t n = queue.tryPopBatch(batch, 32);
+        if (n == 0) std::this_thread::yield();
+        for (std::size_t i = 0; i < n; ++i, ++expected) {
+            ASSERT_EQ(expected, batch[i].getX());
+            ASSERT_EQ(-expected, batch[i].getY());
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(RingBufferTest, mpmcAcrossThreadsDeliversEveryItemOnce) {
+    const int producers = 3, consumers = 3, perProducer = 50000;
+    MpmcRingBuffer<int, 128> queue;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<int> > received(consumers);
+    std::atomic<int> remaining(producers * perProducer);
+
+    for (int p = 0; p < producers; ++p) {
+        threads.push_back(std::thread([&queue, p, perProducer]() {
+            int items[4];
+            for (int i = 0; i < perProducer;) {
+                int n = 0;
+                for (; n < 4 && i + n < perProducer; ++n) items[n] = p * perProducer + i + n;
+                const std::size_t pushed = queue.tryPushBatch(items, n);
+                if (pushed == 0) std::this_thread::yield();
+                i += int(pushed);
+            }
+        }));
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.push_back(std::thread([&queue, &received, &remaining, c]() {
+            int items[8];
+            while (remaining.load() > 0) {
+                const std::size_t n = queue.tryPopBatch(items, 8);
+                if (n == 0) std::this_thread::yield();
+                received[c].insert(received[c].end(), items, items + n);
+                remaining -= int(n);
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t) threads[t].join();
+
+    std::vector<int> seen(producers * perProducer, 0);
+    for (int c = 0; c < consumers; ++c) {
+        int last[producers] = {-1, -1, -1};
+        for (std::size_t i = 0; i < received[c].size(); ++i) {
+            const int v = received[c][i];
+            ++seen[v];
+            // One consumer sees the items of one producer in order
+            ASSERT_GT(v, last[v / perProducer]);
+            last[v / perProducer] = v;
+        }
+    }
+    for (std::size_t i = 0; i < seen.size(); ++i) {
+        ASSERT_EQ(1, seen[i]) << i;
+    }
+    ASSERT_TRUE(queue.empty());
+}
@@ -1,6 +1,7 @@
 #include "../main/RingIndex.h"
 #include <iostream>
 #include <typeinfo>
+#include <utility>
 #include <gtest/gtest.h>
 
 using namespace graph_algo;
@@ -410,3 +411,98 @@ TEST(RingIndexTest, setHigerSize) {
     ASSERT_EQ(42, ringIndex.size());
     ASSERT_EQ(7, ringIndex);
 }
+
+TEST(RingIndexTest, SubtractionOfWholeRings) {
+    RingIndex<> ringIndex(4, 10);
+    ASSERT_EQ(4, ringIndex - 20);
+    ASSERT_EQ(0, ringIndex - 14);
+    ASSERT_EQ(8, ringIndex + -6);
+    ASSERT_EQ(0, ringIndex + -14);
+
+    ringIndex = -20;
+    ASSERT_EQ(0, ringIndex);
+}
+
+TEST(RingIndexTest, FixedSizeFootprint) {
+    ASSERT_EQ(2 * sizeof(int), sizeof(RingIndex<>));
+    ASSERT_EQ(sizeof(int), sizeof(RingIndex<int, 10>));
+    ASSERT_EQ(sizeof(int), sizeof(RingIndex<int, 16>));
+    ASSERT_EQ(10, (RingIndex<int, 10>::size()));
+}
+
+TEST(RingIndexTest, FixedSizeMatchesDynamic) {
+    // 10 takes the conditional subtract path, 16 the mask path
+    RingIndex<> dynamic10(0, 10), dynamic16(0, 16);
+    RingIndex<int, 10> fixed10;
+    RingIndex<int, 16> fixed16;
+    for (int step = -40; step <= 40; ++step) {
+        for (int i = 0; i < 10; ++i) {
+            dynamic10 = i;
+            fixed10 = i;
+            ASSERT_EQ(dynamic10 + step, fixed10 + step) << i << " " << step;
+            ASSERT_EQ(dynamic10 - step, fixed10 - step) << i << " " << step;
+        }
+        for (int i = 0; i < 16; ++i) {
+            dynamic16 = i;
+            fixed16 = i;
+            ASSERT_EQ(dynamic16 + step, fixed16 + step) << i << " " << step;
+            ASSERT_EQ(dynamic16 - step, fixed16 - step) << i << " " << step;
+        }
+        fixed10 = step;
+        dynamic10 = step;
+        ASSERT_EQ(int(dynamic10), int(fixed10));
+        fixed16 = step;
+        dynamic16 = step;
+        ASSERT_EQ(int(dynamic16), int(fixed16));
+    }
+}
+
+TEST(RingIndexTest, FixedSizeIncrementDecrement) {
+    RingIndex<int, 10> ringIndex(8);
+    ASSERT_EQ(9, ++ringIndex);
+    ASSERT_EQ(0, ++ringIndex);
+    ASSERT_EQ(0, ringIndex--);
+    ASSERT_EQ(9, ringIndex);
+
+    RingIndex<int, 8> masked(7);
+    ASSERT_EQ(7, masked++);
+    ASSERT_EQ(0, masked);
+    ASSERT_EQ(7, --masked);
+    ASSERT_TRUE(masked > 6);
+    ASSERT_TRUE(masked == 7);
+}
+
+TEST(RingIndexTest, FixedSizeShouldThrowOutsideRing) {
+    ASSERT_THROW((RingIndex<int, 10>(10)), RingIndexOutOfBoundException);
+    ASSERT_THROW((RingIndex<int, 10>(-1)), RingIndexOutOfBoundException);
+}
+
+/*
+ * The neighbours of every vertex of a ring of N, computed by the compiler
+ */
+template<int N>
+struct NeighbourTable {
+    int previous[N];
+    int next[N];
+
+    constexpr NeighbourTable() : previous(), next() {
+        RingIndex<int, N> i;
+        for (int k = 0; k < N; ++k, ++i) {
+            previous[k] = i - 1;
+            next[k] = i + 1;
+        }
+    }
+};
+
+TEST(RingIndexTest, ConstantExpressions) {
+    constexpr NeighbourTable<6> six;
+    static_assert(six.previous[0] == 5 && six.next[5] == 0 && six.next[2] == 3, "wrapped at compile time");
+    constexpr NeighbourTable<8> eight;
+    static_assert(eight.previous[0] == 7 && eight.next[7] == 0, "masked at compile time");
+
+    constexpr RingIndex<> dynamic(3, 5);
+    static_assert(dynamic + 4 == 2 && dynamic - 9 == 4 && dynamic.size() == 5, "dynamic ring");
+    static_assert(RingIndex<int, 5>(4) + 1 == 0, "fixed ring");
+    static_assert(noexcept(dynamic + 1) && noexcept(++std::declval<RingIndex<int, 5> &>()), "no checks after construction");
+    ASSERT_EQ(5, six.previous[0]);
+}
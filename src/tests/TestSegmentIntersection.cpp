@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/SegmentIntersection.h"
+
+using namespace graph_algo;
+
+typedef std::vector<std::pair<std::uint32_t, std::uint32_t> > Pairs;
+
+static bool between(const PackedPoint<double> &a, const PackedPoint<double> &b, const PackedPoint<double> &p) {
+    return std::min(a.getX(), b.getX()) <= p.getX() && p.getX() <= std::max(a.getX(), b.getX()) &&
+           std::min(a.getY(), b.getY()) <= p.getY() && p.getY() <= std::max(a.getY(), b.getY());
+}
+
+/*
+ * Every pair tested against every other
+ */
+template<class T>
+static Pairs bruteForce(const PointBuffer<T> &endpoints) {
+    Pairs pairs;
+    for (std::uint32_t a = 0; a < endpoints.size() / 2; ++a) {
+        for (std::uint32_t b = a + 1; b < endpoints.size() / 2; ++b) {
+            const PackedPoint<double> a0(endpoints.xs()[2 * a], endpoints.ys()[2 * a]);
+            const PackedPoint<double> a1(endpoints.xs()[2 * a + 1], endpoints.ys()[2 * a + 1]);
+            const PackedPoint<double> b0(endpoints.xs()[2 * b], endpoints.ys()[2 * b]);
+            const PackedPoint<double> b1(endpoints.xs()[2 * b + 1], endpoints.ys()[2 * b + 1]);
+            const double o1 = orient2d(a0, a1, b0), o2 = orient2d(a0, a1, b1);
+            const double o3 = orient2d(b0, b1, a0), o4 = orient2d(b0, b1, a1);
+            bool meet = ((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0)) &&
+                        ((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0));
+            meet = meet || (o1 == 0.0 && between(a0, a1, b0)) || (o2 == 0.0 && between(a0, a1, b1)) ||
+                   (o3 == 0.0 && between(b0, b1, a0)) || (o4 == 0.0 && between(b0, b1, a1));
+            if (meet) pairs.push_back(std::make_pair(a, b));
+        }
+    }
+    return pairs;
+}
+
+TEST(SegmentIntersection, smallCases) {
+    PointBuffer<double> endpoints;
+    // 0 and 1 cross, 2 touches 0 and 3 with its end and 1 ends on it, 3 overlaps 0, 4 is a point on 1, 5 is apart
+    endpoints.push_back(0.0, 0.0);
+    endpoints.push_back(4.0, 0.0);
+    endpoints.push_back(1.0, -1.0);
+    endpoints.push_back(3.0, 1.0);
+    endpoints.push_back(3.0, 2.0);
+    endpoints.push_back(3.0, 0.0);
+    endpoints.push_back(6.0, 0.0);
+    endpoints.push_back(2.5, 0.0);
+    endpoints.push_back(1.5, -0.5);
+    endpoints.push_back(1.5, -0.5);
+    endpoints.push_back(0.0, 5.0);
+    endpoints.push_back(1.0, 6.0);
+    const Pairs expected = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 4}, {2, 3}};
+    EXPECT_EQ(expected, bruteForce(endpoints));
+    EXPECT_EQ(expected, segmentIntersections(endpoints));
+
+    // Vertical segments, and several segments through one point
+    PointBuffer<double> star;
+    for (int i = 0; i < 4; ++i) {
+        star.push_back(-1.0 + i * 0.5, -1.0);
+        star.push_back(1.0 - i * 0.5, 1.0);
+    }
+    star.push_back(0.0, -2.0);
+    star.push_back(0.0, 0.5);
+    EXPECT_EQ(10u, segmentIntersections(star).size());
+    EXPECT_EQ(bruteForce(star), segmentIntersections(star));
+    EXPECT_TRUE(segmentIntersections(PointBuffer<double>()).empty());
+
+    // 3 ends on 0 after 0 crossed 1 and 2, which overlap, at a rounded point
+    PointBuffer<double> overlap;
+    const double ends[] = {4, 0, 2, 4, 0, 4, 4, 2, 2, 3, 4, 2, 1, 3, 3, 2};
+    for (int i = 0; i < 8; ++i) overlap.push_back(ends[2 * i], ends[2 * i + 1]);
+    const Pairs touching = {{0, 1}, {0, 2}, {0, 3}, {1, 2}};
+    EXPECT_EQ(touching, segmentIntersections(overlap));
+}
+
+TEST(SegmentIntersection, integerGrid) {
+    // Random ends on small grids: ends on other segments, overlaps and crossings through one
+    // point that round differently for different pairs
+    std::mt19937 gen(4);
+    SegmentIntersector<double> intersector;
+    for (int round = 0; round < 255; ++round) {
+        const int n = round < 250 ? 2 + round % 10 : 500;
+        std::uniform_int_distribution<int> coordinate(0, 2 + round % 20);
+        PointBuffer<double> endpoints;
+        for (int i = 0; i < 2 * n; ++i) endpoints.push_back(coordinate(gen), coordinate(gen));
+        Pairs pairs;
+        intersector.forEachIntersection(endpoints, [&pairs](std::uint32_t a, std::uint32_t b) {
+            pairs.push_back(std::make_pair(a, b));
+        });
+        std::sort(pairs.begin(), pairs.end());
+        ASSERT_EQ(bruteForce(endpoints), pairs) << round;
+    }
+}
+
+TEST(SegmentIntersection, nonIntegerGrid) {
+    // On a grid in steps of 0.1, 1 crosses 0 so close to the left end of 0 that the crossing
+    // rounds onto it
+    PointBuffer<double> clamped;
+    clamped.push_back(3 * 0.1, 6 * 0.1);
+    clamped.push_back(2 * 0.1, 4 * 0.1);
+    clamped.push_back(0.0, 2 * 0.1);
+    clamped.push_back(5 * 0.1, 7 * 0.1);
+    const Pairs crossing = {{0, 1}};
+    EXPECT_EQ(crossing, bruteForce(clamped));
+    EXPECT_EQ(crossing, segmentIntersections(clamped));
+
+    // Small grids in steps of 0.1 and turned by random angles: the lines through one grid point
+    // almost meet there, and their rounded crossings fall on either side of the ends nearby
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> angle(0.0, 6.283);
+    SegmentIntersector<double> intersector;
+    for (int round = 0; round < 4000; ++round) {
+        const int n = 2 + round % 12;
+        std::uniform_int_distribution<int> coordinate(0, 2 + round % 20);
+        const double c = std::cos(angle(gen)), s = std::sin(angle(gen));
+        PointBuffer<double> endpoints;
+        for (int i = 0; i < 2 * n; ++i) {
+            const double x = coordinate(gen), y = coordinate(gen);
+            if (round % 2 == 0) {
+                endpoints.push_back(x * 0.1, y * 0.1);
+            } else {
+                endpoints.push_back(x * c - y * s, x * s + y * c);
+            }
+        }
+        Pairs pairs;
+        intersector.forEachIntersection(endpoints, [&pairs](std::uint32_t a, std::uint32_t b) {
+            pairs.push_back(std::make_pair(a, b));
+        });
+        std::sort(pairs.begin(), pairs.end());
+        ASSERT_EQ(bruteForce(endpoints), pairs) << round;
+    }
+}
+
+TEST(SegmentIntersection, randomSegments) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0), offset(-5.0, 5.0);
+    SegmentIntersector<double> intersector;
+    for (int round = 0; round < 10; ++round) {
+        PointBuffer<double> endpoints;
+        for (int s = 0; s < 1500; ++s) {
+            const double x = coordinate(gen), y = coordinate(gen);
+            endpoints.push_back(x, y);
+            // Mostly short segments with a few long ones
+            if (s % 20 == 0) {
+                endpoints.push_back(coordinate(gen), coordinate(gen));
+            } else {
+                endpoints.push_back(x + offset(gen), y + offset(gen));
+            }
+        }
+        const Pairs expected = bruteForce(endpoints);
+        Pairs pairs;
+        intersector.forEachIntersection(endpoints, [&pairs](std::uint32_t a, std::uint32_t b) {
+            pairs.push_back(std::make_pair(a, b));
+        });
+        std::sort(pairs.begin(), pairs.end());
+        ASSERT_EQ(expected, pairs) << round;
+        EXPECT_EQ(expected, segmentIntersections(endpoints, 4));
+    }
+}
+
+TEST(SegmentIntersection, gridNetwork) {
+    // A street grid with its diagonals: shared ends, T junctions, overlaps, duplicates and
+    // many segments through one point
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<int> cell(0, 39), kind(0, 5);
+    PointBuffer<float> endpoints;
+    for (int s = 0; s < 4000; ++s) {
+        const int x = cell(gen), y = cell(gen);
+        switch (kind(gen)) {
+            case 0:
+                endpoints.push_back(float(x), float(y));
+                endpoints.push_back(float(x + 1), float(y));
+                break;
+            case 1:
+                endpoints.push_back(float(x), float(y));
+                endpoints.push_back(float(x), float(y + 1));
+                break;
+            case 2:
+                endpoints.push_back(float(x), float(y));
+                endpoints.push_back(float(x + 2), float(y + 2));
+                break;
+            case 3:
+                endpoints.push_back(float(x), float(y + 2));
+                endpoints.push_back(float(x + 2), float(y));
+                break;
+            case 4:
+                endpoints.push_back(float(x), float(y));
+                endpoints.push_back(float(x + 3), float(y));
+                break;
+            default:
+                endpoints.push_back(float(x) + 0.5f, float(y) + 0.5f);
+                endpoints.push_back(float(x) + 0.5f, float(y) + 0.5f);
+                break;
+        }
+    }
+    const Pairs expected = bruteForce(endpoints);
+    EXPECT_EQ(expected, segmentIntersections(endpoints));
+    EXPECT_EQ(expected, segmentIntersections(endpoints, 3));
+}
+
+TEST(SegmentIntersection, strips) {
+    // Enough segments for three strips, with some long ones across the strip boundaries
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0), offset(-3.0, 3.0);
+    PointBuffer<double> endpoints;
+    for (int s = 0; s < 3 * int(PARALLEL_SEGMENT_GRAIN); ++s) {
+        const double x = coordinate(gen), y = coordinate(gen);
+        endpoints.push_back(x, y);
+        if (s % 500 == 0) {
+            endpoints.push_back(coordinate(gen), coordinate(gen));
+        } else {
+            endpoints.push_back(x + offset(gen), y + offset(gen));
+        }
+    }
+    const Pairs single = segmentIntersections(endpoints);
+    EXPECT_GT(single.size(), 5000u);
+    EXPECT_EQ(single, segmentIntersections(endpoints, 3));
+    EXPECT_EQ(single, segmentIntersections(endpoints, 8));
+}
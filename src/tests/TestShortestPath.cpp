@@ -0,0 +1,264 @@
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/ShortestPath.h"
+
+using namespace graph_algo;
+
+typedef CsrGraph<std::uint32_t, double> Graph;
+typedef GraphBuilder<std::uint32_t, double> Builder;
+typedef ShortestPaths<std::uint32_t, double> Paths;
+
+/*
+ * A w x h grid, every vertex at its grid position, edges to the 4 neighbours in both directions
+ * with weight at least their length
+ */
+static Graph grid(std::uint32_t w, std::uint32_t h, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> stretch(1.0, 3.0);
+    Builder builder(w * h);
+    PointBuffer<double> points;
+    for (std::uint32_t y = 0; y < h; ++y) {
+        for (std::uint32_t x = 0; x < w; ++x) {
+            points.push_back(double(x), double(y));
+            const std::uint32_t v = y * w + x;
+            if (x + 1 < w) builder.addUndirectedEdge(v, v + 1, stretch(gen));
+            if (y + 1 < h) builder.addUndirectedEdge(v, v + w, stretch(gen));
+        }
+    }
+    builder.setCoordinates(points);
+    return builder.build();
+}
+
+/*
+ * Plain Dijkstra on std::priority_queue
+ */
+static std::vector<double> reference(const Graph &graph, std::uint32_t source) {
+    std::vector<double> distances(graph.vertexCount(), INFINITY);
+    typedef std::pair<double, std::uint32_t> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> > queue;
+    distances[source] = 0.0;
+    queue.push(Item(0.0, source));
+    while (!queue.empty()) {
+        const Item item = queue.top();
+        queue.pop();
+        if (item.first > distances[item.second]) continue;
+        for (std::uint32_t e = graph.edgeBegin(item.second); e < graph.edgeEnd(item.second); ++e) {
+            const double d = item.first + graph.weight(e);
+            if (d < distances[graph.target(e)]) {
+                distances[graph.target(e)] = d;
+                queue.push(Item(d, graph.target(e)));
+            }
+        }
+    }
+    return distances;
+}
+
+/*
+ * Every parent edge is tight and every path leads back to the source
+ */
+static void checkTree(const Graph &graph, const Paths &paths) {
+    for (std::uint32_t v = 0; v < graph.vertexCount(); ++v) {
+        if (!paths.reached(v) || v == paths.source()) continue;
+        const std::uint32_t u = paths.parent(v);
+        double best = INFINITY;
+        for (std::uint32_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            if (graph.target(e) == v) best = std::min(best, paths.distance(u) + graph.weight(e));
+        }
+        ASSERT_EQ(paths.distance(v), best);
+        ASSERT_EQ(paths.source(), paths.path(v).front());
+    }
+}
+
+TEST(RadixHeapTest, popsInOrder) {
+    RadixHeap<double, int> heap;
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(0.0, 10.0);
+    std::vector<double> keys;
+    double last = 0.0;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            const double key = last + dist(gen);
+            heap.push(key, i);
+            keys.push_back(key);
+        }
+        std::sort(keys.begin(), keys.end(), std::greater<double>());
+        for (int i = 0; i < 5; ++i) {
+            last = heap.pop().first;
+            ASSERT_EQ(keys.back(), last);
+            keys.pop_back();
+        }
+    }
+    ASSERT_EQ(keys.size(), heap.size());
+    while (!heap.empty()) {
+        ASSERT_EQ(keys.back(), heap.pop().first);
+        keys.pop_back();
+    }
+
+    RadixHeap<std::uint32_t, int> integers;
+    integers.push(5u, 0);
+    integers.push(3u, 1);
+    integers.push(3u, 2);
+    ASSERT_EQ(3u, integers.pop().first);
+    integers.push(4u, 3);
+    ASSERT_EQ(3u, integers.pop().first);
+    ASSERT_EQ(3, integers.pop().second);
+    ASSERT_EQ(5u, integers.pop().first);
+}
+
+TEST(ShortestPathTest, small) {
+    // 0 -> 1 -> 3 costs 3, 0 -> 2 -> 3 costs 4, 4 is unreachable
+    Builder builder(5);
+    builder.addEdge(0, 1, 1.0);
+    builder.addEdge(1, 3, 2.0);
+    builder.addEdge(0, 2, 1.0);
+    builder.addEdge(2, 3, 3.0);
+    builder.addEdge(4, 0, 1.0);
+    const Graph graph = builder.build();
+
+    const Paths paths[] = {dijkstra(graph, 0u), deltaStepping(graph, 0u), deltaStepping(graph, 0u, 0.5, 3)};
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(3.0, paths[i].distance(3));
+        ASSERT_EQ(1u, paths[i].parent(3));
+        ASSERT_EQ(0u, paths[i].parent(0));
+        ASSERT_FALSE(paths[i].reached(4));
+        ASSERT_TRUE(std::isinf(paths[i].distance(4)));
+        ASSERT_TRUE(paths[i].path(4).empty());
+        const std::vector<std::uint32_t> path = paths[i].path(3);
+        ASSERT_EQ(3u, path.size());
+        ASSERT_EQ(0u, path[0]);
+        ASSERT_EQ(1u, path[1]);
+        ASSERT_EQ(3u, path[2]);
+    }
+}
+
+TEST(ShortestPathTest, zeroWeights) {
+    // A zero weight cycle must not become a parent cycle
+    Builder builder(4);
+    builder.addUndirectedEdge(1, 2, 0.0);
+    builder.addUndirectedEdge(2, 3, 0.0);
+    builder.addEdge(0, 1, 1.0);
+    builder.addEdge(0, 3, 2.0);
+    const Graph graph = builder.build();
+    const Paths paths[] = {dijkstra(graph, 0u), deltaStepping(graph, 0u, 0.25, 2)};
+    for (int i = 0; i < 2; ++i) {
+        for (std::uint32_t v = 1; v < 4; ++v) {
+            ASSERT_EQ(1.0, paths[i].distance(v));
+            ASSERT_EQ(1u, paths[i].path(v)[1]);
+        }
+    }
+}
+
+TEST(ShortestPathTest, unweighted) {
+    GraphBuilder<std::uint64_t, int> builder(4);
+    builder.addEdge(0, 1);
+    builder.addEdge(1, 2);
+    builder.addEdge(2, 3);
+    builder.addEdge(0, 2);
+    const CsrGraph<std::uint64_t, int> graph = builder.build();
+    ASSERT_EQ(2, dijkstra(graph, std::uint64_t(0)).distance(3));
+    ASSERT_EQ(2, deltaStepping(graph, std::uint64_t(0)).distance(3));
+    ASSERT_EQ(std::numeric_limits<int>::max(), dijkstra(graph, std::uint64_t(3)).distance(0));
+}
+
+TEST(ShortestPathTest, literalSourceAndTinyDelta) {
+    std::mt19937 gen(6);
+    const std::uint32_t n = 500;
+    std::uniform_int_distribution<std::uint32_t> vertex(0, n - 1);
+    std::uniform_real_distribution<double> weight(0.0, 10.0);
+    Builder builder(n);
+    for (int i = 0; i < 3000; ++i) builder.addEdge(vertex(gen), vertex(gen), weight(gen));
+    const Graph graph = builder.build();
+    const std::vector<double> expected = reference(graph, 0);
+
+    // A plain int literal is a vertex
+    ASSERT_EQ(expected, dijkstra(graph, 0).distances());
+    ASSERT_EQ(expected[7], astar(graph, 0, 7).distance(7));
+    // Deltas that would need far too many buckets, down to a denormal, are raised and still exact
+    for (double delta : {1e-9, 4.9e-324}) {
+        const Paths paths = deltaStepping(graph, 0, delta, 2);
+        ASSERT_EQ(expected, paths.distances()) << delta;
+        checkTree(graph, paths);
+    }
+    ASSERT_THROW(deltaStepping(graph, 0, -1.0), std::invalid_argument);
+    ASSERT_THROW(deltaStepping(graph, 0, NAN), std::invalid_argument);
+
+    GraphBuilder<std::uint32_t, int> integers(3);
+    integers.addEdge(0, 1, 100000);
+    integers.addEdge(1, 2, 3);
+    ASSERT_EQ(100003, deltaStepping(integers.build(), 0, 1, 1).distance(2));
+}
+
+TEST(ShortestPathTest, randomGraphs) {
+    std::mt19937 gen(3);
+    for (int round = 0; round < 20; ++round) {
+        const std::uint32_t n = 2000;
+        std::uniform_int_distribution<std::uint32_t> vertex(0, n - 1);
+        // Some weights repeat, so that ties are common
+        std::uniform_int_distribution<int> weight(0, 20);
+        Builder builder(n);
+        for (int i = 0; i < 8000; ++i) builder.addEdge(vertex(gen), vertex(gen), weight(gen) * 0.25);
+        const Graph graph = builder.build();
+        const std::uint32_t source = vertex(gen);
+        const std::vector<double> expected = reference(graph, source);
+
+        const Paths paths[] = {dijkstra(graph, source), deltaStepping(graph, source, 0.0, 1),
+                               deltaStepping(graph, source, 0.5, 4), deltaStepping(graph, source, 100.0, 2)};
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_EQ(expected, paths[i].distances());
+            checkTree(graph, paths[i]);
+        }
+    }
+}
+
+TEST(ShortestPathTest, astar) {
+    const Graph graph = grid(60, 40, 5);
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, graph.vertexCount() - 1);
+    ShortestPathSearch<std::uint32_t, double, double> search(graph);
+    for (int query = 0; query < 50; ++query) {
+        const std::uint32_t source = vertex(gen), target = vertex(gen);
+        const std::vector<double> expected = reference(graph, source);
+
+        search.dijkstra(source);
+        const std::size_t dijkstraSettled = search.settledCount();
+        ASSERT_EQ(expected[target], search.distance(target));
+
+        ASSERT_TRUE(search.astar(source, target));
+        ASSERT_EQ(expected[target], search.distance(target));
+        ASSERT_LE(search.settledCount(), dijkstraSettled);
+        const std::vector<std::uint32_t> path = search.path(target);
+        ASSERT_EQ(source, path.front());
+        ASSERT_EQ(target, path.back());
+        double length = 0.0;
+        for (std::size_t i = 1; i < path.size(); ++i) {
+            length += graph.weight(graph.findEdge(path[i - 1], path[i]));
+        }
+        ASSERT_NEAR(expected[target], length, 1e-9);
+
+        ASSERT_EQ(expected[target], astar(graph, source, target).distance(target));
+        // A smaller scale is still admissible, only slower
+        ASSERT_EQ(expected[target], astar(graph, source, target, 0.5).distance(target));
+    }
+}
+
+TEST(ShortestPathTest, parallelFrontiers) {
+    // Large enough that the frontiers get split between the threads
+    const std::uint32_t n = 100000;
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<std::uint32_t> vertex(0, n - 1);
+    std::uniform_int_distribution<int> weight(1, 64);
+    Builder builder(n);
+    for (std::uint32_t i = 0; i < 5 * n; ++i) builder.addEdge(vertex(gen), vertex(gen), weight(gen) * 0.125);
+    const Graph graph = builder.build();
+    const std::vector<double> expected = reference(graph, 0);
+    for (unsigned threads = 2; threads <= 4; threads += 2) {
+        const Paths paths = deltaStepping(graph, 0u, 2.0, threads);
+        ASSERT_EQ(expected, paths.distances());
+        checkTree(graph, paths);
+    }
+}
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/PackedPoint.h"
+#include "../main/Point.h"
+#include "../main/PointBuffer.h"
+#include "../main/Simplification.h"
+
+using namespace graph_algo;
+
+typedef PackedPoint<double> P;
+
+/*
+ * A random walk that turns a little at every step
+ */
+static std::vector<P> makeTrack(std::mt19937 &gen, int n) {
+    std::normal_distribution<double> turn(0.0, 0.3);
+    std::uniform_real_distribution<double> step(0.5, 1.5);
+    std::vector<P> track;
+    double x = 0.0, y = 0.0, heading = 0.0;
+    for (int i = 0; i < n; ++i) {
+        track.push_back(P(x, y));
+        heading += turn(gen);
+        const double s = step(gen);
+        x += s * std::cos(heading);
+        y += s * std::sin(heading);
+    }
+    return track;
+}
+
+/*
+ * The square 0..4 with every integer point of its edges, starting at (start, 0)
+ */
+static std::vector<P> makeSquare(int start) {
+    std::vector<P> square;
+    for (int i = 0; i < 16; ++i) {
+        const int k = (i + start) % 16;
+        if (k < 4) square.push_back(P(k, 0));
+        else if (k < 8) square.push_back(P(4, k - 4));
+        else if (k < 12) square.push_back(P(12 - k, 4));
+        else square.push_back(P(0, 16 - k));
+    }
+    return square;
+}
+
+static void recursiveDouglasPeucker(const std::vector<P> &points, int first, int last, double tolerance,
+                                    std::vector<int> &kept) {
+    int split = -1;
+    double farthest = tolerance * tolerance;
+    for (int i = first + 1; i < last; ++i) {
+        const double d = detail::segmentDistance2(points[first], points[last], points[i]);
+        if (d > farthest) {
+            farthest = d;
+            split = i;
+        }
+    }
+    if (split < 0) return;
+    recursiveDouglasPeucker(points, first, split, tolerance, kept);
+    kept.push_back(split);
+    recursiveDouglasPeucker(points, split, last, tolerance, kept);
+}
+
+/*
+ * Visvalingam-Whyatt that searches all vertices for the smallest effective area at every step
+ */
+static std::vector<int> slowVisvalingam(const std::vector<P> &points, double area) {
+    std::vector<int> alive;
+    for (int i = 0; i < int(points.size()); ++i) alive.push_back(i);
+    std::vector<double> floor(points.size(), 0.0);
+    double removed = 0.0;
+    while (alive.size() > 2) {
+        std::size_t best = 0;
+        double smallest = HUGE_VAL;
+        for (std::size_t k = 1; k + 1 < alive.size(); ++k) {
+            const double a = std::max(floor[std::size_t(alive[k])], (
+                    detail::triangleArea(points[std::size_t(alive[k - 1])], points[std::size_t(alive[k])], points[std::size_t(alive[k + 1])])));
+            if (a < smallest) {
+                smallest = a;
+                best = k;
+            }
+        }
+        if (smallest > area) break;
+        removed = smallest;
+        floor[std::size_t(alive[best - 1])] = std::max(floor[std::size_t(alive[best - 1])], removed);
+        floor[std::size_t(alive[best + 1])] = std::max(floor[std::size_t(alive[best + 1])], removed);
+        alive.erase(alive.begin() + std::ptrdiff_t(best));
+    }
+    return alive;
+}
+
+TEST(Simplification, douglasPeuckerLine) {
+    std::mt19937 gen(1);
+    PolylineSimplifier simplifier;
+    for (double tolerance : {0.0, 0.5, 2.0, 10.0}) {
+        const std::vector<P> track = makeTrack(gen, 2000);
+        std::vector<int> expected = {0};
+        recursiveDouglasPeucker(track, 0, int(track.size()) - 1, tolerance, expected);
+        expected.push_back(int(track.size()) - 1);
+        EXPECT_EQ(expected, simplifier.douglasPeucker(track, tolerance)) << tolerance;
+        EXPECT_EQ(expected, simplifier.douglasPeucker(PointBuffer<double>(track), tolerance)) << tolerance;
+    }
+
+    // The spike and its base stay, the small bumps go
+    std::vector<Point<double> > line;
+    for (int i = 0; i <= 10; ++i) line.push_back(Point<double>(i, i == 5 ? 3.0 : (i % 2) * 0.1));
+    const std::vector<Point<double> > expected = {Point<double>(0.0, 0.0), Point<double>(4.0, 0.0),
+                                                  Point<double>(5.0, 3.0), Point<double>(6.0, 0.0),
+                                                  Point<double>(10.0, 0.0)};
+    EXPECT_EQ(expected, douglasPeucker(line, 0.5));
+    EXPECT_EQ(2u, douglasPeucker(std::vector<P>{P(0, 0), P(1, 1)}, 1.0).size());
+    EXPECT_TRUE(douglasPeucker(std::vector<P>(), 1.0).empty());
+}
+
+TEST(Simplification, douglasPeuckerRing) {
+    PolylineSimplifier simplifier;
+    // Wherever the seam falls, only the corners are left, including when vertex 0 is mid edge
+    for (int start = 0; start < 16; ++start) {
+        const std::vector<P> square = makeSquare(start);
+        const std::vector<int> &kept = simplifier.douglasPeucker(square, 0.1, true);
+        ASSERT_EQ(4u, kept.size()) << start;
+        for (int i : kept) {
+            EXPECT_TRUE(std::fmod(square[std::size_t(i)].getX(), 4.0) == 0.0 &&
+                        std::fmod(square[std::size_t(i)].getY(), 4.0) == 0.0) << start;
+        }
+    }
+
+    // Rotating a ring keeps the same vertices
+    std::vector<P> ring;
+    for (int i = 0; i < 500; ++i) {
+        const double t = 2.0 * M_PI * i / 500.0, r = 10.0 + std::sin(7.0 * t) + 0.1 * std::sin(50.0 * t);
+        ring.push_back(P(r * std::cos(t), r * std::sin(t)));
+    }
+    const std::vector<int> reference = simplifier.douglasPeucker(ring, 0.05, true);
+    EXPECT_LT(reference.size(), 250u);
+    for (int shift : {1, 137, 499}) {
+        std::vector<P> rotated(ring.begin() + shift, ring.end());
+        rotated.insert(rotated.end(), ring.begin(), ring.begin() + shift);
+        std::vector<int> kept;
+        for (int i : simplifier.douglasPeucker(rotated, 0.05, true)) kept.push_back((i + shift) % 500);
+        std::sort(kept.begin(), kept.end());
+        EXPECT_EQ(reference, kept) << shift;
+    }
+
+    // A flat ring does not collapse below a triangle
+    const std::vector<P> flat = {P(0, 0), P(5, 0.01), P(10, 0), P(5, -0.02)};
+    EXPECT_EQ(3u, douglasPeucker(flat, 1.0, true).size());
+}
+
+TEST(Simplification, visvalingamLine) {
+    std::mt19937 gen(3);
+    PolylineSimplifier simplifier;
+    for (double area : {0.0, 0.1, 1.0, 20.0}) {
+        const std::vector<P> track = makeTrack(gen, 600);
+        EXPECT_EQ(slowVisvalingam(track, area), simplifier.visvalingam(track, area)) << area;
+    }
+
+    const std::vector<P> track = makeTrack(gen, 1000);
+    EXPECT_EQ(slowVisvalingam(track, 5.0), simplifier.visvalingam(track, 5.0));
+    const std::size_t before = simplifier.memoryUsage();
+    for (std::size_t count : {2u, 3u, 100u, 999u, 1000u}) {
+        const std::vector<int> &kept = simplifier.visvalingamCount(track, count);
+        ASSERT_EQ(count, kept.size());
+        EXPECT_EQ(0, kept.front());
+        EXPECT_EQ(999, kept.back());
+    }
+    // Scratch space is reused, not grown again
+    EXPECT_EQ(before, simplifier.memoryUsage());
+    EXPECT_EQ(2u, visvalingam(std::vector<P>{P(0, 0), P(1, 0), P(2, 0)}, 0.0).size());
+}
+
+TEST(Simplification, visvalingamRing) {
+    PolylineSimplifier simplifier;
+    for (int start = 0; start < 16; ++start) {
+        const std::vector<P> square = makeSquare(start);
+        const std::vector<int> &kept = simplifier.visvalingam(square, 0.0, true);
+        ASSERT_EQ(4u, kept.size()) << start;
+        for (int i : kept) {
+            EXPECT_TRUE(std::fmod(square[std::size_t(i)].getX(), 4.0) == 0.0 &&
+                        std::fmod(square[std::size_t(i)].getY(), 4.0) == 0.0) << start;
+        }
+        EXPECT_EQ(3u, simplifier.visvalingamCount(square, 3, true).size());
+        EXPECT_EQ(3u, simplifier.visvalingam(square, 100.0, true).size());
+    }
+}
+
+TEST(Simplification, radialDistanceStream) {
+    std::mt19937 gen(4);
+    const std::vector<P> track = makeTrack(gen, 10000);
+    RadialDistanceStream<P> stream(5.0);
+    std::vector<P> kept;
+    const auto emit = [&kept](const P &p) { kept.push_back(p); };
+    for (const P &p : track) stream.push(p, emit);
+    EXPECT_EQ(track.size(), stream.seen());
+    stream.finish(emit);
+    EXPECT_EQ(kept.size(), stream.kept());
+    EXPECT_EQ(0u, stream.seen());
+
+    ASSERT_GT(kept.size(), 2u);
+    EXPECT_LT(kept.size(), track.size() / 3);
+    EXPECT_EQ(track.front(), kept.front());
+    EXPECT_EQ(track.back(), kept.back());
+    for (std::size_t i = 1; i + 1 < kept.size(); ++i) {
+        EXPECT_GE(std::sqrt(detail::pointDistance2(kept[i - 1], kept[i])), 5.0);
+    }
+
+    // The last point is not repeated when it was kept anyway, and the stream starts over after finish
+    RadialDistanceStream<Point<double> > points(1.0);
+    std::vector<Point<double> > out;
+    const auto keep = [&out](const Point<double> &p) { out.push_back(p); };
+    points.push(Point<double>(0.0, 0.0), keep);
+    points.push(Point<double>(2.0, 0.0), keep);
+    points.finish(keep);
+    points.push(Point<double>(2.5, 0.0), keep);
+    points.push(Point<double>(3.0, 0.0), keep);
+    points.finish(keep);
+    const std::vector<Point<double> > expected = {Point<double>(0.0, 0.0), Point<double>(2.0, 0.0),
+                                                  Point<double>(2.5, 0.0), Point<double>(3.0, 0.0)};
+    EXPECT_EQ(expected, out);
+}
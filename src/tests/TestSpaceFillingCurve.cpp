@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/SpaceFillingCurve.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::randomPoints;
+
+/*
+ * The Hilbert index of (x, y) on the 2^32 x 2^32 grid, one level at a time
+ */
+static std::uint64_t referenceHilbert(std::uint64_t x, std::uint64_t y) {
+    const std::uint64_t n = std::uint64_t(1) << 32;
+    std::uint64_t d = 0;
+    for (std::uint64_t s = n / 2; s > 0; s /= 2) {
+        const std::uint64_t rx = (x & s) > 0, ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+TEST(SpaceFillingCurve, morton) {
+    EXPECT_EQ(0u, MortonCurve::encode(0, 0));
+    EXPECT_EQ(1u, MortonCurve::encode(1, 0));
+    EXPECT_EQ(2u, MortonCurve::encode(0, 1));
+    EXPECT_EQ(15u, MortonCurve::encode(3, 3));
+    EXPECT_EQ(0x5555555555555555ull, MortonCurve::encode(0xFFFFFFFFu, 0));
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFFull, MortonCurve::encode(0xFFFFFFFFu, 0xFFFFFFFFu));
+    std::mt19937 gen(1);
+    for (int i = 0; i < 10000; ++i) {
+        const std::uint32_t x = gen(), y = gen();
+        const std::uint64_t key = MortonCurve::encode(x, y);
+        // The portable bit tricks and the BMI2 instructions agree
+        EXPECT_EQ(detail::spreadBits(x) | detail::spreadBits(y) << 1, key);
+#ifdef GRAPH_ALGO_X86_BMI2
+        if (__builtin_cpu_supports("bmi2")) {
+            EXPECT_EQ(detail::mortonPdep(x, y), key);
+        }
+#endif
+        std::uint32_t dx, dy;
+        MortonCurve::decode(key, dx, dy);
+        EXPECT_EQ(x, dx);
+        EXPECT_EQ(y, dy);
+        EXPECT_EQ(x, detail::compactBits(key));
+    }
+}
+
+TEST(SpaceFillingCurve, hilbert) {
+    // The first cells of the curve, and its last
+    EXPECT_EQ(0u, HilbertCurve::encode(0, 0));
+    EXPECT_EQ(1u, HilbertCurve::encode(1, 0));
+    EXPECT_EQ(2u, HilbertCurve::encode(1, 1));
+    EXPECT_EQ(3u, HilbertCurve::encode(0, 1));
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFFull, HilbertCurve::encode(0xFFFFFFFFu, 0));
+    std::mt19937 gen(2);
+    for (int i = 0; i < 10000; ++i) {
+        const std::uint32_t x = gen() >> (i % 32), y = gen() >> (i % 29);
+        const std::uint64_t key = HilbertCurve::encode(x, y);
+        EXPECT_EQ(referenceHilbert(x, y), key);
+        std::uint32_t dx, dy;
+        HilbertCurve::decode(key, dx, dy);
+        EXPECT_EQ(x, dx);
+        EXPECT_EQ(y, dy);
+    }
+    // Consecutive keys are neighbouring cells
+    std::uniform_int_distribution<std::uint64_t> anyKey(0, 0xFFFFFFFFFFFFFFFEull);
+    for (int i = 0; i < 10000; ++i) {
+        const std::uint64_t key = anyKey(gen);
+        std::uint32_t x0, y0, x1, y1;
+        HilbertCurve::decode(key, x0, y0);
+        HilbertCurve::decode(key + 1, x1, y1);
+        const std::uint32_t dx = x0 > x1 ? x0 - x1 : x1 - x0, dy = y0 > y1 ? y0 - y1 : y1 - y0;
+        EXPECT_EQ(1u, dx + dy);
+    }
+}
+
+TEST(SpaceFillingCurve, grid) {
+    const CurveGrid<double> grid(-1.0, -1.0, 2.0);
+    EXPECT_EQ(0u, grid.column(-1.0));
+    EXPECT_EQ(0u, grid.column(-5.0));
+    EXPECT_EQ(0xFFFFFFFFu, grid.column(1.0));
+    EXPECT_EQ(0xFFFFFFFFu, grid.row(7.0));
+    EXPECT_EQ(0x7FFFFFFFu, grid.row(0.0));
+    EXPECT_EQ(MortonCurve::encode(grid.column(0.25), grid.row(-0.5)), grid.morton(PackedPoint<double>(0.25, -0.5)));
+    const PackedPoint<double> p(0.3, 0.7);
+    const PackedPoint<double> corner = grid.corner<HilbertCurve>(grid.hilbert(p));
+    EXPECT_NEAR(p.getX(), corner.getX(), 1e-9);
+    EXPECT_NEAR(p.getY(), corner.getY(), 1e-9);
+
+    // The bounding square of the points
+    const PointBuffer<double> points = randomPoints(5 * PARALLEL_CURVE_GRAIN, 3);
+    const CurveGrid<double> bounds(points, 4);
+    std::uint32_t minColumn = 0xFFFFFFFFu, maxColumn = 0, minRow = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        minColumn = std::min(minColumn, bounds.column(points.xs()[i]));
+        maxColumn = std::max(maxColumn, bounds.column(points.xs()[i]));
+        minRow = std::min(minRow, bounds.row(points.ys()[i]));
+    }
+    EXPECT_EQ(0u, minColumn);
+    EXPECT_EQ(0u, minRow);
+    EXPECT_GT(maxColumn, 0xFFFF0000u);
+}
+
+TEST(SpaceFillingCurve, curveOrder) {
+    PointBuffer<double> points = randomPoints(20000, 4);
+    // Duplicates keep their input order
+    for (int i = 0; i < 100; ++i) points.push_back(points[i]);
+    const CurveGrid<double> grid(points);
+    std::vector<std::uint64_t> keys(points.size());
+    curveKeys<HilbertCurve>(points, grid, keys.data());
+    for (unsigned threads : {1u, 3u}) {
+        const std::vector<std::uint32_t> order = curveOrder<HilbertCurve>(points, threads);
+        ASSERT_EQ(points.size(), order.size());
+        std::vector<bool> seen(points.size(), false);
+        for (std::size_t k = 0; k < order.size(); ++k) {
+            ASSERT_FALSE(seen[order[k]]);
+            seen[order[k]] = true;
+            if (k == 0) continue;
+            const std::uint64_t previous = keys[order[k - 1]], key = keys[order[k]];
+            EXPECT_LE(previous, key);
+            if (previous == key) {
+                EXPECT_LT(order[k - 1], order[k]);
+            }
+        }
+    }
+    EXPECT_EQ(curveOrder<MortonCurve>(points, 1), curveOrder<MortonCurve>(points, 4));
+    // Enough points for every thread to sort its own chunk
+    const PointBuffer<double> many = randomPoints(5 * PARALLEL_CURVE_GRAIN, 6);
+    EXPECT_EQ(curveOrder<HilbertCurve>(many, 1), curveOrder<HilbertCurve>(many, 4));
+
+    // Small inputs and equal points
+    EXPECT_TRUE(curveOrder<MortonCurve>(PointBuffer<double>()).empty());
+    PointBuffer<double> same;
+    for (int i = 0; i < 5; ++i) same.push_back(1.0, 2.0);
+    EXPECT_EQ(std::vector<std::uint32_t>({0, 1, 2, 3, 4}), curveOrder<HilbertCurve>(same));
+}
+
+TEST(SpaceFillingCurve, curveSort) {
+    const PointBuffer<double> original = randomPoints(5000, 5);
+    PointBuffer<double> points = original;
+    const std::vector<std::uint32_t> order = curveSort<HilbertCurve>(points, 2);
+    ASSERT_EQ(original.size(), points.size());
+    double jumps = 0.0, originalJumps = 0.0;
+    for (std::size_t k = 0; k < points.size(); ++k) {
+        EXPECT_EQ(original[order[k]], points[k]);
+        if (k == 0) continue;
+        jumps += std::abs(points.xs()[k] - points.xs()[k - 1]) + std::abs(points.ys()[k] - points.ys()[k - 1]);
+        originalJumps += std::abs(original.xs()[k] - original.xs()[k - 1]) + std::abs(original.ys()[k] - original.ys()[k - 1]);
+    }
+    // Consecutive points are close along the curve
+    EXPECT_LT(jumps * 10.0, originalJumps);
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/SpatialHash.h"
+#include "../main/Point.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::randomPoints;
+
+typedef std::pair<std::uint32_t, std::uint32_t> IdPair;
+
+static double squaredDistance(const PackedPoint<double> &a, const PackedPoint<double> &b) {
+    const double dx = a.getX() - b.getX(), dy = a.getY() - b.getY();
+    return dx * dx + dy * dy;
+}
+
+static std::vector<IdPair> bruteForcePairs(const PointBuffer<double> &points, double d) {
+    std::vector<IdPair> pairs;
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        for (std::uint32_t j = i + 1; j < points.size(); ++j) {
+            if (squaredDistance(points[i], points[j]) <= d * d) pairs.push_back(IdPair(i, j));
+        }
+    }
+    return pairs;
+}
+
+TEST(SpatialHash, insertMoveRemove) {
+    SpatialHash<double> grid(10.0);
+    EXPECT_TRUE(grid.empty());
+    grid.insert(3, 1.0, 2.0);
+    grid.insert(7, Point<double>(-1.0, 2.0));
+    EXPECT_EQ(2u, grid.size());
+    EXPECT_EQ(2u, grid.cellCount());
+    EXPECT_TRUE(grid.contains(3));
+    EXPECT_FALSE(grid.contains(4));
+    EXPECT_FALSE(grid.contains(100));
+    EXPECT_EQ(PackedPoint<double>(-1.0, 2.0), grid.point(7));
+
+    // Within the cell, then to the cell of point 3
+    grid.move(7, -2.0, 3.0);
+    EXPECT_EQ(PackedPoint<double>(-2.0, 3.0), grid.point(7));
+    grid.move(7, 5.0, 5.0);
+    EXPECT_EQ(1u, grid.cellCount());
+    // Inserting an id that is in moves it
+    grid.insert(3, 25.0, 25.0);
+    EXPECT_EQ(2u, grid.size());
+    EXPECT_EQ(PackedPoint<double>(25.0, 25.0), grid.point(3));
+
+    EXPECT_TRUE(grid.remove(3));
+    EXPECT_FALSE(grid.remove(3));
+    EXPECT_EQ(1u, grid.size());
+    EXPECT_EQ(1u, grid.cellCount());
+    EXPECT_THROW(grid.move(3, 0.0, 0.0), SpatialHashPointNotFoundException);
+    EXPECT_THROW(grid.point(3), SpatialHashPointNotFoundException);
+    grid.clear();
+    EXPECT_TRUE(grid.empty());
+    EXPECT_EQ(0u, grid.cellCount());
+}
+
+TEST(SpatialHash, radiusAfterChurn) {
+    // Random inserts, moves and removes against a plain array of positions
+    SpatialHash<double> grid(4.0);
+    const std::uint32_t ids = 3000;
+    std::vector<bool> present(ids, false);
+    PointBuffer<double> positions = randomPoints(ids, 1, -50.0, 50.0);
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<std::uint32_t> anyId(0, ids - 1);
+    std::uniform_real_distribution<double> coordinate(-50.0, 50.0), step(-3.0, 3.0);
+    for (int round = 0; round < 30000; ++round) {
+        const std::uint32_t id = anyId(gen);
+        const int action = round % 5;
+        if (!present[id] || action == 0) {
+            positions.xs()[id] = coordinate(gen);
+            positions.ys()[id] = coordinate(gen);
+            grid.insert(id, positions[id]);
+            present[id] = true;
+        } else if (action == 4) {
+            EXPECT_TRUE(grid.remove(id));
+            present[id] = false;
+        } else {
+            positions.xs()[id] += step(gen);
+            positions.ys()[id] += step(gen);
+            grid.move(id, positions[id]);
+        }
+    }
+    ASSERT_EQ(std::size_t(std::count(present.begin(), present.end(), true)), grid.size());
+
+    const PointBuffer<double> queries = randomPoints(100, 3, -60.0, 60.0);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        for (double r : {0.5, 3.0, 11.0, 500.0}) {
+            std::vector<std::uint32_t> found;
+            const std::size_t count = grid.radius(queries[q], r, found);
+            EXPECT_EQ(found.size(), count);
+            std::sort(found.begin(), found.end());
+            std::vector<std::uint32_t> expected;
+            for (std::uint32_t id = 0; id < ids; ++id) {
+                if (present[id] && squaredDistance(positions[id], queries[q]) <= r * r) expected.push_back(id);
+            }
+            EXPECT_EQ(expected, found);
+        }
+    }
+}
+
+TEST(SpatialHash, pairsWithin) {
+    const PointBuffer<double> points = randomPoints(3000, 4);
+    SpatialHash<double> grid(5.0);
+    grid.rebuild(points);
+    // Distances under, at and over the cell size
+    for (double d : {2.0, 5.0, 12.0}) {
+        const std::vector<IdPair> expected = bruteForcePairs(points, d);
+        for (unsigned threads : {1u, 3u}) {
+            std::vector<IdPair> pairs = grid.pairsWithin(d, threads);
+            std::sort(pairs.begin(), pairs.end());
+            EXPECT_EQ(expected, pairs);
+        }
+    }
+}
+
+TEST(SpatialHash, rebuildAndMoveAll) {
+    const std::size_t n = 4 * PARALLEL_SPATIAL_HASH_GRAIN;
+    PointBuffer<double> points = randomPoints(n, 5, -1000.0, 1000.0);
+    SpatialHash<double> sequential(8.0), parallel(8.0), inserted(8.0);
+    sequential.rebuild(points, 1);
+    // A rebuild drops what was there before
+    parallel.rebuild(randomPoints(n / 2, 9, -1000.0, 1000.0), 4);
+    parallel.rebuild(points, 4);
+    for (std::uint32_t i = 0; i < n; ++i) inserted.insert(i, points[i]);
+    EXPECT_EQ(n, parallel.size());
+    EXPECT_EQ(inserted.cellCount(), parallel.cellCount());
+    for (std::uint32_t i = 0; i < n; i += 101) {
+        EXPECT_EQ(points[i], parallel.point(i));
+        EXPECT_EQ(points[i], sequential.point(i));
+    }
+
+    // A tick: every point takes a small step, some change cell
+    std::mt19937 gen(6);
+    std::uniform_real_distribution<double> step(-2.0, 2.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.xs()[i] += step(gen);
+        points.ys()[i] += step(gen);
+    }
+    parallel.moveAll(points, 4);
+    for (std::uint32_t i = 0; i < n; ++i) inserted.move(i, points[i]);
+    EXPECT_EQ(n, parallel.size());
+    EXPECT_EQ(inserted.cellCount(), parallel.cellCount());
+    const PointBuffer<double> queries = randomPoints(50, 7, -1000.0, 1000.0);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        std::vector<std::uint32_t> a, b;
+        parallel.radius(queries[q], 20.0, a);
+        inserted.radius(queries[q], 20.0, b);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        EXPECT_EQ(b, a);
+    }
+
+    // moveAll inserts the ids it does not know
+    SpatialHash<double> grown(8.0);
+    grown.insert(2, 0.0, 0.0);
+    grown.moveAll(randomPoints(10, 8));
+    EXPECT_EQ(10u, grown.size());
+}
+
+TEST(SpatialHash, extremeCoordinates) {
+    // Cells beyond the range of std::int32_t are clamped to the border cells
+    SpatialHash<double> grid(1.0);
+    grid.insert(0, 1e300, -1e300);
+    grid.insert(1, 1e300 - 1e290, -1e300);
+    grid.insert(2, -0.5, -0.5);
+    grid.insert(3, 0.5, 0.5);
+    EXPECT_EQ(3u, grid.cellCount());
+    std::vector<std::uint32_t> found;
+    grid.radius(PackedPoint<double>(0.0, 0.0), 1.0, found);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(std::vector<std::uint32_t>({2, 3}), found);
+    const std::vector<IdPair> pairs = grid.pairsWithin(1.5);
+    EXPECT_EQ(std::vector<IdPair>(1, IdPair(2, 3)), pairs);
+}
@@ -0,0 +1,182 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/TextParser.h"
+
+using namespace graph_algo;
+
+static PointBuffer<double> parse(const std::string &text, unsigned threads = 1) {
+    return parsePoints<double>(text.data(), text.data() + text.size(), threads);
+}
+
+static std::size_t badLine(const std::string &text, unsigned threads = 1) {
+    try {
+        parse(text, threads);
+    } catch (const TextParseException &e) {
+        return e.line();
+    }
+    return 0;
+}
+
+static bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+TEST(TextParser, parseNumber) {
+    const char *const texts[] = {"0", "-0", "+1", "0.1", "1.", ".5", "3.14159", "-2.5e-3", "1E10", "1e300",
+                                 "4.9e-324", "2.2250738585072014e-308", "1.7976931348623157e308", "123456789012345678",
+                                 "12345678901234567890123", "0.000000000000000000000000001234", "9007199254740993",
+                                 "1e23", "8.5e-23", "9007199254740995", "18014398509481986e1",
+                                 "1.00000000000000011102230246251565404236316680908203125"};
+    for (const char *text : texts) {
+        double value = 0.0;
+        const char *end = detail::parseNumber(text, text + std::strlen(text), value);
+        ASSERT_EQ(text + std::strlen(text), end) << text;
+        EXPECT_TRUE(sameBits(std::strtod(text, nullptr), value)) << text;
+    }
+
+    // Every double printed in full and shortened goes through the fast path or strtod unchanged
+    std::mt19937_64 gen(1);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+    std::uniform_int_distribution<std::uint64_t> bits;
+    // %f of the largest doubles takes over 300 digits
+    char buffer[400];
+    for (int i = 0; i < 20000; ++i) {
+        double x = coordinate(gen);
+        if (i % 4 == 3) {
+            const std::uint64_t b = bits(gen);
+            std::memcpy(&x, &b, sizeof(x));
+            if (!std::isfinite(x)) continue;
+        }
+        for (const char *format : {"%.17g", "%.6f", "%g", "%.3e"}) {
+            const int length = std::snprintf(buffer, sizeof(buffer), format, x);
+            double value = 0.0;
+            ASSERT_EQ(buffer + length, detail::parseNumber(buffer, buffer + length, value)) << buffer;
+            EXPECT_TRUE(sameBits(std::strtod(buffer, nullptr), value)) << buffer;
+        }
+    }
+
+    // Long mantissas with small exponents, including the doubles and the halfway points between them
+    std::uniform_int_distribution<std::uint64_t> mantissa(0, 9999999999999999999ull);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    for (int i = 0; i < 20000; ++i) {
+        std::uint64_t m = mantissa(gen);
+        if (i % 2 == 1) m = (std::uint64_t(1) << 53) + (m % 64);
+        const int length = std::snprintf(buffer, sizeof(buffer), "%llue%d", (unsigned long long) m, exponent(gen));
+        double value = 0.0;
+        ASSERT_EQ(buffer + length, detail::parseNumber(buffer, buffer + length, value)) << buffer;
+        EXPECT_TRUE(sameBits(std::strtod(buffer, nullptr), value)) << buffer;
+    }
+
+    double value = 0.0;
+    const std::string special = "-inf nan Infinity";
+    EXPECT_EQ(special.data() + 4, detail::parseNumber(special.data(), special.data() + 17, value));
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), value);
+    EXPECT_NE(nullptr, detail::parseNumber(special.data() + 5, special.data() + 17, value));
+    EXPECT_TRUE(std::isnan(value));
+    EXPECT_EQ(special.data() + 17, detail::parseNumber(special.data() + 9, special.data() + 17, value));
+    // An exponent without digits is not part of the number
+    const std::string e = "2e+x";
+    EXPECT_EQ(e.data() + 1, detail::parseNumber(e.data(), e.data() + 4, value));
+    EXPECT_EQ(2.0, value);
+    for (const char *bad : {"", "-", ".", "e5", "x1"}) {
+        EXPECT_EQ(nullptr, detail::parseNumber(bad, bad + std::strlen(bad), value)) << bad;
+    }
+}
+
+TEST(TextParser, points) {
+    const PointBuffer<double> points = parse("x;y\r\n1 2\r\n\r\n# comment\n  -3.5,\t4e1  \n5;6\n7\t8");
+    ASSERT_EQ(4u, points.size());
+    EXPECT_EQ(PackedPoint<double>(1.0, 2.0), points[0]);
+    EXPECT_EQ(PackedPoint<double>(-3.5, 40.0), points[1]);
+    EXPECT_EQ(PackedPoint<double>(5.0, 6.0), points[2]);
+    EXPECT_EQ(PackedPoint<double>(7.0, 8.0), points[3]);
+    EXPECT_TRUE(parse("").empty());
+    EXPECT_TRUE(parse("\n\n# nothing\n").empty());
+    const std::string text = "0.1 0.2\n";
+    const PointBuffer<float> floats = parsePoints<float>(text.data(), text.data() + text.size());
+    EXPECT_EQ(PackedPoint<float>(0.1f, 0.2f), floats[0]);
+
+    // Only the first line may be a header, and a header does not start with a number
+    EXPECT_EQ(3u, badLine("x y\n1 2\nx y\n"));
+    EXPECT_EQ(1u, badLine("1 x\n1 2\n"));
+    EXPECT_EQ(2u, badLine("1 2\n3\n"));
+    EXPECT_EQ(1u, badLine("1 2 3\n"));
+    EXPECT_EQ(1u, badLine("1,,2\n"));
+    EXPECT_EQ(1u, badLine("1-2\n"));
+    EXPECT_THROW(parse("\n1 2\n3 4 x\n"), TextParseException);
+}
+
+TEST(TextParser, chunks) {
+    // Several chunks per thread count, split in the middle of lines
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> coordinate(-1000.0, 1000.0);
+    std::string text = "x,y\n";
+    PointBuffer<double> expected;
+    char line[96];
+    std::size_t lines = 1;
+    while (text.size() < 5 * PARALLEL_PARSE_GRAIN) {
+        const double x = coordinate(gen), y = coordinate(gen);
+        text.append(line, std::size_t(std::snprintf(line, sizeof(line), "%.17g,%.17g\n", x, y)));
+        expected.push_back(x, y);
+        ++lines;
+        if (lines % 1000 == 0) {
+            text += "# comment\n\n";
+            lines += 2;
+        }
+    }
+    for (unsigned threads : {1u, 3u, 4u}) {
+        const PointBuffer<double> points = parse(text, threads);
+        ASSERT_EQ(expected.size(), points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) ASSERT_EQ(expected[i], points[i]);
+    }
+
+    // The line number of an error in a later chunk counts the lines of the chunks before
+    text += "1 2 3\n";
+    for (unsigned threads : {1u, 4u}) EXPECT_EQ(lines + 1, badLine(text, threads));
+}
+
+TEST(TextParser, edges) {
+    const std::string text = "source,target,weight\n0,1,2.5\n1,2\n\n5 0 0.25\n";
+    const CsrGraph<std::uint32_t, double, double> graph = parseEdges(text.data(), text.data() + text.size()).build();
+    EXPECT_EQ(6u, graph.vertexCount());
+    EXPECT_EQ(3u, graph.edgeCount());
+    EXPECT_TRUE(graph.hasWeights());
+    EXPECT_EQ(2.5, graph.weight(graph.findEdge(0, 1)));
+    EXPECT_EQ(1.0, graph.weight(graph.findEdge(1, 2)));
+    EXPECT_EQ(0.25, graph.weight(graph.findEdge(5, 0)));
+
+    const std::string plain = "0 1\n1 0\n";
+    EXPECT_FALSE(parseEdges(plain.data(), plain.data() + plain.size()).build().hasWeights());
+    for (const char *bad : {"0 1 2 3\n", "0 -1\n", "0 1.5\n", "0 4294967295\n", "0 99999999999999999999\n"}) {
+        EXPECT_THROW(parseEdges(bad, bad + std::strlen(bad)), TextParseException) << bad;
+    }
+    // Larger ids fit a 64 bit index
+    const std::string large = "0 4294967295\n";
+    EXPECT_EQ(4294967296ull, (parseEdges<std::uint64_t>(large.data(), large.data() + large.size()).vertexCount()));
+}
+
+TEST(TextParser, files) {
+    const PointBuffer<double> csv = readPoints<double>(GRAPH_ALGO_TEST_DATA "points.csv");
+    ASSERT_EQ(6u, csv.size());
+    EXPECT_EQ(PackedPoint<double>(-312.5, 0.004), csv[2]);
+    EXPECT_EQ(1e300, csv.xs()[3]);
+    EXPECT_EQ(PackedPoint<double>(7.0, 8.0), csv[4]);
+    const PointBuffer<double> text = readPoints<double>(GRAPH_ALGO_TEST_DATA "points.txt");
+    ASSERT_EQ(5u, text.size());
+    EXPECT_EQ(PackedPoint<double>(0.5, 0.5), text[4]);
+
+    GraphBuilder<std::uint32_t, double, double> builder = readEdges(GRAPH_ALGO_TEST_DATA "edges.txt");
+    builder.setCoordinates(text);
+    const CsrGraph<std::uint32_t, double, double> graph = builder.build();
+    EXPECT_EQ(5u, graph.vertexCount());
+    EXPECT_EQ(6u, graph.edgeCount());
+    EXPECT_EQ(0.75, graph.weight(graph.findEdge(1, 2)));
+    EXPECT_THROW(readPoints<double>(GRAPH_ALGO_TEST_DATA "missing.txt"), BinaryFileIOException);
+}
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include "../main/Voronoi.h"
+#include "TestHelpers.h"
+
+using namespace graph_algo;
+using graph_algo::test::randomPoints;
+
+static double squaredDistance(const PackedPoint<double> &a, const PackedPoint<double> &b) {
+    const double dx = a.getX() - b.getX(), dy = a.getY() - b.getY();
+    return dx * dx + dy * dy;
+}
+
+TEST(Voronoi, verticesAreCircumcenters) {
+    const PointBuffer<double> points = randomPoints(500, 1, 0.0, 100.0);
+    DelaunayTriangulation triangulation(points);
+    VoronoiDiagram voronoi(triangulation);
+    ASSERT_EQ(triangulation.triangleCount(), voronoi.vertexCount());
+    const std::vector<std::uint32_t> &triangles = triangulation.triangles();
+    for (std::uint32_t t = 0; t < voronoi.vertexCount(); ++t) {
+        const PackedPoint<double> c = voronoi.vertex(t);
+        const double r = squaredDistance(c, points[triangles[3 * t]]);
+        EXPECT_NEAR(r, squaredDistance(c, points[triangles[3 * t + 1]]), 1e-6 * r);
+        EXPECT_NEAR(r, squaredDistance(c, points[triangles[3 * t + 2]]), 1e-6 * r);
+    }
+}
+
+TEST(Voronoi, cells) {
+    const PointBuffer<double> points = randomPoints(500, 2, 0.0, 100.0);
+    DelaunayTriangulation triangulation(points);
+    VoronoiDiagram voronoi(triangulation, 2);
+    ASSERT_EQ(points.size(), voronoi.cellCount());
+    std::size_t bounded = 0;
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        const ArrayRange<std::uint32_t> cell = voronoi.cell(i);
+        // Every vertex of the cell is a triangle around the point
+        for (std::size_t k = 0; k < cell.size(); ++k) {
+            const std::uint32_t t = cell[k];
+            const std::uint32_t *corner = &triangulation.triangles()[3 * t];
+            EXPECT_TRUE(corner[0] == i || corner[1] == i || corner[2] == i);
+        }
+        if (!voronoi.isBounded(i)) continue;
+        ++bounded;
+        const Polygon<double> polygon = voronoi.cellPolygon(i);
+        EXPECT_TRUE(polygon.isConvex());
+        EXPECT_GT(polygon.signedArea(), 0.0);
+    }
+    EXPECT_EQ(points.size() - triangulation.hull().size(), bounded);
+}
+
+TEST(Voronoi, clippedCellsTileTheBox) {
+    const PointBuffer<double> points = randomPoints(300, 3, 0.0, 100.0);
+    DelaunayTriangulation triangulation(points);
+    VoronoiDiagram voronoi(triangulation);
+    double area = 0.0;
+    for (std::uint32_t i = 0; i < points.size(); ++i) {
+        const Polygon<double> cell = voronoi.clippedCell(i, -10.0, -10.0, 110.0, 110.0);
+        area += cell.signedArea();
+        // The cell of a point holds the points nearer to it than to any other, e.g. its centroid
+        const PackedPoint<double> centroid = cell.centroid();
+        for (std::uint32_t j = 0; j < points.size(); ++j) {
+            EXPECT_LE(squaredDistance(centroid, points[i]), squaredDistance(centroid, points[j]) + 1e-9);
+        }
+        // A bounded cell inside the box is not cut
+        if (voronoi.isBounded(i)) {
+            const Polygon<double> whole = voronoi.cellPolygon(i);
+            bool inside = true;
+            for (int k = 0; k < whole.size(); ++k) {
+                const PackedPoint<double> v = whole[whole.index(k)];
+                inside = inside && v.getX() > -10.0 && v.getX() < 110.0 && v.getY() > -10.0 && v.getY() < 110.0;
+            }
+            if (inside) {
+                EXPECT_NEAR(whole.signedArea(), cell.signedArea(), 1e-6);
+            }
+        }
+    }
+    EXPECT_NEAR(120.0 * 120.0, area, 1e-6);
+}
+
+TEST(Voronoi, collinearAndDuplicates) {
+    PointBuffer<double> points;
+    for (int i = 0; i < 5; ++i) points.push_back(double(i), 0.0);
+    points.push_back(2.0, 0.0);
+    DelaunayTriangulation triangulation(points);
+    VoronoiDiagram voronoi(triangulation);
+    EXPECT_EQ(0u, voronoi.vertexCount());
+    // Strips between the bisectors x = 0.5, 1.5, ...
+    EXPECT_NEAR(1.5 * 4.0, voronoi.clippedCell(0, -1.0, -2.0, 5.0, 2.0).area(), 1e-12);
+    EXPECT_NEAR(1.0 * 4.0, voronoi.clippedCell(2, -1.0, -2.0, 5.0, 2.0).area(), 1e-12);
+    EXPECT_TRUE(voronoi.clippedCell(5, -1.0, -2.0, 5.0, 2.0).empty());
+    EXPECT_FALSE(voronoi.isBounded(2));
+}
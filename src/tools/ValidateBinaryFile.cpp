@@ -0,0 +1,30 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../main/BinaryFile.h"
+
+/*
+ * Checks binary files completely, see validateBinaryFile, and prints what they hold.
+ * Exits with 1 if a file is not valid.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s FILE...\n", argv[0]);
+        return 2;
+    }
+    static const char *const kinds[] = {"", "points", "polygons", "graph"};
+    int status = 0;
+    for (int a = 1; a < argc; ++a) {
+        const std::vector<std::string> problems = graph_algo::validateBinaryFile(argv[a]);
+        if (!problems.empty()) {
+            for (std::size_t p = 0; p < problems.size(); ++p) std::printf("%s: %s\n", argv[a], problems[p].c_str());
+            status = 1;
+            continue;
+        }
+        const graph_algo::BinaryFile file(argv[a]);
+        std::printf("%s: valid, version %u, %s, %llu items, %zu sections, %zu bytes\n", argv[a],
+                    file.header().version, kinds[file.kind()], (unsigned long long) file.itemCount(),
+                    file.sections().size(), file.size());
+    }
+    return status;
+}
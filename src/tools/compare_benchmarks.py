@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""
+Compares two JSON outputs of graph_algo_bench, e.g. of the last release and of the current tree:
+
+    graph_algo_bench --benchmark_out=new.json --benchmark_out_format=json
+    src/tools/compare_benchmarks.py old.json new.json --threshold 0.10
+
+Benchmarks that ran with --benchmark_repetitions are compared by their median. Prints the change
+of the real time of every benchmark in both files and exits with 1 if one got slower by more
+than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """The real time in nanoseconds of every benchmark in a file, medians where there are repetitions"""
+    scale = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    with open(path) as f:
+        benchmarks = json.load(f)['benchmarks']
+    times, medians = {}, {}
+    for b in benchmarks:
+        if b.get('error_occurred'):
+            continue
+        time = b['real_time'] * scale[b.get('time_unit', 'ns')]
+        if b.get('run_type') == 'aggregate':
+            if b.get('aggregate_name') == 'median':
+                medians[b['run_name']] = time
+        else:
+            times.setdefault(b.get('run_name', b['name']), time)
+    times.update(medians)
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compares two graph_algo_bench JSON files.')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='the relative slowdown that counts as a regression (default 0.10)')
+    args = parser.parse_args()
+
+    baseline, current = load(args.baseline), load(args.current)
+    names = [n for n in current if n in baseline]
+    width = max([len(n) for n in names] + [9])
+    regressions = 0
+    print('%-*s %14s %14s %8s' % (width, 'benchmark', 'baseline ns', 'current ns', 'change'))
+    for name in names:
+        change = current[name] / baseline[name] - 1.0 if baseline[name] > 0 else 0.0
+        flag = ''
+        if change > args.threshold:
+            flag = '  slower'
+            regressions += 1
+        elif change < -args.threshold:
+            flag = '  faster'
+        print('%-*s %14.1f %14.1f %+7.1f%%%s' % (width, name, baseline[name], current[name], 100 * change, flag))
+    for name in sorted(set(baseline) ^ set(current)):
+        print('%-*s only in %s' % (width, name, 'baseline' if name in baseline else 'current'))
+    print('%d of %d benchmarks slower by more than %.0f%%' % (regressions, len(names), 100 * args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())